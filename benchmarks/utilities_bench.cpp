@@ -0,0 +1,1000 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "batchstatus.h"
+#include "columnfile.h"
+#include "commands.h"
+#include "conversions.h"
+#include "effectivesinr.h"
+#include "linkadaptation.h"
+#include "linkbudget.h"
+#include "metrics.h"
+#include "numerology.h"
+#include "parallel.h"
+#include "pathloss.h"
+#include "quantilesketch.h"
+#include "resultcache.h"
+#include "scheduler.h"
+#include "simd.h"
+#include "sinr.h"
+#include "sweep.h"
+#include "tbs.h"
+#include "trace.h"
+#include "utilities.h"
+
+// Micro-benchmarks of the functions of utilities.h and of their batch counterparts.
+//
+// Every scalar benchmark calls the function once per element of a fixed set of inputs drawn
+// from the range the function sees in practice, so that branch predictors and table scans
+// are not trained on a single value. Items processed are function calls (or UEs).
+
+namespace {
+
+constexpr std::size_t numInputs = 4096;
+
+std::vector<double> uniform(double low, double high, unsigned seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> distribution(low, high);
+    std::vector<double> values(numInputs);
+    for (double& value : values) {
+        value = distribution(rng);
+    }
+    return values;
+}
+
+std::vector<int> uniformInt(int low, int high, unsigned seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> distribution(low, high);
+    std::vector<int> values(numInputs);
+    for (int& value : values) {
+        value = distribution(rng);
+    }
+    return values;
+}
+
+std::vector<int> choice(const std::vector<int>& options, unsigned seed = 1) {
+    std::vector<int> indices = uniformInt(0, static_cast<int>(options.size()) - 1, seed);
+    for (int& value : indices) {
+        value = options[value];
+    }
+    return indices;
+}
+
+template <typename T, typename Function>
+void callForEach(benchmark::State& state, const std::vector<T>& inputs, Function function) {
+    for (auto _ : state) {
+        for (const T& input : inputs) {
+            benchmark::DoNotOptimize(function(input));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * inputs.size()));
+}
+
+template <typename T, typename U, typename Function>
+void callForEach(benchmark::State& state, const std::vector<T>& a, const std::vector<U>& b, Function function) {
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < a.size(); ++i) {
+            benchmark::DoNotOptimize(function(a[i], b[i]));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * a.size()));
+}
+
+// Ninfo ranges of the two TBS branches
+const std::vector<double>& smallNinfo() { static auto v = uniform(24, 3824); return v; }
+const std::vector<double>& largeNinfo() { static auto v = uniform(3825, 1.2e6); return v; }
+const std::vector<double>& ninfo(int branch) { return branch == 0 ? smallNinfo() : largeNinfo(); }
+const std::vector<int>& codeRates() { static auto v = uniformInt(120, 948, 2); return v; }
+
+void setBranchLabel(benchmark::State& state) {
+    state.SetLabel(state.range(0) == 0 ? "Ninfo<=3824" : "Ninfo>3824");
+}
+
+} // namespace
+
+// Radio basics
+
+void BM_calculateWavelength(benchmark::State& state) {
+    callForEach(state, uniform(0.4e9, 100e9), [](double f) { return calculateWavelength(f); });
+}
+BENCHMARK(BM_calculateWavelength);
+
+void BM_calculateFrequencyFromWavelength(benchmark::State& state) {
+    callForEach(state, uniform(0.003, 0.75), [](double w) { return calculateFrequencyFromWavelength(w); });
+}
+BENCHMARK(BM_calculateFrequencyFromWavelength);
+
+void BM_calculateShannonsCapacity(benchmark::State& state) {
+    callForEach(state, uniform(5e6, 400e6), uniform(0, 1e4, 2),
+                [](double bw, double snr) { return calculateShannonsCapacity(bw, snr); });
+}
+BENCHMARK(BM_calculateShannonsCapacity);
+
+void BM_calculateOFDMSymbolDuration(benchmark::State& state) {
+    callForEach(state, choice({15, 30, 60, 120, 240}), uniformInt(0, 1, 2),
+                [](int scs, int cp) { return calculateOFDMSymbolDuration(scs, cp != 0); });
+}
+BENCHMARK(BM_calculateOFDMSymbolDuration);
+
+void BM_calculateNumberOfSubcarriers(benchmark::State& state) {
+    callForEach(state, uniform(5e6, 400e6), choice({15, 30, 60, 120, 240}, 2),
+                [](double bw, int scs) { return calculateNumberOfSubcarriers(bw, scs); });
+}
+BENCHMARK(BM_calculateNumberOfSubcarriers);
+
+void BM_calculateFFTSize(benchmark::State& state) {
+    callForEach(state, uniform(4e-6, 70e-6), uniform(30.72e6, 245.76e6, 2),
+                [](double t, double fs) { return calculateFFTSize(t, fs); });
+}
+BENCHMARK(BM_calculateFFTSize);
+
+void BM_calculateTrafficDensity(benchmark::State& state) {
+    const auto se = uniform(0.1, 7.4);
+    const auto density = uniform(1, 100, 2);
+    const auto bandwidth = uniform(5e6, 400e6, 3);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numInputs; ++i) {
+            benchmark::DoNotOptimize(calculateTrafficDensity(se[i], density[i], bandwidth[i]));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculateTrafficDensity);
+
+void BM_calculateCoherenceTime(benchmark::State& state) {
+    callForEach(state, uniform(0.003, 0.75), uniform(0.1, 140, 2),
+                [](double w, double v) { return calculateCoherenceTime(w, v); });
+}
+BENCHMARK(BM_calculateCoherenceTime);
+
+void BM_calculateCoherenceBandwidth(benchmark::State& state) {
+    callForEach(state, uniform(10e-9, 5e-6), [](double d) { return calculateCoherenceBandwidth(d); });
+}
+BENCHMARK(BM_calculateCoherenceBandwidth);
+
+// Frame structure
+
+void BM_calculateSlotSize(benchmark::State& state) {
+    callForEach(state, uniformInt(0, 4), [](int n) { return calculateSlotSize(n); });
+}
+BENCHMARK(BM_calculateSlotSize);
+
+void BM_calculateNumberOfSlots(benchmark::State& state) {
+    std::vector<double> slotSizes;
+    for (int n : uniformInt(0, 4)) {
+        slotSizes.push_back(calculateSlotSize(n));
+    }
+    callForEach(state, slotSizes, [](double s) { return calculateNumberOfSlots(s); });
+}
+BENCHMARK(BM_calculateNumberOfSlots);
+
+void BM_calculateSCS(benchmark::State& state) {
+    callForEach(state, uniformInt(0, 4), [](int n) { return calculateSCS(n); });
+}
+BENCHMARK(BM_calculateSCS);
+
+void BM_QamModulationSchemeDescriptor(benchmark::State& state) {
+    callForEach(state, choice({4, 16, 64, 256, 1024}), [](int m) {
+        double b;
+        double sf;
+        QamModulationSchemeDescriptor(m, b, sf);
+        return b + sf;
+    });
+}
+BENCHMARK(BM_QamModulationSchemeDescriptor);
+
+void BM_getNumerology(benchmark::State& state) {
+    callForEach(state, choice({15, 30, 60, 120, 240}), [](int scs) { return getNumerology(scs); });
+}
+BENCHMARK(BM_getNumerology);
+
+// Link budget
+
+void BM_calculateLargeScaleTotalLoss(benchmark::State& state) {
+    callForEach(state, uniform(60, 180), uniform(0, 12, 2),
+                [](double pl, double sh) { return calculateLargeScaleTotalLoss(pl, sh, 10.0); });
+}
+BENCHMARK(BM_calculateLargeScaleTotalLoss);
+
+void BM_calculateTransmittedPowerPerLayer(benchmark::State& state) {
+    callForEach(state, uniform(20, 49), choice({1, 2, 4, 8}, 2),
+                [](double p, int layers) { return calculateTransmittedPowerPerLayer(p, layers); });
+}
+BENCHMARK(BM_calculateTransmittedPowerPerLayer);
+
+void BM_calculateReceivedPowerPerLayer(benchmark::State& state) {
+    callForEach(state, uniform(11, 49), uniform(60, 180, 2),
+                [](double p, double loss) { return calculateReceivedPowerPerLayer(p, loss, 3.0); });
+}
+BENCHMARK(BM_calculateReceivedPowerPerLayer);
+
+void BM_calculateThermalNoisePower(benchmark::State& state) {
+    callForEach(state, uniform(250, 350), uniform(5e6, 400e6, 2),
+                [](double t, double bw) { return calculateThermalNoisePower(t, bw); });
+}
+BENCHMARK(BM_calculateThermalNoisePower);
+
+void BM_dBmToWatts(benchmark::State& state) {
+    callForEach(state, uniform(-140, 50), [](double p) { return dBmToWatts(p); });
+}
+BENCHMARK(BM_dBmToWatts);
+
+void BM_wattsToDbm(benchmark::State& state) {
+    callForEach(state, uniform(1e-17, 100), [](double p) { return wattsToDbm(p); });
+}
+BENCHMARK(BM_wattsToDbm);
+
+void BM_calculateSNRLinear(benchmark::State& state) {
+    callForEach(state, uniform(-130, -40), uniform(1e-14, 2e-12, 2),
+                [](double rx, double noise) { return calculateSNRLinear(rx, noise); });
+}
+BENCHMARK(BM_calculateSNRLinear);
+
+void BM_calculateSpectralEfficiencyPerLayer(benchmark::State& state) {
+    callForEach(state, uniform(0, 1e4), [](double snr) { return calculateSpectralEfficiencyPerLayer(snr); });
+}
+BENCHMARK(BM_calculateSpectralEfficiencyPerLayer);
+
+// CQI / MCS tables
+
+void BM_determineIntermediateSpectralEfficiency(benchmark::State& state) {
+    callForEach(state, uniform(0, 8), [](double se) { return determineIntermediateSpectralEfficiency(se).second; });
+}
+BENCHMARK(BM_determineIntermediateSpectralEfficiency);
+
+void BM_determineIntermediateSpectralEfficiencyTable(benchmark::State& state) {
+    const CQITableId table = static_cast<CQITableId>(state.range(0));
+    callForEach(state, uniform(0, 8),
+                [table](double se) { return determineIntermediateSpectralEfficiency(se, table).second; });
+}
+BENCHMARK(BM_determineIntermediateSpectralEfficiencyTable)->DenseRange(0, 2);
+
+void BM_determineModulationAndCodeRate(benchmark::State& state) {
+    callForEach(state, uniform(0, 8), [](double se) { return determineModulationAndCodeRate(se).second; });
+}
+BENCHMARK(BM_determineModulationAndCodeRate);
+
+void BM_determineModulationAndCodeRateTable(benchmark::State& state) {
+    const MCSTableId table = static_cast<MCSTableId>(state.range(0));
+    callForEach(state, uniform(0, 8),
+                [table](double se) { return determineModulationAndCodeRate(se, table).second; });
+}
+BENCHMARK(BM_determineModulationAndCodeRateTable)->DenseRange(0, 2);
+
+void BM_determineMcsIndex(benchmark::State& state) {
+    const MCSTableId table = static_cast<MCSTableId>(state.range(0));
+    callForEach(state, uniform(0, 8), [table](double se) { return determineMcsIndex(se, table); });
+}
+BENCHMARK(BM_determineMcsIndex)->DenseRange(0, 2);
+
+void BM_determineModulationAndCodeRateUsingMcsIndex(benchmark::State& state) {
+    callForEach(state, uniformInt(0, 27),
+                [](int mcs) { return determineModulationAndCodeRateUsingMcsIndex(mcs).second; });
+}
+BENCHMARK(BM_determineModulationAndCodeRateUsingMcsIndex);
+
+void BM_determineModulationAndCodeRateUsingMcsIndexTable(benchmark::State& state) {
+    const MCSTableId table = static_cast<MCSTableId>(state.range(0));
+    callForEach(state, uniformInt(0, 27),
+                [table](int mcs) { return determineModulationAndCodeRateUsingMcsIndex(mcs, table).second; });
+}
+BENCHMARK(BM_determineModulationAndCodeRateUsingMcsIndexTable)->DenseRange(0, 2);
+
+// Resource elements and TBS
+
+void BM_calculateAvailableREs(benchmark::State& state) {
+    callForEach(state, uniformInt(2, 14), uniformInt(0, 36, 2),
+                [](int symbols, int dmrs) { return calculateAvailableREs(numOfSCsPerRB, symbols, dmrs, 6); });
+}
+BENCHMARK(BM_calculateAvailableREs);
+
+void BM_calculateActualAvailableREs(benchmark::State& state) {
+    callForEach(state, uniformInt(12, 168), uniformInt(1, 273, 2),
+                [](int re, int prbs) { return calculateActualAvailableREs(re, prbs); });
+}
+BENCHMARK(BM_calculateActualAvailableREs);
+
+void BM_calculateNumberOfInformationBits(benchmark::State& state) {
+    callForEach(state, uniformInt(12, 156 * 273), codeRates(),
+                [](int n, int r) { return calculateNumberOfInformationBits(n, r, 6); });
+}
+BENCHMARK(BM_calculateNumberOfInformationBits);
+
+void BM_calculateNinfoPrime(benchmark::State& state) {
+    setBranchLabel(state);
+    callForEach(state, ninfo(static_cast<int>(state.range(0))), [](double n) { return calculateNinfoPrime(n); });
+}
+BENCHMARK(BM_calculateNinfoPrime)->DenseRange(0, 1);
+
+void BM_findTBSForNinfoPrime(benchmark::State& state) {
+    std::vector<int> ninfoPrime;
+    for (double n : smallNinfo()) {
+        ninfoPrime.push_back(calculateNinfoPrime(n));
+    }
+    callForEach(state, ninfoPrime, [](int n) { return findTBSForNinfoPrime(n); });
+}
+BENCHMARK(BM_findTBSForNinfoPrime);
+
+void BM_calculateTBS(benchmark::State& state) {
+    std::vector<int> ninfoPrime;
+    for (double n : largeNinfo()) {
+        ninfoPrime.push_back(calculateNinfoPrime(n));
+    }
+    callForEach(state, ninfoPrime, codeRates(), [](int n, int r) { return calculateTBS(n, r); });
+}
+BENCHMARK(BM_calculateTBS);
+
+void BM_calculateTBSForNinfo(benchmark::State& state) {
+    setBranchLabel(state);
+    callForEach(state, ninfo(static_cast<int>(state.range(0))), codeRates(),
+                [](double n, int r) { return calculateTBSForNinfo(n, r); });
+}
+BENCHMARK(BM_calculateTBSForNinfo)->DenseRange(0, 1);
+
+void BM_calculateTBSForScaledNinfoBatch(benchmark::State& state) {
+    setBranchLabel(state);
+    const std::vector<double>& values = ninfo(static_cast<int>(state.range(0)));
+    std::vector<std::int64_t> scaled(values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        scaled[i] = static_cast<std::int64_t>(values[i] * 2048);
+    }
+    std::vector<int> tbs(values.size());
+    for (auto _ : state) {
+        calculateTBSForScaledNinfoBatch(scaled.data(), codeRates().data(), tbs.data(), values.size());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * values.size()));
+}
+BENCHMARK(BM_calculateTBSForScaledNinfoBatch)->DenseRange(0, 1);
+
+// Throughput
+
+void BM_calculateTotalBitsPerPrb(benchmark::State& state) {
+    callForEach(state, choice({1, 2, 4, 8}), uniformInt(24, 40000, 2),
+                [](int layers, int tbs) { return calculateTotalBitsPerPrb(layers, tbs); });
+}
+BENCHMARK(BM_calculateTotalBitsPerPrb);
+
+void BM_calculateTotalPRBsAvailable(benchmark::State& state) {
+    callForEach(state, uniformInt(11, 273), [](int prbs) { return calculateTotalPRBsAvailable(prbs); });
+}
+BENCHMARK(BM_calculateTotalPRBsAvailable);
+
+void BM_calculateBitsPerSlot(benchmark::State& state) {
+    callForEach(state, uniformInt(24, 40000), uniformInt(9, 224, 2),
+                [](int bits, int prbs) { return calculateBitsPerSlot(bits, prbs); });
+}
+BENCHMARK(BM_calculateBitsPerSlot);
+
+void BM_calculateDLApplicationThroughput(benchmark::State& state) {
+    callForEach(state, uniformInt(24, 4000000), uniformInt(0, 4, 2), [](int bits, int n) {
+        return calculateDLApplicationThroughput(bits, 0.8, calculateSlotSize(n), 1460, 1488);
+    });
+}
+BENCHMARK(BM_calculateDLApplicationThroughput);
+
+void BM_calculateDLFraction(benchmark::State& state) {
+    const std::vector<std::string> ratios = {"4:1", "3:2", "7:3", "1:1", "8:2"};
+    std::vector<std::string> inputs;
+    for (int i : uniformInt(0, static_cast<int>(ratios.size()) - 1)) {
+        inputs.push_back(ratios[i]);
+    }
+    callForEach(state, inputs, [](const std::string& ratio) { return calculateDLFraction(ratio); });
+}
+BENCHMARK(BM_calculateDLFraction);
+
+// Path loss
+
+void BM_calculate5GPathLossRural(benchmark::State& state) {
+    const bool isLOS = state.range(0) != 0;
+    state.SetLabel(isLOS ? "LOS" : "NLOS");
+    callForEach(state, uniform(10, 10000), uniform(1, 10, 2), [isLOS](double d, double ue) {
+        return calculate5GPathLossRural(35, ue, 3300, 3400, d, 5, 20, isLOS);
+    });
+}
+BENCHMARK(BM_calculate5GPathLossRural)->DenseRange(0, 1);
+
+// Same as above with every intermediate value recorded by RingBufferTrace. The rings are
+// drained outside of the timed region before they fill up, so no record is dropped.
+void BM_calculate5GPathLossRuralRingBufferTrace(benchmark::State& state) {
+    const auto distance = uniform(10, 10000);
+    const auto ueHeight = uniform(1, 10, 2);
+    const std::size_t callsPerDrain = traceRingCapacity / 8;
+    std::vector<TraceRecord> records;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calculate5GPathLossRural<RingBufferTrace>(35, ueHeight[i], 3300, 3400, distance[i],
+                                                                           5, 20, true));
+        if (++i == callsPerDrain) {
+            i = 0;
+            state.PauseTiming();
+            records.clear();
+            drainTrace(records);
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_calculate5GPathLossRuralRingBufferTrace);
+
+void BM_calculate5GPathLossRuralBatch(benchmark::State& state) {
+    const SimdLevel requested = static_cast<SimdLevel>(state.range(0));
+    const SimdLevel previous = activeSimdLevel();
+    if (setSimdLevel(requested) != requested) {
+        setSimdLevel(previous);
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return;
+    }
+    const RuralPathLossSite site = makeRuralPathLossSite(35, 3300, 3400, 5, 20);
+    const auto distance = uniform(10, 10000);
+    const auto ueHeight = uniform(1, 10, 2);
+    std::vector<double> pathLoss(numInputs);
+    for (auto _ : state) {
+        calculate5GPathLossRuralBatch(site, distance.data(), ueHeight.data(), false, pathLoss.data(), numInputs);
+        benchmark::ClobberMemory();
+    }
+    setSimdLevel(previous);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculate5GPathLossRuralBatch)->DenseRange(0, 2);
+
+// Multi-cell SINR of 50k UEs under a 40 x 40 grid of cells 500 m apart (1600 cells);
+// range(0) selects pruning at -30 dB, otherwise every pair within range is evaluated
+
+void BM_calculateMultiCellSINRBatch(benchmark::State& state) {
+    std::vector<CoverageSite> cells;
+    for (int r = 0; r < 40; ++r) {
+        for (int c = 0; c < 40; ++c) {
+            cells.push_back({c * 500.0, r * 500.0, 25.0 + 5 * ((r + c) % 3), 43.0});
+        }
+    }
+    const std::size_t count = 50000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> position(0, 39 * 500.0);
+    std::vector<double> x(count), y(count), sinr(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        x[i] = position(rng);
+        y[i] = position(rng);
+    }
+    SinrBatchInput input;
+    input.count = count;
+    input.x = x.data();
+    input.y = y.data();
+    SinrBatchOutput output;
+    output.sinrLinear = sinr.data();
+    SinrConfig config;
+    config.isLOS = true;
+    if (state.range(0) == 0) {
+        config.interferenceThreshold = -std::numeric_limits<double>::infinity();
+    }
+    state.SetLabel(state.range(0) != 0 ? "pruned" : "exhaustive");
+    SinrStats stats;
+    for (auto _ : state) {
+        stats = calculateMultiCellSINRBatch(cells, input, output, config);
+        benchmark::ClobberMemory();
+    }
+    state.counters["pairs_per_UE"] = static_cast<double>(stats.pairsEvaluated) / count;
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_calculateMultiCellSINRBatch)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// 1000 UEs over 10000 slots, 1.25 s of air time at numerology 3; range(0) is the policy
+void BM_SchedulerSimulation(benchmark::State& state) {
+    const std::size_t numUEs = 1000;
+    const std::uint64_t numSlots = 10000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> snr_dB(-5.0, 25.0);
+    std::vector<double> snr(numUEs);
+    for (double& value : snr) {
+        value = std::pow(10.0, snr_dB(rng) / 10);
+    }
+    SchedulerConfig config;
+    config.policy = static_cast<SchedulerPolicy>(state.range(0));
+    for (auto _ : state) {
+        SchedulerResult result = runSchedulerSimulation(snr, numSlots, config);
+        benchmark::DoNotOptimize(result.cellThroughput);
+    }
+    state.counters["air_time_per_run_s"] = numSlots * calculateSlotSize(config.link.numerology) / 1000;
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numSlots));
+}
+BENCHMARK(BM_SchedulerSimulation)->DenseRange(0, 2)->Unit(benchmark::kMillisecond);
+
+// DL throughput of a batch of UEs drawn from 1024 distinct tuples, so that 75% of the
+// queries repeat a tuple; range(0) selects the cache, otherwise the batch engine is called
+void BM_DLThroughputCache(benchmark::State& state) {
+    const auto pathLoss = uniform(70, 140);
+    std::vector<double> keys(numInputs), txPower(numInputs, 43.0), bandwidth(numInputs, 100e6);
+    std::vector<int> layers(numInputs, 2), prbs(numInputs, 273);
+    for (std::size_t i = 0; i < numInputs; ++i) {
+        keys[i] = pathLoss[i % 1024];
+    }
+    DLThroughputBatchInput input;
+    input.count = numInputs;
+    input.pathLoss = keys.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+    std::vector<double> throughput(numInputs);
+    DLThroughputConfig config;
+    config.numerology = 1;
+    DLThroughputCache cache(4096, config);
+    for (auto _ : state) {
+        if (state.range(0) != 0) {
+            state.PauseTiming();
+            cache.clear();
+            state.ResumeTiming();
+            cache.throughputBatch(input, config.numerology, throughput.data());
+        } else {
+            DLThroughputBatchOutput output;
+            output.throughput = throughput.data();
+            calculateDLThroughputBatch(input, output, config);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(state.range(0) != 0 ? "cached" : "uncached");
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_DLThroughputCache)->Arg(0)->Arg(1);
+
+// DL throughput batch of 1M UEs on range(0) threads, 0 for every hardware thread
+void BM_calculateDLThroughputBatchThreads(benchmark::State& state) {
+    const std::size_t count = 1 << 20;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> distribution(70, 140);
+    std::vector<double> pathLoss(count), txPower(count, 43.0), bandwidth(count, 100e6), throughput(count);
+    std::vector<int> layers(count, 4), prbs(count, 273);
+    for (double& value : pathLoss) {
+        value = distribution(rng);
+    }
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    setParallelThreadCount(static_cast<unsigned int>(state.range(0)));
+    for (auto _ : state) {
+        calculateDLThroughputBatch(input, output);
+        benchmark::ClobberMemory();
+    }
+    state.counters["threads"] = parallelThreadCount();
+    setParallelThreadCount(0);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * count));
+}
+BENCHMARK(BM_calculateDLThroughputBatchThreads)->Arg(1)->Arg(0)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// dB / linear conversions over arrays; range(0) is the SIMD level, range(1) selects strict mode
+
+namespace {
+
+bool selectSimdLevel(benchmark::State& state, SimdLevel previous) {
+    const SimdLevel requested = static_cast<SimdLevel>(state.range(0));
+    if (setSimdLevel(requested) != requested) {
+        setSimdLevel(previous);
+        state.SkipWithError("SIMD level not supported by this CPU");
+        return false;
+    }
+    state.SetLabel(state.range(1) != 0 ? "strict" : "fast");
+    return true;
+}
+
+ConversionAccuracy conversionAccuracy(const benchmark::State& state) {
+    return state.range(1) != 0 ? ConversionAccuracy::Strict : ConversionAccuracy::Fast;
+}
+
+void conversionArgs(benchmark::internal::Benchmark* b) {
+    b->Args({0, 1})->Args({0, 0})->Args({1, 0})->Args({2, 0});
+}
+
+} // namespace
+
+void BM_dBmToWattsBatch(benchmark::State& state) {
+    const SimdLevel previous = activeSimdLevel();
+    if (!selectSimdLevel(state, previous)) return;
+    const auto dBm = uniform(-120, 50);
+    std::vector<double> watts(numInputs);
+    for (auto _ : state) {
+        dBmToWattsBatch(dBm.data(), watts.data(), numInputs, conversionAccuracy(state));
+        benchmark::ClobberMemory();
+    }
+    setSimdLevel(previous);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_dBmToWattsBatch)->Apply(conversionArgs);
+
+void BM_wattsToDbmBatch(benchmark::State& state) {
+    const SimdLevel previous = activeSimdLevel();
+    if (!selectSimdLevel(state, previous)) return;
+    const auto watts = uniform(1e-15, 100);
+    std::vector<double> dBm(numInputs);
+    for (auto _ : state) {
+        wattsToDbmBatch(watts.data(), dBm.data(), numInputs, conversionAccuracy(state));
+        benchmark::ClobberMemory();
+    }
+    setSimdLevel(previous);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_wattsToDbmBatch)->Apply(conversionArgs);
+
+void BM_calculateSNRLinearBatch(benchmark::State& state) {
+    const SimdLevel previous = activeSimdLevel();
+    if (!selectSimdLevel(state, previous)) return;
+    const auto rxPower = uniform(-120, -40);
+    const auto noise = uniform(2e-14, 4e-13, 2);
+    std::vector<double> snr(numInputs);
+    for (auto _ : state) {
+        calculateSNRLinearBatch(rxPower.data(), noise.data(), snr.data(), numInputs, conversionAccuracy(state));
+        benchmark::ClobberMemory();
+    }
+    setSimdLevel(previous);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculateSNRLinearBatch)->Apply(conversionArgs);
+
+void BM_calculateSpectralEfficiencyPerLayerBatch(benchmark::State& state) {
+    const SimdLevel previous = activeSimdLevel();
+    if (!selectSimdLevel(state, previous)) return;
+    const auto snr = uniform(0, 1e4);
+    std::vector<double> spectralEfficiency(numInputs);
+    for (auto _ : state) {
+        calculateSpectralEfficiencyPerLayerBatch(snr.data(), spectralEfficiency.data(), numInputs,
+                                                 conversionAccuracy(state));
+        benchmark::ClobberMemory();
+    }
+    setSimdLevel(previous);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculateSpectralEfficiencyPerLayerBatch)->Apply(conversionArgs);
+
+// Full DL throughput chain, per UE and batched
+
+namespace {
+
+struct DLThroughputInputs {
+    std::vector<double> pathLoss = uniform(60, 180);
+    std::vector<double> txPower = uniform(20, 49, 2);
+    std::vector<int> layers = choice({1, 2, 4, 8}, 3);
+    std::vector<int> prbCount = uniformInt(11, 273, 4);
+    std::vector<double> bandwidth = uniform(5e6, 100e6, 5);
+};
+
+} // namespace
+
+void BM_calculateDLThroughput(benchmark::State& state) {
+    DLThroughputInputs in;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numInputs; ++i) {
+            benchmark::DoNotOptimize(calculateDLThroughput(in.pathLoss[i], in.txPower[i], in.layers[i],
+                                                           in.prbCount[i], in.bandwidth[i]));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculateDLThroughput);
+
+void BM_calculateDLThroughputBatch(benchmark::State& state) {
+    DLThroughputInputs in;
+    std::vector<double> throughput(numInputs);
+    DLThroughputBatchInput input;
+    input.count = numInputs;
+    input.pathLoss = in.pathLoss.data();
+    input.txPower = in.txPower.data();
+    input.numOfLayers = in.layers.data();
+    input.prbCount = in.prbCount.data();
+    input.bandwidth = in.bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    DLThroughputConfig config;
+    if (state.range(0) != 0) {
+        config.tbsLookupTable = &defaultTBSLookupTable();
+        state.SetLabel("TBS lookup table");
+    }
+    for (auto _ : state) {
+        calculateDLThroughputBatch(input, output, config);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculateDLThroughputBatch)->DenseRange(0, 1);
+
+// Cost of one stage measurement: a tick counter read and the update of the counters of the
+// thread. calculateDLThroughputBatch() takes six per block of dlThroughputBatchBlockSize
+// UEs when built with FIVEG_METRICS, to compare with the time of a block above
+void BM_StageTimer(benchmark::State& state) {
+    StageTimeline timeline;
+    for (auto _ : state) {
+        timeline.lap(MetricStage::DLSnr, dlThroughputBatchBlockSize);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+BENCHMARK(BM_StageTimer);
+
+// Frame structure of mixed numerologies: the runtime functions per element (0) against
+// calculateFrameStructureBatch(), grouped by numerology (1)
+void BM_FrameStructure(benchmark::State& state) {
+    std::vector<int> numerology(numInputs);
+    std::mt19937 generator(1);
+    for (int& mu : numerology) {
+        mu = static_cast<int>(generator() % (maxNumerology + 1));
+    }
+    std::vector<double> symbolDuration(numInputs), slotSize(numInputs), scs(numInputs);
+    std::vector<int> slots(numInputs);
+    FrameStructureBatchOutput output;
+    output.ofdmSymbolDuration = symbolDuration.data();
+    output.slotSize = slotSize.data();
+    output.slotsPerSubframe = slots.data();
+    output.scs = scs.data();
+    state.SetLabel(state.range(0) == 0 ? "runtime" : "templated");
+    for (auto _ : state) {
+        if (state.range(0) == 0) {
+            for (std::size_t i = 0; i < numInputs; ++i) {
+                slotSize[i] = calculateSlotSize(numerology[i]);
+                slots[i] = calculateNumberOfSlots(slotSize[i]);
+                scs[i] = calculateSCS(numerology[i]);
+                symbolDuration[i] = calculateOFDMSymbolDuration(scs[i], false);
+            }
+        } else {
+            calculateFrameStructureBatch(numerology.data(), output, numInputs);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_FrameStructure)->DenseRange(0, 1);
+
+// DL throughput from file to file: range(0) 0 parses text records, 1 maps column files
+void BM_DLThroughputFromFile(benchmark::State& state) {
+    DLThroughputInputs in;
+    const std::string path = std::string(P_tmpdir) + "/utilities_bench_dl_throughput";
+    if (state.range(0) == 0) {
+        state.SetLabel("text");
+        std::FILE* text = std::fopen((path + ".txt").c_str(), "w");
+        for (std::size_t i = 0; i < numInputs; ++i) {
+            std::fprintf(text, "%d,%.17g,%.17g,%.17g,%d\n", in.layers[i], in.bandwidth[i] / 1e6, in.txPower[i],
+                         in.pathLoss[i], in.prbCount[i]);
+        }
+        std::fclose(text);
+        const Command& command = *findCommand("dl-throughput");
+        for (auto _ : state) {
+            std::FILE* input = std::fopen((path + ".txt").c_str(), "r");
+            std::FILE* output = std::fopen((path + ".out.txt").c_str(), "w");
+            runCommandStream(command, input, output);
+            std::fclose(input);
+            std::fclose(output);
+        }
+        std::remove((path + ".txt").c_str());
+        std::remove((path + ".out.txt").c_str());
+    } else {
+        state.SetLabel("columns");
+        ColumnFileWriter writer;
+        writer.create(path + ".col", numInputs, {{"pathLoss", ColumnType::Float64}, {"txPower", ColumnType::Float64},
+                                                 {"numOfLayers", ColumnType::Int32}, {"prbCount", ColumnType::Int32},
+                                                 {"bandwidth", ColumnType::Float64}});
+        std::copy(in.pathLoss.begin(), in.pathLoss.end(), writer.float64("pathLoss"));
+        std::copy(in.txPower.begin(), in.txPower.end(), writer.float64("txPower"));
+        std::copy(in.layers.begin(), in.layers.end(), writer.int32("numOfLayers"));
+        std::copy(in.prbCount.begin(), in.prbCount.end(), writer.int32("prbCount"));
+        std::copy(in.bandwidth.begin(), in.bandwidth.end(), writer.float64("bandwidth"));
+        writer.close();
+        for (auto _ : state) {
+            calculateDLThroughputColumns(path + ".col", path + ".out.col");
+        }
+        std::remove((path + ".col").c_str());
+        std::remove((path + ".out.col").c_str());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_DLThroughputFromFile)->DenseRange(0, 1);
+
+// Same batch through the validating entry point; range(0) is the percentage of invalid rows
+void BM_calculateDLThroughputBatchChecked(benchmark::State& state) {
+    DLThroughputInputs in;
+    const std::vector<int> rejected = uniformInt(0, 99, 3);
+    for (std::size_t i = 0; i < numInputs; ++i) {
+        in.layers[i] = rejected[i] < state.range(0) ? 0 : in.layers[i];
+    }
+    std::vector<double> throughput(numInputs);
+    std::vector<std::uint64_t> mask(batchMaskWords(numInputs));
+    DLThroughputBatchInput input;
+    input.count = numInputs;
+    input.pathLoss = in.pathLoss.data();
+    input.txPower = in.txPower.data();
+    input.numOfLayers = in.layers.data();
+    input.prbCount = in.prbCount.data();
+    input.bandwidth = in.bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    BatchStatus status;
+    status.validMask = mask.data();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(calculateDLThroughputBatchChecked(input, output, status));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_calculateDLThroughputBatchChecked)->Arg(0)->Arg(10);
+
+// Dimensioning sweep: 4 bandwidths x 4 layer counts x 25 PRB counts x 5 numerologies x
+// 16 Tx powers x 100 path losses = 3.2M points, per point and through the memoized sweep
+
+namespace {
+
+DLThroughputSweepAxes benchmarkSweepAxes() {
+    DLThroughputSweepAxes axes;
+    axes.bandwidth = {20e6, 40e6, 50e6, 100e6};
+    axes.numOfLayers = {1, 2, 4, 8};
+    for (int prb = 11; prb <= 273; prb += 11) axes.prbCount.push_back(prb);
+    axes.numerology = {0, 1, 2, 3, 4};
+    for (int tx = 20; tx < 52; tx += 2) axes.txPower.push_back(tx);
+    for (int pl = 0; pl < 100; ++pl) axes.pathLoss.push_back(60.0 + 1.2 * pl);
+    return axes;
+}
+
+} // namespace
+
+void BM_DLThroughputSweepPerPoint(benchmark::State& state) {
+    const DLThroughputSweepAxes axes = benchmarkSweepAxes();
+    DLThroughputConfig config;
+    for (auto _ : state) {
+        for (double bandwidth : axes.bandwidth)
+        for (int layers : axes.numOfLayers)
+        for (int prbCount : axes.prbCount)
+        for (int numerology : axes.numerology) {
+            config.numerology = numerology;
+            for (double txPower : axes.txPower)
+            for (double pathLoss : axes.pathLoss) {
+                benchmark::DoNotOptimize(calculateDLThroughput(pathLoss, txPower, layers, prbCount, bandwidth, config));
+            }
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * dlThroughputSweepSize(axes)));
+}
+BENCHMARK(BM_DLThroughputSweepPerPoint)->Unit(benchmark::kMillisecond);
+
+void BM_DLThroughputSweep(benchmark::State& state) {
+    const DLThroughputSweepAxes axes = benchmarkSweepAxes();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(runDLThroughputSweep(axes, DLThroughputConfig(), 1).throughput.data());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * dlThroughputSweepSize(axes)));
+}
+BENCHMARK(BM_DLThroughputSweep)->Unit(benchmark::kMillisecond);
+
+// TBS determination over (N_RE, MCS, layers)
+
+void BM_determineTBS(benchmark::State& state) {
+    // N_RE ranges keeping Ninfo on either side of 3824 for single layer transmissions
+    setBranchLabel(state);
+    const auto nRE = state.range(0) == 0 ? uniformInt(12, 300) : uniformInt(20000, maxTBSLookupREs);
+    const auto mcs = uniformInt(0, 27, 2);
+    const auto layers = state.range(0) == 0 ? std::vector<int>(numInputs, 1) : choice({1, 2, 4, 8}, 3);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numInputs; ++i) {
+            benchmark::DoNotOptimize(determineTBS(nRE[i], mcs[i], layers[i]));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_determineTBS)->DenseRange(0, 1);
+
+void BM_TBSLookupTable(benchmark::State& state) {
+    const TBSLookupTable& table = defaultTBSLookupTable();
+    const auto nRE = uniformInt(12, maxTBSLookupREs);
+    const auto mcs = uniformInt(0, 27, 2);
+    const auto layers = choice({1, 2, 4, 8}, 3);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < numInputs; ++i) {
+            benchmark::DoNotOptimize(table.lookup(nRE[i], mcs[i], layers[i]));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_TBSLookupTable);
+
+// SNR to CQI/MCS link adaptation
+
+void BM_determineLinkAdaptation(benchmark::State& state) {
+    callForEach(state, uniform(-10, 40), [](double snr) { return determineLinkAdaptation(snr).codeRate; });
+}
+BENCHMARK(BM_determineLinkAdaptation);
+
+void BM_LinkAdaptationTable(benchmark::State& state) {
+    static const LinkAdaptationTable table;
+    const auto snr = uniform(-10, 40);
+    std::vector<LinkAdaptationEntry> entries(numInputs);
+    for (auto _ : state) {
+        table.lookup(snr.data(), entries.data(), numInputs);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numInputs));
+}
+BENCHMARK(BM_LinkAdaptationTable);
+
+// Per-PRB SINRs to an effective SINR, per UE of 273 PRBs
+
+const std::vector<double>& prbSinr() {
+    static const std::vector<double> sinr = [] {
+        std::vector<double> values = uniform(-5, 30);
+        for (double& value : values) {
+            value = std::pow(10, value / 10);
+        }
+        return values;
+    }();
+    return sinr;
+}
+
+void BM_EffectiveLinkAdaptation(benchmark::State& state) {
+    constexpr std::size_t numPrbs = 273;
+    const std::size_t numUes = numInputs / numPrbs;
+    EffectiveSinrConfig config;
+    config.model = state.range(0) == 0 ? EffectiveSinrModel::EESM : EffectiveSinrModel::MIESM;
+    state.SetLabel(state.range(0) == 0 ? "EESM" : "MIESM");
+    std::vector<EffectiveLinkAdaptation> results(numUes);
+    for (auto _ : state) {
+        determineEffectiveLinkAdaptationBatch(prbSinr().data(), numPrbs, numUes, results.data(), config);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * numUes));
+}
+BENCHMARK(BM_EffectiveLinkAdaptation)->DenseRange(0, 1);
+
+// 5th percentile and median of throughputs: selection on a stored copy of the samples
+// (0) against a streaming quantile sketch (1)
+void BM_ThroughputPercentiles(benchmark::State& state) {
+    const std::vector<double> throughput = uniform(0, 2e6);
+    std::vector<double> stored;
+    QuantileSketch sketch;
+    state.SetLabel(state.range(0) == 0 ? "nth_element" : "sketch");
+    for (auto _ : state) {
+        double cellEdge, median;
+        if (state.range(0) == 0) {
+            stored.assign(throughput.begin(), throughput.end());
+            std::nth_element(stored.begin(), stored.begin() + stored.size() / 20, stored.end());
+            cellEdge = stored[stored.size() / 20];
+            std::nth_element(stored.begin(), stored.begin() + stored.size() / 2, stored.end());
+            median = stored[stored.size() / 2];
+        } else {
+            sketch.clear();
+            sketch.add(throughput.data(), throughput.size());
+            cellEdge = sketch.quantile(0.05);
+            median = sketch.quantile(0.5);
+        }
+        benchmark::DoNotOptimize(cellEdge);
+        benchmark::DoNotOptimize(median);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * throughput.size()));
+}
+BENCHMARK(BM_ThroughputPercentiles)->DenseRange(0, 1);
+
+// Writes the results as JSON to utilities_bench.json, in addition to the console report,
+// unless another output file is requested with --benchmark_out.
+int main(int argc, char** argv) {
+    std::vector<char*> args(argv, argv + argc);
+    bool hasOutput = false;
+    for (int i = 1; i < argc; ++i) {
+        hasOutput = hasOutput || std::strncmp(argv[i], "--benchmark_out=", 16) == 0;
+    }
+    char defaultOutput[] = "--benchmark_out=utilities_bench.json";
+    char defaultFormat[] = "--benchmark_out_format=json";
+    if (!hasOutput) {
+        args.push_back(defaultOutput);
+        args.push_back(defaultFormat);
+    }
+    int numArgs = static_cast<int>(args.size());
+    benchmark::Initialize(&numArgs, args.data());
+    if (benchmark::ReportUnrecognizedArguments(numArgs, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
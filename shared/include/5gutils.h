@@ -0,0 +1,219 @@
+#ifndef FIVEG_UTILS_H
+#define FIVEG_UTILS_H
+
+/**
+ * @file 5gutils.h
+ * @brief Stable C interface of lib5gutils: batched path loss, DL throughput, TBS and
+ * conversion functions for callers in other languages.
+ *
+ * Every function takes arrays as a pointer and a length, and may be called from any thread.
+ * The functions never throw or abort: they return FIVEG_OK or one of the FIVEG_ERROR codes,
+ * in which case the outputs are left unspecified. Rows that are invalid in an otherwise
+ * valid call are reported per row where the C++ function does.
+ *
+ * The interface only grows: functions, constants and struct layouts of a released
+ * FIVEG_API_VERSION are never changed or removed. Structs that may gain fields start with
+ * a size member, set by their init function, so that a library can serve callers built
+ * against an older header.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__)
+#define FIVEG_API __attribute__((visibility("default")))
+#else
+#define FIVEG_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of the interface described by this header. */
+#define FIVEG_API_VERSION 1
+
+/* Status codes */
+#define FIVEG_OK 0
+#define FIVEG_ERROR_NULL_POINTER 1     /* a mandatory array or struct is null */
+#define FIVEG_ERROR_INVALID_ARGUMENT 2 /* an argument common to the whole call is out of range */
+#define FIVEG_ERROR_INTERNAL 3         /* out of memory or another unexpected failure */
+
+/* Accuracy of the conversions, see conversions.h */
+#define FIVEG_ACCURACY_FAST 0   /* SIMD polynomial kernels, within a few ulp of libm */
+#define FIVEG_ACCURACY_STRICT 1 /* bit-identical to the scalar functions */
+
+/* CQI and MCS tables of 3GPP TS 38.214 */
+#define FIVEG_TABLE_1 1 /* up to 64QAM */
+#define FIVEG_TABLE_2 2 /* up to 256QAM */
+#define FIVEG_TABLE_3 3 /* low spectral efficiency */
+
+/**
+ * @brief Get the version of the interface implemented by the library.
+ *
+ * @return FIVEG_API_VERSION of the library, at least the version of a compatible header.
+ */
+FIVEG_API int fiveg_api_version(void);
+
+/**
+ * @brief Get a description of a status code.
+ *
+ * @param status Status code.
+ * @return Static string describing the status.
+ */
+FIVEG_API const char* fiveg_status_message(int status);
+
+/**
+ * @brief Set the number of threads used by the batch functions.
+ *
+ * @param numThreads Number of threads, 0 for the number of hardware threads.
+ * @return The number of threads after the call.
+ */
+FIVEG_API unsigned int fiveg_set_num_threads(unsigned int numThreads);
+
+/* Conversions */
+
+/** @brief Convert powers from dBm to Watts. */
+FIVEG_API int fiveg_dbm_to_watts(const double* dBm, double* watts, size_t count, int accuracy);
+
+/** @brief Convert powers from Watts to dBm. */
+FIVEG_API int fiveg_watts_to_dbm(const double* watts, double* dBm, size_t count, int accuracy);
+
+/** @brief Calculate linear SNRs from received powers in dBm and noise powers in Watts. */
+FIVEG_API int fiveg_snr_linear(const double* rxPower_dBm, const double* thermalNoisePower_Watts, double* snrLinear,
+                               size_t count, int accuracy);
+
+/** @brief Calculate the Shannon spectral efficiency per layer, log2(1 + SNR), of linear SNRs. */
+FIVEG_API int fiveg_spectral_efficiency(const double* snrLinear, double* spectralEfficiency, size_t count,
+                                        int accuracy);
+
+/** @brief Calculate Shannon's capacity in bps from bandwidths in Hz and linear SNRs. */
+FIVEG_API int fiveg_shannon_capacity(const double* bandwidth, const double* snrLinear, double* capacity,
+                                     size_t count, int accuracy);
+
+/* Path loss */
+
+/**
+ * @brief Parameters of a rural macro site, see calculate5GPathLossRural().
+ */
+typedef struct fiveg_rural_site {
+    double gNBAntennaHeight; /* in meters */
+    double fLow;             /* in MHz */
+    double fHigh;            /* in MHz */
+    double buildingHeight;   /* in meters */
+    double streetWidth;      /* in meters */
+} fiveg_rural_site;
+
+/**
+ * @brief Calculate the 3GPP TR 38.901 rural macro path loss of UEs of one site.
+ *
+ * @param site Site parameters.
+ * @param distance2D Horizontal distances between the gNB and the UEs in meters.
+ * @param ueHeight Heights of the UEs in meters.
+ * @param isLOS Non-zero for line of sight.
+ * @param pathLoss Output array receiving the path loss in dB, 0 outside the validity range.
+ * @param count Number of UEs.
+ * @return Status code.
+ */
+FIVEG_API int fiveg_pathloss_rural(const fiveg_rural_site* site, const double* distance2D, const double* ueHeight,
+                                   int isLOS, double* pathLoss, size_t count);
+
+/* TBS */
+
+/**
+ * @brief Determine the TBS of PDSCH allocations, see determineTBS().
+ *
+ * @param nRE Numbers of REs allocated to the UEs.
+ * @param mcsIndex MCS indices.
+ * @param numLayers Numbers of spatial layers.
+ * @param tbs Output array receiving the TBS sizes in bits, 0 for an invalid allocation.
+ * @param count Number of allocations.
+ * @param mcsTable FIVEG_TABLE_1, 2 or 3.
+ * @return Status code.
+ */
+FIVEG_API int fiveg_determine_tbs(const int32_t* nRE, const int32_t* mcsIndex, const int32_t* numLayers, int32_t* tbs,
+                                  size_t count, int mcsTable);
+
+/* DL throughput */
+
+/**
+ * @brief Parameters common to the UEs of a DL throughput batch, see DLThroughputConfig.
+ */
+typedef struct fiveg_dl_throughput_config {
+    size_t size; /* sizeof(fiveg_dl_throughput_config) */
+    double dlFraction;
+    int32_t applicationPacketSize; /* in bytes */
+    int32_t macPacketSize;         /* in bytes */
+    int32_t numerology;
+    int32_t prbPerUE;
+    int32_t numOfSymbolsPerSlot;
+    int32_t numOfREsForDMRS;
+    int32_t numOfOverheadREs;
+    int32_t cqiTable;              /* FIVEG_TABLE_1, 2 or 3 */
+    int32_t mcsTable;              /* FIVEG_TABLE_1, 2 or 3 */
+    int32_t accuracy;              /* FIVEG_ACCURACY_FAST or FIVEG_ACCURACY_STRICT */
+    double temperature;            /* in Kelvin */
+    double shadowingLoss;          /* in dB, used when the batch has no shadowing column */
+    double o2iLoss;                /* in dB, used when the batch has no O2I column */
+    double beamFormingGain;        /* in dB per layer */
+    double downlinkOverhead;       /* fraction of PRBs lost to DL overhead */
+} fiveg_dl_throughput_config;
+
+/**
+ * @brief Fill a configuration with the defaults of DLThroughputConfig.
+ *
+ * @param config Configuration to initialize.
+ */
+FIVEG_API void fiveg_dl_throughput_config_init(fiveg_dl_throughput_config* config);
+
+/**
+ * @brief Input columns of a DL throughput batch; the last two are optional.
+ */
+typedef struct fiveg_dl_throughput_input {
+    const double* pathLoss;      /* in dB */
+    const double* txPower;       /* total transmit power in dBm */
+    const int32_t* numOfLayers;
+    const int32_t* prbCount;     /* PRBs configured in the gNB */
+    const double* bandwidth;     /* in Hz */
+    const double* shadowingLoss; /* in dB, or null */
+    const double* o2iLoss;       /* in dB, or null */
+} fiveg_dl_throughput_input;
+
+/**
+ * @brief Output columns of a DL throughput batch; all but the throughput are optional.
+ */
+typedef struct fiveg_dl_throughput_output {
+    double* throughput;      /* DL application throughput in kbps */
+    double* snrLinear;       /* SNR per layer */
+    int32_t* cqiIndex;
+    int32_t* mcsIndex;
+    int32_t* modulationOrder;
+    double* codeRate;        /* R in 1024 units */
+    int32_t* tbsSize;        /* TBS per layer in bits */
+    uint64_t* validMask;     /* bit i % 64 of word i / 64 is set for a valid row, (count + 63) / 64 words */
+    uint8_t* errors;         /* per row, 0 when valid, otherwise a BatchError of batchstatus.h */
+} fiveg_dl_throughput_output;
+
+/**
+ * @brief Run the DL throughput chain for a batch of UEs.
+ *
+ * Rows with a non-finite input, or with a layer count, PRB count or bandwidth out of range,
+ * get 0 in every output column and are reported in validMask and errors. So are all rows
+ * when a parameter of the configuration is out of range (error 1, InvalidConfiguration).
+ *
+ * @param config Parameters common to all UEs, null for the defaults.
+ * @param input Input columns.
+ * @param output Output columns.
+ * @param count Number of UEs.
+ * @param numInvalid Receives the number of invalid rows, may be null.
+ * @return Status code; FIVEG_ERROR_INVALID_ARGUMENT for an unknown table or accuracy, or a
+ *         config.size smaller than that of version 1.
+ */
+FIVEG_API int fiveg_dl_throughput(const fiveg_dl_throughput_config* config, const fiveg_dl_throughput_input* input,
+                                  const fiveg_dl_throughput_output* output, size_t count, size_t* numInvalid);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FIVEG_UTILS_H */
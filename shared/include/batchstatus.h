@@ -0,0 +1,145 @@
+#ifndef BATCHSTATUS_H
+#define BATCHSTATUS_H
+
+/**
+ * @file batchstatus.h
+ * @brief Batch entry points that report invalid elements per element instead of throwing.
+ *
+ * The scalar functions of utilities.h signal invalid input in two ways: getNumerology() and
+ * determineModulationAndCodeRateUsingMcsIndex() throw, the others return 0 or -1. Neither
+ * works well over large batches: one bad row unwinds the whole job, or its sentinel is
+ * silently summed into the aggregates.
+ *
+ * The functions below validate every element, compute the valid ones and write 0 to the
+ * outputs of the invalid ones. Validation is folded into the loops as selects rather than
+ * branches. Each element gets a bit in a validity mask, and optionally an error code, so
+ * invalid records can be skipped by later vectorized passes and reported afterwards.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include "linkbudget.h"
+
+/**
+ * @brief Reason an element of a batch was rejected.
+ *
+ * When several checks fail, the first one in declaration order is reported.
+ */
+enum class BatchError : std::uint8_t {
+    None = 0,
+    InvalidConfiguration, // a parameter shared by the whole batch is invalid, or a mandatory column is null
+    NonFiniteInput,       // NaN or infinite floating point input
+    UnsupportedSCS,       // subcarrier spacing other than 15, 30, 60, 120 or 240 kHz
+    InvalidMcsIndex,      // MCS index outside of the MCS table
+    InvalidLayerCount,    // number of layers outside [1, maxNumOfLayers]
+    InvalidPrbCount,      // PRB count outside [0, maxNumOfPRBs]
+    InvalidBandwidth      // bandwidth not greater than 0
+};
+
+/**
+ * @brief Get a human readable description of a batch error.
+ *
+ * @param error Error code.
+ * @return Static string describing the error.
+ */
+const char* batchErrorMessage(BatchError error) noexcept;
+
+/**
+ * @brief Get the number of 64-bit words of the validity mask of a batch.
+ *
+ * @param count Number of elements.
+ * @return Number of words.
+ */
+constexpr std::size_t batchMaskWords(std::size_t count) {
+    return (count + 63) / 64;
+}
+
+/**
+ * @brief Status columns filled by the checked batch functions.
+ *
+ * Both columns are optional. Bit (i % 64) of validMask[i / 64] is set when element i is
+ * valid; the unused high bits of the last word are cleared.
+ */
+struct BatchStatus {
+    std::uint64_t* validMask = nullptr; // optional, batchMaskWords(count) words
+    BatchError* errors = nullptr;       // optional, count elements, BatchError::None when valid
+};
+
+/**
+ * @brief Check the validity bit of an element.
+ *
+ * @param validMask Validity mask.
+ * @param i Element index.
+ * @return True if element i is valid.
+ */
+inline bool isBatchElementValid(const std::uint64_t* validMask, std::size_t i) noexcept {
+    return (validMask[i / 64] >> (i % 64)) & 1u;
+}
+
+/**
+ * @brief Count the valid elements of a batch.
+ *
+ * @param validMask Validity mask.
+ * @param count Number of elements.
+ * @return Number of set bits among the first @p count.
+ */
+std::size_t countValidBatchElements(const std::uint64_t* validMask, std::size_t count) noexcept;
+
+/**
+ * @brief Determine the numerology of an array of subcarrier spacings.
+ *
+ * Non-throwing counterpart of getNumerology(). Unsupported spacings yield numerology 0
+ * and BatchError::UnsupportedSCS.
+ *
+ * @param scs Subcarrier spacings in kHz.
+ * @param numerology Output array receiving the numerologies.
+ * @param count Number of elements.
+ * @param status Status columns.
+ * @return Number of invalid elements.
+ */
+std::size_t getNumerologyBatch(const int* scs, int* numerology, std::size_t count,
+                               const BatchStatus& status) noexcept;
+
+/**
+ * @brief Look up Modulation Order (Qm) and MCS Code Rate (R) for an array of MCS indices.
+ *
+ * Non-throwing counterpart of determineModulationAndCodeRateUsingMcsIndex(). Indices outside
+ * the table yield Qm = 0, R = 0 and BatchError::InvalidMcsIndex.
+ *
+ * @param mcsIdx MCS indices.
+ * @param modulationOrder Output array receiving Qm.
+ * @param codeRate Output array receiving R in 1024 units.
+ * @param count Number of elements.
+ * @param status Status columns.
+ * @param table MCS table to use.
+ * @return Number of invalid elements.
+ */
+std::size_t determineModulationAndCodeRateUsingMcsIndexBatch(const int* mcsIdx, int* modulationOrder, double* codeRate,
+                                                             std::size_t count, const BatchStatus& status,
+                                                             MCSTableId table = MCSTableId::Table2) noexcept;
+
+/**
+ * @brief Run the DL throughput chain for a batch of UEs, rejecting invalid rows.
+ *
+ * Valid rows get the same values as calculateDLThroughputBatch(). A row is invalid if a
+ * floating point input is not finite, or if its layers, PRB count or bandwidth is out of
+ * range; every output column of an invalid row is set to 0. If the configuration is
+ * invalid (numerology outside [0, 4], packet sizes not positive, PRBs per UE negative)
+ * or a mandatory input column is null, every row is rejected with
+ * BatchError::InvalidConfiguration.
+ *
+ * Invalid rows never throw, but the batch runs on the thread pool of parallel.h, so a
+ * failure to allocate memory or to start a thread is thrown to the caller.
+ *
+ * @param input Input columns.
+ * @param output Output columns.
+ * @param status Status columns.
+ * @param config Parameters common to all UEs of the batch.
+ * @return Number of invalid rows.
+ * @throws std::bad_alloc or std::system_error if the thread pool cannot run the batch.
+ */
+std::size_t calculateDLThroughputBatchChecked(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                                              const BatchStatus& status,
+                                              const DLThroughputConfig& config = DLThroughputConfig());
+
+#endif // BATCHSTATUS_H
@@ -0,0 +1,254 @@
+#ifndef COLUMNFILE_H
+#define COLUMNFILE_H
+
+/**
+ * @file columnfile.h
+ * @brief Memory mapped columnar files for the inputs and results of batch runs.
+ *
+ * A column file holds a fixed number of rows of named columns of doubles or 32 bit
+ * integers, each column stored contiguously, so that a mapped column is directly the
+ * pointer + length array the batch engines take. Opening a file only reads its header and
+ * column directory, whatever the number of rows. Version 1 of the layout, in the byte
+ * order of the writer:
+ *
+ *     offset 0   header, 64 bytes:
+ *                char[8] magic "5GCOLUMN", uint32 version (1), uint32 byte order mark
+ *                (0x01020304), uint64 number of rows, uint32 number of columns, uint32 0,
+ *                uint64 file size, 24 zero bytes
+ *     offset 64  one 64 byte directory entry per column:
+ *                char[48] name (NUL terminated), uint32 type (1 float64, 2 int32), uint32 0,
+ *                uint64 offset of the column data
+ *     then       the column data, each column starting on a 64 byte boundary
+ *
+ * Readers reject files with another magic, version or byte order, or whose columns do not
+ * fit the file. Other tools can write the format with a few lines of code; the rows of a
+ * column are just an array of native doubles or int32s.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "linkbudget.h"
+#include "pathloss.h"
+
+/**
+ * @brief Element type of a column.
+ */
+enum class ColumnType : std::uint32_t {
+    Float64 = 1,
+    Int32 = 2
+};
+
+/**
+ * @brief Name and type of a column of a file to create.
+ */
+struct ColumnSpec {
+    std::string name; // at most 47 characters
+    ColumnType type;
+};
+
+/**
+ * @brief Read only mapping of a column file.
+ */
+class ColumnFile {
+public:
+    ColumnFile() = default;
+    ~ColumnFile();
+
+    ColumnFile(const ColumnFile&) = delete;
+    ColumnFile& operator=(const ColumnFile&) = delete;
+
+    /**
+     * @brief Map a column file, replacing the file mapped before.
+     *
+     * Takes the same time for any number of rows: the columns are paged in as they are
+     * read, and are advised for sequential access.
+     *
+     * @param path Path of the file.
+     * @return False if the file could not be mapped, errno tells why (EINVAL for a file
+     *         that is not a valid column file).
+     */
+    bool open(const std::string& path);
+
+    /**
+     * @brief Unmap the file. The column pointers become invalid.
+     */
+    void close();
+
+    std::size_t numRows() const { return numRows_; }
+    std::size_t numColumns() const { return columns_.size(); }
+    const std::string& columnName(std::size_t column) const { return columns_[column].name; }
+    ColumnType columnType(std::size_t column) const { return columns_[column].type; }
+
+    /**
+     * @brief Get a column of doubles.
+     *
+     * @param name Name of the column.
+     * @return The numRows() values of the column, null if there is no such column of doubles.
+     */
+    const double* float64(const std::string& name) const;
+
+    /**
+     * @brief Get a column of 32 bit integers.
+     *
+     * @param name Name of the column.
+     * @return The numRows() values of the column, null if there is no such column of integers.
+     */
+    const std::int32_t* int32(const std::string& name) const;
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        const void* data;
+    };
+
+    const void* find(const std::string& name, ColumnType type) const;
+
+    void* mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+    std::size_t numRows_ = 0;
+    std::vector<Column> columns_;
+};
+
+/**
+ * @brief Writer of a column file, with the columns mapped for the engines to fill in place.
+ *
+ * The number of rows is fixed when the file is created. Callers that produce the rows in
+ * order call flush() after each block of rows, which starts writing the block to disk so
+ * that the results stream out while the next block is computed.
+ */
+class ColumnFileWriter {
+public:
+    ColumnFileWriter() = default;
+    ~ColumnFileWriter();
+
+    ColumnFileWriter(const ColumnFileWriter&) = delete;
+    ColumnFileWriter& operator=(const ColumnFileWriter&) = delete;
+
+    /**
+     * @brief Create a column file, replacing any existing file, and map its columns.
+     *
+     * The columns are zero until written.
+     *
+     * @param path Path of the file.
+     * @param numRows Number of rows.
+     * @param columns Names and types of the columns; names must be unique.
+     * @return False if the file could not be created, errno tells why (EINVAL for an
+     *         empty, too long or repeated column name).
+     */
+    bool create(const std::string& path, std::size_t numRows, const std::vector<ColumnSpec>& columns);
+
+    /**
+     * @brief Start writing rows [beginRow, endRow) of every column to disk.
+     *
+     * @return False if the write back could not be started, errno tells why.
+     */
+    bool flush(std::size_t beginRow, std::size_t endRow);
+
+    /**
+     * @brief Write every row to disk and close the file. The column pointers become invalid.
+     *
+     * @return False if the file could not be written, errno tells why.
+     */
+    bool close();
+
+    std::size_t numRows() const { return numRows_; }
+
+    /**
+     * @brief Get a column of doubles to fill.
+     *
+     * @param name Name of the column.
+     * @return The numRows() values of the column, null if there is no such column of doubles.
+     */
+    double* float64(const std::string& name);
+
+    /**
+     * @brief Get a column of 32 bit integers to fill.
+     *
+     * @param name Name of the column.
+     * @return The numRows() values of the column, null if there is no such column of integers.
+     */
+    std::int32_t* int32(const std::string& name);
+
+private:
+    struct Column {
+        std::string name;
+        ColumnType type;
+        std::size_t offset;
+    };
+
+    void* find(const std::string& name, ColumnType type);
+
+    int file_ = -1;
+    void* mapping_ = nullptr;
+    std::size_t mappingSize_ = 0;
+    std::size_t numRows_ = 0;
+    std::vector<Column> columns_;
+};
+
+/**
+ * @brief Point the input columns of a DL throughput batch at the columns of a file.
+ *
+ * Uses the float64 columns "pathLoss", "txPower", "bandwidth", "shadowingLoss" and
+ * "o2iLoss" and the int32 columns "numOfLayers" and "prbCount", in the units of
+ * DLThroughputBatchInput. The last two float64 columns are optional.
+ *
+ * @param file Mapped input file.
+ * @param input Receives the column pointers and the number of rows.
+ * @return False if a mandatory column is missing.
+ */
+bool mapDLThroughputInput(const ColumnFile& file, DLThroughputBatchInput& input);
+
+/**
+ * @brief Columns of a DL throughput result file.
+ *
+ * @param intermediates Also store the intermediate results of DLThroughputBatchOutput.
+ * @return "throughput", then "snrLinear", "cqiIndex", "mcsIndex", "modulationOrder",
+ *         "codeRate" and "tbsSize" if asked for.
+ */
+std::vector<ColumnSpec> dlThroughputOutputColumns(bool intermediates);
+
+/**
+ * @brief Point the output columns of a DL throughput batch at the columns of a file.
+ *
+ * Columns of dlThroughputOutputColumns() missing from the file are left null.
+ *
+ * @param file Result file being written.
+ * @return The output columns.
+ */
+DLThroughputBatchOutput mapDLThroughputOutput(ColumnFileWriter& file);
+
+/**
+ * @brief Run calculateDLThroughputBatch() from a column file into a new column file.
+ *
+ * The engine reads and writes the mapped columns directly, one block of rows at a time,
+ * and each finished block is flushed to disk.
+ *
+ * @param inputPath File with the columns of mapDLThroughputInput().
+ * @param outputPath Result file to create, with the columns of dlThroughputOutputColumns().
+ * @param config Parameters common to all UEs.
+ * @param intermediates Also store the intermediate results.
+ * @return False on a missing column or an I/O error, errno tells why.
+ */
+bool calculateDLThroughputColumns(const std::string& inputPath, const std::string& outputPath,
+                                  const DLThroughputConfig& config = DLThroughputConfig(),
+                                  bool intermediates = false);
+
+/**
+ * @brief Run calculate5GPathLossRuralBatch() from a column file into a new column file.
+ *
+ * Reads the float64 columns "distance2D" and "ueHeight" in meters and writes the float64
+ * column "pathLoss" in dB, one block of rows at a time.
+ *
+ * @param site Precomputed site model.
+ * @param isLOS Boolean indicating if the scenario is Line of Sight.
+ * @param inputPath Input file.
+ * @param outputPath Result file to create.
+ * @return False on a missing column or an I/O error, errno tells why.
+ */
+bool calculate5GPathLossRuralColumns(const RuralPathLossSite& site, bool isLOS, const std::string& inputPath,
+                                     const std::string& outputPath);
+
+#endif // COLUMNFILE_H
@@ -0,0 +1,144 @@
+#ifndef COMMANDS_H
+#define COMMANDS_H
+
+/**
+ * @file commands.h
+ * @brief Non-interactive registry of the utilities, shared by the multi-call `5g` binary.
+ *
+ * Every utility, and every function of utilities.h, is exposed as a command taking one
+ * record of numeric inputs and producing one record of numeric outputs. Records are read as lines of comma, semicolon, tab or space
+ * separated values and written back as comma separated values, one output line per record.
+ */
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+
+/**
+ * @brief Maximum number of input or output fields of a command.
+ */
+constexpr int maxCommandFields = 8;
+
+/**
+ * @brief A utility callable on one record.
+ */
+struct Command {
+    const char* name;        // name used on the `5g` command line
+    const char* utility;     // name of the interactive utility it replaces, or of the function it calls
+    const char* description;
+    const char* inputs;      // comma separated input column names
+    const char* outputs;     // comma separated output column names
+    int minInputs;           // trailing optional inputs default to 0
+    int maxInputs;
+    int numOutputs;
+    bool (*evaluate)(const double* inputs, double* outputs); // false for an invalid record
+    // Optional, evaluates count records at once; records are maxCommandFields values apart
+    // in inputs and outputs, valid receives what evaluate() would return for each record
+    void (*evaluateBatch)(const double* inputs, double* outputs, bool* valid, std::size_t count);
+};
+
+/**
+ * @brief Options of a streaming batch run.
+ */
+struct CommandStreamOptions {
+    int precision = 17;  // significant digits of the outputs, 17 round-trips doubles
+    bool header = false; // write the output column names as the first line
+};
+
+/**
+ * @brief Counters of a streaming batch run.
+ */
+struct CommandStreamStats {
+    std::size_t records = 0; // records evaluated, one output line each
+    std::size_t invalid = 0; // records that could not be parsed or were rejected by the command
+};
+
+/**
+ * @brief Get the registered commands.
+ *
+ * @param count Receives the number of commands.
+ * @return Array of the commands.
+ */
+const Command* commandList(std::size_t& count);
+
+/**
+ * @brief Find a command by its name or by the name of the utility it replaces.
+ *
+ * @param name Command or utility name.
+ * @return The command, nullptr if none matches.
+ */
+const Command* findCommand(const std::string& name);
+
+/**
+ * @brief Parse the numeric fields of a record.
+ *
+ * @param begin First character of the record.
+ * @param end One past the last character of the record; *end must not be a digit.
+ * @param fields Receives up to maxCommandFields values.
+ * @return Number of fields, -1 if a field is not a number or there are too many.
+ */
+int parseCommandFields(const char* begin, const char* end, double* fields);
+
+/**
+ * @brief Append the outputs of a command as one comma separated line.
+ *
+ * @param command Command which produced the outputs.
+ * @param outputs Its command.numOutputs outputs, ignored when @p valid is false.
+ * @param valid False to write "nan" for every output.
+ * @param out Output buffer.
+ * @param precision Significant digits of the outputs.
+ */
+void formatCommandOutputs(const Command& command, const double* outputs, bool valid, std::string& out,
+                          int precision);
+
+/**
+ * @brief Parse a record and evaluate a command on it.
+ *
+ * The outputs are appended to @p out as one comma separated line. Records which do not
+ * parse, have the wrong number of fields or are rejected by the command produce a line
+ * of "nan" outputs so that output lines stay aligned with input records.
+ *
+ * @param command Command to evaluate.
+ * @param begin First character of the record.
+ * @param end One past the last character of the record; *end must not be a digit.
+ * @param out Output buffer.
+ * @param precision Significant digits of the outputs.
+ * @return True if the record was valid.
+ */
+bool evaluateRecord(const Command& command, const char* begin, const char* end, std::string& out, int precision);
+
+/**
+ * @brief Evaluate a command on every record of a stream.
+ *
+ * Input is read in large blocks and output is buffered, so the cost per record is the
+ * parsing, the calculation and the formatting only. Empty lines and lines starting with
+ * '#' are skipped; so is a first line whose first field is not a number (a CSV header).
+ *
+ * @param command Command to evaluate.
+ * @param in Input stream.
+ * @param out Output stream.
+ * @param options Formatting options.
+ * @return Number of records and of invalid records.
+ */
+CommandStreamStats runCommandStream(const Command& command, std::FILE* in, std::FILE* out,
+                                    const CommandStreamOptions& options = CommandStreamOptions());
+
+/**
+ * @brief Evaluate a command on every row of a column file (see columnfile.h).
+ *
+ * The inputs are the float64 columns named after the input column names of the command;
+ * trailing optional inputs may be missing and default to 0. The result file gets one
+ * float64 column per output, "nan" for invalid rows. Rows are gathered into records one
+ * block at a time and go through evaluateBatch() when the command has one; the engines of
+ * columnfile.h work on the mapped columns without that step.
+ *
+ * @param command Command to evaluate.
+ * @param inputPath Input column file.
+ * @param outputPath Result file to create.
+ * @param stats Receives the number of rows and of invalid rows.
+ * @return False on a missing input column or an I/O error, errno tells why.
+ */
+bool runCommandColumns(const Command& command, const std::string& inputPath, const std::string& outputPath,
+                       CommandStreamStats& stats);
+
+#endif // COMMANDS_H
@@ -4,87 +4,279 @@
 /**
  * @file constants.h
  * @brief Constants used by the utility functions for telecommunications calculations.
+ *
+ * The 3GPP tables are constexpr arrays: they live in read-only data, need no static
+ * initialization and can be evaluated at compile time. Only numeric fields are stored
+ * in the table entries; modulation names are kept apart, see modulationSchemeName().
  */
 
+#include <cstddef>
+
 constexpr double pi            = 3.14159265358979323846;
 constexpr double speedOfLight  = 299792458.0; // in meters/second
 constexpr    int numOfSCsPerRB = 12;
+constexpr    int maxNumOfLayers = 8;   // PDSCH layers per UE, TS 38.211
+constexpr    int maxNumOfPRBs   = 275; // largest transmission bandwidth configuration, TS 38.101
+
+/**
+ * @brief Read-only view of a constexpr 3GPP table.
+ */
+template <typename T>
+struct ConstexprTable {
+    const T* entries;
+    std::size_t count;
+
+    constexpr std::size_t size() const { return count; }
+    constexpr const T& operator[](std::size_t i) const { return entries[i]; }
+    constexpr const T& front() const { return entries[0]; }
+    constexpr const T& back() const { return entries[count - 1]; }
+    constexpr const T* begin() const { return entries; }
+    constexpr const T* end() const { return entries + count; }
+};
+
+/**
+ * @brief CQI tables of 3GPP TS 38.214 Section 5.2.2.1.
+ */
+enum class CQITableId {
+    Table1, // Table 5.2.2.1-2, up to 64QAM
+    Table2, // Table 5.2.2.1-3, up to 256QAM
+    Table3  // Table 5.2.2.1-4, low spectral efficiency
+};
+
+/**
+ * @brief MCS index tables for PDSCH of 3GPP TS 38.214 Section 5.1.3.1.
+ */
+enum class MCSTableId {
+    Table1, // Table 5.1.3.1-1, up to 64QAM
+    Table2, // Table 5.1.3.1-2, up to 256QAM
+    Table3  // Table 5.1.3.1-3, low spectral efficiency
+};
+
+/**
+ * @brief Modulation scheme names, indexed by modulation order / 2.
+ */
+constexpr const char* modulationSchemeNames[] = {
+    "Modulation_Zero", "Modulation_QPSK", "Modulation_16_QAM", "Modulation_64_QAM", "Modulation_256_QAM"
+};
+
+/**
+ * @brief Get the name of a modulation scheme.
+ *
+ * @param modulationOrder Modulation order (Qm), 0 for the out of range CQI.
+ * @return Name of the modulation scheme.
+ */
+constexpr const char* modulationSchemeName(int modulationOrder) {
+    return modulationSchemeNames[modulationOrder / 2];
+}
 
 /**
  * @brief Structure to hold CQI table entries.
  */
 struct CQIEntry {
     int index;
-    const char* modulation;
-    int codeRate;
+    int modulationOrder; // Qm, 0 for the out of range entry
+    double codeRate; // x 1024
     double intermediateSpectralEfficiency; // Expressed as bits/s/Hz
 };
 
-// CQI table
-const std::vector<CQIEntry> cqiTable = {
-    {0,  "Modulation_Zero",    0,   0.0},
-    {1,  "Modulation_QPSK",    78,  0.1523},
-    {2,  "Modulation_QPSK",    193, 0.3770},
-    {3,  "Modulation_QPSK",    449, 0.8770},
-    {4,  "Modulation_16_QAM",  378, 1.4766},
-    {5,  "Modulation_16_QAM",  490, 1.9141},
-    {6,  "Modulation_16_QAM",  616, 2.4063},
-    {7,  "Modulation_64_QAM",  466, 2.7305},
-    {8,  "Modulation_64_QAM",  567, 3.3223},
-    {9,  "Modulation_64_QAM",  666, 3.9023},
-    {10, "Modulation_64_QAM",  772, 4.5234},
-    {11, "Modulation_64_QAM",  873, 5.1152},
-    {12, "Modulation_256_QAM", 711, 5.5547},
-    {13, "Modulation_256_QAM", 797, 6.2266},
-    {14, "Modulation_256_QAM", 885, 6.9141},
-    {15, "Modulation_256_QAM", 948, 7.4063}
+constexpr CQIEntry cqiTable1Entries[] = {
+    {0,  0, 0,   0.0},
+    {1,  2, 78,  0.1523},
+    {2,  2, 120, 0.2344},
+    {3,  2, 193, 0.3770},
+    {4,  2, 308, 0.6016},
+    {5,  2, 449, 0.8770},
+    {6,  2, 602, 1.1758},
+    {7,  4, 378, 1.4766},
+    {8,  4, 490, 1.9141},
+    {9,  4, 616, 2.4063},
+    {10, 6, 466, 2.7305},
+    {11, 6, 567, 3.3223},
+    {12, 6, 666, 3.9023},
+    {13, 6, 772, 4.5234},
+    {14, 6, 873, 5.1152},
+    {15, 6, 948, 5.5547}
 };
 
+constexpr CQIEntry cqiTable2Entries[] = {
+    {0,  0, 0,   0.0},
+    {1,  2, 78,  0.1523},
+    {2,  2, 193, 0.3770},
+    {3,  2, 449, 0.8770},
+    {4,  4, 378, 1.4766},
+    {5,  4, 490, 1.9141},
+    {6,  4, 616, 2.4063},
+    {7,  6, 466, 2.7305},
+    {8,  6, 567, 3.3223},
+    {9,  6, 666, 3.9023},
+    {10, 6, 772, 4.5234},
+    {11, 6, 873, 5.1152},
+    {12, 8, 711, 5.5547},
+    {13, 8, 797, 6.2266},
+    {14, 8, 885, 6.9141},
+    {15, 8, 948, 7.4063}
+};
+
+constexpr CQIEntry cqiTable3Entries[] = {
+    {0,  0, 0,   0.0},
+    {1,  2, 30,  0.0586},
+    {2,  2, 50,  0.0977},
+    {3,  2, 78,  0.1523},
+    {4,  2, 120, 0.2344},
+    {5,  2, 193, 0.3770},
+    {6,  2, 308, 0.6016},
+    {7,  2, 449, 0.8770},
+    {8,  2, 602, 1.1758},
+    {9,  4, 378, 1.4766},
+    {10, 4, 490, 1.9141},
+    {11, 4, 616, 2.4063},
+    {12, 6, 466, 2.7305},
+    {13, 6, 567, 3.3223},
+    {14, 6, 666, 3.9023},
+    {15, 6, 772, 4.5234}
+};
+
+constexpr ConstexprTable<CQIEntry> cqiTable1 = {cqiTable1Entries, sizeof(cqiTable1Entries) / sizeof(CQIEntry)};
+constexpr ConstexprTable<CQIEntry> cqiTable2 = {cqiTable2Entries, sizeof(cqiTable2Entries) / sizeof(CQIEntry)};
+constexpr ConstexprTable<CQIEntry> cqiTable3 = {cqiTable3Entries, sizeof(cqiTable3Entries) / sizeof(CQIEntry)};
+
+// CQI table used when no table is selected explicitly
+constexpr ConstexprTable<CQIEntry> cqiTable = cqiTable2;
+
+/**
+ * @brief Select a CQI table.
+ *
+ * @param id CQI table identifier.
+ * @return View of the selected table.
+ */
+constexpr ConstexprTable<CQIEntry> getCQITable(CQITableId id) {
+    return id == CQITableId::Table1 ? cqiTable1 : (id == CQITableId::Table3 ? cqiTable3 : cqiTable2);
+}
+
 /**
  * @brief Structure to hold MCS table entries.
  */
 struct MCSEntry {
     int index;
     int modulationOrder; // Qm
-    const char* modulationScheme;
     double mcsCodeRate; // R
     double maxSpectralEfficiency; // Maximum spectral efficiency supported
 };
 
-// MCS table
-const std::vector<MCSEntry> mcsTable = {
-    {0,  2, "Modulation_QPSK",    120,   0.2344},
-    {1,  2, "Modulation_QPSK",    193,   0.3770},
-    {2,  2, "Modulation_QPSK",    308,   0.6016},
-    {3,  2, "Modulation_QPSK",    449,   0.8770},
-    {4,  2, "Modulation_QPSK",    602,   1.1758},
-    {5,  4, "Modulation_16_QAM",  378,   1.4766},
-    {6,  4, "Modulation_16_QAM",  434,   1.6953},
-    {7,  4, "Modulation_16_QAM",  490,   1.9141},
-    {8,  4, "Modulation_16_QAM",  553,   2.1602},
-    {9,  4, "Modulation_16_QAM",  616,   2.4063},
-    {10, 4, "Modulation_16_QAM",  658,   2.5703},
-    {11, 6, "Modulation_64_QAM",  466,   2.7305},
-    {12, 6, "Modulation_64_QAM",  517,   3.0293},
-    {13, 6, "Modulation_64_QAM",  567,   3.3223},
-    {14, 6, "Modulation_64_QAM",  616,   3.6094},
-    {15, 6, "Modulation_64_QAM",  666,   3.9023},
-    {16, 6, "Modulation_64_QAM",  719,   4.2129},
-    {17, 6, "Modulation_64_QAM",  772,   4.5234},
-    {18, 6, "Modulation_64_QAM",  822,   4.8164},
-    {19, 6, "Modulation_64_QAM",  873,   5.1152},
-    {20, 8, "Modulation_256_QAM", 682.5, 5.3320},
-    {21, 8, "Modulation_256_QAM", 711,   5.5547},
-    {22, 8, "Modulation_256_QAM", 754,   5.8906},
-    {23, 8, "Modulation_256_QAM", 797,   6.2266},
-    {24, 8, "Modulation_256_QAM", 841,   6.5703},
-    {25, 8, "Modulation_256_QAM", 885,   6.9141},
-    {26, 8, "Modulation_256_QAM", 916.5, 7.1602},
-    {27, 8, "Modulation_256_QAM", 948,   7.4063}
+constexpr MCSEntry mcsTable1Entries[] = {
+    {0,  2, 120, 0.2344},
+    {1,  2, 157, 0.3066},
+    {2,  2, 193, 0.3770},
+    {3,  2, 251, 0.4902},
+    {4,  2, 308, 0.6016},
+    {5,  2, 379, 0.7402},
+    {6,  2, 449, 0.8770},
+    {7,  2, 526, 1.0273},
+    {8,  2, 602, 1.1758},
+    {9,  2, 679, 1.3262},
+    {10, 4, 340, 1.3281},
+    {11, 4, 378, 1.4766},
+    {12, 4, 434, 1.6953},
+    {13, 4, 490, 1.9141},
+    {14, 4, 553, 2.1602},
+    {15, 4, 616, 2.4063},
+    {16, 4, 658, 2.5703},
+    {17, 6, 438, 2.5664},
+    {18, 6, 466, 2.7305},
+    {19, 6, 517, 3.0293},
+    {20, 6, 567, 3.3223},
+    {21, 6, 616, 3.6094},
+    {22, 6, 666, 3.9023},
+    {23, 6, 719, 4.2129},
+    {24, 6, 772, 4.5234},
+    {25, 6, 822, 4.8164},
+    {26, 6, 873, 5.1152},
+    {27, 6, 910, 5.3320},
+    {28, 6, 948, 5.5547}
+};
+
+constexpr MCSEntry mcsTable2Entries[] = {
+    {0,  2, 120,   0.2344},
+    {1,  2, 193,   0.3770},
+    {2,  2, 308,   0.6016},
+    {3,  2, 449,   0.8770},
+    {4,  2, 602,   1.1758},
+    {5,  4, 378,   1.4766},
+    {6,  4, 434,   1.6953},
+    {7,  4, 490,   1.9141},
+    {8,  4, 553,   2.1602},
+    {9,  4, 616,   2.4063},
+    {10, 4, 658,   2.5703},
+    {11, 6, 466,   2.7305},
+    {12, 6, 517,   3.0293},
+    {13, 6, 567,   3.3223},
+    {14, 6, 616,   3.6094},
+    {15, 6, 666,   3.9023},
+    {16, 6, 719,   4.2129},
+    {17, 6, 772,   4.5234},
+    {18, 6, 822,   4.8164},
+    {19, 6, 873,   5.1152},
+    {20, 8, 682.5, 5.3320},
+    {21, 8, 711,   5.5547},
+    {22, 8, 754,   5.8906},
+    {23, 8, 797,   6.2266},
+    {24, 8, 841,   6.5703},
+    {25, 8, 885,   6.9141},
+    {26, 8, 916.5, 7.1602},
+    {27, 8, 948,   7.4063}
+};
+
+constexpr MCSEntry mcsTable3Entries[] = {
+    {0,  2, 30,  0.0586},
+    {1,  2, 40,  0.0781},
+    {2,  2, 50,  0.0977},
+    {3,  2, 64,  0.1250},
+    {4,  2, 78,  0.1523},
+    {5,  2, 99,  0.1934},
+    {6,  2, 120, 0.2344},
+    {7,  2, 157, 0.3066},
+    {8,  2, 193, 0.3770},
+    {9,  2, 251, 0.4902},
+    {10, 2, 308, 0.6016},
+    {11, 2, 379, 0.7402},
+    {12, 2, 449, 0.8770},
+    {13, 2, 526, 1.0273},
+    {14, 2, 602, 1.1758},
+    {15, 4, 340, 1.3281},
+    {16, 4, 378, 1.4766},
+    {17, 4, 434, 1.6953},
+    {18, 4, 490, 1.9141},
+    {19, 4, 553, 2.1602},
+    {20, 4, 616, 2.4063},
+    {21, 6, 438, 2.5664},
+    {22, 6, 466, 2.7305},
+    {23, 6, 517, 3.0293},
+    {24, 6, 567, 3.3223},
+    {25, 6, 616, 3.6094},
+    {26, 6, 666, 3.9023},
+    {27, 6, 719, 4.2129},
+    {28, 6, 772, 4.5234}
 };
 
+constexpr ConstexprTable<MCSEntry> mcsTable1 = {mcsTable1Entries, sizeof(mcsTable1Entries) / sizeof(MCSEntry)};
+constexpr ConstexprTable<MCSEntry> mcsTable2 = {mcsTable2Entries, sizeof(mcsTable2Entries) / sizeof(MCSEntry)};
+constexpr ConstexprTable<MCSEntry> mcsTable3 = {mcsTable3Entries, sizeof(mcsTable3Entries) / sizeof(MCSEntry)};
+
+// MCS table used when no table is selected explicitly
+constexpr ConstexprTable<MCSEntry> mcsTable = mcsTable2;
+
+/**
+ * @brief Select an MCS table.
+ *
+ * @param id MCS table identifier.
+ * @return View of the selected table.
+ */
+constexpr ConstexprTable<MCSEntry> getMCSTable(MCSTableId id) {
+    return id == MCSTableId::Table1 ? mcsTable1 : (id == MCSTableId::Table3 ? mcsTable3 : mcsTable2);
+}
+
 // 3GPP TS 38.214 TBS table
-const std::vector<int> tbsTable = {
+constexpr int tbsTableEntries[] = {
     24,32,40,48,56,64,72,80,88,96,104,112,120,128,136,144,152,160,168,176,184,192,208,224,240,256,
     272,288,304,320,336,352,368,384,408,432,456,480,504,528,552,576,608,640,672,704,736,768,808,848,
     888,928,984,1032,1064,1128,1160,1192,1224,1256,1288,1320,1352,1416,1480,1544,1608,1672,1736,1800,
@@ -92,4 +284,12 @@ const std::vector<int> tbsTable = {
     3496,3624,3752,3824
 };
 
-#endif
\ No newline at end of file
+constexpr ConstexprTable<int> tbsTable = {tbsTableEntries, sizeof(tbsTableEntries) / sizeof(int)};
+
+static_assert(cqiTable1.size() == 16 && cqiTable2.size() == 16 && cqiTable3.size() == 16,
+              "CQI tables have 16 entries");
+static_assert(mcsTable1.size() == 29 && mcsTable2.size() == 28 && mcsTable3.size() == 29,
+              "MCS tables have 29, 28 and 29 entries");
+static_assert(tbsTable.back() == 3824, "TBS table ends at 3824 bits");
+
+#endif
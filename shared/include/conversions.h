@@ -0,0 +1,100 @@
+#ifndef CONVERSIONS_H
+#define CONVERSIONS_H
+
+/**
+ * @file conversions.h
+ * @brief Array variants of the dB / linear conversions of utilities.h.
+ *
+ * dBmToWatts(), wattsToDbm(), calculateSNRLinear() and calculateSpectralEfficiencyPerLayer()
+ * cost one std::pow, log10 or log2 call per value. The batch functions below evaluate them
+ * over whole arrays with the exp2 / log polynomial kernels of simd.h, on the SIMD level
+ * selected by activeSimdLevel(). Each function documents the largest deviation from its
+ * scalar counterpart; ConversionAccuracy::Strict trades the speed for libm results.
+ */
+
+#include <cstddef>
+#include "utilities.h"
+
+/**
+ * @brief Accuracy requested from a batch conversion.
+ */
+enum class ConversionAccuracy {
+    Fast = 0,  // SIMD polynomial kernels, within the documented bound of the scalar function
+    Strict = 1 // libm, bit-identical to the scalar function
+};
+
+/**
+ * @brief Convert an array of powers from dBm to Watts.
+ *
+ * In fast mode the result is within 4 ulp of dBmToWatts(). Inputs below -3000 dBm or
+ * above 3000 dBm, and NaNs, are converted with libm.
+ *
+ * @param dBm Powers in dBm.
+ * @param watts Output array receiving the powers in Watts.
+ * @param count Number of values.
+ * @param accuracy Requested accuracy.
+ */
+void dBmToWattsBatch(const double* dBm, double* watts, std::size_t count,
+                     ConversionAccuracy accuracy = ConversionAccuracy::Fast);
+
+/**
+ * @brief Convert an array of powers from Watts to dBm.
+ *
+ * In fast mode the result is within 2e-12 dB of wattsToDbm(). Inputs that are not
+ * positive, finite and normal are converted with libm.
+ *
+ * @param watts Powers in Watts.
+ * @param dBm Output array receiving the powers in dBm.
+ * @param count Number of values.
+ * @param accuracy Requested accuracy.
+ */
+void wattsToDbmBatch(const double* watts, double* dBm, std::size_t count,
+                     ConversionAccuracy accuracy = ConversionAccuracy::Fast);
+
+/**
+ * @brief Calculate the linear SNR for arrays of received and thermal noise powers.
+ *
+ * In fast mode the result is within 4 ulp of calculateSNRLinear(), under the same input
+ * range as dBmToWattsBatch().
+ *
+ * @param rxPower_dBm Received powers in dBm.
+ * @param thermalNoisePower_Watts Thermal noise powers in Watts.
+ * @param snrLinear Output array receiving the SNR in linear scale.
+ * @param count Number of values.
+ * @param accuracy Requested accuracy.
+ */
+void calculateSNRLinearBatch(const double* rxPower_dBm, const double* thermalNoisePower_Watts, double* snrLinear,
+                             std::size_t count, ConversionAccuracy accuracy = ConversionAccuracy::Fast);
+
+/**
+ * @brief Calculate the spectral efficiency per layer for an array of linear SNRs.
+ *
+ * Negative SNRs give 0, as in calculateSpectralEfficiencyPerLayer(). In fast mode the
+ * result is within 4 ulp of the scalar function; infinite and NaN SNRs are handled by libm.
+ *
+ * @param snrLinear SNRs in linear scale.
+ * @param spectralEfficiency Output array receiving the spectral efficiency in bits/second/Hz.
+ * @param count Number of values.
+ * @param accuracy Requested accuracy.
+ */
+void calculateSpectralEfficiencyPerLayerBatch(const double* snrLinear, double* spectralEfficiency, std::size_t count,
+                                              ConversionAccuracy accuracy = ConversionAccuracy::Fast);
+
+/**
+ * @brief Calculate Shannon's capacity for arrays of bandwidths and linear SNRs.
+ *
+ * Bandwidths that are not positive and negative SNRs give 0, as in calculateShannonsCapacity().
+ * The log2(1 + SNR) term has the accuracy of calculateSpectralEfficiencyPerLayerBatch(); in strict
+ * mode the result is bit-identical to the scalar function. Large arrays are spread over
+ * parallelThreadCount() threads, with the same results.
+ *
+ * @param bandwidth Bandwidths in Hz.
+ * @param snrLinear SNRs in linear scale.
+ * @param capacity Output array receiving the capacities in bits per second.
+ * @param count Number of values.
+ * @param accuracy Requested accuracy.
+ */
+void calculateShannonsCapacityBatch(const double* bandwidth, const double* snrLinear, double* capacity,
+                                    std::size_t count, ConversionAccuracy accuracy = ConversionAccuracy::Fast);
+
+#endif // CONVERSIONS_H
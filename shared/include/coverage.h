@@ -0,0 +1,96 @@
+#ifndef COVERAGE_H
+#define COVERAGE_H
+
+/**
+ * @file coverage.h
+ * @brief Raster coverage maps (path loss, RSRP, SNR and best server) over a set of gNBs
+ * using the rural path loss model.
+ */
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pathloss.h"
+
+/**
+ * @brief A gNB placed on the coverage map.
+ */
+struct CoverageSite {
+    double x;                // easting in meters
+    double y;                // northing in meters
+    double gNBAntennaHeight; // in meters
+    double txPower;          // total transmit power in dBm
+};
+
+/**
+ * @brief Geometry of the raster. Pixel (col, row) covers the square whose lower left
+ * corner is (originX + col * resolution, originY + row * resolution).
+ */
+struct CoverageGrid {
+    double originX = 0.0;     // in meters
+    double originY = 0.0;     // in meters
+    double resolution = 10.0; // pixel size in meters
+    int width = 0;            // number of columns
+    int height = 0;           // number of rows
+};
+
+/**
+ * @brief Radio and execution parameters shared by all sites of a coverage map.
+ */
+struct CoverageConfig {
+    double fLow = 3300.0;          // in MHz
+    double fHigh = 3400.0;         // in MHz
+    double buildingHeight = 5.0;   // in meters
+    double streetWidth = 20.0;     // in meters
+    double ueHeight = 1.5;         // in meters
+    bool isLOS = false;
+    int prbCount = 273;            // PRBs over which the tx power is spread (RSRP per RE)
+    double bandwidth = 100e6;      // in Hz, noise bandwidth of the SNR
+    double temperature = 300.0;    // in Kelvin
+    double maxDistance = 10000.0;  // sites farther than this (the model limit) do not serve a pixel
+    int tileSize = 64;             // tile edge in pixels
+    unsigned int numThreads = 0;   // 0 uses every hardware thread
+};
+
+/**
+ * @brief Coverage rasters, stored row by row (index = row * width + col).
+ *
+ * Pixels not served by any site hold NaN and a best server of -1.
+ */
+struct CoverageMap {
+    CoverageGrid grid;
+    std::vector<float> pathLoss;        // path loss to the best server in dB
+    std::vector<float> rsrp;            // RSRP of the best server in dBm
+    std::vector<float> snr;             // wideband SNR of the best server in dB
+    std::vector<std::int32_t> bestServer; // index of the best server in the site list
+};
+
+/**
+ * @brief Generate the coverage map of a set of gNBs.
+ *
+ * The raster is cut into square tiles which are distributed over a thread pool. Each
+ * tile only evaluates the sites within maxDistance of it, one site at a time over all
+ * pixels of the tile, so that the site model stays in registers while the tile
+ * buffers stay in cache.
+ *
+ * @param sites gNBs to evaluate.
+ * @param grid Raster geometry.
+ * @param config Radio and execution parameters.
+ * @return The coverage map.
+ */
+CoverageMap generateCoverageMap(const std::vector<CoverageSite>& sites, const CoverageGrid& grid,
+                                const CoverageConfig& config = CoverageConfig());
+
+/**
+ * @brief Write the rasters of a coverage map as raw little-endian files.
+ *
+ * Writes <prefix>_pathloss.f32, <prefix>_rsrp.f32, <prefix>_snr.f32 (32-bit floats),
+ * <prefix>_server.i32 (32-bit integers) and a <prefix>.hdr text header describing the grid.
+ *
+ * @param map Coverage map to write.
+ * @param prefix Path prefix of the output files.
+ * @return True if every file was written successfully.
+ */
+bool writeCoverageMap(const CoverageMap& map, const std::string& prefix);
+
+#endif // COVERAGE_H
@@ -0,0 +1,126 @@
+#ifndef EFFECTIVESINR_H
+#define EFFECTIVESINR_H
+
+/**
+ * @file effectivesinr.h
+ * @brief Compression of per-PRB SINRs into one effective SINR for link adaptation.
+ *
+ * On a frequency selective channel each PRB of an allocation sees its own SINR, while the
+ * CQI/MCS chain of linkadaptation.h takes a single SNR. The effective SINR is the SINR of
+ * a flat channel on which the codeword would perform the same:
+ *
+ *  - EESM (exponential effective SINR mapping): gamma_eff = -beta ln(mean(exp(-gamma_i / beta))),
+ *    beta being calibrated per MCS.
+ *  - MIESM (mutual information effective SINR mapping): the mean of the mutual information
+ *    per PRB mapped back to an SINR, with min(Qm, log2(1 + gamma)) as the mutual information
+ *    of a Qm bit symbol.
+ *
+ * The kernels are vectorized with the exp2 / log2 primitives of simd.h on the level selected
+ * by activeSimdLevel() and do not allocate, so that they can run per UE and TTI over up to
+ * 273 PRBs.
+ */
+
+#include <cstddef>
+#include "linkadaptation.h"
+
+/**
+ * @brief Effective SINR mapping.
+ */
+enum class EffectiveSinrModel {
+    EESM,
+    MIESM
+};
+
+/**
+ * @brief Parameters of the effective SINR link adaptation.
+ */
+struct EffectiveSinrConfig {
+    EffectiveSinrModel model = EffectiveSinrModel::EESM;
+    CQITableId cqiTable = CQITableId::Table2;
+    MCSTableId mcsTable = MCSTableId::Table2;
+    const double* beta = nullptr; // EESM beta per MCS index of mcsTable, null for eesmBeta()
+};
+
+/**
+ * @brief Link adaptation decision taken on an effective SINR.
+ */
+struct EffectiveLinkAdaptation {
+    double effectiveSinr; // linear scale
+    LinkAdaptationEntry entry;
+};
+
+/**
+ * @brief EESM effective SINR of a set of PRBs.
+ *
+ * Evaluated relative to the smallest SINR so that no term underflows. Within 1e-12 relative
+ * of the libm result on every SIMD level.
+ *
+ * @param sinrLinear SINR of each PRB in linear scale, finite and non-negative.
+ * @param count Number of PRBs.
+ * @param beta EESM calibration factor, positive.
+ * @return The effective SINR in linear scale, 0 if count is 0.
+ */
+double calculateEesmEffectiveSinr(const double* sinrLinear, std::size_t count, double beta);
+
+/**
+ * @brief MIESM effective SINR of a set of PRBs for one modulation order.
+ *
+ * Within 1e-12 relative of the libm result on every SIMD level.
+ *
+ * @param sinrLinear SINR of each PRB in linear scale, finite and non-negative.
+ * @param count Number of PRBs.
+ * @param modulationOrder Qm, the mutual information bound in bits per symbol.
+ * @return The effective SINR in linear scale, 0 if count is 0.
+ */
+double calculateMiesmEffectiveSinr(const double* sinrLinear, std::size_t count, int modulationOrder);
+
+/**
+ * @brief Calibrated EESM beta of an MCS.
+ *
+ * Beta is fitted so that EESM agrees with MIESM at the modulation order of the MCS on a
+ * reference channel of two equally likely SINRs, 6 dB above and below the SINR at which
+ * the MCS reaches its maximum spectral efficiency. It therefore grows with the modulation
+ * order, from about 1.3 for QPSK to about 90 for 256QAM (down to about 1.1 for the lowest
+ * code rates of MCS table 3). The values are computed once, on first use.
+ *
+ * @param mcsIndex Index into the MCS table.
+ * @param table MCS table to use.
+ * @return The calibrated beta.
+ * @throws std::runtime_error if mcsIndex is not in the table.
+ */
+double eesmBeta(int mcsIndex, MCSTableId table = MCSTableId::Table2);
+
+/**
+ * @brief Link adaptation of one UE from its per-PRB SINRs.
+ *
+ * The parameter of the mapping (beta or Qm) depends on the MCS the effective SINR selects.
+ * The search starts from the MCS with the largest parameter, which gives the largest
+ * effective SINR, and steps down to the MCS selected by determineLinkAdaptationLinear()
+ * until the effective SINR computed for an MCS selects that MCS or a higher one. On a flat
+ * channel it takes the same decision as determineLinkAdaptationLinear().
+ *
+ * @param sinrLinear SINR of each PRB in linear scale, finite and non-negative.
+ * @param numPrbs Number of PRBs, at least 1.
+ * @param config Mapping and tables to use.
+ * @return The effective SINR and the decision taken on it.
+ */
+EffectiveLinkAdaptation determineEffectiveLinkAdaptation(const double* sinrLinear, std::size_t numPrbs,
+                                                         const EffectiveSinrConfig& config = EffectiveSinrConfig());
+
+/**
+ * @brief Link adaptation of a set of UEs from their per-PRB SINRs.
+ *
+ * Calls determineEffectiveLinkAdaptation() for each UE. Large batches are spread over
+ * parallelThreadCount() threads, with the same results.
+ *
+ * @param sinrLinear numUes rows of numPrbs SINRs in linear scale, UE after UE.
+ * @param numPrbs Number of PRBs of each UE, at least 1.
+ * @param numUes Number of UEs.
+ * @param results Output array receiving one decision per UE.
+ * @param config Mapping and tables to use.
+ */
+void determineEffectiveLinkAdaptationBatch(const double* sinrLinear, std::size_t numPrbs, std::size_t numUes,
+                                           EffectiveLinkAdaptation* results,
+                                           const EffectiveSinrConfig& config = EffectiveSinrConfig());
+
+#endif // EFFECTIVESINR_H
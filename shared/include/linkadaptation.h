@@ -0,0 +1,153 @@
+#ifndef LINKADAPTATION_H
+#define LINKADAPTATION_H
+
+/**
+ * @file linkadaptation.h
+ * @brief Direct SNR (dB) to CQI / MCS / Qm / R mapping through a quantized lookup table.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "utilities.h"
+
+/**
+ * @brief Link adaptation decision for one SNR.
+ */
+struct LinkAdaptationEntry {
+    std::uint8_t cqiIndex;
+    std::uint8_t mcsIndex;
+    std::uint8_t modulationOrder; // Qm
+    float codeRate;               // R in 1024 units
+};
+
+inline bool operator==(const LinkAdaptationEntry& a, const LinkAdaptationEntry& b) {
+    return a.cqiIndex == b.cqiIndex && a.mcsIndex == b.mcsIndex &&
+           a.modulationOrder == b.modulationOrder && a.codeRate == b.codeRate;
+}
+
+inline bool operator!=(const LinkAdaptationEntry& a, const LinkAdaptationEntry& b) {
+    return !(a == b);
+}
+
+/**
+ * @brief Exact link adaptation chain for one SNR.
+ *
+ * Converts the SNR to linear scale, then applies calculateSpectralEfficiencyPerLayer(),
+ * determineIntermediateSpectralEfficiency() and determineModulationAndCodeRate().
+ *
+ * @param snr_dB Signal-to-Noise Ratio in dB.
+ * @param cqiTable CQI table to use.
+ * @param mcsTable MCS table to use.
+ * @return CQI index, MCS index, Qm and R selected for the SNR.
+ */
+LinkAdaptationEntry determineLinkAdaptation(double snr_dB, CQITableId cqiTable = CQITableId::Table2,
+                                            MCSTableId mcsTable = MCSTableId::Table2);
+
+/**
+ * @brief Exact link adaptation chain for one SNR in linear scale.
+ *
+ * determineLinkAdaptation() without the conversion from dB, for SNRs that are computed in
+ * linear scale such as the effective SINRs of effectivesinr.h.
+ *
+ * @param snrLinear Signal-to-Noise Ratio in linear scale.
+ * @param cqiTable CQI table to use.
+ * @param mcsTable MCS table to use.
+ * @return CQI index, MCS index, Qm and R selected for the SNR.
+ */
+LinkAdaptationEntry determineLinkAdaptationLinear(double snrLinear, CQITableId cqiTable = CQITableId::Table2,
+                                                  MCSTableId mcsTable = MCSTableId::Table2);
+
+/**
+ * @brief SNR (dB) keyed lookup table replacing the link adaptation chain.
+ *
+ * The SNR range is cut into bins of a fixed width. Since the chain changes its decision
+ * at a handful of SNR thresholds only, each bin stores the decision below and above the
+ * (at most one) threshold it contains, with that threshold located to the last bit by
+ * bisection on the exact chain. A lookup is therefore exact for every SNR, and costs one
+ * multiply, one load and one compare. SNRs outside the range are clamped to the first or
+ * last bin, which is exact as long as the range spans every threshold (the default range
+ * does for all CQI/MCS tables).
+ */
+class LinkAdaptationTable {
+public:
+    /**
+     * @brief Build the table.
+     *
+     * @param minSnr_dB Lower end of the quantized range in dB.
+     * @param maxSnr_dB Upper end of the quantized range in dB.
+     * @param step_dB Bin width in dB.
+     * @param cqiTable CQI table to use.
+     * @param mcsTable MCS table to use.
+     */
+    explicit LinkAdaptationTable(double minSnr_dB = -10.0, double maxSnr_dB = 40.0, double step_dB = 0.01,
+                                 CQITableId cqiTable = CQITableId::Table2, MCSTableId mcsTable = MCSTableId::Table2);
+
+    /**
+     * @brief Look up the link adaptation decision for an SNR.
+     *
+     * @param snr_dB Signal-to-Noise Ratio in dB.
+     * @return The same decision as determineLinkAdaptation(), and the lowest decision
+     *         (CQI 0, out of range) for a NaN SNR.
+     */
+    LinkAdaptationEntry lookup(double snr_dB) const {
+        const Bin& bin = bins_[binIndex(snr_dB)];
+        // A NaN lands in bin 0 and fails the threshold comparison below
+        if (bin.multipleThresholds && snr_dB == snr_dB) {
+            return determineLinkAdaptation(snr_dB, cqiTable_, mcsTable_);
+        }
+        return snr_dB >= bin.threshold ? bin.above : bin.below;
+    }
+
+    /**
+     * @brief Look up the link adaptation decisions for an array of SNRs.
+     *
+     * @param snr_dB Signal-to-Noise Ratios in dB.
+     * @param entries Output array receiving the decisions.
+     * @param count Number of SNRs.
+     */
+    void lookup(const double* snr_dB, LinkAdaptationEntry* entries, std::size_t count) const;
+
+    /**
+     * @brief Validation mode: compare the table against the exact chain.
+     *
+     * Evaluates both on each side of every bin boundary and of every decision threshold,
+     * which are the only places where a quantized table can disagree with the chain.
+     *
+     * @return Number of disagreements, 0 for a correct table.
+     */
+    std::size_t validate() const;
+
+    std::size_t numBins() const { return bins_.size(); }
+
+    /**
+     * @brief SNRs in dB at which the decision changes: the smallest SNR of each decision.
+     */
+    const std::vector<double>& thresholds() const { return thresholds_; }
+
+private:
+    struct Bin {
+        double threshold;              // decision switches from below to above at this SNR, +inf if none
+        LinkAdaptationEntry below;
+        LinkAdaptationEntry above;
+        bool multipleThresholds;       // the bin is too wide; fall back to the exact chain
+    };
+
+    std::size_t binIndex(double snr_dB) const {
+        double position = (snr_dB - minSnr_dB_) * inverseStep_;
+        // Written so that a NaN SNR also maps to bin 0 instead of reaching the conversion
+        position = !(position >= 0.0) ? 0.0 : (position > lastBin_ ? lastBin_ : position);
+        return static_cast<std::size_t>(position);
+    }
+
+    double minSnr_dB_;
+    double step_dB_;
+    double inverseStep_;
+    double lastBin_;
+    CQITableId cqiTable_;
+    MCSTableId mcsTable_;
+    std::vector<double> thresholds_;
+    std::vector<Bin> bins_;
+};
+
+#endif // LINKADAPTATION_H
@@ -0,0 +1,119 @@
+#ifndef LINKBUDGET_H
+#define LINKBUDGET_H
+
+/**
+ * @file linkbudget.h
+ * @brief Batch (structure-of-arrays) evaluation of the DL throughput chain.
+ *
+ * The functions in utilities.h evaluate the link budget for a single UE. The batch
+ * API below takes one contiguous column per input field and runs every stage of the
+ * DLThroughputCalculator chain as a tight loop over a block of UEs, so that large
+ * planning runs are not dominated by per-call overhead.
+ */
+
+#include <cstddef>
+#include "conversions.h"
+#include "utilities.h"
+
+class TBSLookupTable;
+
+/**
+ * @brief Number of UEs processed per stage before moving on to the next stage.
+ *
+ * All intermediate columns of one block live on the stack and stay in L1/L2 cache.
+ */
+constexpr std::size_t dlThroughputBatchBlockSize = 256;
+
+/**
+ * @brief Parameters shared by every UE of a batch.
+ *
+ * The defaults are the values hard coded in the DLThroughputCalculator utility.
+ */
+struct DLThroughputConfig {
+    double dlFraction = 0.8;          // DL fraction, see calculateDLFraction() ("4:1" -> 0.8)
+    int applicationPacketSize = 1460; // in bytes
+    int macPacketSize = 1488;         // in bytes
+    int numerology = 3;
+    int prbPerUE = 1;                 // PRBs used to size the TBS of a UE
+    int numOfSymbolsPerSlot = 14;
+    int numOfREsForDMRS = 0;
+    int numOfOverheadREs = 0;
+    double temperature = 300.0;       // in Kelvin
+    double shadowingLoss = 0.0;       // in dB, used when no per-UE column is given
+    double o2iLoss = 0.0;             // in dB, used when no per-UE column is given
+    double beamFormingGain = 0.0;     // in dB per layer
+    double downlinkOverhead = 0.18;   // fraction of PRBs lost to DL overhead
+    CQITableId cqiTableId = CQITableId::Table2;
+    MCSTableId mcsTableId = MCSTableId::Table2;
+    const TBSLookupTable* tbsLookupTable = nullptr; // optional, replaces the TBS calculation by a table lookup
+    ConversionAccuracy conversionAccuracy = ConversionAccuracy::Strict; // SNR and spectral efficiency, see conversions.h
+};
+
+/**
+ * @brief Input columns of a DL throughput batch.
+ *
+ * Every non-null pointer must reference at least @c count elements.
+ * The shadowing and O2I columns are optional; when null, the values from
+ * DLThroughputConfig are used for every UE.
+ */
+struct DLThroughputBatchInput {
+    std::size_t count = 0;
+    const double* pathLoss = nullptr;      // in dB
+    const double* txPower = nullptr;       // total transmit power in dBm
+    const int* numOfLayers = nullptr;      // number of spatial layers
+    const int* prbCount = nullptr;         // PRBs configured in the gNB
+    const double* bandwidth = nullptr;     // in Hz
+    const double* shadowingLoss = nullptr; // optional, in dB
+    const double* o2iLoss = nullptr;       // optional, in dB
+};
+
+/**
+ * @brief Output columns of a DL throughput batch.
+ *
+ * Only @c throughput is mandatory. Intermediate results are written for every
+ * non-null column, each of which must hold at least @c count elements.
+ */
+struct DLThroughputBatchOutput {
+    double* throughput = nullptr;   // DL application throughput in kbps (bits per ms)
+    double* snrLinear = nullptr;    // optional, SNR per layer in linear scale
+    int* cqiIndex = nullptr;        // optional
+    int* mcsIndex = nullptr;        // optional
+    int* modulationOrder = nullptr; // optional, Qm
+    double* codeRate = nullptr;     // optional, R in 1024 units
+    int* tbsSize = nullptr;         // optional, TBS per layer in bits
+};
+
+/**
+ * @brief Run the DL throughput chain for a batch of UEs.
+ *
+ * Produces the same values as chaining calculateLargeScaleTotalLoss(), calculateSNRLinear(),
+ * determineIntermediateSpectralEfficiency(), determineModulationAndCodeRate(), the TBS
+ * determination and calculateDLApplicationThroughput() for each UE, but evaluates each
+ * stage over a whole block of UEs at a time. Large batches are spread over
+ * parallelThreadCount() threads; the results do not depend on the number of threads.
+ *
+ * @param input Input columns.
+ * @param output Output columns.
+ * @param config Parameters common to all UEs of the batch.
+ */
+void calculateDLThroughputBatch(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                                const DLThroughputConfig& config = DLThroughputConfig());
+
+/**
+ * @brief Run the DL throughput chain for a single UE.
+ *
+ * Scalar reference of calculateDLThroughputBatch() built directly on the functions
+ * of utilities.h.
+ *
+ * @param pathLoss Path loss in dB.
+ * @param txPower Total transmit power in dBm.
+ * @param numOfLayers Number of spatial layers.
+ * @param prbCount PRBs configured in the gNB.
+ * @param bandwidth Bandwidth in Hz.
+ * @param config Parameters of the calculation.
+ * @return DL application throughput in kbps.
+ */
+double calculateDLThroughput(double pathLoss, double txPower, int numOfLayers, int prbCount, double bandwidth,
+                             const DLThroughputConfig& config = DLThroughputConfig());
+
+#endif // LINKBUDGET_H
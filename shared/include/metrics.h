@@ -0,0 +1,248 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+/**
+ * @file metrics.h
+ * @brief Per-stage timers and counters of the hot paths, exported as JSON or Prometheus text.
+ *
+ * Each instrumented stage counts its calls, the elements it processed and the time it
+ * took, read from the time stamp counter on x86 and from steady_clock elsewhere. Stages
+ * time whole blocks or chunks of a batch, never single elements, so a measurement costs
+ * two counter reads and a few stores per block: well under 1% of the work it measures.
+ * The invalid input counters count the sentinel returns of the scalar functions, such as
+ * the 0 returned by calculateWavelength() for a frequency that is not positive.
+ *
+ * Every thread updates counters of its own, which readMetrics() sums on demand; the
+ * counters of finished threads are kept. The instrumentation is compiled in when
+ * FIVEG_METRICS is 1 (the CMake option of the same name). Otherwise the macros below
+ * expand to nothing, the hot paths carry no code and readMetrics() reports zeros.
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#ifndef FIVEG_METRICS
+#define FIVEG_METRICS 0
+#endif
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define FIVEG_HAVE_RDTSC 1
+#include <x86intrin.h>
+#else
+#define FIVEG_HAVE_RDTSC 0
+#endif
+
+constexpr bool metricsCompiledIn = FIVEG_METRICS != 0;
+
+/**
+ * @brief Instrumented stages.
+ */
+enum class MetricStage {
+    DLThroughputBatch = 0, // calculateDLThroughputBatch(), per chunk
+    DLSnr,                 // steps 1-4: large-scale loss, Rx power, thermal noise and SNR
+    DLMcs,                 // steps 5-7: spectral efficiency, CQI and MCS
+    DLTbs,                 // steps 8-11: available REs, Ninfo and TBS
+    DLThroughput,          // steps 12-15: bits per slot and throughput
+    DLOutputColumns,       // optional intermediate columns
+    PathLossRuralBatch,    // calculate5GPathLossRuralBatch(), per chunk
+    TBSBatch,              // determineTBSBatch(), per chunk
+    Count
+};
+
+constexpr std::size_t numMetricStages = static_cast<std::size_t>(MetricStage::Count);
+
+/**
+ * @brief Functions counting the calls rejected with a sentinel return.
+ */
+enum class InvalidInput {
+    Wavelength = 0,          // calculateWavelength()
+    FrequencyFromWavelength, // calculateFrequencyFromWavelength()
+    ShannonsCapacity,        // calculateShannonsCapacity()
+    OFDMSymbolDuration,      // calculateOFDMSymbolDuration()
+    NumberOfSubcarriers,     // calculateNumberOfSubcarriers()
+    FFTSize,                 // calculateFFTSize()
+    CoherenceTime,           // calculateCoherenceTime()
+    CoherenceBandwidth,      // calculateCoherenceBandwidth()
+    NumberOfSlots,           // calculateNumberOfSlots()
+    QamModulationScheme,     // QamModulationSchemeDescriptor()
+    SpectralEfficiency,      // calculateSpectralEfficiencyPerLayer()
+    Count
+};
+
+constexpr std::size_t numInvalidInputs = static_cast<std::size_t>(InvalidInput::Count);
+
+/**
+ * @brief Totals of one stage.
+ */
+struct StageMetrics {
+    std::uint64_t calls = 0;
+    std::uint64_t elements = 0;
+    std::uint64_t ticks = 0; // time stamp counter cycles, or nanoseconds without one
+    double seconds = 0.0;
+};
+
+/**
+ * @brief Totals of every thread since the start of the process or the last resetMetrics().
+ */
+struct MetricsSnapshot {
+    StageMetrics stages[numMetricStages];
+    std::uint64_t invalidInputs[numInvalidInputs] = {};
+
+    const StageMetrics& stage(MetricStage s) const { return stages[static_cast<std::size_t>(s)]; }
+    std::uint64_t invalidInput(InvalidInput f) const { return invalidInputs[static_cast<std::size_t>(f)]; }
+};
+
+/**
+ * @brief Formats of writeMetrics().
+ */
+enum class MetricsFormat {
+    Json = 0,
+    Prometheus = 1 // text exposition format, version 0.0.4
+};
+
+/**
+ * @brief Read the tick counter used by the stage timers.
+ */
+inline std::uint64_t readMetricTicks() {
+#if FIVEG_HAVE_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief Add a measurement to the counters of the calling thread.
+ *
+ * @param stage Stage measured.
+ * @param elements Elements processed.
+ * @param ticks Ticks taken, see readMetricTicks().
+ */
+void recordStage(MetricStage stage, std::size_t elements, std::uint64_t ticks);
+
+/**
+ * @brief Count a call rejected with a sentinel return on the calling thread.
+ *
+ * @param function Function rejecting its input.
+ */
+void countInvalidInput(InvalidInput function);
+
+/**
+ * @brief Sum the counters of every thread.
+ *
+ * Ticks are converted to seconds with the tick rate measured against steady_clock since
+ * the first measurement, which takes at least 10 ms.
+ *
+ * @return Totals since the start of the process or the last resetMetrics().
+ */
+MetricsSnapshot readMetrics();
+
+/**
+ * @brief Restart the totals reported by readMetrics() from zero.
+ */
+void resetMetrics();
+
+/**
+ * @brief Get the name of a stage in the exported metrics, e.g. "dl_snr".
+ */
+const char* metricStageName(MetricStage stage);
+
+/**
+ * @brief Get the name of the function of an invalid input counter, e.g. "calculateWavelength".
+ */
+const char* invalidInputName(InvalidInput function);
+
+/**
+ * @brief Write a snapshot as a JSON object.
+ *
+ * {"stages": {"<stage>": {"calls": n, "elements": n, "ticks": n, "seconds": x}, ...},
+ *  "invalid_inputs": {"<function>": n, ...}}
+ */
+void writeMetricsJson(std::ostream& out, const MetricsSnapshot& metrics);
+
+/**
+ * @brief Write a snapshot in the Prometheus text exposition format.
+ *
+ * Counters fiveg_stage_calls_total, fiveg_stage_elements_total and
+ * fiveg_stage_seconds_total labelled by stage, and fiveg_invalid_inputs_total labelled
+ * by function.
+ */
+void writeMetricsPrometheus(std::ostream& out, const MetricsSnapshot& metrics);
+
+/**
+ * @brief Write the current totals, see readMetrics().
+ */
+void writeMetrics(std::ostream& out, MetricsFormat format);
+
+/**
+ * @brief Write the totals to a file when the process exits.
+ *
+ * The file is written by an atexit() handler, so it is not written if the process is
+ * killed or ends with _exit(). Later calls replace the file and the format.
+ *
+ * @param path File to write.
+ * @param format Format of the file.
+ */
+void writeMetricsAtExit(const std::string& path, MetricsFormat format);
+
+/**
+ * @brief Times the enclosing scope as one call of a stage, see FIVEG_METRICS_SCOPE.
+ */
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(MetricStage stage, std::size_t elements)
+        : stage_(stage), elements_(elements), start_(readMetricTicks()) {}
+    ~ScopedStageTimer() { recordStage(stage_, elements_, readMetricTicks() - start_); }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    MetricStage stage_;
+    std::size_t elements_;
+    std::uint64_t start_;
+};
+
+/**
+ * @brief Times consecutive stages of a function with one counter read per stage, see
+ * FIVEG_METRICS_LAP.
+ */
+class StageTimeline {
+public:
+    StageTimeline() : last_(readMetricTicks()) {}
+
+    // Record the time since the previous lap, or since construction, as one call of a stage
+    void lap(MetricStage stage, std::size_t elements) {
+        const std::uint64_t now = readMetricTicks();
+        recordStage(stage, elements, now - last_);
+        last_ = now;
+    }
+
+private:
+    std::uint64_t last_;
+};
+
+#define FIVEG_METRICS_CONCAT_(a, b) a##b
+#define FIVEG_METRICS_CONCAT(a, b) FIVEG_METRICS_CONCAT_(a, b)
+
+#if FIVEG_METRICS
+// Time the rest of the enclosing scope as one call of a stage processing some elements
+#define FIVEG_METRICS_SCOPE(stage, elements) \
+    ScopedStageTimer FIVEG_METRICS_CONCAT(fivegStageTimer, __LINE__)((stage), (elements))
+// Start a timeline of consecutive stages, then close each stage with FIVEG_METRICS_LAP
+#define FIVEG_METRICS_TIMELINE(timeline) StageTimeline timeline
+#define FIVEG_METRICS_LAP(timeline, stage, elements) timeline.lap((stage), (elements))
+// Count a sentinel return of a function
+#define FIVEG_METRICS_INVALID_INPUT(function) countInvalidInput(function)
+#else
+#define FIVEG_METRICS_SCOPE(stage, elements) ((void)0)
+#define FIVEG_METRICS_TIMELINE(timeline) ((void)0)
+#define FIVEG_METRICS_LAP(timeline, stage, elements) ((void)0)
+#define FIVEG_METRICS_INVALID_INPUT(function) ((void)0)
+#endif
+
+#endif // METRICS_H
@@ -0,0 +1,115 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+/**
+ * @file montecarlo.h
+ * @brief Monte Carlo evaluation of the DL throughput chain under shadow fading and O2I loss.
+ *
+ * Each trial draws a log-normal shadowing loss and, for indoor UEs, an O2I penetration loss
+ * for every UE of a scenario, then runs the DL throughput chain of calculateDLThroughputBatch().
+ * The throughputs are reduced into a fixed-bin histogram, from which the CDF, quantiles and
+ * outage probabilities are read, and into a QuantileSketch whose quantiles keep a bounded
+ * relative error down to the cell edge.
+ *
+ * Random numbers come from a counter-based generator (Philox4x32-10) keyed by the seed and
+ * indexed by the sample number, so every sample is a pure function of (seed, trial, UE). The
+ * samples are processed in fixed chunks and all reductions are exact integer counts or are
+ * summed in chunk order, which makes the results identical for any number of threads.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "linkbudget.h"
+#include "quantilesketch.h"
+
+/**
+ * @brief Output block of the Philox4x32-10 counter-based random number generator.
+ */
+struct PhiloxBlock {
+    std::uint32_t v[4];
+};
+
+/**
+ * @brief Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC11).
+ *
+ * @param counter 128-bit counter, word 0 being the least significant.
+ * @param key 64-bit key, word 0 being the least significant.
+ * @return Four independent uniformly distributed 32-bit words.
+ */
+PhiloxBlock philox4x32(const std::uint32_t counter[4], const std::uint32_t key[2]);
+
+/**
+ * @brief Random loss model and execution parameters of a Monte Carlo run.
+ *
+ * The O2I loss follows the structure of 3GPP TR 38.901 Section 7.4.3: a building penetration
+ * loss, an indoor loss of 0.5 dB/m over a distance drawn as the minimum of two uniform draws
+ * in [0, maxIndoorDistance], and a normally distributed (in dB) random part.
+ */
+struct MonteCarloConfig {
+    std::uint64_t numTrials = 1000;     // trials, each drawing every UE of the scenario once
+    std::uint64_t seed = 1;
+    double shadowingStdDev = 8.0;       // in dB, log-normal shadow fading (TR 38.901 RMa NLOS)
+    double indoorProbability = 0.0;     // probability that a UE is indoor in a trial
+    double penetrationLoss = 5.0;       // in dB, mean building penetration loss (low-loss model at low frequencies)
+    double o2iStdDev = 4.4;             // in dB, standard deviation of the O2I loss
+    double maxIndoorDistance = 25.0;    // in meters
+    double outageThroughput = 0.0;      // in kbps, samples at or below this throughput are in outage
+    int numBins = 1000;                 // histogram bins
+    double maxThroughput = 0.0;         // in kbps, upper edge of the histogram, 0 for the peak throughput of the scenario
+    unsigned int numThreads = 0;        // 0 uses parallelThreadCount()
+    DLThroughputConfig linkBudget;      // DL throughput chain; its shadowing and O2I losses are ignored
+};
+
+/**
+ * @brief Throughput distribution of a Monte Carlo run.
+ *
+ * Bin i of the histogram counts the samples in [i * binWidth, (i + 1) * binWidth); the last
+ * bin also holds any sample beyond maxThroughput.
+ */
+struct MonteCarloResult {
+    std::uint64_t numSamples = 0;      // trials x UEs
+    std::uint64_t outageSamples = 0;   // samples at or below the outage throughput
+    double meanThroughput = 0.0;       // in kbps
+    double minThroughput = 0.0;        // in kbps
+    double maxThroughput = 0.0;        // in kbps
+    double binWidth = 0.0;             // in kbps
+    std::vector<std::uint64_t> histogram;
+    std::vector<double> cdf;           // P(throughput < upper edge of bin i)
+    QuantileSketch throughputSketch;   // every sample, in kbps
+};
+
+/**
+ * @brief Run the DL throughput chain over random shadowing and O2I realizations.
+ *
+ * @param scenario UEs of the scenario; the shadowing and O2I columns are ignored.
+ * @param config Loss model, histogram and execution parameters.
+ * @return The throughput distribution, empty if the scenario has no UE or numTrials is 0.
+ */
+MonteCarloResult runMonteCarloDLThroughput(const DLThroughputBatchInput& scenario,
+                                           const MonteCarloConfig& config = MonteCarloConfig());
+
+/**
+ * @brief Draw the shadowing and O2I losses of a sample, as runMonteCarloDLThroughput() does.
+ *
+ * @param config Loss model parameters.
+ * @param sample Sample number, trial * number of UEs + UE index.
+ * @param shadowingLoss Receives the shadowing loss in dB.
+ * @param o2iLoss Receives the O2I loss in dB, 0 for an outdoor UE.
+ */
+void drawMonteCarloLosses(const MonteCarloConfig& config, std::uint64_t sample,
+                          double& shadowingLoss, double& o2iLoss);
+
+/**
+ * @brief Quantile of the throughput distribution, interpolated linearly within a bin.
+ *
+ * The error is up to a bin width; result.throughputSketch.quantile() has a relative error
+ * instead, which is tighter for the low percentiles.
+ *
+ * @param result Monte Carlo result.
+ * @param probability Probability in [0, 1], e.g. 0.05 for the cell edge throughput.
+ * @return The throughput in kbps below which the given fraction of the samples lies.
+ */
+double monteCarloQuantile(const MonteCarloResult& result, double probability);
+
+#endif // MONTECARLO_H
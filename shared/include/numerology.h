@@ -0,0 +1,189 @@
+#ifndef NUMEROLOGY_H
+#define NUMEROLOGY_H
+
+/**
+ * @file numerology.h
+ * @brief Numerology as a compile-time parameter.
+ *
+ * The runtime functions of utilities.h compute 2^µ with std::pow, and
+ * calculateOFDMSymbolDuration() maps the SCS back to µ through getNumerology(), on every
+ * call. The templates below take µ as a template argument instead, so that the slot
+ * duration, SCS, symbols per slot and slots per subframe are constants in the loops
+ * instantiated for each numerology, and return the same values as the runtime functions.
+ *
+ * A loop over a batch selects its instantiation once with dispatchNumerology(). Batches
+ * mixing numerologies are split with groupByNumerology() and each group runs its own
+ * instantiation.
+ */
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "utilities.h"
+
+constexpr int maxNumerology = 4; // 240 kHz, TS 38.211 Table 4.2-1
+
+/**
+ * @brief Numerology carried as a type, for the loop bodies passed to dispatchNumerology().
+ */
+template <int Mu>
+using NumerologyConstant = std::integral_constant<int, Mu>;
+
+/**
+ * @brief Slot size of numerology Mu, see calculateSlotSize(int).
+ *
+ * @tparam Mu Numerology in [0, 4].
+ * @return Slot size in milliseconds.
+ */
+template <int Mu>
+constexpr double calculateSlotSize() {
+    static_assert(Mu >= 0 && Mu <= maxNumerology, "numerology must be in [0, 4]");
+    return 1.0 / (1 << Mu);
+}
+
+/**
+ * @brief Number of slots per 1 ms subframe of numerology Mu.
+ *
+ * @tparam Mu Numerology in [0, 4].
+ * @return Number of slots per subframe.
+ */
+template <int Mu>
+constexpr int calculateNumberOfSlots() {
+    static_assert(Mu >= 0 && Mu <= maxNumerology, "numerology must be in [0, 4]");
+    return 1 << Mu;
+}
+
+/**
+ * @brief Subcarrier spacing of numerology Mu, see calculateSCS(int).
+ *
+ * @tparam Mu Numerology in [0, 4].
+ * @return SCS in kHz.
+ */
+template <int Mu>
+constexpr double calculateSCS() {
+    static_assert(Mu >= 0 && Mu <= maxNumerology, "numerology must be in [0, 4]");
+    return 15.0 * (1 << Mu);
+}
+
+/**
+ * @brief Number of OFDM symbols per slot of numerology Mu.
+ *
+ * @tparam Mu Numerology in [0, 4].
+ * @param useExtendedCP Extended cyclic prefix, which only numerology 2 supports.
+ * @return 12 with an extended CP at numerology 2, 14 otherwise.
+ */
+template <int Mu>
+constexpr int calculateNumberOfSymbolsPerSlot(bool useExtendedCP) {
+    static_assert(Mu >= 0 && Mu <= maxNumerology, "numerology must be in [0, 4]");
+    return Mu == 2 && useExtendedCP ? 12 : 14;
+}
+
+/**
+ * @brief OFDM symbol duration of numerology Mu, see calculateOFDMSymbolDuration(double, bool).
+ *
+ * @tparam Mu Numerology in [0, 4].
+ * @param useExtendedCP Extended cyclic prefix, which only numerology 2 supports.
+ * @return OFDM symbol duration in milliseconds.
+ */
+template <int Mu>
+constexpr double calculateOFDMSymbolDuration(bool useExtendedCP) {
+    return 1.0 / (calculateNumberOfSymbolsPerSlot<Mu>(useExtendedCP) * static_cast<double>(1 << Mu));
+}
+
+/**
+ * @brief Slot size of a numerology carried as a type.
+ *
+ * Overloads calculateSlotSize(int), so that code generic over the numerology type gets a
+ * constant for a NumerologyConstant and the runtime value for an int.
+ */
+template <int Mu>
+constexpr double calculateSlotSize(NumerologyConstant<Mu>) {
+    return calculateSlotSize<Mu>();
+}
+
+/**
+ * @brief Subcarrier spacing of a numerology carried as a type, see calculateSlotSize(NumerologyConstant).
+ */
+template <int Mu>
+constexpr double calculateSCS(NumerologyConstant<Mu>) {
+    return calculateSCS<Mu>();
+}
+
+/**
+ * @brief Call a function with a numerology known at runtime as a compile-time constant.
+ *
+ * @param numerology Numerology in [0, 4].
+ * @param function Callable taking a NumerologyConstant<Mu>, instantiated for every Mu.
+ * @return The result of the function.
+ * @throws std::invalid_argument if the numerology is out of range.
+ */
+template <typename Function>
+auto dispatchNumerology(int numerology, Function&& function) -> decltype(function(NumerologyConstant<0>())) {
+    switch (numerology) {
+        case 0:
+            return function(NumerologyConstant<0>());
+        case 1:
+            return function(NumerologyConstant<1>());
+        case 2:
+            return function(NumerologyConstant<2>());
+        case 3:
+            return function(NumerologyConstant<3>());
+        case 4:
+            return function(NumerologyConstant<4>());
+        default:
+            throw std::invalid_argument("Unsupported numerology value");
+    }
+}
+
+/**
+ * @brief Elements of a batch ordered by numerology.
+ *
+ * indices[begin[µ], begin[µ + 1]) are the elements of numerology µ, in their batch
+ * order; the group µ = maxNumerology + 1 holds the elements of an invalid numerology.
+ */
+struct NumerologyGroups {
+    static constexpr int numGroups = maxNumerology + 2;
+    std::size_t begin[numGroups + 1] = {};
+    std::vector<std::size_t> indices;
+
+    std::size_t size(int group) const { return begin[group + 1] - begin[group]; }
+    const std::size_t* group(int group) const { return indices.data() + begin[group]; }
+};
+
+/**
+ * @brief Group the elements of a mixed-numerology batch by numerology.
+ *
+ * @param numerology Numerology of each element.
+ * @param count Number of elements.
+ * @param groups Receives the groups; its storage is reused across calls.
+ */
+void groupByNumerology(const int* numerology, std::size_t count, NumerologyGroups& groups);
+
+/**
+ * @brief Output columns of calculateFrameStructureBatch(); every column is optional.
+ */
+struct FrameStructureBatchOutput {
+    double* ofdmSymbolDuration = nullptr; // in milliseconds, normal CP
+    double* slotSize = nullptr;           // in milliseconds
+    int* slotsPerSubframe = nullptr;
+    double* scs = nullptr;                // in kHz
+    double* rbBandwidth = nullptr;        // in kHz
+};
+
+/**
+ * @brief Describe the frame structure of a batch of numerologies.
+ *
+ * Same values as the runtime functions of utilities.h. The elements are grouped by
+ * numerology and each group is filled by the instantiation of its numerology; an element
+ * whose numerology is outside [0, 4] gets 0 in every column.
+ *
+ * @param numerology Numerology of each element.
+ * @param output Output columns.
+ * @param count Number of elements.
+ * @return Number of elements with an invalid numerology.
+ */
+std::size_t calculateFrameStructureBatch(const int* numerology, const FrameStructureBatchOutput& output,
+                                         std::size_t count);
+
+#endif // NUMEROLOGY_H
@@ -0,0 +1,116 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+/**
+ * @file parallel.h
+ * @brief Work-stealing parallel-for and parallel-reduce used by the batch and raster computations.
+ *
+ * Loops run on a process wide pool of threads which is started on first use and grows
+ * on demand. The range of a loop is cut into chunks and dealt out as one contiguous run
+ * of chunks per thread. A thread takes chunks from the front of its run, and once it
+ * runs dry it steals the back half of the run of another thread. Cheap and expensive
+ * chunks are therefore balanced without tuning the initial split.
+ *
+ * Chunk boundaries depend only on the range and the grain, never on the number of
+ * threads, so a loop body that writes per element results produces identical output for
+ * any thread count. parallelReduce() extends that to reductions by combining the partial
+ * results of the chunks in chunk order.
+ *
+ * A loop started from inside the body of another loop runs on the calling thread.
+ */
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Get the number of hardware threads.
+ *
+ * @return The number of hardware threads, at least 1.
+ */
+unsigned int hardwareThreadCount();
+
+/**
+ * @brief Get the number of threads used by loops that do not ask for a number.
+ *
+ * Defaults to hardwareThreadCount().
+ *
+ * @return Default number of threads.
+ */
+unsigned int parallelThreadCount();
+
+/**
+ * @brief Set the number of threads used by loops that do not ask for a number.
+ *
+ * Applies to the batch functions, which take no thread count of their own. Their results
+ * do not depend on it.
+ *
+ * @param numThreads Number of threads, 0 to restore hardwareThreadCount().
+ * @return The default number of threads after the call.
+ */
+unsigned int setParallelThreadCount(unsigned int numThreads);
+
+/**
+ * @brief Choose a grain for a loop whose iterations have a uniform cost.
+ *
+ * Cuts the range into about 256 chunks, enough to balance 64 threads, but never into
+ * chunks smaller than @p minGrain. The result is a multiple of @p minGrain and depends
+ * on @p count only, so it keeps the results independent of the thread count.
+ *
+ * @param count Number of iterations.
+ * @param minGrain Smallest chunk worth handing to a thread.
+ * @return Grain to pass to parallelFor() or parallelReduce().
+ */
+std::size_t parallelGrain(std::size_t count, std::size_t minGrain);
+
+/**
+ * @brief Run a loop body over [0, count) on several threads.
+ *
+ * The range is cut into chunks of @p grain iterations, balanced over the threads by work
+ * stealing. The body receives half-open chunk bounds [begin, end), begin being a multiple
+ * of @p grain, and must be safe to call concurrently for disjoint chunks. A range of a
+ * single chunk runs on the calling thread. The first exception thrown by the body stops
+ * the loop and is rethrown to the caller.
+ *
+ * @param count Number of iterations.
+ * @param grain Number of iterations per chunk (values below 1 are treated as 1).
+ * @param body Loop body called once per chunk.
+ * @param numThreads Number of threads to use, 0 for parallelThreadCount().
+ */
+void parallelFor(std::size_t count, std::size_t grain,
+                 const std::function<void(std::size_t begin, std::size_t end)>& body,
+                 unsigned int numThreads = 0);
+
+/**
+ * @brief Reduce [0, count) over several threads, in a fixed order.
+ *
+ * @p map reduces each chunk of parallelFor() to a partial result, and the partial results
+ * are folded from left to right with @p combine, starting from @p identity. Since neither
+ * the chunks nor the order of the fold depend on the thread count, floating point sums
+ * are identical for any number of threads.
+ *
+ * @param count Number of iterations.
+ * @param grain Number of iterations per chunk (values below 1 are treated as 1).
+ * @param identity Initial value of the fold.
+ * @param map Partial result of a chunk, called as map(begin, end).
+ * @param combine Fold step, called as combine(accumulated, partial).
+ * @param numThreads Number of threads to use, 0 for parallelThreadCount().
+ * @return The folded result.
+ */
+template <typename T, typename Map, typename Combine>
+T parallelReduce(std::size_t count, std::size_t grain, T identity, Map map, Combine combine,
+                 unsigned int numThreads = 0) {
+    grain = grain == 0 ? 1 : grain;
+    std::vector<T> partials((count + grain - 1) / grain, identity);
+    parallelFor(count, grain, [&](std::size_t begin, std::size_t end) {
+        partials[begin / grain] = map(begin, end);
+    }, numThreads);
+    T result = std::move(identity);
+    for (T& partial : partials) {
+        result = combine(std::move(result), std::move(partial));
+    }
+    return result;
+}
+
+#endif // PARALLEL_H
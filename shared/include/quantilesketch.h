@@ -0,0 +1,153 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+/**
+ * @file quantilesketch.h
+ * @brief Mergeable streaming quantiles of unbounded sample sets in constant memory.
+ *
+ * QuantileSketch is a log-linear (HDR) histogram: every power of two between its lowest
+ * and highest value is split into 2^precisionBits buckets of equal width. A sample is
+ * binned from the bits of its IEEE 754 representation, without a logarithm, and only
+ * the bucket counts are kept, so the memory depends on the value range and precision
+ * only (about 41 KB for the defaults), never on the number of samples.
+ *
+ * Counts are exact integers: sketches filled by different threads merge into exactly the
+ * sketch a single thread would have filled, whatever the order. A quantile is reported
+ * as the middle of the bucket holding the sample of that rank, within relativeError() of
+ * the sample itself.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "linkbudget.h"
+
+/**
+ * @brief Streaming quantile sketch with a bounded relative error.
+ *
+ * Samples below lowestValue, including 0 and negative values, share an underflow bucket
+ * reported as the smallest sample; samples above highestValue share an overflow bucket
+ * reported as the largest sample. NaN samples are ignored.
+ */
+class QuantileSketch {
+public:
+    /**
+     * @brief Create an empty sketch.
+     *
+     * @param lowestValue Smallest value resolved with the relative error, greater than 0.
+     * @param highestValue Largest value resolved with the relative error.
+     * @param precisionBits Buckets per power of two as a power of two, in [1, 16]; the
+     *        relative error is 2^-(precisionBits + 1).
+     * @throws std::invalid_argument if the range or the precision is invalid.
+     */
+    explicit QuantileSketch(double lowestValue = 1e-3, double highestValue = 1e9, int precisionBits = 7);
+
+    /**
+     * @brief Add a sample.
+     *
+     * @param value Sample value.
+     */
+    void add(double value) {
+        if (value >= lowestValue_ && value <= highestValue_) {
+            ++counts_[bucketOf(value)];
+        } else if (value < lowestValue_) {
+            ++counts_.front();
+        } else if (value > highestValue_) {
+            ++counts_.back();
+        } else {
+            return; // NaN
+        }
+        ++count_;
+        min_ = value < min_ ? value : min_;
+        max_ = value > max_ ? value : max_;
+    }
+
+    /**
+     * @brief Add an array of samples.
+     *
+     * @param values Sample values.
+     * @param count Number of samples.
+     */
+    void add(const double* values, std::size_t count);
+
+    /**
+     * @brief Add the samples of another sketch.
+     *
+     * @param other Sketch with the same lowest value, highest value and precision.
+     * @throws std::invalid_argument if the bucket layouts differ.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * @brief Remove every sample, keeping the bucket layout.
+     */
+    void clear();
+
+    /**
+     * @brief Get the quantile of the samples added so far.
+     *
+     * The quantile of probability p is the sample of rank ceil(p * count()) (nearest rank),
+     * so 0 gives min() and 1 gives max().
+     *
+     * @param probability Probability in [0, 1], e.g. 0.05 for the cell edge throughput.
+     * @return Estimate of the quantile, 0 if the sketch is empty.
+     */
+    double quantile(double probability) const;
+
+    /**
+     * @brief Get the fraction of the samples at or below a value.
+     *
+     * @param value Value, resolved to its bucket.
+     * @return Fraction of the samples in the buckets up to the one holding @p value.
+     */
+    double cdf(double value) const;
+
+    std::uint64_t count() const { return count_; }
+    double min() const { return count_ ? min_ : 0.0; }
+    double max() const { return count_ ? max_ : 0.0; }
+    double lowestValue() const { return lowestValue_; }
+    double highestValue() const { return highestValue_; }
+    int precisionBits() const { return precisionBits_; }
+    double relativeError() const { return 1.0 / (2 << precisionBits_); }
+    std::size_t numBuckets() const { return counts_.size(); }
+
+private:
+    // Bucket of a value in [lowestValue_, highestValue_]: the sign, exponent and leading
+    // mantissa bits of the value, offset so that lowestValue_ falls in bucket 1
+    std::size_t bucketOf(double value) const {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<std::size_t>((bits >> (52 - precisionBits_)) - firstKey_) + 1;
+    }
+
+    // Middle of a bucket within [lowestValue_, highestValue_]
+    double bucketMiddle(std::size_t bucket) const;
+
+    double lowestValue_;
+    double highestValue_;
+    int precisionBits_;
+    std::uint64_t firstKey_; // key of lowestValue_
+    std::vector<std::uint64_t> counts_; // underflow, the buckets of the range, overflow
+    std::uint64_t count_ = 0;
+    double min_;
+    double max_;
+};
+
+/**
+ * @brief Stream the DL throughputs of a batch of UEs into a sketch.
+ *
+ * Runs calculateDLThroughputBatch() block by block on several threads, each thread adding
+ * its throughputs to its own sketch, and merges the thread sketches into @p sketch. The
+ * throughputs themselves are never stored, so batches of any size take constant memory,
+ * and calling this for successive batches accumulates their distribution. The result is
+ * the same for any number of threads.
+ *
+ * @param input Input columns.
+ * @param sketch Sketch receiving the throughputs in kbps.
+ * @param config Parameters common to all UEs of the batch.
+ */
+void sketchDLThroughputBatch(const DLThroughputBatchInput& input, QuantileSketch& sketch,
+                             const DLThroughputConfig& config = DLThroughputConfig());
+
+#endif // QUANTILESKETCH_H
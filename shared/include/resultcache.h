@@ -0,0 +1,161 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+/**
+ * @file resultcache.h
+ * @brief Memoization of DL throughput results keyed by their input tuple.
+ *
+ * Planning runs evaluate the same (path loss, Tx power, layers, PRB count, bandwidth,
+ * numerology) tuples over and over. DLThroughputCache keeps the throughput of each tuple
+ * in a fixed size open addressing hash table and only runs the DL throughput chain for
+ * tuples it has not seen.
+ *
+ * The table can live in a file mapped into memory, so that results survive restarts and
+ * are shared by the processes that open the same file one after the other. The file
+ * records the parameters of DLThroughputConfig the results depend on; a file written
+ * with other parameters, or another capacity, is cleared when opened.
+ *
+ * A cache is not thread safe: use one cache per thread, or lock around it.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "linkbudget.h"
+
+/**
+ * @brief Inputs of one DL throughput evaluation.
+ */
+struct DLThroughputCacheKey {
+    double pathLoss;  // in dB
+    double txPower;   // total transmit power in dBm
+    int numOfLayers;  // number of spatial layers
+    int prbCount;     // PRBs configured in the gNB
+    double bandwidth; // in Hz
+    int numerology;
+};
+
+/**
+ * @brief Counters of a cache since it was created.
+ */
+struct DLThroughputCacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;    // lookups that ran the DL throughput chain
+    std::uint64_t evictions = 0; // entries overwritten because their probe window was full
+};
+
+/**
+ * @brief Cache of DL throughput results.
+ *
+ * Every entry is evaluated with calculateDLThroughputBatch(), whichever method stores it,
+ * so that throughput() and throughputBatch() return the same value for a tuple.
+ *
+ * Entries are stored in a power of two number of slots with linear probing limited to a
+ * short window. When the window of a new key is full, the entry in its home slot is
+ * replaced, so the cache never grows and lookups never scan more than the window.
+ */
+class DLThroughputCache {
+public:
+    /**
+     * @brief Create a cache held in memory.
+     *
+     * @param capacity Number of entries, rounded up to a power of two.
+     * @param config Parameters of the calculation; config.numerology is taken from the keys.
+     */
+    explicit DLThroughputCache(std::size_t capacity, const DLThroughputConfig& config = DLThroughputConfig());
+
+    /**
+     * @brief Create a cache backed by a file.
+     *
+     * The file is created if needed. Entries found in it are kept when it was written with
+     * the same capacity and calculation parameters. If the file cannot be opened or mapped,
+     * the cache is held in memory instead, see isPersistent().
+     *
+     * @param path Path of the backing file.
+     * @param capacity Number of entries, rounded up to a power of two.
+     * @param config Parameters of the calculation; config.numerology is taken from the keys.
+     */
+    DLThroughputCache(const std::string& path, std::size_t capacity,
+                      const DLThroughputConfig& config = DLThroughputConfig());
+
+    ~DLThroughputCache();
+
+    DLThroughputCache(const DLThroughputCache&) = delete;
+    DLThroughputCache& operator=(const DLThroughputCache&) = delete;
+
+    /**
+     * @brief Get the throughput of a tuple, running the DL throughput chain on a miss.
+     *
+     * Tuples holding a NaN are evaluated every time and never stored.
+     *
+     * @param key Inputs of the evaluation.
+     * @return DL application throughput in kbps, as calculateDLThroughputBatch() returns it.
+     */
+    double throughput(const DLThroughputCacheKey& key);
+
+    /**
+     * @brief Get the throughputs of a batch of UEs sharing a numerology.
+     *
+     * Each distinct tuple missing from the cache is evaluated once with
+     * calculateDLThroughputBatch(), then stored; its repeats in the batch count as hits.
+     * The optional shadowing and O2I columns of the input are not part of the key: a batch
+     * with either column is evaluated in full, counted as misses and never stored.
+     *
+     * @param input Input columns.
+     * @param numerology Numerology of every UE.
+     * @param throughput Output column of input.count elements, in kbps.
+     */
+    void throughputBatch(const DLThroughputBatchInput& input, int numerology, double* throughput);
+
+    /**
+     * @brief Look up a tuple without evaluating it.
+     *
+     * Counts neither a hit nor a miss.
+     *
+     * @param key Inputs of the evaluation.
+     * @param throughput Set to the cached throughput when found.
+     * @return Whether the tuple is cached.
+     */
+    bool find(const DLThroughputCacheKey& key, double& throughput) const;
+
+    /**
+     * @brief Remove every entry. Counters are kept.
+     */
+    void clear();
+
+    /**
+     * @brief Write the entries to the backing file.
+     *
+     * Entries reach the file when the cache is destroyed in any case; call this to make
+     * them durable earlier. Does nothing for a cache held in memory.
+     *
+     * @return Whether the file was written.
+     */
+    bool sync();
+
+    std::size_t capacity() const { return capacity_; }
+    std::size_t size() const;
+    bool isPersistent() const { return file_ >= 0; }
+    const DLThroughputCacheStats& stats() const { return stats_; }
+
+private:
+    struct Entry;
+    struct Header;
+
+    void initialize(std::size_t capacity, const DLThroughputConfig& config);
+    void reset();
+    const Entry* lookup(const DLThroughputCacheKey& key, std::uint64_t hash) const;
+    void insert(const DLThroughputCacheKey& key, std::uint64_t hash, double throughput);
+
+    DLThroughputConfig config_;
+    std::uint64_t fingerprint_ = 0; // hash of the parameters of config_ the results depend on
+    std::size_t capacity_ = 0;
+    Header* header_ = nullptr;
+    Entry* entries_ = nullptr;
+    void* mapping_ = nullptr; // file mapping or heap block holding the header and the entries
+    std::size_t mappingSize_ = 0;
+    int file_ = -1;
+    DLThroughputCacheStats stats_;
+};
+
+#endif // RESULTCACHE_H
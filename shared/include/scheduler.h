@@ -0,0 +1,148 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+/**
+ * @file scheduler.h
+ * @brief Slot level downlink scheduler simulation of one cell.
+ *
+ * DLThroughputCalculator sizes the TBS of a single UE holding one PRB. The simulator below
+ * shares the PRBs left by calculateTotalPRBsAvailable() among many UEs, slot after slot,
+ * with a round-robin, proportional fair or max-C/I scheduler, and reports the throughput
+ * each UE gets.
+ *
+ * Every slot the PRBs are split into resource block groups (RBGs), each given to a
+ * different UE. The UEs are kept in an indexed heap ordered by their scheduling metric, so
+ * a slot costs O(k log n) for k RBGs and n UEs, whatever the number of UEs.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "linkbudget.h"
+
+/**
+ * @brief Scheduling policy.
+ */
+enum class SchedulerPolicy {
+    RoundRobin = 0,       // least recently served UE first
+    ProportionalFair = 1, // highest ratio of TBS to average throughput first
+    MaxCI = 2             // highest TBS first
+};
+
+/**
+ * @brief Parameters of a scheduler simulation.
+ */
+struct SchedulerConfig {
+    SchedulerPolicy policy = SchedulerPolicy::ProportionalFair;
+    int prbCount = 273;                  // PRBs configured in the gNB
+    int rbgSize = 16;                    // PRBs per RBG; the last RBG of a slot may be smaller
+    int numOfLayers = 1;                 // spatial layers of every UE
+    double fairnessTimeConstant = 100.0; // in slots, above 1, averaging window of the proportional fair throughput
+    DLThroughputConfig link;             // numerology, REs per PRB, overhead, tables, DL fraction and packet sizes
+};
+
+/**
+ * @brief Throughput obtained by each UE of a simulation.
+ */
+struct SchedulerResult {
+    std::uint64_t slots = 0;
+    std::vector<std::uint64_t> bits;        // bits delivered to each UE
+    std::vector<std::uint64_t> allocations; // RBGs given to each UE
+    std::vector<double> throughput;         // DL application throughput of each UE in kbps
+    double cellThroughput = 0.0;            // sum of the UE throughputs in kbps
+    double fairnessIndex = 0.0;             // Jain's index of the UE throughputs, 1 when all are equal
+};
+
+/**
+ * @brief TTI driven scheduler of one cell.
+ *
+ * The channel of a UE is described by its linear SNR (or SINR), mapped to CQI, MCS and
+ * TBS as in calculateDLThroughput(). It stays constant until setChannel() is called, which
+ * lets callers model mobility or block fading at the rate they need.
+ */
+class SchedulerSimulator {
+public:
+    /**
+     * @brief Create a simulator.
+     *
+     * @param snrLinear SNR per layer of each UE in linear scale.
+     * @param config Simulation parameters.
+     * @throws std::invalid_argument if the fairness time constant is not above 1 slot.
+     */
+    SchedulerSimulator(const std::vector<double>& snrLinear, const SchedulerConfig& config = SchedulerConfig());
+
+    /**
+     * @brief Change the channel of a UE, effective from the next slot.
+     *
+     * @param ue Index of the UE.
+     * @param snrLinear New SNR per layer in linear scale.
+     */
+    void setChannel(std::size_t ue, double snrLinear);
+
+    /**
+     * @brief Schedule a number of slots.
+     *
+     * @param numSlots Number of slots.
+     */
+    void run(std::uint64_t numSlots);
+
+    /**
+     * @brief Get the throughput of each UE since the simulator was created.
+     *
+     * @return Per UE and cell results.
+     */
+    SchedulerResult result() const;
+
+    /**
+     * @brief Get the TBS a UE would get on one RBG of rbgSize PRBs.
+     *
+     * @param ue Index of the UE.
+     * @return TBS in bits.
+     */
+    int rbgTBS(std::size_t ue) const { return ues_[ue].tbs; }
+
+private:
+    struct UE {
+        int mcs = 0;
+        int tbs = 0;                // TBS on one full RBG
+        double scaledAverage = 0.0; // proportional fair average throughput (bits per slot) times averageScale_
+        std::uint64_t lastServed = 0; // slot of the last service times RBGs per slot, plus rank in that slot
+        std::uint64_t bits = 0;
+        std::uint64_t allocations = 0;
+    };
+
+    int slotTBS(std::size_t ue, int prbs) const;
+    double metric(std::size_t ue) const;
+    bool before(std::size_t a, std::size_t b) const;
+    void siftUp(std::size_t position);
+    void siftDown(std::size_t position);
+    void update(std::size_t ue);
+    void renormalize();
+
+    SchedulerConfig config_;
+    int availableREs_;      // REs per PRB
+    int rbgsPerSlot_;
+    int lastRbgSize_;
+    double forgettingFactor_;
+    double averageScale_;   // 1 / forgettingFactor_ raised to the number of slots since the last renormalization
+    std::uint64_t slot_ = 0;
+    std::vector<UE> ues_;
+    std::vector<double> keys_;           // scheduling metric of each UE
+    std::vector<std::size_t> heap_;      // UE indices, best metric first
+    std::vector<std::size_t> position_;  // position of each UE in heap_
+    std::vector<std::size_t> scheduled_; // UEs served in the current slot
+};
+
+/**
+ * @brief Simulate a cell for a number of slots with constant channels.
+ *
+ * @param snrLinear SNR per layer of each UE in linear scale.
+ * @param numSlots Number of slots.
+ * @param config Simulation parameters.
+ * @return Per UE and cell results.
+ * @throws std::invalid_argument if the fairness time constant is not above 1 slot.
+ */
+SchedulerResult runSchedulerSimulation(const std::vector<double>& snrLinear, std::uint64_t numSlots,
+                                       const SchedulerConfig& config = SchedulerConfig());
+
+#endif // SCHEDULER_H
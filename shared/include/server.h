@@ -0,0 +1,148 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+/**
+ * @file server.h
+ * @brief Resident server answering the commands of commands.h over a Unix domain socket.
+ *
+ * Launching a utility per query costs far more than the calculation itself. CommandServer
+ * keeps the commands loaded and serves any number of clients from a single thread. Clients
+ * may pipeline requests: they are answered in order, one response per request, and a
+ * connection may mix both request formats.
+ *
+ * Line requests are a command name followed by its input record, as accepted by the `5g`
+ * binary, terminated by a newline; the newline of the last line before the client shuts
+ * down its side of the connection is optional:
+ *
+ *     dl-throughput 4,100,40,100,273
+ *
+ * The response is the output line of the record; an unknown command gets "error".
+ *
+ * Binary requests start with a zero byte, which a line never does. All values are in the
+ * byte order of the server:
+ *
+ *     uint8 0, uint8 command index in commandList(), uint8 number of inputs, uint8 0
+ *     (reserved), followed by that many doubles
+ *
+ * The response is:
+ *
+ *     uint8 status (0 valid, 1 invalid record, 2 unknown command, 3 nonzero reserved byte),
+ *     uint8 number of outputs, uint16 0, followed by that many doubles ("nan" for an
+ *     invalid record)
+ *
+ * Every request read in one pass over the ready connections is evaluated together, so
+ * requests from concurrent clients for a command with an evaluateBatch() go through a
+ * single batch call.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "commands.h"
+
+/**
+ * @brief Options of a CommandServer.
+ */
+struct CommandServerOptions {
+    int precision = 17;                          // significant digits of the line responses
+    std::size_t maxLineLength = 4096;            // longer line requests close the connection
+    std::size_t maxPendingOutput = 1 << 20;      // connections with more unsent bytes are not read
+    int backlog = 128;                           // pending connections, see listen(2)
+};
+
+/**
+ * @brief Counters of a CommandServer since it was created.
+ */
+struct CommandServerStats {
+    std::size_t connections = 0;     // connections accepted
+    std::size_t requests = 0;        // requests answered
+    std::size_t invalid = 0;         // requests answered with "nan" outputs or an error
+    std::size_t batches = 0;         // calls to an evaluateBatch() of a command
+    std::size_t batchedRequests = 0; // requests evaluated through those calls
+    std::size_t protocolErrors = 0;  // connections closed for a malformed request
+};
+
+/**
+ * @brief Single threaded poll(2) server of the registered commands.
+ */
+class CommandServer {
+public:
+    explicit CommandServer(const CommandServerOptions& options = CommandServerOptions());
+    ~CommandServer();
+
+    CommandServer(const CommandServer&) = delete;
+    CommandServer& operator=(const CommandServer&) = delete;
+
+    /**
+     * @brief Listen on a Unix domain socket.
+     *
+     * An existing socket file at @p path is replaced; it is removed again by the destructor.
+     *
+     * @param path Path of the socket.
+     * @return False if the socket could not be created, errno tells why.
+     */
+    bool listen(const std::string& path);
+
+    /**
+     * @brief Serve the clients until stop() is called.
+     *
+     * @return False if polling failed, errno tells why.
+     */
+    bool run();
+
+    /**
+     * @brief Accept, read, evaluate and answer whatever is ready.
+     *
+     * @param timeout Milliseconds to wait for something to do, -1 to wait forever.
+     * @return False if polling failed, errno tells why.
+     */
+    bool poll(int timeout);
+
+    /**
+     * @brief Make run() return.
+     *
+     * Safe to call from another thread or from a signal handler.
+     */
+    void stop();
+
+    const CommandServerStats& stats() const { return stats_; }
+
+private:
+    struct Connection {
+        int fd;
+        std::vector<char> input;
+        std::string output;
+        std::size_t written = 0; // bytes of output already sent
+        bool closing = false;    // no more requests are read, close once the output is sent
+    };
+
+    struct Request {
+        std::size_t connection;
+        const Command* command; // null for an unknown command
+        bool binary;
+        bool malformed; // binary request with a nonzero reserved byte
+        bool valid;
+        double inputs[maxCommandFields];
+        double outputs[maxCommandFields];
+    };
+
+    void accept();
+    void read(std::size_t connection);
+    void parse(std::size_t connection);
+    void evaluate();
+    void respond(const Request& request);
+    void write(std::size_t connection);
+
+    CommandServerOptions options_;
+    int listener_ = -1;
+    int wakeRead_ = -1;
+    int wakeWrite_ = -1;
+    std::string path_;
+    std::atomic<bool> stopping_;
+    std::vector<Connection> connections_;
+    std::vector<Request> requests_;
+    CommandServerStats stats_;
+};
+
+#endif // SERVER_H
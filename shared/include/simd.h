@@ -0,0 +1,183 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+/**
+ * @file simd.h
+ * @brief Runtime selection of the SIMD instruction set used by the batch kernels,
+ * and the vector math primitives shared by those kernels.
+ *
+ * Kernels are compiled for every supported instruction set through function target
+ * attributes, so the project does not need any architecture specific compiler flags.
+ * The widest instruction set supported by the CPU is selected at runtime.
+ */
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define FIVEG_HAVE_X86_SIMD 1
+#include <immintrin.h>
+#define FIVEG_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define FIVEG_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define FIVEG_HAVE_X86_SIMD 0
+#endif
+
+/**
+ * @brief Instruction sets a batch kernel can be dispatched to.
+ */
+enum class SimdLevel {
+    Scalar = 0,
+    AVX2 = 1,   // 4 doubles per vector, requires AVX2 and FMA
+    AVX512 = 2  // 8 doubles per vector, requires AVX-512F
+};
+
+/**
+ * @brief Detect the widest instruction set supported by the CPU and the OS.
+ *
+ * @return Supported SIMD level.
+ */
+SimdLevel detectSimdLevel();
+
+/**
+ * @brief Get the SIMD level currently used by the batch kernels.
+ *
+ * Defaults to detectSimdLevel().
+ *
+ * @return Active SIMD level.
+ */
+SimdLevel activeSimdLevel();
+
+/**
+ * @brief Restrict the batch kernels to the given SIMD level.
+ *
+ * Requests above the detected level are clamped to the detected level. This is
+ * mainly meant for testing and benchmarking the narrower kernels.
+ *
+ * @param level Requested SIMD level.
+ * @return The SIMD level that is active after the call.
+ */
+SimdLevel setSimdLevel(SimdLevel level);
+
+#if FIVEG_HAVE_X86_SIMD
+namespace simd {
+
+// Coefficients of ln(m) = 2s * (1 + s^2/3 + s^4/5 + ...), s = (m - 1) / (m + 1).
+// For m in [sqrt(1/2), sqrt(2)], s^2 <= 0.0295 and eleven terms are accurate to well
+// below one ulp; the result is within 2 ulp of std::log for normal positive inputs.
+constexpr double lnSeries[] = {1.0, 1.0 / 3, 1.0 / 5, 1.0 / 7, 1.0 / 9, 1.0 / 11,
+                               1.0 / 13, 1.0 / 15, 1.0 / 17, 1.0 / 19, 1.0 / 21};
+constexpr double ln2Hi = 6.93147180369123816490e-01;
+constexpr double ln2Lo = 1.90821492927058770002e-10;
+constexpr double log10e = 0.43429448190325182765;
+constexpr double log2e = 1.44269504088896340736;
+constexpr double sqrt2 = 1.41421356237309504880;
+constexpr double twoPow52 = 4503599627370496.0;
+constexpr double ln2 = 0.69314718055994530942;
+constexpr double roundingMagic = 6755399441055744.0; // 1.5 * 2^52, leaves an integer in the low mantissa bits
+
+// Coefficients of 2^r = sum (r * ln2)^k / k!. For r in [-1/2, 1/2] the truncation error of the
+// degree 13 polynomial is below 5e-18 relative, so 2^r is within 1 ulp of the exact value.
+constexpr double exp2Coefficient(int k) {
+    return k == 0 ? 1.0 : exp2Coefficient(k - 1) * ln2 / k;
+}
+constexpr double exp2Series[] = {exp2Coefficient(0), exp2Coefficient(1), exp2Coefficient(2), exp2Coefficient(3),
+                                 exp2Coefficient(4), exp2Coefficient(5), exp2Coefficient(6), exp2Coefficient(7),
+                                 exp2Coefficient(8), exp2Coefficient(9), exp2Coefficient(10), exp2Coefficient(11),
+                                 exp2Coefficient(12), exp2Coefficient(13)};
+
+// Natural logarithm of positive, finite, normal values.
+FIVEG_TARGET_AVX2 inline __m256d logAvx2(__m256d x) {
+    const __m256i bits = _mm256_castpd_si256(x);
+    const __m256i mantissaBits = _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                                 _mm256_set1_epi64x(0x3FF0000000000000LL));
+    // Biased exponent converted to double through the 2^52 trick (no cvtepi64_pd in AVX2)
+    const __m256i exponentBits = _mm256_or_si256(_mm256_srli_epi64(bits, 52),
+                                                 _mm256_castpd_si256(_mm256_set1_pd(twoPow52)));
+    __m256d e = _mm256_sub_pd(_mm256_castsi256_pd(exponentBits), _mm256_set1_pd(twoPow52 + 1023.0));
+    __m256d m = _mm256_castsi256_pd(mantissaBits);
+
+    // Move m from [1, 2) to [sqrt(1/2), sqrt(2))
+    const __m256d above = _mm256_cmp_pd(m, _mm256_set1_pd(sqrt2), _CMP_GT_OQ);
+    m = _mm256_blendv_pd(m, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), above);
+    e = _mm256_add_pd(e, _mm256_and_pd(above, _mm256_set1_pd(1.0)));
+
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d s = _mm256_div_pd(_mm256_sub_pd(m, one), _mm256_add_pd(m, one));
+    const __m256d z = _mm256_mul_pd(s, s);
+    __m256d p = _mm256_set1_pd(lnSeries[10]);
+    for (int k = 9; k >= 0; --k) {
+        p = _mm256_fmadd_pd(p, z, _mm256_set1_pd(lnSeries[k]));
+    }
+    const __m256d lnM = _mm256_mul_pd(_mm256_add_pd(s, s), p);
+    return _mm256_fmadd_pd(e, _mm256_set1_pd(ln2Hi), _mm256_fmadd_pd(e, _mm256_set1_pd(ln2Lo), lnM));
+}
+
+FIVEG_TARGET_AVX2 inline __m256d log10Avx2(__m256d x) {
+    return _mm256_mul_pd(logAvx2(x), _mm256_set1_pd(log10e));
+}
+
+FIVEG_TARGET_AVX2 inline __m256d log2Avx2(__m256d x) {
+    return _mm256_mul_pd(logAvx2(x), _mm256_set1_pd(log2e));
+}
+
+// 2^(hi + lo) for hi in [-1022, 1023] and |lo| much smaller than 1, lo carrying the rounding
+// error of hi. Within 2 ulp of the exact value; the result is never subnormal.
+FIVEG_TARGET_AVX2 inline __m256d exp2Avx2(__m256d hi, __m256d lo) {
+    const __m256d n = _mm256_round_pd(hi, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m256d r = _mm256_add_pd(_mm256_sub_pd(hi, n), lo);
+    __m256d p = _mm256_set1_pd(exp2Series[13]);
+    for (int k = 12; k >= 0; --k) {
+        p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(exp2Series[k]));
+    }
+    // 2^n assembled in the exponent field
+    const __m256i nBits = _mm256_castpd_si256(_mm256_add_pd(n, _mm256_set1_pd(roundingMagic)));
+    const __m256i scale = _mm256_slli_epi64(_mm256_add_epi64(nBits, _mm256_set1_epi64x(1023)), 52);
+    return _mm256_mul_pd(p, _mm256_castsi256_pd(scale));
+}
+
+FIVEG_TARGET_AVX512 inline __m512d logAvx512(__m512d x) {
+    const __m512i bits = _mm512_castpd_si512(x);
+    const __m512i mantissaBits = _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL)),
+                                                 _mm512_set1_epi64(0x3FF0000000000000LL));
+    const __m512i exponentBits = _mm512_or_si512(_mm512_srli_epi64(bits, 52),
+                                                 _mm512_castpd_si512(_mm512_set1_pd(twoPow52)));
+    __m512d e = _mm512_sub_pd(_mm512_castsi512_pd(exponentBits), _mm512_set1_pd(twoPow52 + 1023.0));
+    __m512d m = _mm512_castsi512_pd(mantissaBits);
+
+    const __mmask8 above = _mm512_cmp_pd_mask(m, _mm512_set1_pd(sqrt2), _CMP_GT_OQ);
+    m = _mm512_mask_mul_pd(m, above, m, _mm512_set1_pd(0.5));
+    e = _mm512_mask_add_pd(e, above, e, _mm512_set1_pd(1.0));
+
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d s = _mm512_div_pd(_mm512_sub_pd(m, one), _mm512_add_pd(m, one));
+    const __m512d z = _mm512_mul_pd(s, s);
+    __m512d p = _mm512_set1_pd(lnSeries[10]);
+    for (int k = 9; k >= 0; --k) {
+        p = _mm512_fmadd_pd(p, z, _mm512_set1_pd(lnSeries[k]));
+    }
+    const __m512d lnM = _mm512_mul_pd(_mm512_add_pd(s, s), p);
+    return _mm512_fmadd_pd(e, _mm512_set1_pd(ln2Hi), _mm512_fmadd_pd(e, _mm512_set1_pd(ln2Lo), lnM));
+}
+
+FIVEG_TARGET_AVX512 inline __m512d log10Avx512(__m512d x) {
+    return _mm512_mul_pd(logAvx512(x), _mm512_set1_pd(log10e));
+}
+
+FIVEG_TARGET_AVX512 inline __m512d log2Avx512(__m512d x) {
+    return _mm512_mul_pd(logAvx512(x), _mm512_set1_pd(log2e));
+}
+
+FIVEG_TARGET_AVX512 inline __m512d exp2Avx512(__m512d hi, __m512d lo) {
+    const __m512d n = _mm512_roundscale_pd(hi, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    const __m512d r = _mm512_add_pd(_mm512_sub_pd(hi, n), lo);
+    __m512d p = _mm512_set1_pd(exp2Series[13]);
+    for (int k = 12; k >= 0; --k) {
+        p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(exp2Series[k]));
+    }
+    const __m512i nBits = _mm512_castpd_si512(_mm512_add_pd(n, _mm512_set1_pd(roundingMagic)));
+    const __m512i scale = _mm512_slli_epi64(_mm512_add_epi64(nBits, _mm512_set1_epi64(1023)), 52);
+    return _mm512_mul_pd(p, _mm512_castsi512_pd(scale));
+}
+
+} // namespace simd
+#endif // FIVEG_HAVE_X86_SIMD
+
+#endif // SIMD_H
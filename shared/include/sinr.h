@@ -0,0 +1,138 @@
+#ifndef SINR_H
+#define SINR_H
+
+/**
+ * @file sinr.h
+ * @brief Downlink SINR of UEs under co-channel interference from many gNBs.
+ *
+ * calculateSNRLinear() compares the received power against thermal noise only, which is
+ * far too optimistic in dense deployments. The functions below sum, for every UE, the
+ * received power of all co-channel cells with the rural path loss model and
+ * calculateReceivedPowerPerLayer(): the strongest cell is the serving cell and every other
+ * cell is an interferer.
+ *
+ * Evaluating every (UE, cell) pair is out of reach for national scale layouts. The batch
+ * engine sorts UEs and cells into a uniform grid of bins and, for each bin of UEs, drops
+ * the cells whose received power is bound to stay below a threshold relative to the noise
+ * or to the serving cell, whichever is larger.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "conversions.h"
+#include "coverage.h"
+
+/**
+ * @brief Radio and execution parameters of a SINR computation.
+ */
+struct SinrConfig {
+    double fLow = 3300.0;                  // in MHz
+    double fHigh = 3400.0;                 // in MHz
+    double buildingHeight = 5.0;           // in meters
+    double streetWidth = 20.0;             // in meters
+    double ueHeight = 1.5;                 // in meters
+    bool isLOS = false;
+    int numOfLayers = 1;                   // Tx power is split evenly over the layers
+    double beamFormingGain = 0.0;          // in dB per layer
+    double bandwidth = 100e6;              // in Hz, noise bandwidth
+    double temperature = 300.0;            // in Kelvin
+    double maxDistance = 10000.0;          // cells farther than this (the model limit) are ignored
+    double interferenceThreshold = -30.0;  // in dB, see calculateMultiCellSINRBatch()
+    double binSize = 500.0;                // edge of the spatial bins in meters
+    ConversionAccuracy conversionAccuracy = ConversionAccuracy::Strict;
+    unsigned int numThreads = 0;           // 0 uses every hardware thread
+};
+
+/**
+ * @brief UE positions of a SINR batch. Both columns hold @c count elements.
+ */
+struct SinrBatchInput {
+    std::size_t count = 0;
+    const double* x = nullptr; // easting in meters
+    const double* y = nullptr; // northing in meters
+};
+
+/**
+ * @brief Output columns of a SINR batch.
+ *
+ * Only @c sinrLinear is mandatory; every non-null column must hold @c count elements.
+ * UEs that receive no cell above the threshold get a SINR of 0, a serving cell of -1 and
+ * powers of 0.
+ */
+struct SinrBatchOutput {
+    double* sinrLinear = nullptr;         // SINR per layer in linear scale
+    std::int32_t* servingCell = nullptr;  // optional, index of the strongest cell
+    double* signalPower = nullptr;        // optional, Rx power per layer of the serving cell in Watts
+    double* interferencePower = nullptr;  // optional, summed Rx power per layer of the other cells in Watts
+};
+
+/**
+ * @brief Number of (UE, cell) pairs handled by a SINR batch.
+ */
+struct SinrStats {
+    std::size_t pairsEvaluated = 0;   // pairs whose path loss was computed
+    std::size_t pairsContributing = 0; // pairs within the pruning radius of the cell
+    std::size_t unservedUEs = 0;      // UEs without any contributing cell
+};
+
+/**
+ * @brief Get the distance beyond which a cell is dropped by calculateMultiCellSINRBatch().
+ *
+ * Beyond the returned distance, the received power per layer of the cell is below the
+ * noise power plus config.interferenceThreshold. The radius is found on a 1% geometric
+ * grid of distances and rounded up to the next grid point; it is config.maxDistance when
+ * the cell stays above the threshold up to the limit of the model.
+ *
+ * @param cell gNB of the cell.
+ * @param config Radio parameters.
+ * @return Pruning radius in meters, 0 if the cell is below the threshold everywhere.
+ */
+double calculateSinrPruningRadius(const CoverageSite& cell, const SinrConfig& config = SinrConfig());
+
+/**
+ * @brief Compute the downlink SINR of a batch of UEs.
+ *
+ * UEs and cells are sorted into square bins of config.binSize meters. For each bin of UEs,
+ * the cells whose pruning radius reaches the bin are ranked by an upper bound of their
+ * received power over the bin, and evaluated in that order, one cell at a time over all
+ * UEs of the bin with calculate5GPathLossRuralBatch(). Evaluation stops at the first cell
+ * whose bound is below config.interferenceThreshold relative to the larger of the noise
+ * power and the weakest serving cell found so far in the bin.
+ *
+ * A dropped cell therefore adds less than config.interferenceThreshold, relative to the
+ * larger of noise and signal, to the interference of any UE. This holds for each dropped
+ * cell on its own; their sum is not bounded by the threshold. Pairs outside the validity
+ * range of the path loss model contribute nothing. A threshold of -infinity evaluates
+ * every pair within config.maxDistance.
+ *
+ * In NLOS mode the rural model falls back to the lower LOS path loss beyond 5 km, so far
+ * cells can outweigh closer ones and the bounds prune much less than in LOS mode; a
+ * config.maxDistance of 5 km restores the pruning when that range is acceptable.
+ *
+ * @param cells Co-channel gNBs.
+ * @param input UE positions.
+ * @param output Output columns.
+ * @param config Radio and execution parameters.
+ * @return Pair counts.
+ */
+SinrStats calculateMultiCellSINRBatch(const std::vector<CoverageSite>& cells, const SinrBatchInput& input,
+                                      const SinrBatchOutput& output, const SinrConfig& config = SinrConfig());
+
+/**
+ * @brief Compute the downlink SINR of a single UE against every cell.
+ *
+ * Scalar reference of calculateMultiCellSINRBatch() without pruning: every cell within
+ * config.maxDistance and the validity range of the model contributes.
+ *
+ * @param cells Co-channel gNBs.
+ * @param x Easting of the UE in meters.
+ * @param y Northing of the UE in meters.
+ * @param config Radio parameters.
+ * @param servingCell Optional output receiving the index of the strongest cell, -1 if none.
+ * @return SINR per layer in linear scale.
+ */
+double calculateMultiCellSINR(const std::vector<CoverageSite>& cells, double x, double y,
+                              const SinrConfig& config = SinrConfig(), std::int32_t* servingCell = nullptr);
+
+#endif // SINR_H
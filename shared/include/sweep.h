@@ -0,0 +1,99 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+/**
+ * @file sweep.h
+ * @brief Parameter sweep of the DL throughput chain over a Cartesian grid of inputs.
+ *
+ * Each stage of the DLThroughputCalculator chain only depends on some of the swept inputs:
+ *
+ *   thermal noise          <- bandwidth
+ *   Tx power per layer     <- Tx power, layers
+ *   large-scale loss       <- path loss
+ *   SNR, CQI               <- bandwidth, layers, Tx power, path loss
+ *   MCS, TBS               <- CQI
+ *   PRBs after overhead    <- PRB count
+ *   slot duration          <- numerology
+ *   throughput             <- layers, TBS, PRBs after overhead, slot duration
+ *
+ * runDLThroughputSweep() evaluates every stage once per distinct combination of its own
+ * inputs and keeps the results in a table indexed by those inputs. Only the final stage,
+ * a handful of multiplications, runs once per grid point.
+ */
+
+#include <cstddef>
+#include <vector>
+#include "linkbudget.h"
+
+/**
+ * @brief Values taken by each swept input.
+ *
+ * The grid is the Cartesian product of all axes. Results are stored row-major in the
+ * order of declaration: bandwidth varies slowest and path loss fastest.
+ */
+struct DLThroughputSweepAxes {
+    std::vector<double> bandwidth;  // in Hz
+    std::vector<int> numOfLayers;   // number of spatial layers
+    std::vector<int> prbCount;      // PRBs configured in the gNB
+    std::vector<int> numerology;
+    std::vector<double> txPower;    // total transmit power in dBm
+    std::vector<double> pathLoss;   // in dB
+};
+
+/**
+ * @brief Number of evaluations of each stage of a sweep.
+ */
+struct DLThroughputSweepStats {
+    std::size_t points = 0;                   // grid points, i.e. final stage evaluations
+    std::size_t thermalNoiseEvaluations = 0;
+    std::size_t txPowerPerLayerEvaluations = 0;
+    std::size_t totalLossEvaluations = 0;
+    std::size_t linkEvaluations = 0;          // SNR to CQI
+    std::size_t tbsEvaluations = 0;           // CQI to MCS and TBS
+    std::size_t prbEvaluations = 0;
+    std::size_t slotEvaluations = 0;
+};
+
+/**
+ * @brief Throughputs of every point of a sweep.
+ */
+struct DLThroughputSweepResult {
+    std::vector<double> throughput; // DL application throughput in kbps, see DLThroughputSweepAxes for the order
+    DLThroughputSweepStats stats;
+};
+
+/**
+ * @brief Get the number of points of a sweep.
+ *
+ * @param axes Swept values.
+ * @return The product of the axis sizes.
+ */
+std::size_t dlThroughputSweepSize(const DLThroughputSweepAxes& axes);
+
+/**
+ * @brief Get the position of a grid point in DLThroughputSweepResult::throughput.
+ *
+ * @param axes Swept values.
+ * @param bandwidth, numOfLayers, prbCount, numerology, txPower, pathLoss Index into each axis.
+ * @return Index of the point.
+ */
+std::size_t dlThroughputSweepIndex(const DLThroughputSweepAxes& axes, std::size_t bandwidth, std::size_t numOfLayers,
+                                   std::size_t prbCount, std::size_t numerology, std::size_t txPower,
+                                   std::size_t pathLoss);
+
+/**
+ * @brief Run the DL throughput chain for every point of a grid of inputs.
+ *
+ * Each throughput equals calculateDLThroughput() for the inputs of the point, with
+ * config.numerology replaced by the swept numerology.
+ *
+ * @param axes Swept values.
+ * @param config Parameters common to all points; numerology is taken from the axes.
+ * @param numThreads Number of threads to use, 0 for every hardware thread.
+ * @return Throughputs of all points, empty if any axis is empty.
+ */
+DLThroughputSweepResult runDLThroughputSweep(const DLThroughputSweepAxes& axes,
+                                             const DLThroughputConfig& config = DLThroughputConfig(),
+                                             unsigned int numThreads = 0);
+
+#endif // SWEEP_H
@@ -0,0 +1,153 @@
+#ifndef TBS_H
+#define TBS_H
+
+/**
+ * @file tbs.h
+ * @brief Transport block size determination over (N_RE, MCS index, layers).
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "utilities.h"
+
+/**
+ * @brief Largest number of REs a UE can be allocated: 156 REs per PRB over 275 PRBs.
+ */
+constexpr int maxTBSLookupREs = 156 * 275;
+
+/**
+ * @brief Largest number of spatial layers covered by the TBS lookup table.
+ */
+constexpr int maxTBSLookupLayers = 8;
+
+class TBSLookupTable;
+
+/**
+ * @brief Get Ninfo = N_RE * R * Qm * layers in units of 1/2048 bit.
+ *
+ * The code rates of every MCS table are multiples of 1/2 in units of 1/1024, so Ninfo is an
+ * exact integer in these units and the whole TBS procedure can run on integers.
+ *
+ * @param nRE Number of REs allocated to the UE.
+ * @param codeRate Code rate in units of 1/1024, a multiple of 1/2.
+ * @param modulationOrder Modulation order (Qm).
+ * @param numLayers Number of spatial layers.
+ * @return Ninfo times 2048.
+ */
+constexpr std::int64_t scaledNinfo(int nRE, double codeRate, int modulationOrder, int numLayers) {
+    return static_cast<std::int64_t>(codeRate * 2) * nRE * modulationOrder * numLayers;
+}
+
+/**
+ * @brief Determine the TBS for a given Ninfo with integer arithmetic only.
+ *
+ * Bit-exact with calculateTBSForNinfo(ninfo / 2048.0, codeRate), which takes the logarithms,
+ * powers of two and roundings of the procedure in double precision. Here they are a count of
+ * leading zeros, shifts and an integer division. A Ninfo of 0 gives 24 bits.
+ *
+ * @param ninfo Ninfo in units of 1/2048 bit, see scaledNinfo(); negative values count as 0.
+ * @param codeRate Code rate in units of 1/1024, as passed to calculateTBS().
+ * @return The TBS size in bits.
+ */
+int calculateTBSForScaledNinfo(std::int64_t ninfo, int codeRate);
+
+/**
+ * @brief Determine the TBS for arrays of Ninfo values with integer arithmetic only.
+ *
+ * @param ninfo Ninfo values in units of 1/2048 bit, see scaledNinfo().
+ * @param codeRate Code rates in units of 1/1024.
+ * @param tbs Output array receiving the TBS sizes in bits.
+ * @param count Number of values.
+ */
+void calculateTBSForScaledNinfoBatch(const std::int64_t* ninfo, const int* codeRate, int* tbs, std::size_t count);
+
+/**
+ * @brief Determine the TBS of a PDSCH allocation.
+ *
+ * Chains the MCS table, scaledNinfo() and calculateTBSForScaledNinfo(); gives the same
+ * result as calculateTBSForNinfo() with Ninfo = calculateNumberOfInformationBits() * layers.
+ *
+ * @param nRE Number of REs allocated to the UE.
+ * @param mcsIdx MCS index value in the MCS table.
+ * @param numLayers Number of spatial layers.
+ * @param table MCS table the index refers to.
+ * @return The TBS size in bits, 0 if the MCS index is invalid or nRE or numLayers is not positive.
+ */
+int determineTBS(int nRE, int mcsIdx, int numLayers, MCSTableId table = MCSTableId::Table2);
+
+/**
+ * @brief Determine the TBS of arrays of PDSCH allocations.
+ *
+ * Same results as determineTBS(), or as a lookup in @p lookupTable for the allocations
+ * it covers. Large arrays are spread over parallelThreadCount() threads.
+ *
+ * @param nRE Numbers of REs allocated to the UEs.
+ * @param mcsIdx MCS index values in the MCS table.
+ * @param numLayers Numbers of spatial layers.
+ * @param tbs Output array receiving the TBS sizes in bits.
+ * @param count Number of allocations.
+ * @param table MCS table the indices refer to.
+ * @param lookupTable Optional table built for @p table, used for the allocations it covers.
+ */
+void determineTBSBatch(const int* nRE, const int* mcsIdx, const int* numLayers, int* tbs, std::size_t count,
+                       MCSTableId table = MCSTableId::Table2, const TBSLookupTable* lookupTable = nullptr);
+
+/**
+ * @brief Precomputed TBS for every (N_RE, MCS index, layers) combination.
+ *
+ * Turns determineTBS() into a single indexed load. The full domain
+ * (maxTBSLookupREs x 28 MCS indices x maxTBSLookupLayers) takes about 38 MB for MCS table 2 and is
+ * built in parallel in roughly a second; smaller limits can be given when only
+ * part of the domain is needed.
+ */
+class TBSLookupTable {
+public:
+    /**
+     * @brief Build the table.
+     *
+     * @param maxREs Largest N_RE covered by the table.
+     * @param maxLayers Largest number of layers covered by the table.
+     * @param table MCS table the MCS indices refer to.
+     */
+    explicit TBSLookupTable(int maxREs = maxTBSLookupREs, int maxLayers = maxTBSLookupLayers,
+                            MCSTableId table = MCSTableId::Table2);
+
+    /**
+     * @brief Look up the TBS of an allocation.
+     *
+     * No bounds checking is done: nRE must be in [0, maxREs()], mcsIdx a valid
+     * MCS index and numLayers in [1, maxLayers()].
+     *
+     * @param nRE Number of REs allocated to the UE.
+     * @param mcsIdx MCS index value in the MCS table.
+     * @param numLayers Number of spatial layers.
+     * @return The TBS size in bits, as determineTBS() would return it.
+     */
+    int lookup(int nRE, int mcsIdx, int numLayers) const {
+        return static_cast<int>(table_[(static_cast<std::size_t>(numLayers - 1) * numMcs_ + mcsIdx) * rowLength_ + nRE]);
+    }
+
+    int maxREs() const { return maxREs_; }
+    int maxLayers() const { return maxLayers_; }
+    MCSTableId mcsTableId() const { return mcsTableId_; }
+
+private:
+    int maxREs_;
+    int maxLayers_;
+    MCSTableId mcsTableId_;
+    int numMcs_;
+    std::size_t rowLength_;
+    std::vector<std::uint32_t> table_;
+};
+
+/**
+ * @brief Get the process wide TBS lookup table over the full domain of MCS table 2.
+ *
+ * The table is built on first use.
+ *
+ * @return The shared table.
+ */
+const TBSLookupTable& defaultTBSLookupTable();
+
+#endif // TBS_H
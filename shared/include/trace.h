@@ -0,0 +1,122 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/**
+ * @file trace.h
+ * @brief Trace policies selected at compile time.
+ *
+ * Functions that report diagnostics or intermediate values take a trace policy as a
+ * template argument instead of a runtime flag. A policy is a class with static members:
+ *   - enabled: whether the policy records anything
+ *   - value(name, value, unit): report an intermediate value
+ *   - message(text): report a diagnostic
+ * Names, units and texts are stored by pointer and must be string literals.
+ *
+ * NoTrace has empty inline members, so an untraced instantiation compiles to the same code
+ * as a function without tracing. StreamTrace prints right away, values to std::cout and
+ * diagnostics to std::cerr. RingBufferTrace appends a record to a ring buffer owned by the
+ * calling thread, without locks or allocation; the records are written out by flushTrace(),
+ * or periodically by a background thread started with startTraceFlusher().
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+/**
+ * @brief Trace policy that records nothing.
+ */
+struct NoTrace {
+    static constexpr bool enabled = false;
+    static void value(const char*, double, const char* = "") {}
+    static void message(const char*) {}
+};
+
+/**
+ * @brief Trace policy printing values to std::cout and diagnostics to std::cerr.
+ *
+ * Values are printed as "name: value unit". Meant for the interactive utilities; the
+ * streams serialize concurrent callers.
+ */
+struct StreamTrace {
+    static constexpr bool enabled = true;
+    static void value(const char* name, double value, const char* unit = "");
+    static void message(const char* text);
+};
+
+/**
+ * @brief Trace policy recording into per-thread lock-free ring buffers.
+ *
+ * A thread only touches its own ring. When the ring is full the record is dropped and
+ * counted by droppedTraceRecords(), so a traced hot loop never waits for the flusher.
+ */
+struct RingBufferTrace {
+    static constexpr bool enabled = true;
+    static void value(const char* name, double value, const char* unit = "");
+    static void message(const char* text);
+};
+
+/**
+ * @brief Records held by the ring buffer of each thread.
+ */
+constexpr std::size_t traceRingCapacity = 4096;
+
+/**
+ * @brief One record of RingBufferTrace.
+ */
+struct TraceRecord {
+    std::uint64_t timestamp; // steady clock, in nanoseconds
+    std::uint32_t thread;    // ring the record was taken from, in order of first use by a thread
+    const char* name;        // name of the value, or text of the diagnostic
+    const char* unit;        // nullptr for a diagnostic
+    double value;
+};
+
+/**
+ * @brief Move every pending record out of the ring buffers.
+ *
+ * May run while other threads keep tracing. Records of one thread keep their order;
+ * records of different threads are grouped by thread.
+ *
+ * @param records Vector the records are appended to.
+ * @return Number of records appended.
+ */
+std::size_t drainTrace(std::vector<TraceRecord>& records);
+
+/**
+ * @brief Write every pending record to a stream, one line per record.
+ *
+ * Lines read "[thread] name: value unit" for values and "[thread] text" for diagnostics.
+ *
+ * @param out Output stream.
+ * @return Number of records written.
+ */
+std::size_t flushTrace(std::ostream& out);
+
+/**
+ * @brief Start a background thread calling flushTrace() periodically.
+ *
+ * Does nothing if the flusher is already running. A flusher still running when the program
+ * exits is stopped by the static destructors, after a last flush.
+ *
+ * @param out Output stream; must outlive the flusher, or the static destructors if it is
+ *            never stopped.
+ * @param interval Time between two flushes.
+ */
+void startTraceFlusher(std::ostream& out, std::chrono::milliseconds interval = std::chrono::milliseconds(50));
+
+/**
+ * @brief Stop the background flusher, after a last flush.
+ */
+void stopTraceFlusher();
+
+/**
+ * @brief Get the number of records dropped because a ring buffer was full.
+ *
+ * @return Dropped records since the start of the program.
+ */
+std::uint64_t droppedTraceRecords();
+
+#endif // TRACE_H
@@ -4,6 +4,10 @@
 /**
  * @file utilities.h
  * @brief Utility functions for telecommunications calculations.
+ *
+ * Functions with a Trace template argument report diagnostics and intermediate values
+ * through that policy. They are instantiated for NoTrace (the default), StreamTrace and
+ * RingBufferTrace.
  */
 
 #include <cmath>
@@ -16,15 +20,17 @@
 #include <sstream> // For string stream operations
 #include <iostream>
 #include "constants.h"
+#include "trace.h"
 
 /**
  * Calculates the wavelength of a signal given its frequency.
  * 
+ * @tparam Trace Trace policy, see trace.h.
  * @param frequency Frequency of the signal in hertz (Hz).
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Wavelength in meters (m).
  */
-double calculateWavelength(double frequency, bool logging=false);
+template <typename Trace = NoTrace>
+double calculateWavelength(double frequency);
 
 /**
  * @brief Calculate the frequency from wavelength.
@@ -32,21 +38,21 @@ double calculateWavelength(double frequency, bool logging=false);
  * Given the wavelength in meters, this function calculates the frequency in Hz
  * using the speed of light (c).
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param wavelength The wavelength in meters.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The frequency in Hz.
  */
-double calculateFrequencyFromWavelength(double wavelength, bool logging=false);
+template <typename Trace = NoTrace>
+double calculateFrequencyFromWavelength(double wavelength);
 
 /**
  * Calculates Shannon's Capacity given bandwidth and signal-to-noise ratio.
  * 
  * @param bandwidth The bandwidth in hertz (Hz).
  * @param snr The signal-to-noise ratio (dimensionless).
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Shannon's Capacity in bits per second (bps).
  */
-double calculateShannonsCapacity(double bandwidth, double snr, bool logging=false);
+double calculateShannonsCapacity(double bandwidth, double snr);
 
 /**
  * @brief Calculate the OFDM symbol duration.
@@ -55,12 +61,13 @@ double calculateShannonsCapacity(double bandwidth, double snr, bool logging=fals
  * calculates the Orthogonal Frequency-Division Multiplexing (OFDM)
  * symbol duration in microseconds.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param scs Subcarrier spacing in kHz.
  * @param useExtendedCP Flag to indicate whether extended CP needs to be considered or not
- * @param logging Boolean flag to enable or disable logging functionality
  * @return OFDM symbol duration in milliseconds.
  */
-double calculateOFDMSymbolDuration(double scs, bool useExtendedCP, bool logging=false);
+template <typename Trace = NoTrace>
+double calculateOFDMSymbolDuration(double scs, bool useExtendedCP);
 
 /**
  * @brief Calculate the number of subcarriers (Nsc).
@@ -68,12 +75,13 @@ double calculateOFDMSymbolDuration(double scs, bool useExtendedCP, bool logging=
  * Given the bandwidth in Hz and the subcarrier spacing (SCS) in kHz, 
  * this function calculates and returns the number of subcarriers.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param bandwidth The system bandwidth in Hz.
  * @param scs Subcarrier spacing in kHz.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The number of subcarriers (Nsc).
  */
-int calculateNumberOfSubcarriers(double bandwidth, double scs, bool logging=false);
+template <typename Trace = NoTrace>
+int calculateNumberOfSubcarriers(double bandwidth, double scs);
 
 /**
  * @brief Calculate the FFT size.
@@ -81,12 +89,13 @@ int calculateNumberOfSubcarriers(double bandwidth, double scs, bool logging=fals
  * Given the OFDM symbol duration in seconds and the sampling frequency in Hz,
  * this function calculates and returns the FFT size.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param symbolDuration OFDM symbol duration in seconds.
  * @param samplingFreq Sampling frequency in Hz.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The FFT size.
  */
-int calculateFFTSize(double symbolDuration, double samplingFreq, bool logging=false);
+template <typename Trace = NoTrace>
+int calculateFFTSize(double symbolDuration, double samplingFreq);
 
 /**
  * @brief Calculate the traffic density GkM.
@@ -97,10 +106,9 @@ int calculateFFTSize(double symbolDuration, double samplingFreq, bool logging=fa
  * @param spectralEfficiency Spectral efficiency in bits/second/Hz/cell.
  * @param cellularDensity Cellular density in cells per square kilometer.
  * @param bandwidth Bandwidth in Hz.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Traffic density (GkM) in bits/second/km^2.
  */
-double calculateTrafficDensity(double spectralEfficiency, double cellularDensity, double bandwidth, bool logging=false);
+double calculateTrafficDensity(double spectralEfficiency, double cellularDensity, double bandwidth);
 
 /**
  * @brief Calculate the Coherence Time (Tc).
@@ -108,12 +116,13 @@ double calculateTrafficDensity(double spectralEfficiency, double cellularDensity
  * Given the wavelength in meters and the speed of the wireless device in meters per second,
  * this function calculates the Coherence Time (Tc) in seconds.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param wavelength Wavelength in meters.
  * @param speed Speed of the wireless device in meters per second.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Coherence Time (Tc) in seconds.
  */
-double calculateCoherenceTime(double wavelength, double speed, bool logging=false);
+template <typename Trace = NoTrace>
+double calculateCoherenceTime(double wavelength, double speed);
 
 /**
  * @brief Calculate the Coherence Bandwidth (Bc).
@@ -121,39 +130,37 @@ double calculateCoherenceTime(double wavelength, double speed, bool logging=fals
  * Given the delay spread (Tdel) in seconds, this function calculates the Coherence Bandwidth (Bc) in Hz.
  * The formula used is Bc = 1/Tdel, assuming the delay spread is given in seconds.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param delaySpread Delay spread in seconds.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Coherence Bandwidth (Bc) in Hz.
  */
-double calculateCoherenceBandwidth(double delaySpread, bool logging=false);
+template <typename Trace = NoTrace>
+double calculateCoherenceBandwidth(double delaySpread);
 
 /**
  * @brief Calculate the slot size given numerology.
  *
  * @param n Numerology value.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Slot size in milliseconds.
  */
-double calculateSlotSize(int n, bool logging=false);
+double calculateSlotSize(int n);
 
 /**
  * @brief Calculate the number of slots per subframe.
  *
  * A subframe is 1 millisecond long.
  * @param slotSize Slot size in milliseconds.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Number of slots per subframe.
  */
-int calculateNumberOfSlots(double slotSize, bool logging=false);
+int calculateNumberOfSlots(double slotSize);
 
 /**
  * @brief Calculate the Subcarrier Spacing (SCS) given numerology.
  *
  * @param n Numerology value.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return SCS in Hz.
  */
-double calculateSCS(int n, bool logging=false);
+double calculateSCS(int n);
 
 /**
  * @brief Describe the QAM Modulation Scheme.
@@ -163,12 +170,13 @@ double calculateSCS(int n, bool logging=false);
  * The actual scaling factor for power normalization purposes should be calculated as 1/sqrt(sf),
  * where sf is the scaling factor computed here.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param M Modulation order (e.g., 16, 64, 256 for 16-QAM, 64-QAM, 256-QAM).
  * @param b Reference to a double to store the number of bits per QAM symbol.
  * @param sf Reference to a double to store the scaling factor.
- * @param logging Boolean flag to enable or disable logging functionality
  */
-void QamModulationSchemeDescriptor(int M, double& b, double& sf, bool logging=false);
+template <typename Trace = NoTrace>
+void QamModulationSchemeDescriptor(int M, double& b, double& sf);
 
 /**
  * @brief Determines the numerology given a Subcarrier Spacing (SCS).
@@ -196,10 +204,9 @@ int getNumerology(int scs);
  * @param pathLoss Path loss in dB.
  * @param shadowingLoss Shadowing loss in dB.
  * @param o2iLoss O2I loss in dB.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Total large-scale loss in dB.
  */
-double calculateLargeScaleTotalLoss(double pathLoss, double shadowingLoss, double o2iLoss, bool logging=false);
+double calculateLargeScaleTotalLoss(double pathLoss, double shadowingLoss, double o2iLoss);
 
 /**
  * @brief Calculate the transmitted power per layer in dBm.
@@ -211,10 +218,9 @@ double calculateLargeScaleTotalLoss(double pathLoss, double shadowingLoss, doubl
  *
  * @param txPower Total transmitted power in dBm
  * @param numOfLayers Number of spatial layers
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Transmitted power per layer in dBm.
  */
-double calculateTransmittedPowerPerLayer(double txPower, int numOfLayers, bool logging=false);
+double calculateTransmittedPowerPerLayer(double txPower, int numOfLayers);
 
 /**
  * @brief Calculate the received power per layer in dBm.
@@ -226,10 +232,9 @@ double calculateTransmittedPowerPerLayer(double txPower, int numOfLayers, bool l
  * @param txPowerPerLayer Transmitted power per layer in dBm.
  * @param totalLoss Total large-scale loss in dB.
  * @param bfGain Beamforming gain in dB.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Received power per layer in dBm.
  */
-double calculateReceivedPowerPerLayer(double txPowerPerLayer, double totalLoss, double bfGain, bool logging=false);
+double calculateReceivedPowerPerLayer(double txPowerPerLayer, double totalLoss, double bfGain);
 
 /**
  * @brief Calculate the thermal noise power.
@@ -241,10 +246,9 @@ double calculateReceivedPowerPerLayer(double txPowerPerLayer, double totalLoss,
  *
  * @param temperature Temperature in Kelvin.
  * @param bandwidth Bandwidth in Hz.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Thermal noise power in watts.
  */
-double calculateThermalNoisePower(double temperature, double bandwidth, bool logging=false);
+double calculateThermalNoisePower(double temperature, double bandwidth);
 
 /**
  * @brief Convert power from dBm to Watts.
@@ -255,10 +259,9 @@ double calculateThermalNoisePower(double temperature, double bandwidth, bool log
  * where P(dBm) is the power in dBm.
  *
  * @param dBm Power in dBm.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Power in Watts.
  */
-double dBmToWatts(double dBm, bool logging=false);
+double dBmToWatts(double dBm);
 
 /**
  * @brief Convert power from watts to dBm.
@@ -268,10 +271,9 @@ double dBmToWatts(double dBm, bool logging=false);
  * where P(W) is the power in Watts.
  * 
  * @param watts Power level in watts.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Power level in dBm.
  */
-double wattsToDbm(double watts, bool logging=false);
+double wattsToDbm(double watts);
 
 /**
  * @brief Calculate the Signal-to-Noise Ratio (SNR) in linear scale.
@@ -281,10 +283,9 @@ double wattsToDbm(double watts, bool logging=false);
  *
  * @param rxPower_dBm Received power in dBm.
  * @param thermalNoisePower_Watts Thermal noise power in watts.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return SNR in linear scale.
  */
-double calculateSNRLinear(double rxPower_dBm, double thermalNoisePower_Watts, bool logging=false);
+double calculateSNRLinear(double rxPower_dBm, double thermalNoisePower_Watts);
 
 /**
  * @brief Calculate the spectral efficiency per layer.
@@ -294,44 +295,79 @@ double calculateSNRLinear(double rxPower_dBm, double thermalNoisePower_Watts, bo
  * where SNR(linear) is the signal-to-noise ratio in linear scale.
  *
  * @param snrLinear Signal-to-Noise Ratio in linear scale.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Spectral efficiency per layer in bits/second/Hz.
  */
-double calculateSpectralEfficiencyPerLayer(double snrLinear, bool logging=false);
+double calculateSpectralEfficiencyPerLayer(double snrLinear);
 
 /**
  * @brief Calculate the intermediate spectral efficiency by referring CQI table.
  *
- * This function maps a given spectral efficiency to the closest CQI index in the CQI Table.
+ * This function maps a given spectral efficiency to the closest CQI index in the CQI Table
+ * (CQI table 2 of TS 38.214, up to 256QAM).
  * The spectral efficiency in CQI table corresponding to the chosen CQI index is considered as 
  * the intermediate spectral efficiency.
  *
  * @param spectralEfficiency Spectral efficiency in bits/second/Hz.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return A pair containing CQI Index and intermediate spectral efficiency in bits/second/Hz.
  */
-std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEfficiency, bool logging=false);
+std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEfficiency);
+
+/**
+ * @brief Calculate the intermediate spectral efficiency by referring the selected CQI table.
+ *
+ * @param spectralEfficiency Spectral efficiency in bits/second/Hz.
+ * @param table CQI table to use.
+ * @return A pair containing CQI Index and intermediate spectral efficiency in bits/second/Hz.
+ */
+std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEfficiency, CQITableId table);
 
 /**
  * @brief Determine Modulation Order (Qm) and MCS Code Rate (R) from the MCS table.
  *
- * This function searches the MCS table to find the entry that does not exceed the given spectral efficiency.
+ * This function searches the MCS table (MCS table 2 of TS 38.214, up to 256QAM) to find the entry
+ * that does not exceed the given spectral efficiency.
  * It returns the modulation order and code rate that correspond to the highest feasible spectral efficiency.
  *
  * @param spectralEfficiency The target spectral efficiency.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return A pair containing Modulation Order (Qm) and MCS Code Rate (R).
  */
-std::pair<int, double> determineModulationAndCodeRate(double spectralEfficiency, bool logging=false);
+std::pair<int, double> determineModulationAndCodeRate(double spectralEfficiency);
+
+/**
+ * @brief Determine Modulation Order (Qm) and MCS Code Rate (R) from the selected MCS table.
+ *
+ * @param spectralEfficiency The target spectral efficiency.
+ * @param table MCS table to use.
+ * @return A pair containing Modulation Order (Qm) and MCS Code Rate (R).
+ */
+std::pair<int, double> determineModulationAndCodeRate(double spectralEfficiency, MCSTableId table);
+
+/**
+ * @brief Determine the MCS index selected by determineModulationAndCodeRate().
+ *
+ * @param spectralEfficiency The target spectral efficiency.
+ * @param table MCS table to use.
+ * @return Index of the highest feasible entry in the MCS table.
+ */
+int determineMcsIndex(double spectralEfficiency, MCSTableId table = MCSTableId::Table2);
 
 /**
  * @brief Determine Modulation Order (Qm) and MCS Code Rate (R) from the MCS table.
  *
  * @param mcsIdx MCS index value in the MCS table
- * @param logging Boolean flag to enable or disable logging functionality
  * @return A pair containing Modulation Order (Qm) and MCS Code Rate (R).
  */
-std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx, bool logging=false);
+std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx);
+
+/**
+ * @brief Determine Modulation Order (Qm) and MCS Code Rate (R) from the selected MCS table.
+ *
+ * @param mcsIdx MCS index value in the MCS table
+ * @param table MCS table to use.
+ * @return A pair containing Modulation Order (Qm) and MCS Code Rate (R).
+ * @throws std::runtime_error if the MCS index is not in the table.
+ */
+std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx, MCSTableId table);
 
 /**
  * @brief Calculate the number of REs available for data transfer in a Resource Block.
@@ -344,10 +380,9 @@ std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx, b
  * @param numberOfSymbols Number of symbols per slot.
  * @param numberOfREsForDMRS Number of REs reserved for DMRS.
  * @param overheadFromHigherLayer Overhead REs configured by higher layer parameters.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The number of REs available for data.
  */
-int calculateAvailableREs(int numberOfSubcarriers, int numberOfSymbols, int numberOfREsForDMRS, int overheadFromHigherLayer, bool logging=false);
+int calculateAvailableREs(int numberOfSubcarriers, int numberOfSymbols, int numberOfREsForDMRS, int overheadFromHigherLayer);
 
 /**
  * @brief Calculate the actual number of REs available for data transfer.
@@ -358,10 +393,9 @@ int calculateAvailableREs(int numberOfSubcarriers, int numberOfSymbols, int numb
  *
  * @param availableREsPerRB Number of REs per RB available for data transfer.
  * @param numberOfAllocatedPRBs Number of allocated PRBs for the UE.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Actual total number of REs available for data transfer.
  */
-int calculateActualAvailableREs(int availableREsPerRB, int numberOfAllocatedPRBs, bool logging=false);
+int calculateActualAvailableREs(int availableREsPerRB, int numberOfAllocatedPRBs);
 
 /**
  * @brief Calculate the number of information bits.
@@ -375,10 +409,9 @@ int calculateActualAvailableREs(int availableREsPerRB, int numberOfAllocatedPRBs
  * @param N Total number of REs available for data transmission.
  * @param codeRate Code rate, provided as per 1024 units (e.g., 711 for a code rate of 711/1024).
  * @param modulationOrder Modulation order (Qm), e.g., 2 for QPSK, 4 for 16QAM, etc.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The number of information bits Ninfo.
  */
-double calculateNumberOfInformationBits(int N, double codeRate, int modulationOrder, bool logging=false);
+double calculateNumberOfInformationBits(int N, double codeRate, int modulationOrder);
 
 /**
  * @brief Calculate NinfoPrime based on Ninfo for Transport Block Size (TBS) determination.
@@ -392,10 +425,9 @@ double calculateNumberOfInformationBits(int N, double codeRate, int modulationOr
  * where n = [log2(Ninfo - 24)] - 5
  *
  * @param Ninfo Number of information bits calculated.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The NinfoPrime value for TBS determination.
  */
-int calculateNinfoPrime(double Ninfo, bool logging=false);
+int calculateNinfoPrime(double Ninfo);
 
 /**
  * @brief Find the TBS size for a given NinfoPrime using a predefined TBS table.
@@ -404,20 +436,31 @@ int calculateNinfoPrime(double Ninfo, bool logging=false);
  * than or equal to NinfoPrime. It returns the TBS value corresponding to that entry.
  *
  * @param NinfoPrime Calculated NinfoPrime value.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The TBS size that meets or exceeds NinfoPrime.
  */
-int findTBSForNinfoPrime(int NinfoPrime, bool logging=false);
+int findTBSForNinfoPrime(int NinfoPrime);
 
 /**
  * @brief Calculate the TBS size when Ninfo > 3824 using specified conditions.
  *
  * @param NinfoPrime Calculated NinfoPrime value.
  * @param codeRate Code rate, provided as per 1024 units (e.g., 711 for a code rate of 711/1024).
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The TBS size calculated based on the given conditions.
  */
-int calculateTBS(int NinfoPrime, int codeRate, bool logging=false);
+int calculateTBS(int NinfoPrime, int codeRate);
+
+/**
+ * @brief Determine the TBS size for a given Ninfo.
+ *
+ * Applies the TBS procedure used by the throughput calculators: NinfoPrime is derived
+ * with calculateNinfoPrime() and the TBS is looked up with findTBSForNinfoPrime() when
+ * Ninfo <= 3824, or calculated with calculateTBS() otherwise.
+ *
+ * @param Ninfo Number of information bits calculated.
+ * @param codeRate Code rate, provided as per 1024 units (e.g., 711 for a code rate of 711/1024).
+ * @return The TBS size in bits.
+ */
+int calculateTBSForNinfo(double Ninfo, int codeRate);
 
 /**
  * @brief Calculate total bits per PRB for multiple layers.
@@ -427,10 +470,9 @@ int calculateTBS(int NinfoPrime, int codeRate, bool logging=false);
  *
  * @param numLayers The number of layers.
  * @param tbsSize The TBS size used for each layer.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Total bits per PRB across all layers.
  */
-int calculateTotalBitsPerPrb(int numLayers, int tbsSize, bool logging=false);
+int calculateTotalBitsPerPrb(int numLayers, int tbsSize);
 
 /**
  * @brief Calculate the total number of Physical Resource Blocks (PRBs) available.
@@ -442,10 +484,9 @@ int calculateTotalBitsPerPrb(int numLayers, int tbsSize, bool logging=false);
  *
  * @param prbCount Total number of PRBs initially available.
  * @param downlinkOH Downlink overhead as a fraction of total PRBs (default is 0.18 for 18% overhead).
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Total number of PRBs available after accounting for overhead.
  */
-int calculateTotalPRBsAvailable(int prbCount, double downlinkOH = 0.18, bool logging=false);
+int calculateTotalPRBsAvailable(int prbCount, double downlinkOH = 0.18);
 
 /**
  * @brief Calculate the total number of bits per slot.
@@ -455,10 +496,9 @@ int calculateTotalPRBsAvailable(int prbCount, double downlinkOH = 0.18, bool log
  *
  * @param bitsPerPRB Number of bits per PRB.
  * @param totalPRBAvailable Total number of PRBs available.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Total number of bits per slot.
  */
-int calculateBitsPerSlot(int bitsPerPRB, int totalPRBAvailable, bool logging=false);
+int calculateBitsPerSlot(int bitsPerPRB, int totalPRBAvailable);
 
 /**
  * @brief Calculate Downlink Application Throughput.
@@ -467,28 +507,29 @@ int calculateBitsPerSlot(int bitsPerPRB, int totalPRBAvailable, bool logging=fal
  * the ratio of application packet size to MAC packet size. The DL MAC Throughput is given by:
  * DL MAC Throughput = (bitsPerSlot * DL Fraction) / slot time
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param bitsPerSlot Number of bits per slot.
  * @param dlFraction Fraction of downlink time usage.
  * @param slotTime Duration of a slot in seconds.
  * @param appPacketSize Application layer packet size in bits.
  * @param macPacketSize MAC layer packet size in bits.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Downlink Application Throughput in bits per second.
  */
-double calculateDLApplicationThroughput(int bitsPerSlot, double dlFraction, double slotTime, int appPacketSize, int macPacketSize, bool logging=false);
+template <typename Trace = NoTrace>
+double calculateDLApplicationThroughput(int bitsPerSlot, double dlFraction, double slotTime, int appPacketSize, int macPacketSize);
 
 /**
  * @brief Parse a DL:UL ratio string and compute the DL fraction.
  *
  * @param ratioStr The DL:UL ratio as a string, e.g., "4:1".
- * @param logging Boolean flag to enable or disable logging functionality
  * @return The DL fraction as a double.
  */
-double calculateDLFraction(const std::string& ratioStr, bool logging=false);
+double calculateDLFraction(const std::string& ratioStr);
 
 /**
  * @brief Calculate the 5G path loss based on the given parameters, using LOS path loss as baseline for NLOS comparison.
  *
+ * @tparam Trace Trace policy, see trace.h.
  * @param gNBAntennaHeight Height of the gNB antenna in meters.
  * @param ueHeight Height of the UE in meters.
  * @param fLow Lower frequency in MHz.
@@ -497,10 +538,10 @@ double calculateDLFraction(const std::string& ratioStr, bool logging=false);
  * @param buildingHeight Height of the building in meters (for NLOS scenarios).
  * @param streetWidth Width of the street in meters (for NLOS scenarios).
  * @param isLOS Boolean indicating if the scenario is Line of Sight.
- * @param logging Boolean flag to enable or disable logging functionality
  * @return Calculated path loss in dB.
  */
+template <typename Trace = NoTrace>
 double calculate5GPathLossRural(double gNBAntennaHeight, double ueHeight, double fLow, double fHigh, double distance2D, 
-                           double buildingHeight, double streetWidth, bool isLOS, bool logging=false);
+                           double buildingHeight, double streetWidth, bool isLOS);
                            
 #endif // UTILITIES_H
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include "batchstatus.h"
+#include "parallel.h"
+#include <algorithm>
+#include <bitset>
+#include <cmath>
+
+namespace {
+
+// Elements validated and computed at once; a multiple of 64 so that every chunk starts on
+// a word of the validity mask
+constexpr std::size_t statusChunkSize = dlThroughputBatchBlockSize;
+static_assert(statusChunkSize % 64 == 0, "status chunks must cover whole mask words");
+
+// Smallest number of rows of calculateDLThroughputBatchChecked() worth handing to another
+// thread; parallelGrain() returns multiples of it, so every thread owns whole mask words
+constexpr std::size_t checkedParallelGrain = 16 * statusChunkSize;
+
+// Writes the status of elements [begin, begin + n), begin being a multiple of 64, and
+// returns the number of invalid elements among them.
+std::size_t recordStatus(const BatchStatus& status, std::size_t begin, const BatchError* errors, std::size_t n) {
+    std::size_t invalid = 0;
+    for (std::size_t word = 0; word * 64 < n; ++word) {
+        std::uint64_t bits = 0;
+        std::size_t end = std::min<std::size_t>(64, n - word * 64);
+        for (std::size_t bit = 0; bit < end; ++bit) {
+            bits |= static_cast<std::uint64_t>(errors[word * 64 + bit] == BatchError::None) << bit;
+        }
+        invalid += end - std::bitset<64>(bits).count();
+        if (status.validMask) {
+            status.validMask[begin / 64 + word] = bits;
+        }
+    }
+    if (status.errors) {
+        std::copy(errors, errors + n, status.errors + begin);
+    }
+    return invalid;
+}
+
+template <typename T>
+void zeroInvalid(T* column, const BatchError* errors, std::size_t n) {
+    for (std::size_t i = 0; column && i < n; ++i) {
+        column[i] = errors[i] == BatchError::None ? column[i] : T();
+    }
+}
+
+void zeroInvalidRows(const DLThroughputBatchOutput& output, const BatchError* errors, std::size_t n) {
+    zeroInvalid(output.throughput, errors, n);
+    zeroInvalid(output.snrLinear, errors, n);
+    zeroInvalid(output.cqiIndex, errors, n);
+    zeroInvalid(output.mcsIndex, errors, n);
+    zeroInvalid(output.modulationOrder, errors, n);
+    zeroInvalid(output.codeRate, errors, n);
+    zeroInvalid(output.tbsSize, errors, n);
+}
+
+template <typename T>
+T* offsetColumn(T* column, std::size_t begin) {
+    return column ? column + begin : nullptr;
+}
+
+DLThroughputBatchOutput offsetOutput(const DLThroughputBatchOutput& output, std::size_t begin) {
+    DLThroughputBatchOutput result;
+    result.throughput = offsetColumn(output.throughput, begin);
+    result.snrLinear = offsetColumn(output.snrLinear, begin);
+    result.cqiIndex = offsetColumn(output.cqiIndex, begin);
+    result.mcsIndex = offsetColumn(output.mcsIndex, begin);
+    result.modulationOrder = offsetColumn(output.modulationOrder, begin);
+    result.codeRate = offsetColumn(output.codeRate, begin);
+    result.tbsSize = offsetColumn(output.tbsSize, begin);
+    return result;
+}
+
+bool isValidConfiguration(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                          const DLThroughputConfig& config) {
+    bool columns = output.throughput && input.pathLoss && input.txPower && input.numOfLayers &&
+                   input.prbCount && input.bandwidth;
+    bool values = config.numerology >= 0 && config.numerology <= 4 && config.applicationPacketSize > 0 &&
+                  config.macPacketSize > 0 && config.prbPerUE >= 0 && std::isfinite(config.dlFraction) &&
+                  std::isfinite(config.temperature) && std::isfinite(config.shadowingLoss) &&
+                  std::isfinite(config.o2iLoss) && std::isfinite(config.beamFormingGain) &&
+                  std::isfinite(config.downlinkOverhead);
+    return columns && values;
+}
+
+// Validates and computes rows [begin, begin + n) of calculateDLThroughputBatchChecked(),
+// n being at most statusChunkSize, and returns the number of invalid rows among them
+std::size_t checkedDLThroughputChunk(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                                     const BatchStatus& status, const DLThroughputConfig& config,
+                                     bool validConfiguration, std::size_t begin, std::size_t n) {
+    BatchError errors[statusChunkSize];
+    const DLThroughputBatchOutput chunkOutput = offsetOutput(output, begin);
+    if (!validConfiguration) {
+        std::fill(errors, errors + n, BatchError::InvalidConfiguration);
+        zeroInvalidRows(chunkOutput, errors, n);
+        return recordStatus(status, begin, errors, n);
+    }
+
+    // Invalid rows are replaced by harmless values, computed with the valid ones and zeroed afterwards
+    double pathLoss[statusChunkSize], txPower[statusChunkSize], bandwidth[statusChunkSize];
+    double shadowingLoss[statusChunkSize], o2iLoss[statusChunkSize];
+    int numOfLayers[statusChunkSize], prbCount[statusChunkSize];
+    for (std::size_t i = 0; i < n; ++i) {
+        std::size_t row = begin + i;
+        double shadowing = input.shadowingLoss ? input.shadowingLoss[row] : config.shadowingLoss;
+        double o2i = input.o2iLoss ? input.o2iLoss[row] : config.o2iLoss;
+        bool finite = std::isfinite(input.pathLoss[row]) && std::isfinite(input.txPower[row]) &&
+                      std::isfinite(input.bandwidth[row]) && std::isfinite(shadowing) && std::isfinite(o2i);
+        int layers = input.numOfLayers[row];
+        int prbs = input.prbCount[row];
+        BatchError error = BatchError::None;
+        error = input.bandwidth[row] > 0 ? error : BatchError::InvalidBandwidth;
+        error = prbs >= 0 && prbs <= maxNumOfPRBs ? error : BatchError::InvalidPrbCount;
+        error = layers >= 1 && layers <= maxNumOfLayers ? error : BatchError::InvalidLayerCount;
+        error = finite ? error : BatchError::NonFiniteInput;
+        bool valid = error == BatchError::None;
+        errors[i] = error;
+        pathLoss[i] = valid ? input.pathLoss[row] : 0.0;
+        txPower[i] = valid ? input.txPower[row] : 0.0;
+        bandwidth[i] = valid ? input.bandwidth[row] : 1.0;
+        shadowingLoss[i] = valid ? shadowing : 0.0;
+        o2iLoss[i] = valid ? o2i : 0.0;
+        numOfLayers[i] = valid ? layers : 1;
+        prbCount[i] = valid ? prbs : 0;
+    }
+
+    DLThroughputBatchInput chunkInput;
+    chunkInput.count = n;
+    chunkInput.pathLoss = pathLoss;
+    chunkInput.txPower = txPower;
+    chunkInput.numOfLayers = numOfLayers;
+    chunkInput.prbCount = prbCount;
+    chunkInput.bandwidth = bandwidth;
+    chunkInput.shadowingLoss = shadowingLoss;
+    chunkInput.o2iLoss = o2iLoss;
+    calculateDLThroughputBatch(chunkInput, chunkOutput, config);
+    zeroInvalidRows(chunkOutput, errors, n);
+    return recordStatus(status, begin, errors, n);
+}
+
+} // namespace
+
+const char* batchErrorMessage(BatchError error) noexcept {
+    switch (error) {
+        case BatchError::None:
+            return "No error";
+        case BatchError::InvalidConfiguration:
+            return "Invalid batch configuration";
+        case BatchError::NonFiniteInput:
+            return "Input is NaN or infinite";
+        case BatchError::UnsupportedSCS:
+            return "Unsupported SCS value";
+        case BatchError::InvalidMcsIndex:
+            return "Invalid MCS index";
+        case BatchError::InvalidLayerCount:
+            return "Invalid number of layers";
+        case BatchError::InvalidPrbCount:
+            return "Invalid PRB count";
+        case BatchError::InvalidBandwidth:
+            return "Bandwidth must be greater than 0 Hz";
+    }
+    return "Unknown error";
+}
+
+std::size_t countValidBatchElements(const std::uint64_t* validMask, std::size_t count) noexcept {
+    std::size_t valid = 0;
+    for (std::size_t word = 0; word < count / 64; ++word) {
+        valid += std::bitset<64>(validMask[word]).count();
+    }
+    if (count % 64) {
+        std::uint64_t tail = validMask[count / 64] & ((std::uint64_t(1) << (count % 64)) - 1);
+        valid += std::bitset<64>(tail).count();
+    }
+    return valid;
+}
+
+std::size_t getNumerologyBatch(const int* scs, int* numerology, std::size_t count,
+                               const BatchStatus& status) noexcept {
+    std::size_t invalid = 0;
+    BatchError errors[statusChunkSize];
+    for (std::size_t begin = 0; begin < count; begin += statusChunkSize) {
+        std::size_t n = std::min(statusChunkSize, count - begin);
+        for (std::size_t i = 0; i < n; ++i) {
+            // 15 kHz * 2^n for n in [0, 4]
+            int value = scs[begin + i];
+            int ratio = value / 15;
+            bool valid = value > 0 && value % 15 == 0 && ratio <= 16 && (ratio & (ratio - 1)) == 0;
+            numerology[begin + i] = valid ? (ratio > 1) + (ratio > 2) + (ratio > 4) + (ratio > 8) : 0;
+            errors[i] = valid ? BatchError::None : BatchError::UnsupportedSCS;
+        }
+        invalid += recordStatus(status, begin, errors, n);
+    }
+    return invalid;
+}
+
+std::size_t determineModulationAndCodeRateUsingMcsIndexBatch(const int* mcsIdx, int* modulationOrder, double* codeRate,
+                                                             std::size_t count, const BatchStatus& status,
+                                                             MCSTableId table) noexcept {
+    const ConstexprTable<MCSEntry> mcs = getMCSTable(table);
+    const int size = static_cast<int>(mcs.size());
+    std::size_t invalid = 0;
+    BatchError errors[statusChunkSize];
+    for (std::size_t begin = 0; begin < count; begin += statusChunkSize) {
+        std::size_t n = std::min(statusChunkSize, count - begin);
+        for (std::size_t i = 0; i < n; ++i) {
+            int index = mcsIdx[begin + i];
+            bool valid = index >= 0 && index < size;
+            const MCSEntry& entry = mcs[valid ? index : 0];
+            modulationOrder[begin + i] = valid ? entry.modulationOrder : 0;
+            codeRate[begin + i] = valid ? entry.mcsCodeRate : 0.0;
+            errors[i] = valid ? BatchError::None : BatchError::InvalidMcsIndex;
+        }
+        invalid += recordStatus(status, begin, errors, n);
+    }
+    return invalid;
+}
+
+std::size_t calculateDLThroughputBatchChecked(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                                              const BatchStatus& status, const DLThroughputConfig& config) {
+    const bool validConfiguration = isValidConfiguration(input, output, config);
+    // Nested in this loop, calculateDLThroughputBatch() runs on the thread of the chunk
+    return parallelReduce(input.count, parallelGrain(input.count, checkedParallelGrain), std::size_t(0),
+                          [&](std::size_t chunkBegin, std::size_t chunkEnd) {
+        std::size_t invalid = 0;
+        for (std::size_t begin = chunkBegin; begin < chunkEnd; begin += statusChunkSize) {
+            const std::size_t n = std::min(statusChunkSize, chunkEnd - begin);
+            invalid += checkedDLThroughputChunk(input, output, status, config, validConfiguration, begin, n);
+        }
+        return invalid;
+    }, [](std::size_t total, std::size_t partial) { return total + partial; });
+}
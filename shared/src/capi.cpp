@@ -0,0 +1,261 @@
+#include "5gutils.h"
+#include "batchstatus.h"
+#include "conversions.h"
+#include "linkbudget.h"
+#include "parallel.h"
+#include "pathloss.h"
+#include "tbs.h"
+#include <cstddef>
+
+// The int32_t columns of the interface are passed to the engines as int columns
+static_assert(sizeof(int) == sizeof(std::int32_t), "the C interface requires a 32 bit int");
+static_assert(sizeof(BatchError) == sizeof(std::uint8_t), "the C interface stores batch errors as bytes");
+
+namespace {
+
+// Size of version 1 of fiveg_dl_throughput_config; later versions only append fields
+constexpr std::size_t dlThroughputConfigV1Size = offsetof(fiveg_dl_throughput_config, downlinkOverhead) + sizeof(double);
+
+bool toAccuracy(int accuracy, ConversionAccuracy& result) {
+    switch (accuracy) {
+        case FIVEG_ACCURACY_FAST: result = ConversionAccuracy::Fast; return true;
+        case FIVEG_ACCURACY_STRICT: result = ConversionAccuracy::Strict; return true;
+        default: return false;
+    }
+}
+
+bool toCqiTable(int table, CQITableId& result) {
+    switch (table) {
+        case FIVEG_TABLE_1: result = CQITableId::Table1; return true;
+        case FIVEG_TABLE_2: result = CQITableId::Table2; return true;
+        case FIVEG_TABLE_3: result = CQITableId::Table3; return true;
+        default: return false;
+    }
+}
+
+bool toMcsTable(int table, MCSTableId& result) {
+    switch (table) {
+        case FIVEG_TABLE_1: result = MCSTableId::Table1; return true;
+        case FIVEG_TABLE_2: result = MCSTableId::Table2; return true;
+        case FIVEG_TABLE_3: result = MCSTableId::Table3; return true;
+        default: return false;
+    }
+}
+
+// Runs a conversion with one input column after checking its arguments
+template <typename Function>
+int convert(const double* in, double* out, std::size_t count, int accuracy, Function function) {
+    ConversionAccuracy acc;
+    if (!toAccuracy(accuracy, acc)) {
+        return FIVEG_ERROR_INVALID_ARGUMENT;
+    }
+    if (count == 0) {
+        return FIVEG_OK;
+    }
+    if (!in || !out) {
+        return FIVEG_ERROR_NULL_POINTER;
+    }
+    try {
+        function(in, out, count, acc);
+    } catch (...) {
+        return FIVEG_ERROR_INTERNAL;
+    }
+    return FIVEG_OK;
+}
+
+// Runs a conversion with two input columns after checking its arguments
+template <typename Function>
+int convert(const double* in1, const double* in2, double* out, std::size_t count, int accuracy, Function function) {
+    if (count != 0 && !in2) {
+        return FIVEG_ERROR_NULL_POINTER;
+    }
+    return convert(in1, out, count, accuracy, [&](const double* in, double* result, std::size_t n, ConversionAccuracy acc) {
+        function(in, in2, result, n, acc);
+    });
+}
+
+} // namespace
+
+extern "C" {
+
+int fiveg_api_version(void) {
+    return FIVEG_API_VERSION;
+}
+
+const char* fiveg_status_message(int status) {
+    switch (status) {
+        case FIVEG_OK: return "Success";
+        case FIVEG_ERROR_NULL_POINTER: return "Null pointer";
+        case FIVEG_ERROR_INVALID_ARGUMENT: return "Invalid argument";
+        case FIVEG_ERROR_INTERNAL: return "Internal error";
+        default: return "Unknown status";
+    }
+}
+
+unsigned int fiveg_set_num_threads(unsigned int numThreads) {
+    try {
+        return setParallelThreadCount(numThreads);
+    } catch (...) {
+        return parallelThreadCount();
+    }
+}
+
+int fiveg_dbm_to_watts(const double* dBm, double* watts, size_t count, int accuracy) {
+    return convert(dBm, watts, count, accuracy, [](const double* in, double* out, std::size_t n, ConversionAccuracy acc) {
+        dBmToWattsBatch(in, out, n, acc);
+    });
+}
+
+int fiveg_watts_to_dbm(const double* watts, double* dBm, size_t count, int accuracy) {
+    return convert(watts, dBm, count, accuracy, [](const double* in, double* out, std::size_t n, ConversionAccuracy acc) {
+        wattsToDbmBatch(in, out, n, acc);
+    });
+}
+
+int fiveg_snr_linear(const double* rxPower_dBm, const double* thermalNoisePower_Watts, double* snrLinear,
+                     size_t count, int accuracy) {
+    return convert(rxPower_dBm, thermalNoisePower_Watts, snrLinear, count, accuracy,
+                   [](const double* rx, const double* noise, double* out, std::size_t n, ConversionAccuracy acc) {
+                       calculateSNRLinearBatch(rx, noise, out, n, acc);
+                   });
+}
+
+int fiveg_spectral_efficiency(const double* snrLinear, double* spectralEfficiency, size_t count, int accuracy) {
+    return convert(snrLinear, spectralEfficiency, count, accuracy,
+                   [](const double* in, double* out, std::size_t n, ConversionAccuracy acc) {
+                       calculateSpectralEfficiencyPerLayerBatch(in, out, n, acc);
+                   });
+}
+
+int fiveg_shannon_capacity(const double* bandwidth, const double* snrLinear, double* capacity, size_t count,
+                           int accuracy) {
+    return convert(bandwidth, snrLinear, capacity, count, accuracy,
+                   [](const double* bw, const double* snr, double* out, std::size_t n, ConversionAccuracy acc) {
+                       calculateShannonsCapacityBatch(bw, snr, out, n, acc);
+                   });
+}
+
+int fiveg_pathloss_rural(const fiveg_rural_site* site, const double* distance2D, const double* ueHeight, int isLOS,
+                         double* pathLoss, size_t count) {
+    if (!site || (count != 0 && (!distance2D || !ueHeight || !pathLoss))) {
+        return FIVEG_ERROR_NULL_POINTER;
+    }
+    try {
+        const RuralPathLossSite model = makeRuralPathLossSite(site->gNBAntennaHeight, site->fLow, site->fHigh,
+                                                              site->buildingHeight, site->streetWidth);
+        calculate5GPathLossRuralBatch(model, distance2D, ueHeight, isLOS != 0, pathLoss, count);
+    } catch (...) {
+        return FIVEG_ERROR_INTERNAL;
+    }
+    return FIVEG_OK;
+}
+
+int fiveg_determine_tbs(const int32_t* nRE, const int32_t* mcsIndex, const int32_t* numLayers, int32_t* tbs,
+                        size_t count, int mcsTable) {
+    MCSTableId table;
+    if (!toMcsTable(mcsTable, table)) {
+        return FIVEG_ERROR_INVALID_ARGUMENT;
+    }
+    if (count != 0 && (!nRE || !mcsIndex || !numLayers || !tbs)) {
+        return FIVEG_ERROR_NULL_POINTER;
+    }
+    try {
+        determineTBSBatch(nRE, mcsIndex, numLayers, tbs, count, table);
+    } catch (...) {
+        return FIVEG_ERROR_INTERNAL;
+    }
+    return FIVEG_OK;
+}
+
+void fiveg_dl_throughput_config_init(fiveg_dl_throughput_config* config) {
+    if (!config) {
+        return;
+    }
+    const DLThroughputConfig defaults;
+    config->size = sizeof(fiveg_dl_throughput_config);
+    config->dlFraction = defaults.dlFraction;
+    config->applicationPacketSize = defaults.applicationPacketSize;
+    config->macPacketSize = defaults.macPacketSize;
+    config->numerology = defaults.numerology;
+    config->prbPerUE = defaults.prbPerUE;
+    config->numOfSymbolsPerSlot = defaults.numOfSymbolsPerSlot;
+    config->numOfREsForDMRS = defaults.numOfREsForDMRS;
+    config->numOfOverheadREs = defaults.numOfOverheadREs;
+    config->cqiTable = FIVEG_TABLE_1 + static_cast<int32_t>(defaults.cqiTableId);
+    config->mcsTable = FIVEG_TABLE_1 + static_cast<int32_t>(defaults.mcsTableId);
+    config->accuracy = defaults.conversionAccuracy == ConversionAccuracy::Fast ? FIVEG_ACCURACY_FAST
+                                                                               : FIVEG_ACCURACY_STRICT;
+    config->temperature = defaults.temperature;
+    config->shadowingLoss = defaults.shadowingLoss;
+    config->o2iLoss = defaults.o2iLoss;
+    config->beamFormingGain = defaults.beamFormingGain;
+    config->downlinkOverhead = defaults.downlinkOverhead;
+}
+
+int fiveg_dl_throughput(const fiveg_dl_throughput_config* config, const fiveg_dl_throughput_input* input,
+                        const fiveg_dl_throughput_output* output, size_t count, size_t* numInvalid) {
+    if (!input || !output) {
+        return FIVEG_ERROR_NULL_POINTER;
+    }
+    DLThroughputConfig engineConfig;
+    if (config) {
+        if (config->size < dlThroughputConfigV1Size || !toCqiTable(config->cqiTable, engineConfig.cqiTableId) ||
+            !toMcsTable(config->mcsTable, engineConfig.mcsTableId) ||
+            !toAccuracy(config->accuracy, engineConfig.conversionAccuracy)) {
+            return FIVEG_ERROR_INVALID_ARGUMENT;
+        }
+        engineConfig.dlFraction = config->dlFraction;
+        engineConfig.applicationPacketSize = config->applicationPacketSize;
+        engineConfig.macPacketSize = config->macPacketSize;
+        engineConfig.numerology = config->numerology;
+        engineConfig.prbPerUE = config->prbPerUE;
+        engineConfig.numOfSymbolsPerSlot = config->numOfSymbolsPerSlot;
+        engineConfig.numOfREsForDMRS = config->numOfREsForDMRS;
+        engineConfig.numOfOverheadREs = config->numOfOverheadREs;
+        engineConfig.temperature = config->temperature;
+        engineConfig.shadowingLoss = config->shadowingLoss;
+        engineConfig.o2iLoss = config->o2iLoss;
+        engineConfig.beamFormingGain = config->beamFormingGain;
+        engineConfig.downlinkOverhead = config->downlinkOverhead;
+    }
+    if (count != 0 && (!input->pathLoss || !input->txPower || !input->numOfLayers || !input->prbCount ||
+                       !input->bandwidth || !output->throughput)) {
+        return FIVEG_ERROR_NULL_POINTER;
+    }
+
+    DLThroughputBatchInput columns;
+    columns.count = count;
+    columns.pathLoss = input->pathLoss;
+    columns.txPower = input->txPower;
+    columns.numOfLayers = input->numOfLayers;
+    columns.prbCount = input->prbCount;
+    columns.bandwidth = input->bandwidth;
+    columns.shadowingLoss = input->shadowingLoss;
+    columns.o2iLoss = input->o2iLoss;
+
+    DLThroughputBatchOutput results;
+    results.throughput = output->throughput;
+    results.snrLinear = output->snrLinear;
+    results.cqiIndex = output->cqiIndex;
+    results.mcsIndex = output->mcsIndex;
+    results.modulationOrder = output->modulationOrder;
+    results.codeRate = output->codeRate;
+    results.tbsSize = output->tbsSize;
+
+    BatchStatus status;
+    status.validMask = output->validMask;
+    status.errors = reinterpret_cast<BatchError*>(output->errors);
+
+    std::size_t invalid;
+    try {
+        invalid = calculateDLThroughputBatchChecked(columns, results, status, engineConfig);
+    } catch (...) {
+        return FIVEG_ERROR_INTERNAL;
+    }
+    if (numInvalid) {
+        *numInvalid = invalid;
+    }
+    return FIVEG_OK;
+}
+
+} // extern "C"
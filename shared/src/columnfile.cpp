@@ -0,0 +1,383 @@
+#include "columnfile.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::is_same<std::int32_t, int>::value, "int32 columns are passed to the engines as int arrays");
+
+namespace {
+
+constexpr char columnMagic[8] = {'5', 'G', 'C', 'O', 'L', 'U', 'M', 'N'};
+constexpr std::uint32_t columnVersion = 1;
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+constexpr std::size_t columnAlignment = 64;
+constexpr std::size_t maxNameLength = 47;
+
+// Rows per engine call of the file drivers: large enough to keep every thread busy, small
+// enough for the blocks to stream out while the next ones are computed
+constexpr std::size_t columnBlockRows = 1 << 20;
+
+struct Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint64_t numRows;
+    std::uint32_t numColumns;
+    std::uint32_t reserved;
+    std::uint64_t fileSize;
+    char padding[24];
+};
+
+struct DirectoryEntry {
+    char name[48];
+    std::uint32_t type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+};
+
+static_assert(sizeof(Header) == 64 && sizeof(DirectoryEntry) == 64, "unexpected padding of the file layout");
+
+std::size_t elementSize(std::uint32_t type) {
+    return type == static_cast<std::uint32_t>(ColumnType::Float64) ? sizeof(double)
+         : type == static_cast<std::uint32_t>(ColumnType::Int32) ? sizeof(std::int32_t) : 0;
+}
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+template <typename T>
+T* advance(T* column, std::size_t rows) {
+    return column ? column + rows : nullptr;
+}
+
+// Row range [beginRow, endRow) of a column, starting on a page boundary of the mapping
+void pageRange(std::size_t offset, std::size_t size, std::size_t beginRow, std::size_t endRow,
+               std::size_t& pageBegin, std::size_t& pageEnd) {
+    static const std::size_t pageSize = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    pageBegin = (offset + beginRow * size) / pageSize * pageSize;
+    pageEnd = offset + endRow * size;
+}
+
+} // namespace
+
+ColumnFile::~ColumnFile() {
+    close();
+}
+
+bool ColumnFile::open(const std::string& path) {
+    close();
+    int file = ::open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        return false;
+    }
+    struct stat status;
+    if (::fstat(file, &status) != 0) {
+        int error = errno;
+        ::close(file);
+        errno = error;
+        return false;
+    }
+    const std::size_t size = static_cast<std::size_t>(status.st_size);
+    if (size < sizeof(Header)) {
+        ::close(file);
+        errno = EINVAL;
+        return false;
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, file, 0);
+    int error = errno;
+    ::close(file); // the mapping keeps the file open
+    if (mapping == MAP_FAILED) {
+        errno = error;
+        return false;
+    }
+    mapping_ = mapping;
+    mappingSize_ = size;
+
+    const Header& header = *static_cast<const Header*>(mapping);
+    bool valid = std::memcmp(header.magic, columnMagic, sizeof(columnMagic)) == 0 &&
+                 header.version == columnVersion && header.byteOrder == byteOrderMark && header.fileSize == size &&
+                 header.numColumns <= (size - sizeof(Header)) / sizeof(DirectoryEntry);
+    const DirectoryEntry* directory = reinterpret_cast<const DirectoryEntry*>(&header + 1);
+    for (std::uint32_t c = 0; valid && c < header.numColumns; ++c) {
+        const DirectoryEntry& entry = directory[c];
+        const std::size_t element = elementSize(entry.type);
+        valid = element != 0 && std::memchr(entry.name, '\0', sizeof(entry.name)) != nullptr &&
+                entry.offset % columnAlignment == 0 && entry.offset <= size &&
+                header.numRows <= (size - entry.offset) / element;
+        if (valid) {
+            Column column;
+            column.name = entry.name;
+            column.type = static_cast<ColumnType>(entry.type);
+            column.data = static_cast<const char*>(mapping) + entry.offset;
+            columns_.push_back(column);
+        }
+    }
+    if (!valid) {
+        close();
+        errno = EINVAL;
+        return false;
+    }
+    numRows_ = static_cast<std::size_t>(header.numRows);
+    ::madvise(mapping_, mappingSize_, MADV_SEQUENTIAL);
+    return true;
+}
+
+void ColumnFile::close() {
+    if (mapping_) {
+        ::munmap(mapping_, mappingSize_);
+    }
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    numRows_ = 0;
+    columns_.clear();
+}
+
+const void* ColumnFile::find(const std::string& name, ColumnType type) const {
+    for (const Column& column : columns_) {
+        if (column.name == name && column.type == type) {
+            return column.data;
+        }
+    }
+    return nullptr;
+}
+
+const double* ColumnFile::float64(const std::string& name) const {
+    return static_cast<const double*>(find(name, ColumnType::Float64));
+}
+
+const std::int32_t* ColumnFile::int32(const std::string& name) const {
+    return static_cast<const std::int32_t*>(find(name, ColumnType::Int32));
+}
+
+ColumnFileWriter::~ColumnFileWriter() {
+    close();
+}
+
+bool ColumnFileWriter::create(const std::string& path, std::size_t numRows, const std::vector<ColumnSpec>& columns) {
+    close();
+    std::vector<Column> layout;
+    std::size_t size = alignUp(sizeof(Header) + columns.size() * sizeof(DirectoryEntry), columnAlignment);
+    for (const ColumnSpec& spec : columns) {
+        const std::size_t element = elementSize(static_cast<std::uint32_t>(spec.type));
+        bool repeated = std::any_of(layout.begin(), layout.end(),
+                                    [&](const Column& column) { return column.name == spec.name; });
+        if (element == 0 || spec.name.empty() || spec.name.size() > maxNameLength || repeated) {
+            errno = EINVAL;
+            return false;
+        }
+        layout.push_back({spec.name, spec.type, size});
+        size = alignUp(size + numRows * element, columnAlignment);
+    }
+
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) {
+        return false;
+    }
+    // The file is sparse until written, so creating it takes the same time for any size
+    void* mapping = MAP_FAILED;
+    if (::ftruncate(file, static_cast<off_t>(size)) == 0) {
+        mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    }
+    if (mapping == MAP_FAILED) {
+        int error = errno;
+        ::close(file);
+        errno = error;
+        return false;
+    }
+    file_ = file;
+    mapping_ = mapping;
+    mappingSize_ = size;
+    numRows_ = numRows;
+    columns_ = layout;
+
+    Header& header = *static_cast<Header*>(mapping_);
+    std::memcpy(header.magic, columnMagic, sizeof(columnMagic));
+    header.version = columnVersion;
+    header.byteOrder = byteOrderMark;
+    header.numRows = numRows;
+    header.numColumns = static_cast<std::uint32_t>(columns_.size());
+    header.fileSize = size;
+    DirectoryEntry* directory = reinterpret_cast<DirectoryEntry*>(&header + 1);
+    for (std::size_t c = 0; c < columns_.size(); ++c) {
+        std::memcpy(directory[c].name, columns_[c].name.c_str(), columns_[c].name.size() + 1);
+        directory[c].type = static_cast<std::uint32_t>(columns_[c].type);
+        directory[c].offset = columns_[c].offset;
+    }
+    return true;
+}
+
+bool ColumnFileWriter::flush(std::size_t beginRow, std::size_t endRow) {
+    endRow = std::min(endRow, numRows_);
+    if (!mapping_ || beginRow >= endRow) {
+        return true;
+    }
+    for (const Column& column : columns_) {
+        std::size_t pageBegin, pageEnd;
+        pageRange(column.offset, elementSize(static_cast<std::uint32_t>(column.type)), beginRow, endRow,
+                  pageBegin, pageEnd);
+#ifdef __linux__
+        // Starts the write back without waiting for it; MS_ASYNC does nothing on Linux
+        if (::sync_file_range(file_, static_cast<off_t>(pageBegin), static_cast<off_t>(pageEnd - pageBegin),
+                              SYNC_FILE_RANGE_WRITE) != 0) {
+            return false;
+        }
+#else
+        if (::msync(static_cast<char*>(mapping_) + pageBegin, pageEnd - pageBegin, MS_ASYNC) != 0) {
+            return false;
+        }
+#endif
+    }
+    return true;
+}
+
+bool ColumnFileWriter::close() {
+    if (!mapping_) {
+        return true;
+    }
+    bool ok = ::msync(mapping_, mappingSize_, MS_SYNC) == 0;
+    int error = errno;
+    ::munmap(mapping_, mappingSize_);
+    ok = ::close(file_) == 0 && ok;
+    if (!ok) {
+        errno = error;
+    }
+    file_ = -1;
+    mapping_ = nullptr;
+    mappingSize_ = 0;
+    numRows_ = 0;
+    columns_.clear();
+    return ok;
+}
+
+void* ColumnFileWriter::find(const std::string& name, ColumnType type) {
+    for (const Column& column : columns_) {
+        if (column.name == name && column.type == type) {
+            return static_cast<char*>(mapping_) + column.offset;
+        }
+    }
+    return nullptr;
+}
+
+double* ColumnFileWriter::float64(const std::string& name) {
+    return static_cast<double*>(find(name, ColumnType::Float64));
+}
+
+std::int32_t* ColumnFileWriter::int32(const std::string& name) {
+    return static_cast<std::int32_t*>(find(name, ColumnType::Int32));
+}
+
+bool mapDLThroughputInput(const ColumnFile& file, DLThroughputBatchInput& input) {
+    input.count = file.numRows();
+    input.pathLoss = file.float64("pathLoss");
+    input.txPower = file.float64("txPower");
+    input.numOfLayers = file.int32("numOfLayers");
+    input.prbCount = file.int32("prbCount");
+    input.bandwidth = file.float64("bandwidth");
+    input.shadowingLoss = file.float64("shadowingLoss");
+    input.o2iLoss = file.float64("o2iLoss");
+    return input.pathLoss && input.txPower && input.numOfLayers && input.prbCount && input.bandwidth;
+}
+
+std::vector<ColumnSpec> dlThroughputOutputColumns(bool intermediates) {
+    std::vector<ColumnSpec> columns = {{"throughput", ColumnType::Float64}};
+    if (intermediates) {
+        columns.push_back({"snrLinear", ColumnType::Float64});
+        columns.push_back({"cqiIndex", ColumnType::Int32});
+        columns.push_back({"mcsIndex", ColumnType::Int32});
+        columns.push_back({"modulationOrder", ColumnType::Int32});
+        columns.push_back({"codeRate", ColumnType::Float64});
+        columns.push_back({"tbsSize", ColumnType::Int32});
+    }
+    return columns;
+}
+
+DLThroughputBatchOutput mapDLThroughputOutput(ColumnFileWriter& file) {
+    DLThroughputBatchOutput output;
+    output.throughput = file.float64("throughput");
+    output.snrLinear = file.float64("snrLinear");
+    output.cqiIndex = file.int32("cqiIndex");
+    output.mcsIndex = file.int32("mcsIndex");
+    output.modulationOrder = file.int32("modulationOrder");
+    output.codeRate = file.float64("codeRate");
+    output.tbsSize = file.int32("tbsSize");
+    return output;
+}
+
+bool calculateDLThroughputColumns(const std::string& inputPath, const std::string& outputPath,
+                                  const DLThroughputConfig& config, bool intermediates) {
+    ColumnFile in;
+    DLThroughputBatchInput input;
+    if (!in.open(inputPath)) {
+        return false;
+    }
+    if (!mapDLThroughputInput(in, input)) {
+        errno = EINVAL;
+        return false;
+    }
+    ColumnFileWriter out;
+    if (!out.create(outputPath, in.numRows(), dlThroughputOutputColumns(intermediates))) {
+        return false;
+    }
+    const DLThroughputBatchOutput output = mapDLThroughputOutput(out);
+
+    for (std::size_t begin = 0; begin < in.numRows(); begin += columnBlockRows) {
+        DLThroughputBatchInput blockInput;
+        blockInput.count = std::min(columnBlockRows, in.numRows() - begin);
+        blockInput.pathLoss = input.pathLoss + begin;
+        blockInput.txPower = input.txPower + begin;
+        blockInput.numOfLayers = input.numOfLayers + begin;
+        blockInput.prbCount = input.prbCount + begin;
+        blockInput.bandwidth = input.bandwidth + begin;
+        blockInput.shadowingLoss = advance(input.shadowingLoss, begin);
+        blockInput.o2iLoss = advance(input.o2iLoss, begin);
+
+        DLThroughputBatchOutput blockOutput;
+        blockOutput.throughput = output.throughput + begin;
+        blockOutput.snrLinear = advance(output.snrLinear, begin);
+        blockOutput.cqiIndex = advance(output.cqiIndex, begin);
+        blockOutput.mcsIndex = advance(output.mcsIndex, begin);
+        blockOutput.modulationOrder = advance(output.modulationOrder, begin);
+        blockOutput.codeRate = advance(output.codeRate, begin);
+        blockOutput.tbsSize = advance(output.tbsSize, begin);
+
+        calculateDLThroughputBatch(blockInput, blockOutput, config);
+        if (!out.flush(begin, begin + blockInput.count)) {
+            return false;
+        }
+    }
+    return out.close();
+}
+
+bool calculate5GPathLossRuralColumns(const RuralPathLossSite& site, bool isLOS, const std::string& inputPath,
+                                     const std::string& outputPath) {
+    ColumnFile in;
+    if (!in.open(inputPath)) {
+        return false;
+    }
+    const double* distance2D = in.float64("distance2D");
+    const double* ueHeight = in.float64("ueHeight");
+    if (!distance2D || !ueHeight) {
+        errno = EINVAL;
+        return false;
+    }
+    ColumnFileWriter out;
+    if (!out.create(outputPath, in.numRows(), {{"pathLoss", ColumnType::Float64}})) {
+        return false;
+    }
+    double* pathLoss = out.float64("pathLoss");
+
+    for (std::size_t begin = 0; begin < in.numRows(); begin += columnBlockRows) {
+        const std::size_t count = std::min(columnBlockRows, in.numRows() - begin);
+        calculate5GPathLossRuralBatch(site, distance2D + begin, ueHeight + begin, isLOS, pathLoss + begin, count);
+        if (!out.flush(begin, begin + count)) {
+            return false;
+        }
+    }
+    return out.close();
+}
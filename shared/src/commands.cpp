@@ -0,0 +1,827 @@
+#include "commands.h"
+#include "columnfile.h"
+#include "linkbudget.h"
+#include "numerology.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t streamBlockSize = 1 << 16;
+constexpr std::size_t columnBlockRecords = 4096;
+
+// Largest number of information bits the int based TBS steps handle
+constexpr double maxInformationBits = 1e9;
+
+bool isInteger(double value) {
+    return value == std::floor(value) && std::fabs(value) < 1e9;
+}
+
+bool isSupportedSCS(double scs) {
+    return scs == 15 || scs == 30 || scs == 60 || scs == 120 || scs == 240;
+}
+
+// Table of an optional table input: 1 to 3 for tables 1 to 3, 0 when omitted for the default table 2
+bool tableIndex(double value, int& table) {
+    if (value != 0 && value != 1 && value != 2 && value != 3) {
+        return false;
+    }
+    table = value == 0 ? 1 : static_cast<int>(value) - 1;
+    return true;
+}
+
+bool isNumerology(double n) {
+    return isInteger(n) && n >= 0 && n <= maxNumerology;
+}
+
+bool wavelength(const double* in, double* out) {
+    if (in[0] <= 0) {
+        return false;
+    }
+    out[0] = calculateWavelength(in[0]);
+    return true;
+}
+
+bool frequency(const double* in, double* out) {
+    if (in[0] <= 0) {
+        return false;
+    }
+    out[0] = calculateFrequencyFromWavelength(in[0]);
+    return true;
+}
+
+bool shannonsCapacity(const double* in, double* out) {
+    if (in[0] <= 0 || in[1] < 0) {
+        return false;
+    }
+    out[0] = calculateShannonsCapacity(in[0], in[1]);
+    return true;
+}
+
+bool ofdmSymbolDuration(const double* in, double* out) {
+    if (!isSupportedSCS(in[0])) {
+        return false;
+    }
+    out[0] = calculateOFDMSymbolDuration(in[0], in[1] != 0);
+    return true;
+}
+
+// Numerology of a supported SCS, -1 otherwise
+int numerologyOfSCS(double scs) {
+    return scs == 15 ? 0 : scs == 30 ? 1 : scs == 60 ? 2 : scs == 120 ? 3 : scs == 240 ? 4 : -1;
+}
+
+// Symbol durations of the records of one numerology
+struct OFDMSymbolDurationGroup {
+    const double* in;
+    double* out;
+    const std::size_t* indices;
+    std::size_t count;
+
+    template <int Mu>
+    void operator()(NumerologyConstant<Mu>) const {
+        for (std::size_t k = 0; k < count; ++k) {
+            const std::size_t i = indices[k] * maxCommandFields;
+            out[i] = calculateOFDMSymbolDuration<Mu>(in[i + 1] != 0);
+        }
+    }
+};
+
+// Same records as ofdmSymbolDuration(), grouped by numerology
+void ofdmSymbolDurationBatch(const double* in, double* out, bool* valid, std::size_t count) {
+    std::vector<int> numerology(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        numerology[i] = numerologyOfSCS(in[i * maxCommandFields]);
+        valid[i] = numerology[i] >= 0;
+    }
+    NumerologyGroups groups;
+    groupByNumerology(numerology.data(), count, groups);
+    for (int mu = 0; mu <= maxNumerology; ++mu) {
+        if (groups.size(mu) > 0) {
+            dispatchNumerology(mu, OFDMSymbolDurationGroup{in, out, groups.group(mu), groups.size(mu)});
+        }
+    }
+}
+
+bool numberOfSubcarriers(const double* in, double* out) {
+    if (in[0] <= 0 || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateNumberOfSubcarriers(in[0], in[1]);
+    return true;
+}
+
+bool fftSize(const double* in, double* out) {
+    if (in[0] <= 0 || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateFFTSize(in[0], in[1]);
+    return true;
+}
+
+bool trafficDensity(const double* in, double* out) {
+    if (in[0] < 0 || in[1] < 0 || in[2] < 0) {
+        return false;
+    }
+    out[0] = calculateTrafficDensity(in[0], in[1], in[2]);
+    return true;
+}
+
+bool coherenceTime(const double* in, double* out) {
+    if (in[0] <= 0 || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateCoherenceTime(in[0], in[1]);
+    return true;
+}
+
+bool coherenceBandwidth(const double* in, double* out) {
+    if (in[0] <= 0) {
+        return false;
+    }
+    out[0] = calculateCoherenceBandwidth(in[0]);
+    return true;
+}
+
+bool frameStructure(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[0] < 0 || in[0] > 4) {
+        return false;
+    }
+    int n = static_cast<int>(in[0]);
+    double slotSize = calculateSlotSize(n);
+    double scs = calculateSCS(n);
+    out[0] = calculateOFDMSymbolDuration(scs, false);
+    out[1] = slotSize;
+    out[2] = calculateNumberOfSlots(slotSize);
+    out[3] = scs;
+    out[4] = numOfSCsPerRB * scs;
+    return true;
+}
+
+// Same records as frameStructure(), through calculateFrameStructureBatch()
+void frameStructureBatch(const double* in, double* out, bool* valid, std::size_t count) {
+    std::vector<int> numerology(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const double n = in[i * maxCommandFields];
+        valid[i] = isInteger(n) && n >= 0 && n <= maxNumerology;
+        numerology[i] = valid[i] ? static_cast<int>(n) : -1;
+    }
+    std::vector<double> symbolDuration(count), slotSize(count), scs(count), rbBandwidth(count);
+    std::vector<int> slotsPerSubframe(count);
+    FrameStructureBatchOutput output;
+    output.ofdmSymbolDuration = symbolDuration.data();
+    output.slotSize = slotSize.data();
+    output.slotsPerSubframe = slotsPerSubframe.data();
+    output.scs = scs.data();
+    output.rbBandwidth = rbBandwidth.data();
+    calculateFrameStructureBatch(numerology.data(), output, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        double* record = out + i * maxCommandFields;
+        record[0] = symbolDuration[i];
+        record[1] = slotSize[i];
+        record[2] = slotsPerSubframe[i];
+        record[3] = scs[i];
+        record[4] = rbBandwidth[i];
+    }
+}
+
+bool qamModulationScheme(const double* in, double* out) {
+    if (!isInteger(in[0])) {
+        return false;
+    }
+    double b;
+    double sf;
+    QamModulationSchemeDescriptor(static_cast<int>(in[0]), b, sf);
+    if (b == 0 || sf == 0) {
+        return false;
+    }
+    out[0] = b;
+    out[1] = sf;
+    out[2] = 1 / std::sqrt(sf);
+    return true;
+}
+
+bool dlThroughput(const double* in, double* out) {
+    const double layers = in[0];
+    if ((layers != 1 && layers != 2 && layers != 4 && layers != 8) || in[1] <= 0 || in[2] <= 0 ||
+        in[3] <= 0 || !isInteger(in[4]) || in[4] <= 0) {
+        return false;
+    }
+    out[0] = calculateDLThroughput(in[3], in[2], static_cast<int>(layers), static_cast<int>(in[4]), in[1] * 1e6) / 1000;
+    return true;
+}
+
+// Same records as dlThroughput(), evaluated through calculateDLThroughputBatch()
+void dlThroughputBatch(const double* in, double* out, bool* valid, std::size_t count) {
+    std::vector<double> pathLoss, txPower, bandwidth;
+    std::vector<int> numOfLayers, prbCount;
+    std::vector<std::size_t> index;
+    for (std::size_t i = 0; i < count; ++i) {
+        const double* record = in + i * maxCommandFields;
+        const double layers = record[0];
+        valid[i] = (layers == 1 || layers == 2 || layers == 4 || layers == 8) && record[1] > 0 && record[2] > 0 &&
+                   record[3] > 0 && isInteger(record[4]) && record[4] > 0;
+        if (valid[i]) {
+            index.push_back(i);
+            pathLoss.push_back(record[3]);
+            txPower.push_back(record[2]);
+            numOfLayers.push_back(static_cast<int>(layers));
+            prbCount.push_back(static_cast<int>(record[4]));
+            bandwidth.push_back(record[1] * 1e6);
+        }
+    }
+    std::vector<double> throughput(index.size());
+    DLThroughputBatchInput input;
+    input.count = index.size();
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = numOfLayers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    calculateDLThroughputBatch(input, output);
+    for (std::size_t k = 0; k < index.size(); ++k) {
+        out[index[k] * maxCommandFields] = throughput[k] / 1000;
+    }
+}
+
+bool pathLossRural(const double* in, double* out) {
+    for (int i = 0; i < 7; ++i) {
+        if (in[i] <= 0) {
+            return false;
+        }
+    }
+    out[0] = calculate5GPathLossRural(in[0], in[1], in[2], in[3], in[4], in[5], in[6], in[7] != 0);
+    return true;
+}
+
+bool dBmToWattsCommand(const double* in, double* out) {
+    out[0] = dBmToWatts(in[0]);
+    return true;
+}
+
+bool wattsToDbmCommand(const double* in, double* out) {
+    if (in[0] <= 0) {
+        return false;
+    }
+    out[0] = wattsToDbm(in[0]);
+    return true;
+}
+
+bool spectralEfficiency(const double* in, double* out) {
+    if (in[0] < 0) {
+        return false;
+    }
+    out[0] = calculateSpectralEfficiencyPerLayer(in[0]);
+    return true;
+}
+
+bool modulationAndCodeRate(const double* in, double* out) {
+    int table;
+    if (!tableIndex(in[1], table)) {
+        return false;
+    }
+    auto cqiResult = determineIntermediateSpectralEfficiency(in[0], static_cast<CQITableId>(table));
+    auto mcsResult = determineModulationAndCodeRate(cqiResult.second, static_cast<MCSTableId>(table));
+    out[0] = mcsResult.first;
+    out[1] = mcsResult.second;
+    return true;
+}
+
+bool informationBitsPerSlot(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[0] <= 0 || !isInteger(in[1]) || in[1] < 0 || in[1] >= mcsTable.size() ||
+        !isInteger(in[2]) || in[2] <= 0) {
+        return false;
+    }
+    auto mcsResult = determineModulationAndCodeRateUsingMcsIndex(static_cast<int>(in[1]));
+    int availableREsPerRB = calculateAvailableREs(numOfSCsPerRB, static_cast<int>(in[2]), 0, 0);
+    int accomadatableREs = calculateActualAvailableREs(availableREsPerRB, static_cast<int>(in[0]));
+    double nInfo = accomadatableREs * mcsResult.first * (mcsResult.second / 1024);
+    out[0] = nInfo;
+    out[1] = calculateTBSForNinfo(nInfo, static_cast<int>(mcsResult.second));
+    return true;
+}
+
+bool slotSize(const double* in, double* out) {
+    if (!isNumerology(in[0])) {
+        return false;
+    }
+    out[0] = calculateSlotSize(static_cast<int>(in[0]));
+    return true;
+}
+
+bool numberOfSlots(const double* in, double* out) {
+    if (in[0] <= 0) {
+        return false;
+    }
+    out[0] = calculateNumberOfSlots(in[0]);
+    return true;
+}
+
+bool scsOfNumerology(const double* in, double* out) {
+    if (!isNumerology(in[0])) {
+        return false;
+    }
+    out[0] = calculateSCS(static_cast<int>(in[0]));
+    return true;
+}
+
+bool numerologyCommand(const double* in, double* out) {
+    if (!isSupportedSCS(in[0])) {
+        return false;
+    }
+    out[0] = getNumerology(static_cast<int>(in[0]));
+    return true;
+}
+
+bool largeScaleLoss(const double* in, double* out) {
+    out[0] = calculateLargeScaleTotalLoss(in[0], in[1], in[2]);
+    return true;
+}
+
+bool txPowerPerLayer(const double* in, double* out) {
+    if (!isInteger(in[1]) || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateTransmittedPowerPerLayer(in[0], static_cast<int>(in[1]));
+    return true;
+}
+
+bool rxPowerPerLayer(const double* in, double* out) {
+    out[0] = calculateReceivedPowerPerLayer(in[0], in[1], in[2]);
+    return true;
+}
+
+bool thermalNoisePower(const double* in, double* out) {
+    if (in[0] <= 0 || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateThermalNoisePower(in[0], in[1]);
+    return true;
+}
+
+bool snrLinear(const double* in, double* out) {
+    if (in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateSNRLinear(in[0], in[1]);
+    return true;
+}
+
+bool intermediateSpectralEfficiency(const double* in, double* out) {
+    int table;
+    if (!tableIndex(in[1], table)) {
+        return false;
+    }
+    auto cqiResult = determineIntermediateSpectralEfficiency(in[0], static_cast<CQITableId>(table));
+    out[0] = cqiResult.first;
+    out[1] = cqiResult.second;
+    return true;
+}
+
+bool mcsIndex(const double* in, double* out) {
+    int table;
+    if (!tableIndex(in[1], table)) {
+        return false;
+    }
+    out[0] = determineMcsIndex(in[0], static_cast<MCSTableId>(table));
+    return true;
+}
+
+bool modulationAndCodeRateOfMcsIndex(const double* in, double* out) {
+    int table;
+    if (!tableIndex(in[1], table)) {
+        return false;
+    }
+    const MCSTableId id = static_cast<MCSTableId>(table);
+    if (!isInteger(in[0]) || in[0] < 0 || in[0] >= getMCSTable(id).size()) {
+        return false;
+    }
+    auto mcsResult = determineModulationAndCodeRateUsingMcsIndex(static_cast<int>(in[0]), id);
+    out[0] = mcsResult.first;
+    out[1] = mcsResult.second;
+    return true;
+}
+
+bool availableREs(const double* in, double* out) {
+    for (int i = 0; i < 4; ++i) {
+        if (!isInteger(in[i]) || in[i] < 0) {
+            return false;
+        }
+    }
+    if (in[0] * in[1] > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    out[0] = calculateAvailableREs(static_cast<int>(in[0]), static_cast<int>(in[1]), static_cast<int>(in[2]),
+                                   static_cast<int>(in[3]));
+    return true;
+}
+
+bool actualAvailableREs(const double* in, double* out) {
+    if (!isInteger(in[0]) || !isInteger(in[1]) || in[1] < 0 ||
+        std::fabs(std::min(156.0, in[0]) * in[1]) > maxInformationBits) {
+        return false;
+    }
+    out[0] = calculateActualAvailableREs(static_cast<int>(in[0]), static_cast<int>(in[1]));
+    return true;
+}
+
+bool informationBits(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[0] < 0 || in[1] < 0 || !isInteger(in[2]) || in[2] <= 0) {
+        return false;
+    }
+    out[0] = calculateNumberOfInformationBits(static_cast<int>(in[0]), in[1], static_cast<int>(in[2]));
+    return true;
+}
+
+bool ninfoPrime(const double* in, double* out) {
+    if (!(in[0] > 0 && in[0] <= maxInformationBits)) {
+        return false;
+    }
+    out[0] = calculateNinfoPrime(in[0]);
+    return true;
+}
+
+bool tbsOfNinfoPrime(const double* in, double* out) {
+    if (!isInteger(in[0])) {
+        return false;
+    }
+    out[0] = findTBSForNinfoPrime(static_cast<int>(in[0]));
+    return true;
+}
+
+bool tbsFormula(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[0] < 0 || in[0] > maxInformationBits || !isInteger(in[1]) || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateTBS(static_cast<int>(in[0]), static_cast<int>(in[1]));
+    return true;
+}
+
+bool tbsOfNinfo(const double* in, double* out) {
+    if (!(in[0] > 0 && in[0] <= maxInformationBits) || !isInteger(in[1]) || in[1] <= 0) {
+        return false;
+    }
+    out[0] = calculateTBSForNinfo(in[0], static_cast<int>(in[1]));
+    return true;
+}
+
+bool totalBitsPerPrb(const double* in, double* out) {
+    // calculateTotalBitsPerPrb() loops over the layers: keep them to the 8 of NR
+    if (!isInteger(in[0]) || in[0] < 0 || in[0] > 8 || !isInteger(in[1]) || in[0] * in[1] > maxInformationBits ||
+        in[0] * in[1] < -maxInformationBits) {
+        return false;
+    }
+    out[0] = calculateTotalBitsPerPrb(static_cast<int>(in[0]), static_cast<int>(in[1]));
+    return true;
+}
+
+bool totalPRBsAvailable(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[0] < 0 || in[1] < 0 || in[1] > 1) {
+        return false;
+    }
+    out[0] = calculateTotalPRBsAvailable(static_cast<int>(in[0]), in[1]);
+    return true;
+}
+
+bool bitsPerSlot(const double* in, double* out) {
+    if (!isInteger(in[0]) || !isInteger(in[1]) || std::fabs(in[0] * in[1]) > std::numeric_limits<int>::max()) {
+        return false;
+    }
+    out[0] = calculateBitsPerSlot(static_cast<int>(in[0]), static_cast<int>(in[1]));
+    return true;
+}
+
+bool dlApplicationThroughput(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[1] < 0 || in[1] > 1 || in[2] <= 0 || !isInteger(in[3]) || in[3] < 0 ||
+        !isInteger(in[4]) || in[4] <= 0) {
+        return false;
+    }
+    out[0] = calculateDLApplicationThroughput(static_cast<int>(in[0]), in[1], in[2], static_cast<int>(in[3]),
+                                              static_cast<int>(in[4]));
+    return true;
+}
+
+bool dlFraction(const double* in, double* out) {
+    if (!isInteger(in[0]) || in[0] < 0 || !isInteger(in[1]) || in[1] <= 0) {
+        return false;
+    }
+    char ratio[32];
+    std::snprintf(ratio, sizeof(ratio), "%d:%d", static_cast<int>(in[0]), static_cast<int>(in[1]));
+    out[0] = calculateDLFraction(ratio);
+    return true;
+}
+
+const Command commands[] = {
+    {"wavelength", "WavelengthCalculator", "Wavelength of a signal",
+     "frequency_Hz", "wavelength_m", 1, 1, 1, wavelength, nullptr},
+    {"frequency", "CalculateFrequencyGivenWavelength", "Frequency of a signal",
+     "wavelength_m", "frequency_Hz", 1, 1, 1, frequency, nullptr},
+    {"shannon", "ShannonsCapacityCalculator", "Shannon's capacity",
+     "bandwidth_Hz,snr_linear", "capacity_bps", 2, 2, 1, shannonsCapacity, nullptr},
+    {"ofdm-symbol-duration", "OFDMSymbolDurationCalculatorGivenSCS", "OFDM symbol duration",
+     "scs_kHz,extendedCP", "symbolDuration_ms", 1, 2, 1, ofdmSymbolDuration, ofdmSymbolDurationBatch},
+    {"subcarriers", "NumOfSubCarriersGivenScsAndBandwidth", "Number of subcarriers",
+     "bandwidth_Hz,scs_kHz", "subcarriers", 2, 2, 1, numberOfSubcarriers, nullptr},
+    {"fft-size", "FFTSizeCalculator", "FFT size",
+     "symbolDuration_s,samplingFrequency_Hz", "fftSize", 2, 2, 1, fftSize, nullptr},
+    {"traffic-density", "TrafficDensityCalculator", "Traffic density",
+     "spectralEfficiency_bpsHz,cellularDensity,bandwidth_Hz", "trafficDensity", 3, 3, 1, trafficDensity, nullptr},
+    {"coherence-time", "CoherenceTimeCalculator", "Coherence time",
+     "wavelength_m,speed_mps", "coherenceTime_s", 2, 2, 1, coherenceTime, nullptr},
+    {"coherence-bandwidth", "CoherenceBandwidthCalculator", "Coherence bandwidth",
+     "delaySpread_s", "coherenceBandwidth_Hz", 1, 1, 1, coherenceBandwidth, nullptr},
+    {"frame-structure", "DescribeFrameStructureGivenNumerology", "Frame structure of a numerology",
+     "numerology", "symbolDuration_ms,slotSize_ms,slotsPerSubframe,scs_kHz,rbBandwidth_kHz", 1, 1, 5, frameStructure,
+     frameStructureBatch},
+    {"qam", "QamModulationSchemeDescriptor", "QAM modulation scheme",
+     "M", "bitsPerSymbol,scalingFactor,normalization", 1, 1, 3, qamModulationScheme, nullptr},
+    {"dl-throughput", "DLThroughputCalculator", "Analytical DL application throughput",
+     "layers,bandwidth_MHz,txPower_dBm,pathLoss_dB,prbCount",
+     "throughput_Mbps", 5, 5, 1, dlThroughput, dlThroughputBatch},
+    {"pathloss-rural", "PathLossCalculatorRural", "3GPP TR 38.901 rural macro path loss",
+     "gNBAntennaHeight_m,ueHeight_m,fLow_MHz,fHigh_MHz,distance2D_m,buildingHeight_m,streetWidth_m,isLOS",
+     "pathLoss_dB", 8, 8, 1, pathLossRural, nullptr},
+    {"dbm-to-watts", "ConvertDbmToWatts", "Convert dBm to Watts",
+     "power_dBm", "power_W", 1, 1, 1, dBmToWattsCommand, nullptr},
+    {"watts-to-dbm", "ConvertWattsToDbm", "Convert Watts to dBm",
+     "power_W", "power_dBm", 1, 1, 1, wattsToDbmCommand, nullptr},
+    {"spectral-efficiency", "CalculateSpectralEfficiency", "Shannon spectral efficiency per layer",
+     "snr_linear", "spectralEfficiency_bpsHz", 1, 1, 1, spectralEfficiency, nullptr},
+    {"modulation-code-rate", "GetModulationOrderAndCodeRate", "Modulation order and code rate",
+     "spectralEfficiency_bpsHz,table", "modulationOrder,codeRate", 1, 2, 2, modulationAndCodeRate, nullptr},
+    {"information-bits", "CalculateInformationBitsPerTTISlot", "Information bits and TBS per slot",
+     "prbs,mcsIndex,symbolsPerSlot", "nInfo,tbs", 3, 3, 2, informationBitsPerSlot, nullptr},
+    // The steps of the utilities, under the names of their functions in utilities.h. Table
+    // inputs, here and in modulation-code-rate, are 1 to 3, or 0 (omitted) for table 2.
+    {"slot-size", "calculateSlotSize", "Slot size of a numerology",
+     "numerology", "slotSize_ms", 1, 1, 1, slotSize, nullptr},
+    {"slots-per-subframe", "calculateNumberOfSlots", "Number of slots per subframe",
+     "slotSize_ms", "slotsPerSubframe", 1, 1, 1, numberOfSlots, nullptr},
+    {"scs", "calculateSCS", "Subcarrier spacing of a numerology",
+     "numerology", "scs_kHz", 1, 1, 1, scsOfNumerology, nullptr},
+    {"numerology", "getNumerology", "Numerology of a subcarrier spacing",
+     "scs_kHz", "numerology", 1, 1, 1, numerologyCommand, nullptr},
+    {"large-scale-loss", "calculateLargeScaleTotalLoss", "Total large-scale loss",
+     "pathLoss_dB,shadowingLoss_dB,o2iLoss_dB", "totalLoss_dB", 1, 3, 1, largeScaleLoss, nullptr},
+    {"tx-power-per-layer", "calculateTransmittedPowerPerLayer", "Transmitted power per layer",
+     "txPower_dBm,layers", "txPowerPerLayer_dBm", 2, 2, 1, txPowerPerLayer, nullptr},
+    {"rx-power-per-layer", "calculateReceivedPowerPerLayer", "Received power per layer",
+     "txPowerPerLayer_dBm,totalLoss_dB,bfGain_dB", "rxPowerPerLayer_dBm", 2, 3, 1, rxPowerPerLayer, nullptr},
+    {"thermal-noise", "calculateThermalNoisePower", "Thermal noise power",
+     "temperature_K,bandwidth_Hz", "noisePower_W", 2, 2, 1, thermalNoisePower, nullptr},
+    {"snr", "calculateSNRLinear", "SNR in linear scale",
+     "rxPower_dBm,noisePower_W", "snr_linear", 2, 2, 1, snrLinear, nullptr},
+    {"cqi", "determineIntermediateSpectralEfficiency", "CQI index and intermediate spectral efficiency",
+     "spectralEfficiency_bpsHz,cqiTable", "cqiIndex,spectralEfficiency_bpsHz", 1, 2, 2, intermediateSpectralEfficiency,
+     nullptr},
+    {"mcs-index", "determineMcsIndex", "MCS index of a spectral efficiency",
+     "spectralEfficiency_bpsHz,mcsTable", "mcsIndex", 1, 2, 1, mcsIndex, nullptr},
+    {"mcs", "determineModulationAndCodeRateUsingMcsIndex", "Modulation order and code rate of an MCS index",
+     "mcsIndex,mcsTable", "modulationOrder,codeRate", 1, 2, 2, modulationAndCodeRateOfMcsIndex, nullptr},
+    {"available-res", "calculateAvailableREs", "REs available for data in a PRB",
+     "subcarriers,symbols,dmrsREs,overheadREs", "availableREs", 2, 4, 1, availableREs, nullptr},
+    {"actual-available-res", "calculateActualAvailableREs", "REs available for data in an allocation",
+     "availableREsPerRB,prbs", "actualAvailableREs", 2, 2, 1, actualAvailableREs, nullptr},
+    {"ninfo", "calculateNumberOfInformationBits", "Number of information bits",
+     "nRE,codeRate,modulationOrder", "nInfo", 3, 3, 1, informationBits, nullptr},
+    {"ninfo-prime", "calculateNinfoPrime", "Quantized number of information bits",
+     "nInfo", "nInfoPrime", 1, 1, 1, ninfoPrime, nullptr},
+    {"tbs-table", "findTBSForNinfoPrime", "TBS from the table, for NinfoPrime <= 3824",
+     "nInfoPrime", "tbs", 1, 1, 1, tbsOfNinfoPrime, nullptr},
+    {"tbs-formula", "calculateTBS", "TBS from the formula, for NinfoPrime > 3824",
+     "nInfoPrime,codeRate", "tbs", 2, 2, 1, tbsFormula, nullptr},
+    {"tbs", "calculateTBSForNinfo", "TBS of a number of information bits",
+     "nInfo,codeRate", "tbs", 2, 2, 1, tbsOfNinfo, nullptr},
+    {"bits-per-prb", "calculateTotalBitsPerPrb", "Bits per PRB over every layer",
+     "layers,tbs", "bitsPerPrb", 2, 2, 1, totalBitsPerPrb, nullptr},
+    {"prbs-available", "calculateTotalPRBsAvailable", "PRBs left after the DL overhead",
+     "prbCount,downlinkOverhead", "prbsAvailable", 2, 2, 1, totalPRBsAvailable, nullptr},
+    {"bits-per-slot", "calculateBitsPerSlot", "Bits per slot",
+     "bitsPerPrb,prbs", "bitsPerSlot", 2, 2, 1, bitsPerSlot, nullptr},
+    {"dl-application-throughput", "calculateDLApplicationThroughput", "DL application throughput",
+     "bitsPerSlot,dlFraction,slotTime_s,appPacketSize_bits,macPacketSize_bits", "throughput_bps", 5, 5, 1,
+     dlApplicationThroughput, nullptr},
+    {"dl-fraction", "calculateDLFraction", "DL fraction of a DL:UL ratio",
+     "dlParts,ulParts", "dlFraction", 2, 2, 1, dlFraction, nullptr},
+};
+
+bool isSeparator(char c) {
+    return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r';
+}
+
+void appendValue(std::string& out, double value, int precision) {
+    char text[32];
+    int length = std::snprintf(text, sizeof(text), "%.*g", precision, value);
+    out.append(text, static_cast<std::size_t>(length));
+}
+
+} // namespace
+
+const Command* commandList(std::size_t& count) {
+    count = sizeof(commands) / sizeof(Command);
+    return commands;
+}
+
+const Command* findCommand(const std::string& name) {
+    for (const auto& command : commands) {
+        if (name == command.name || name == command.utility) {
+            return &command;
+        }
+    }
+    return nullptr;
+}
+
+int parseCommandFields(const char* begin, const char* end, double* fields) {
+    int count = 0;
+    const char* p = begin;
+    while (true) {
+        while (p < end && isSeparator(*p)) {
+            ++p;
+        }
+        if (p == end) {
+            return count;
+        }
+        if (count == maxCommandFields) {
+            return -1;
+        }
+        char* next;
+        fields[count] = std::strtod(p, &next);
+        if (next == p || next > end || (next < end && !isSeparator(*next))) {
+            return -1;
+        }
+        ++count;
+        p = next;
+    }
+}
+
+void formatCommandOutputs(const Command& command, const double* outputs, bool valid, std::string& out,
+                          int precision) {
+    for (int i = 0; i < command.numOutputs; ++i) {
+        if (i > 0) {
+            out += ',';
+        }
+        if (valid) {
+            appendValue(out, outputs[i], precision);
+        } else {
+            out += "nan";
+        }
+    }
+    out += '\n';
+}
+
+bool evaluateRecord(const Command& command, const char* begin, const char* end, std::string& out, int precision) {
+    double inputs[maxCommandFields] = {};
+    double outputs[maxCommandFields];
+    int count = parseCommandFields(begin, end, inputs);
+    bool valid = count >= command.minInputs && count <= command.maxInputs && command.evaluate(inputs, outputs);
+    formatCommandOutputs(command, outputs, valid, out, precision);
+    return valid;
+}
+
+CommandStreamStats runCommandStream(const Command& command, std::FILE* in, std::FILE* out,
+                                    const CommandStreamOptions& options) {
+    CommandStreamStats stats;
+    std::string output;
+    output.reserve(2 * streamBlockSize);
+    if (options.header) {
+        output += command.outputs;
+        output += '\n';
+    }
+
+    bool firstLine = true;
+    auto processLine = [&](const char* begin, const char* end) {
+        const char* p = begin;
+        while (p < end && isSeparator(*p)) {
+            ++p;
+        }
+        if (p == end || *p == '#') {
+            return;
+        }
+        if (firstLine) {
+            firstLine = false;
+            char* next;
+            std::strtod(p, &next);
+            if (next == p) {
+                return; // header line
+            }
+        }
+        ++stats.records;
+        if (!evaluateRecord(command, p, end, output, options.precision)) {
+            ++stats.invalid;
+        }
+        if (output.size() >= streamBlockSize) {
+            std::fwrite(output.data(), 1, output.size(), out);
+            output.clear();
+        }
+    };
+
+    // One extra byte keeps the buffer null terminated for strtod
+    std::vector<char> buffer(streamBlockSize + 1);
+    std::size_t pending = 0;
+    while (true) {
+        if (pending == buffer.size() - 1) {
+            buffer.resize(2 * buffer.size() - 1); // a line longer than the buffer
+        }
+        std::size_t read = std::fread(buffer.data() + pending, 1, buffer.size() - 1 - pending, in);
+        const std::size_t filled = pending + read;
+        buffer[filled] = '\0';
+
+        const char* p = buffer.data();
+        const char* end = p + filled;
+        while (const char* newline = static_cast<const char*>(std::memchr(p, '\n', end - p))) {
+            processLine(p, newline);
+            p = newline + 1;
+        }
+        pending = static_cast<std::size_t>(end - p);
+        if (read == 0) {
+            processLine(p, end); // last line without a newline
+            break;
+        }
+        std::memmove(buffer.data(), p, pending);
+    }
+
+    std::fwrite(output.data(), 1, output.size(), out);
+    std::fflush(out);
+    return stats;
+}
+
+bool runCommandColumns(const Command& command, const std::string& inputPath, const std::string& outputPath,
+                       CommandStreamStats& stats) {
+    ColumnFile in;
+    if (!in.open(inputPath)) {
+        return false;
+    }
+    auto splitNames = [](const char* names) {
+        std::vector<std::string> split;
+        for (const char* p = names; *p; ++p) {
+            const char* comma = std::strchr(p, ',');
+            split.push_back(comma ? std::string(p, comma) : std::string(p));
+            if (!comma) {
+                break;
+            }
+            p = comma;
+        }
+        return split;
+    };
+
+    const std::vector<std::string> inputNames = splitNames(command.inputs);
+    std::vector<const double*> inputs;
+    for (const std::string& name : inputNames) {
+        inputs.push_back(in.float64(name));
+        if (!inputs.back() && static_cast<int>(inputs.size()) <= command.minInputs) {
+            errno = EINVAL;
+            return false;
+        }
+    }
+    const std::vector<std::string> outputNames = splitNames(command.outputs);
+    std::vector<ColumnSpec> outputColumns;
+    for (const std::string& name : outputNames) {
+        outputColumns.push_back({name, ColumnType::Float64});
+    }
+    ColumnFileWriter out;
+    if (!out.create(outputPath, in.numRows(), outputColumns)) {
+        return false;
+    }
+    std::vector<double*> outputs;
+    for (const std::string& name : outputNames) {
+        outputs.push_back(out.float64(name));
+    }
+
+    std::vector<double> records(columnBlockRecords * maxCommandFields, 0.0);
+    std::vector<double> results(columnBlockRecords * maxCommandFields);
+    std::unique_ptr<bool[]> valid(new bool[columnBlockRecords]);
+    for (std::size_t begin = 0; begin < in.numRows(); begin += columnBlockRecords) {
+        const std::size_t count = std::min(columnBlockRecords, in.numRows() - begin);
+        for (std::size_t f = 0; f < inputs.size(); ++f) {
+            for (std::size_t r = 0; r < count; ++r) {
+                records[r * maxCommandFields + f] = inputs[f] ? inputs[f][begin + r] : 0.0;
+            }
+        }
+        if (command.evaluateBatch) {
+            command.evaluateBatch(records.data(), results.data(), valid.get(), count);
+        } else {
+            for (std::size_t r = 0; r < count; ++r) {
+                valid[r] = command.evaluate(&records[r * maxCommandFields], &results[r * maxCommandFields]);
+            }
+        }
+        for (std::size_t r = 0; r < count; ++r) {
+            stats.invalid += !valid[r];
+            for (std::size_t o = 0; o < outputs.size(); ++o) {
+                outputs[o][begin + r] = valid[r] ? results[r * maxCommandFields + o] : std::nan("");
+            }
+        }
+        stats.records += count;
+        if (!out.flush(begin, begin + count)) {
+            return false;
+        }
+    }
+    return out.close();
+}
@@ -0,0 +1,270 @@
+#include "conversions.h"
+#include "parallel.h"
+#include "simd.h"
+#include <cfloat>
+
+namespace {
+
+// Smallest number of values worth handing to another thread, a multiple of every vector width
+constexpr std::size_t conversionParallelGrain = 16384;
+
+// log2(10) as a double-double, so that t * log2(10) keeps its full precision into the
+// exponent of exp2 even for |t| in the hundreds
+constexpr double log2Of10Hi = 3.321928094887362;
+constexpr double log2Of10Lo = 1.661617516973592e-16;
+constexpr double tenLog10e = 4.3429448190325182765; // 10 / ln(10)
+constexpr double dBmRangeLimit = 3000.0;            // keeps x / 10 * log2(10) inside the range of exp2Avx2()
+
+void dBmToWattsScalar(const double* dBm, double* watts, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        watts[i] = dBmToWatts(dBm[i]);
+    }
+}
+
+void wattsToDbmScalar(const double* watts, double* dBm, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        dBm[i] = wattsToDbm(watts[i]);
+    }
+}
+
+void snrLinearScalar(const double* rxPower_dBm, const double* thermalNoisePower_Watts, double* snrLinear,
+                     std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        snrLinear[i] = calculateSNRLinear(rxPower_dBm[i], thermalNoisePower_Watts[i]);
+    }
+}
+
+void spectralEfficiencyScalar(const double* snrLinear, double* spectralEfficiency, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        spectralEfficiency[i] = calculateSpectralEfficiencyPerLayer(snrLinear[i]);
+    }
+}
+
+#if FIVEG_HAVE_X86_SIMD
+
+// Vectors holding a lane outside the range of the polynomial kernels are converted with libm,
+// so that the fast mode never returns a wrong infinity, zero or NaN.
+
+FIVEG_TARGET_AVX2 inline bool inDbmRangeAvx2(__m256d x) {
+    const __m256d magnitude = _mm256_andnot_pd(_mm256_set1_pd(-0.0), x);
+    return _mm256_movemask_pd(_mm256_cmp_pd(magnitude, _mm256_set1_pd(dBmRangeLimit), _CMP_LE_OQ)) == 0xF;
+}
+
+// 10^(x / 10). x / 10 is rounded exactly like the std::pow(10, x / 10) of the scalar functions,
+// whose result carries that rounding error too (up to ~35 ulp at |x| = 300).
+FIVEG_TARGET_AVX2 inline __m256d dBToLinearAvx2(__m256d x) {
+    const __m256d t = _mm256_div_pd(x, _mm256_set1_pd(10.0));
+    const __m256d hi = _mm256_mul_pd(t, _mm256_set1_pd(log2Of10Hi));
+    const __m256d lo = _mm256_fmadd_pd(t, _mm256_set1_pd(log2Of10Lo), _mm256_fmsub_pd(t, _mm256_set1_pd(log2Of10Hi), hi));
+    return simd::exp2Avx2(hi, lo);
+}
+
+FIVEG_TARGET_AVX2 void dBmToWattsAvx2(const double* dBm, double* watts, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d x = _mm256_loadu_pd(dBm + i);
+        if (inDbmRangeAvx2(x)) {
+            _mm256_storeu_pd(watts + i, _mm256_mul_pd(_mm256_set1_pd(1e-3), dBToLinearAvx2(x)));
+        } else {
+            dBmToWattsScalar(dBm + i, watts + i, 4);
+        }
+    }
+    dBmToWattsScalar(dBm + i, watts + i, count - i);
+}
+
+FIVEG_TARGET_AVX2 void wattsToDbmAvx2(const double* watts, double* dBm, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d x = _mm256_loadu_pd(watts + i);
+        const __m256d normal = _mm256_and_pd(_mm256_cmp_pd(x, _mm256_set1_pd(DBL_MIN), _CMP_GE_OQ),
+                                             _mm256_cmp_pd(x, _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ));
+        if (_mm256_movemask_pd(normal) == 0xF) {
+            _mm256_storeu_pd(dBm + i, _mm256_fmadd_pd(simd::logAvx2(x), _mm256_set1_pd(tenLog10e),
+                                                      _mm256_set1_pd(30.0)));
+        } else {
+            wattsToDbmScalar(watts + i, dBm + i, 4);
+        }
+    }
+    wattsToDbmScalar(watts + i, dBm + i, count - i);
+}
+
+FIVEG_TARGET_AVX2 void snrLinearAvx2(const double* rxPower_dBm, const double* thermalNoisePower_Watts,
+                                     double* snrLinear, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d x = _mm256_loadu_pd(rxPower_dBm + i);
+        if (inDbmRangeAvx2(x)) {
+            const __m256d rxPower_Watts = _mm256_mul_pd(_mm256_set1_pd(1e-3), dBToLinearAvx2(x));
+            _mm256_storeu_pd(snrLinear + i, _mm256_div_pd(rxPower_Watts, _mm256_loadu_pd(thermalNoisePower_Watts + i)));
+        } else {
+            snrLinearScalar(rxPower_dBm + i, thermalNoisePower_Watts + i, snrLinear + i, 4);
+        }
+    }
+    snrLinearScalar(rxPower_dBm + i, thermalNoisePower_Watts + i, snrLinear + i, count - i);
+}
+
+FIVEG_TARGET_AVX2 void spectralEfficiencyAvx2(const double* snrLinear, double* spectralEfficiency, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d x = _mm256_loadu_pd(snrLinear + i);
+        if (_mm256_movemask_pd(_mm256_cmp_pd(x, _mm256_set1_pd(DBL_MAX), _CMP_LE_OQ)) == 0xF) {
+            // Negative SNRs become log2(1) = 0
+            const __m256d onePlusSnr = _mm256_add_pd(_mm256_set1_pd(1.0), _mm256_max_pd(x, _mm256_setzero_pd()));
+            _mm256_storeu_pd(spectralEfficiency + i, simd::log2Avx2(onePlusSnr));
+        } else {
+            spectralEfficiencyScalar(snrLinear + i, spectralEfficiency + i, 4);
+        }
+    }
+    spectralEfficiencyScalar(snrLinear + i, spectralEfficiency + i, count - i);
+}
+
+FIVEG_TARGET_AVX512 inline bool inDbmRangeAvx512(__m512d x) {
+    return _mm512_cmp_pd_mask(_mm512_abs_pd(x), _mm512_set1_pd(dBmRangeLimit), _CMP_LE_OQ) == 0xFF;
+}
+
+FIVEG_TARGET_AVX512 inline __m512d dBToLinearAvx512(__m512d x) {
+    const __m512d t = _mm512_div_pd(x, _mm512_set1_pd(10.0));
+    const __m512d hi = _mm512_mul_pd(t, _mm512_set1_pd(log2Of10Hi));
+    const __m512d lo = _mm512_fmadd_pd(t, _mm512_set1_pd(log2Of10Lo), _mm512_fmsub_pd(t, _mm512_set1_pd(log2Of10Hi), hi));
+    return simd::exp2Avx512(hi, lo);
+}
+
+FIVEG_TARGET_AVX512 void dBmToWattsAvx512(const double* dBm, double* watts, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d x = _mm512_loadu_pd(dBm + i);
+        if (inDbmRangeAvx512(x)) {
+            _mm512_storeu_pd(watts + i, _mm512_mul_pd(_mm512_set1_pd(1e-3), dBToLinearAvx512(x)));
+        } else {
+            dBmToWattsScalar(dBm + i, watts + i, 8);
+        }
+    }
+    dBmToWattsScalar(dBm + i, watts + i, count - i);
+}
+
+FIVEG_TARGET_AVX512 void wattsToDbmAvx512(const double* watts, double* dBm, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d x = _mm512_loadu_pd(watts + i);
+        const __mmask8 normal = _mm512_cmp_pd_mask(x, _mm512_set1_pd(DBL_MIN), _CMP_GE_OQ) &
+                                _mm512_cmp_pd_mask(x, _mm512_set1_pd(DBL_MAX), _CMP_LE_OQ);
+        if (normal == 0xFF) {
+            _mm512_storeu_pd(dBm + i, _mm512_fmadd_pd(simd::logAvx512(x), _mm512_set1_pd(tenLog10e),
+                                                      _mm512_set1_pd(30.0)));
+        } else {
+            wattsToDbmScalar(watts + i, dBm + i, 8);
+        }
+    }
+    wattsToDbmScalar(watts + i, dBm + i, count - i);
+}
+
+FIVEG_TARGET_AVX512 void snrLinearAvx512(const double* rxPower_dBm, const double* thermalNoisePower_Watts,
+                                         double* snrLinear, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d x = _mm512_loadu_pd(rxPower_dBm + i);
+        if (inDbmRangeAvx512(x)) {
+            const __m512d rxPower_Watts = _mm512_mul_pd(_mm512_set1_pd(1e-3), dBToLinearAvx512(x));
+            _mm512_storeu_pd(snrLinear + i, _mm512_div_pd(rxPower_Watts, _mm512_loadu_pd(thermalNoisePower_Watts + i)));
+        } else {
+            snrLinearScalar(rxPower_dBm + i, thermalNoisePower_Watts + i, snrLinear + i, 8);
+        }
+    }
+    snrLinearScalar(rxPower_dBm + i, thermalNoisePower_Watts + i, snrLinear + i, count - i);
+}
+
+FIVEG_TARGET_AVX512 void spectralEfficiencyAvx512(const double* snrLinear, double* spectralEfficiency,
+                                                  std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d x = _mm512_loadu_pd(snrLinear + i);
+        if (_mm512_cmp_pd_mask(x, _mm512_set1_pd(DBL_MAX), _CMP_LE_OQ) == 0xFF) {
+            const __m512d onePlusSnr = _mm512_add_pd(_mm512_set1_pd(1.0), _mm512_max_pd(x, _mm512_setzero_pd()));
+            _mm512_storeu_pd(spectralEfficiency + i, simd::log2Avx512(onePlusSnr));
+        } else {
+            spectralEfficiencyScalar(snrLinear + i, spectralEfficiency + i, 8);
+        }
+    }
+    spectralEfficiencyScalar(snrLinear + i, spectralEfficiency + i, count - i);
+}
+
+#endif // FIVEG_HAVE_X86_SIMD
+
+// The scalar level has no polynomial kernels: fast mode falls back to libm there as well
+SimdLevel conversionLevel(ConversionAccuracy accuracy) {
+    return accuracy == ConversionAccuracy::Fast ? activeSimdLevel() : SimdLevel::Scalar;
+}
+
+} // namespace
+
+void dBmToWattsBatch(const double* dBm, double* watts, std::size_t count, ConversionAccuracy accuracy) {
+    switch (conversionLevel(accuracy)) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            dBmToWattsAvx512(dBm, watts, count);
+            return;
+        case SimdLevel::AVX2:
+            dBmToWattsAvx2(dBm, watts, count);
+            return;
+#endif
+        default:
+            dBmToWattsScalar(dBm, watts, count);
+    }
+}
+
+void wattsToDbmBatch(const double* watts, double* dBm, std::size_t count, ConversionAccuracy accuracy) {
+    switch (conversionLevel(accuracy)) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            wattsToDbmAvx512(watts, dBm, count);
+            return;
+        case SimdLevel::AVX2:
+            wattsToDbmAvx2(watts, dBm, count);
+            return;
+#endif
+        default:
+            wattsToDbmScalar(watts, dBm, count);
+    }
+}
+
+void calculateSNRLinearBatch(const double* rxPower_dBm, const double* thermalNoisePower_Watts, double* snrLinear,
+                             std::size_t count, ConversionAccuracy accuracy) {
+    switch (conversionLevel(accuracy)) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            snrLinearAvx512(rxPower_dBm, thermalNoisePower_Watts, snrLinear, count);
+            return;
+        case SimdLevel::AVX2:
+            snrLinearAvx2(rxPower_dBm, thermalNoisePower_Watts, snrLinear, count);
+            return;
+#endif
+        default:
+            snrLinearScalar(rxPower_dBm, thermalNoisePower_Watts, snrLinear, count);
+    }
+}
+
+void calculateSpectralEfficiencyPerLayerBatch(const double* snrLinear, double* spectralEfficiency, std::size_t count,
+                                              ConversionAccuracy accuracy) {
+    switch (conversionLevel(accuracy)) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            spectralEfficiencyAvx512(snrLinear, spectralEfficiency, count);
+            return;
+        case SimdLevel::AVX2:
+            spectralEfficiencyAvx2(snrLinear, spectralEfficiency, count);
+            return;
+#endif
+        default:
+            spectralEfficiencyScalar(snrLinear, spectralEfficiency, count);
+    }
+}
+
+void calculateShannonsCapacityBatch(const double* bandwidth, const double* snrLinear, double* capacity,
+                                    std::size_t count, ConversionAccuracy accuracy) {
+    parallelFor(count, parallelGrain(count, conversionParallelGrain), [&](std::size_t begin, std::size_t end) {
+        calculateSpectralEfficiencyPerLayerBatch(snrLinear + begin, capacity + begin, end - begin, accuracy);
+        for (std::size_t i = begin; i < end; ++i) {
+            capacity[i] = (bandwidth[i] <= 0 || snrLinear[i] < 0) ? 0.0 : bandwidth[i] * capacity[i];
+        }
+    });
+}
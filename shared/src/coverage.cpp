@@ -0,0 +1,156 @@
+#include "coverage.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+
+// Distance from a coordinate to the interval [low, high], 0 when inside
+double distanceToInterval(double value, double low, double high) {
+    return value < low ? low - value : (value > high ? value - high : 0.0);
+}
+
+// Writes 32-bit values in little-endian byte order whatever the byte order of the host,
+// as the header of writeCoverageMap() declares
+template <typename T>
+bool writeRaw(const std::string& path, const std::vector<T>& values) {
+    static_assert(sizeof(T) == 4, "rasters hold 32-bit values");
+    std::ofstream out(path, std::ios::binary);
+    unsigned char buffer[4096];
+    for (std::size_t begin = 0; begin < values.size() && out; begin += sizeof(buffer) / 4) {
+        const std::size_t n = std::min(sizeof(buffer) / 4, values.size() - begin);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint32_t bits;
+            std::memcpy(&bits, &values[begin + i], 4);
+            buffer[4 * i] = static_cast<unsigned char>(bits);
+            buffer[4 * i + 1] = static_cast<unsigned char>(bits >> 8);
+            buffer[4 * i + 2] = static_cast<unsigned char>(bits >> 16);
+            buffer[4 * i + 3] = static_cast<unsigned char>(bits >> 24);
+        }
+        out.write(reinterpret_cast<const char*>(buffer), static_cast<std::streamsize>(4 * n));
+    }
+    return static_cast<bool>(out);
+}
+
+} // namespace
+
+CoverageMap generateCoverageMap(const std::vector<CoverageSite>& sites, const CoverageGrid& grid,
+                                const CoverageConfig& config) {
+    const float noData = std::numeric_limits<float>::quiet_NaN();
+    const std::size_t numPixels = static_cast<std::size_t>(grid.width) * grid.height;
+
+    CoverageMap map;
+    map.grid = grid;
+    map.pathLoss.assign(numPixels, noData);
+    map.rsrp.assign(numPixels, noData);
+    map.snr.assign(numPixels, noData);
+    map.bestServer.assign(numPixels, -1);
+
+    // Site dependent terms are computed once, outside of the tiles
+    std::vector<RuralPathLossSite> models;
+    std::vector<double> txPowerPerRE;
+    for (const auto& site : sites) {
+        models.push_back(makeRuralPathLossSite(site.gNBAntennaHeight, config.fLow, config.fHigh,
+                                               config.buildingHeight, config.streetWidth));
+        txPowerPerRE.push_back(site.txPower - 10 * std::log10(numOfSCsPerRB * config.prbCount));
+    }
+    const double noisePower_dBm = wattsToDbm(calculateThermalNoisePower(config.temperature, config.bandwidth));
+    const double rsrpToSnr = 10 * std::log10(numOfSCsPerRB * config.prbCount) - noisePower_dBm;
+
+    const int tileSize = std::max(1, config.tileSize);
+    const int tilesX = (grid.width + tileSize - 1) / tileSize;
+    const int tilesY = (grid.height + tileSize - 1) / tileSize;
+    const double maxDistance2 = config.maxDistance * config.maxDistance;
+
+    parallelFor(static_cast<std::size_t>(tilesX) * tilesY, 1, [&](std::size_t begin, std::size_t end) {
+        std::vector<double> distance(static_cast<std::size_t>(tileSize) * tileSize);
+        std::vector<double> pathLoss(distance.size());
+        std::vector<double> bestRsrp(distance.size());
+        std::vector<double> bestPathLoss(distance.size());
+        std::vector<std::int32_t> bestServer(distance.size());
+
+        for (std::size_t tile = begin; tile < end; ++tile) {
+            const int col0 = static_cast<int>(tile % tilesX) * tileSize;
+            const int row0 = static_cast<int>(tile / tilesX) * tileSize;
+            const int cols = std::min(tileSize, grid.width - col0);
+            const int rows = std::min(tileSize, grid.height - row0);
+            const std::size_t n = static_cast<std::size_t>(cols) * rows;
+
+            // Pixel centres covered by the tile
+            const double x0 = grid.originX + (col0 + 0.5) * grid.resolution;
+            const double y0 = grid.originY + (row0 + 0.5) * grid.resolution;
+            const double x1 = x0 + (cols - 1) * grid.resolution;
+            const double y1 = y0 + (rows - 1) * grid.resolution;
+
+            std::fill(bestRsrp.begin(), bestRsrp.begin() + n, -std::numeric_limits<double>::infinity());
+            std::fill(bestServer.begin(), bestServer.begin() + n, -1);
+
+            for (std::size_t s = 0; s < sites.size(); ++s) {
+                const double dx = distanceToInterval(sites[s].x, x0, x1);
+                const double dy = distanceToInterval(sites[s].y, y0, y1);
+                if (dx * dx + dy * dy > maxDistance2) {
+                    continue; // no pixel of the tile is within range of this site
+                }
+
+                for (int r = 0; r < rows; ++r) {
+                    const double ry = y0 + r * grid.resolution - sites[s].y;
+                    double* row = distance.data() + static_cast<std::size_t>(r) * cols;
+                    for (int c = 0; c < cols; ++c) {
+                        const double rx = x0 + c * grid.resolution - sites[s].x;
+                        row[c] = std::sqrt(rx * rx + ry * ry);
+                    }
+                }
+                calculate5GPathLossRuralBatch(models[s], distance.data(), config.ueHeight, config.isLOS,
+                                              pathLoss.data(), n);
+
+                for (std::size_t k = 0; k < n; ++k) {
+                    // The model returns 0 outside of its validity range
+                    const bool valid = pathLoss[k] > 0 && distance[k] <= config.maxDistance;
+                    const double rsrp = txPowerPerRE[s] - pathLoss[k];
+                    if (valid && rsrp > bestRsrp[k]) {
+                        bestRsrp[k] = rsrp;
+                        bestPathLoss[k] = pathLoss[k];
+                        bestServer[k] = static_cast<std::int32_t>(s);
+                    }
+                }
+            }
+
+            for (int r = 0; r < rows; ++r) {
+                for (int c = 0; c < cols; ++c) {
+                    const std::size_t k = static_cast<std::size_t>(r) * cols + c;
+                    if (bestServer[k] < 0) {
+                        continue;
+                    }
+                    const std::size_t pixel = static_cast<std::size_t>(row0 + r) * grid.width + col0 + c;
+                    map.pathLoss[pixel] = static_cast<float>(bestPathLoss[k]);
+                    map.rsrp[pixel] = static_cast<float>(bestRsrp[k]);
+                    map.snr[pixel] = static_cast<float>(bestRsrp[k] + rsrpToSnr);
+                    map.bestServer[pixel] = bestServer[k];
+                }
+            }
+        }
+    }, config.numThreads);
+
+    return map;
+}
+
+bool writeCoverageMap(const CoverageMap& map, const std::string& prefix) {
+    std::ofstream header(prefix + ".hdr");
+    header << std::setprecision(12)
+           << "width " << map.grid.width << "\n"
+           << "height " << map.grid.height << "\n"
+           << "originX " << map.grid.originX << "\n"
+           << "originY " << map.grid.originY << "\n"
+           << "resolution " << map.grid.resolution << "\n"
+           << "byteOrder little\n"
+           << "rowOrder southToNorth\n";
+    bool ok = static_cast<bool>(header);
+    ok = writeRaw(prefix + "_pathloss.f32", map.pathLoss) && ok;
+    ok = writeRaw(prefix + "_rsrp.f32", map.rsrp) && ok;
+    ok = writeRaw(prefix + "_snr.f32", map.snr) && ok;
+    ok = writeRaw(prefix + "_server.i32", map.bestServer) && ok;
+    return ok;
+}
@@ -0,0 +1,297 @@
+#include "effectivesinr.h"
+#include "parallel.h"
+#include "simd.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Smallest number of UEs worth handing to another thread
+constexpr std::size_t effectiveSinrParallelGrain = 64;
+
+constexpr double ln2 = 0.69314718055994530942;
+constexpr double log2e = 1.44269504088896340736;
+constexpr double minExponent = -1022.0; // terms below 2^-1022 of the largest one do not count
+
+// Reference channel of the beta calibration: two SINRs 6 dB apart from the operating point
+constexpr double referenceSpread = 3.9810717055349722; // 10^(6 / 10)
+constexpr double minBeta = 1e-3;
+constexpr double maxBeta = 1e4;
+constexpr int calibrationIterations = 200;
+
+constexpr std::size_t maxMcsEntries = 32;
+static_assert(mcsTable1.size() <= maxMcsEntries && mcsTable2.size() <= maxMcsEntries &&
+              mcsTable3.size() <= maxMcsEntries, "MCS tables do not fit the beta tables");
+
+double minScalar(const double* sinr, std::size_t count) {
+    double minimum = std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < count; ++i) {
+        minimum = std::min(minimum, sinr[i]);
+    }
+    return minimum;
+}
+
+// Sum of exp(-(sinr - minSinr) / beta)
+double eesmSumScalar(const double* sinr, std::size_t count, double minSinr, double inverseBeta) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += std::exp(-(sinr[i] - minSinr) * inverseBeta);
+    }
+    return sum;
+}
+
+// Sum of min(Qm, log2(1 + sinr))
+double miesmSumScalar(const double* sinr, std::size_t count, double modulationOrder) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < count; ++i) {
+        sum += std::min(modulationOrder, std::log2(1.0 + std::max(sinr[i], 0.0)));
+    }
+    return sum;
+}
+
+#if FIVEG_HAVE_X86_SIMD
+
+FIVEG_TARGET_AVX2 double horizontalSumAvx2(__m256d x) {
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(x), _mm256_extractf128_pd(x, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+FIVEG_TARGET_AVX2 double minAvx2(const double* sinr, std::size_t count) {
+    __m256d minimum = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        minimum = _mm256_min_pd(minimum, _mm256_loadu_pd(sinr + i));
+    }
+    const __m128d pair = _mm_min_pd(_mm256_castpd256_pd128(minimum), _mm256_extractf128_pd(minimum, 1));
+    const double vectorMinimum = _mm_cvtsd_f64(_mm_min_sd(pair, _mm_unpackhi_pd(pair, pair)));
+    return std::min(vectorMinimum, minScalar(sinr + i, count - i));
+}
+
+FIVEG_TARGET_AVX2 double eesmSumAvx2(const double* sinr, std::size_t count, double minSinr, double inverseBeta) {
+    const __m256d minimum = _mm256_set1_pd(minSinr);
+    const __m256d scale = _mm256_set1_pd(-inverseBeta * log2e);
+    const __m256d floor = _mm256_set1_pd(minExponent);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d sum = zero;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d t = _mm256_mul_pd(_mm256_sub_pd(_mm256_loadu_pd(sinr + i), minimum), scale);
+        sum = _mm256_add_pd(sum, simd::exp2Avx2(_mm256_max_pd(t, floor), zero));
+    }
+    return horizontalSumAvx2(sum) + eesmSumScalar(sinr + i, count - i, minSinr, inverseBeta);
+}
+
+FIVEG_TARGET_AVX2 double miesmSumAvx2(const double* sinr, std::size_t count, double modulationOrder) {
+    const __m256d bound = _mm256_set1_pd(modulationOrder);
+    const __m256d one = _mm256_set1_pd(1.0);
+    const __m256d zero = _mm256_setzero_pd();
+    __m256d sum = zero;
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d onePlusSinr = _mm256_add_pd(one, _mm256_max_pd(_mm256_loadu_pd(sinr + i), zero));
+        sum = _mm256_add_pd(sum, _mm256_min_pd(bound, simd::log2Avx2(onePlusSinr)));
+    }
+    return horizontalSumAvx2(sum) + miesmSumScalar(sinr + i, count - i, modulationOrder);
+}
+
+FIVEG_TARGET_AVX512 double minAvx512(const double* sinr, std::size_t count) {
+    __m512d minimum = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        minimum = _mm512_min_pd(minimum, _mm512_loadu_pd(sinr + i));
+    }
+    return std::min(_mm512_reduce_min_pd(minimum), minScalar(sinr + i, count - i));
+}
+
+FIVEG_TARGET_AVX512 double eesmSumAvx512(const double* sinr, std::size_t count, double minSinr, double inverseBeta) {
+    const __m512d minimum = _mm512_set1_pd(minSinr);
+    const __m512d scale = _mm512_set1_pd(-inverseBeta * log2e);
+    const __m512d floor = _mm512_set1_pd(minExponent);
+    const __m512d zero = _mm512_setzero_pd();
+    __m512d sum = zero;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d t = _mm512_mul_pd(_mm512_sub_pd(_mm512_loadu_pd(sinr + i), minimum), scale);
+        sum = _mm512_add_pd(sum, simd::exp2Avx512(_mm512_max_pd(t, floor), zero));
+    }
+    return _mm512_reduce_add_pd(sum) + eesmSumScalar(sinr + i, count - i, minSinr, inverseBeta);
+}
+
+FIVEG_TARGET_AVX512 double miesmSumAvx512(const double* sinr, std::size_t count, double modulationOrder) {
+    const __m512d bound = _mm512_set1_pd(modulationOrder);
+    const __m512d one = _mm512_set1_pd(1.0);
+    const __m512d zero = _mm512_setzero_pd();
+    __m512d sum = zero;
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d onePlusSinr = _mm512_add_pd(one, _mm512_max_pd(_mm512_loadu_pd(sinr + i), zero));
+        sum = _mm512_add_pd(sum, _mm512_min_pd(bound, simd::log2Avx512(onePlusSinr)));
+    }
+    return _mm512_reduce_add_pd(sum) + miesmSumScalar(sinr + i, count - i, modulationOrder);
+}
+
+#endif // FIVEG_HAVE_X86_SIMD
+
+double sinrMin(const double* sinr, std::size_t count, SimdLevel level) {
+    switch (level) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            return minAvx512(sinr, count);
+        case SimdLevel::AVX2:
+            return minAvx2(sinr, count);
+#endif
+        default:
+            return minScalar(sinr, count);
+    }
+}
+
+// EESM relative to the smallest SINR: every term is in (0, 1] and the one of the smallest
+// SINR is exactly 1, so the mean never underflows
+double eesm(const double* sinr, std::size_t count, double minSinr, double beta, SimdLevel level) {
+    if (count == 0) {
+        return 0.0;
+    }
+    const double inverseBeta = 1.0 / beta;
+    double sum;
+    switch (level) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            sum = eesmSumAvx512(sinr, count, minSinr, inverseBeta);
+            break;
+        case SimdLevel::AVX2:
+            sum = eesmSumAvx2(sinr, count, minSinr, inverseBeta);
+            break;
+#endif
+        default:
+            sum = eesmSumScalar(sinr, count, minSinr, inverseBeta);
+    }
+    return minSinr - beta * std::log(sum / static_cast<double>(count));
+}
+
+double miesm(const double* sinr, std::size_t count, int modulationOrder, SimdLevel level) {
+    if (count == 0) {
+        return 0.0;
+    }
+    const double bound = static_cast<double>(modulationOrder);
+    double sum;
+    switch (level) {
+#if FIVEG_HAVE_X86_SIMD
+        case SimdLevel::AVX512:
+            sum = miesmSumAvx512(sinr, count, bound);
+            break;
+        case SimdLevel::AVX2:
+            sum = miesmSumAvx2(sinr, count, bound);
+            break;
+#endif
+        default:
+            sum = miesmSumScalar(sinr, count, bound);
+    }
+    // 2^I - 1, without the cancellation at low SINRs
+    return std::expm1(sum / static_cast<double>(count) * ln2);
+}
+
+// Beta for which EESM matches MIESM on the reference channel of an MCS. EESM grows
+// monotonically with beta from the smaller SINR to the mean SINR, and the MIESM of the
+// channel lies in between, so a bisection on log(beta) finds it.
+double calibrateBeta(const MCSEntry& mcs) {
+    const double operatingPoint = std::expm1(mcs.maxSpectralEfficiency * ln2);
+    const double channel[2] = {operatingPoint / referenceSpread, operatingPoint * referenceSpread};
+    const double target = miesm(channel, 2, mcs.modulationOrder, SimdLevel::Scalar);
+    double low = std::log(minBeta);
+    double high = std::log(maxBeta);
+    for (int k = 0; k < calibrationIterations && low < high; ++k) {
+        const double mid = low + (high - low) / 2;
+        if (mid <= low || mid >= high) {
+            break;
+        }
+        if (eesm(channel, 2, channel[0], std::exp(mid), SimdLevel::Scalar) < target) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    return std::exp(high);
+}
+
+struct BetaTables {
+    double beta[3][maxMcsEntries];
+
+    BetaTables() {
+        const MCSTableId tables[3] = {MCSTableId::Table1, MCSTableId::Table2, MCSTableId::Table3};
+        for (int t = 0; t < 3; ++t) {
+            const ConstexprTable<MCSEntry> mcs = getMCSTable(tables[t]);
+            for (std::size_t m = 0; m < mcs.size(); ++m) {
+                beta[t][m] = calibrateBeta(mcs[m]);
+            }
+        }
+    }
+};
+
+const double* betaTable(MCSTableId table) {
+    static const BetaTables tables;
+    return tables.beta[table == MCSTableId::Table1 ? 0 : (table == MCSTableId::Table3 ? 2 : 1)];
+}
+
+} // namespace
+
+double calculateEesmEffectiveSinr(const double* sinrLinear, std::size_t count, double beta) {
+    const SimdLevel level = activeSimdLevel();
+    return eesm(sinrLinear, count, sinrMin(sinrLinear, count, level), beta, level);
+}
+
+double calculateMiesmEffectiveSinr(const double* sinrLinear, std::size_t count, int modulationOrder) {
+    return miesm(sinrLinear, count, modulationOrder, activeSimdLevel());
+}
+
+double eesmBeta(int mcsIndex, MCSTableId table) {
+    if (mcsIndex < 0 || mcsIndex >= static_cast<int>(getMCSTable(table).size())) {
+        throw std::runtime_error("Invalid MCS index");
+    }
+    return betaTable(table)[mcsIndex];
+}
+
+EffectiveLinkAdaptation determineEffectiveLinkAdaptation(const double* sinrLinear, std::size_t numPrbs,
+                                                         const EffectiveSinrConfig& config) {
+    const SimdLevel level = activeSimdLevel();
+    const ConstexprTable<MCSEntry> mcs = getMCSTable(config.mcsTable);
+    const bool eesmModel = config.model == EffectiveSinrModel::EESM;
+    const double* beta = config.beta ? config.beta : betaTable(config.mcsTable);
+    const double minSinr = eesmModel ? sinrMin(sinrLinear, numPrbs, level) : 0.0;
+
+    // Beta or Qm of an MCS; the effective SINR grows with either
+    auto parameter = [&](int m) {
+        return eesmModel ? beta[m] : static_cast<double>(mcs[m].modulationOrder);
+    };
+    auto evaluate = [&](int m) {
+        EffectiveLinkAdaptation result;
+        result.effectiveSinr = eesmModel ? eesm(sinrLinear, numPrbs, minSinr, beta[m], level)
+                                         : miesm(sinrLinear, numPrbs, mcs[m].modulationOrder, level);
+        result.entry = determineLinkAdaptationLinear(result.effectiveSinr, config.cqiTable, config.mcsTable);
+        return result;
+    };
+
+    int m = 0;
+    for (int k = 1; k < static_cast<int>(mcs.size()); ++k) {
+        if (parameter(k) >= parameter(m)) {
+            m = k;
+        }
+    }
+    // Each step selects a lower MCS, so the walk ends after at most one step per MCS
+    EffectiveLinkAdaptation result = evaluate(m);
+    while (result.entry.mcsIndex < m) {
+        m = result.entry.mcsIndex;
+        result = evaluate(m);
+    }
+    return result;
+}
+
+void determineEffectiveLinkAdaptationBatch(const double* sinrLinear, std::size_t numPrbs, std::size_t numUes,
+                                           EffectiveLinkAdaptation* results, const EffectiveSinrConfig& config) {
+    parallelFor(numUes, parallelGrain(numUes, effectiveSinrParallelGrain), [&](std::size_t begin, std::size_t end) {
+        for (std::size_t ue = begin; ue < end; ++ue) {
+            results[ue] = determineEffectiveLinkAdaptation(sinrLinear + ue * numPrbs, numPrbs, config);
+        }
+    });
+}
@@ -0,0 +1,115 @@
+#include "linkadaptation.h"
+#include <limits>
+
+namespace {
+
+// SNRs far enough out that every table is at its lowest and highest CQI
+constexpr double lowestSnr_dB = -300.0;
+constexpr double highestSnr_dB = 300.0;
+
+// Smallest SNR whose CQI index is at least cqiIndex, to the last bit. The chain is
+// monotonic in the SNR, so a bisection over doubles converges onto the switch point.
+double findThreshold(int cqiIndex, CQITableId cqiTable, MCSTableId mcsTable) {
+    double below = lowestSnr_dB;
+    double above = highestSnr_dB;
+    while (true) {
+        double mid = below + (above - below) / 2;
+        if (mid <= below || mid >= above) {
+            return above;
+        }
+        if (determineLinkAdaptation(mid, cqiTable, mcsTable).cqiIndex >= cqiIndex) {
+            above = mid;
+        } else {
+            below = mid;
+        }
+    }
+}
+
+} // namespace
+
+LinkAdaptationEntry determineLinkAdaptation(double snr_dB, CQITableId cqiTable, MCSTableId mcsTable) {
+    return determineLinkAdaptationLinear(std::pow(10, snr_dB / 10), cqiTable, mcsTable);
+}
+
+LinkAdaptationEntry determineLinkAdaptationLinear(double snrLinear, CQITableId cqiTable, MCSTableId mcsTable) {
+    double spectralEfficiency = calculateSpectralEfficiencyPerLayer(snrLinear);
+    auto cqiResult = determineIntermediateSpectralEfficiency(spectralEfficiency, cqiTable);
+    int mcsIndex = determineMcsIndex(cqiResult.second, mcsTable);
+    const MCSEntry& mcs = getMCSTable(mcsTable)[mcsIndex];
+
+    LinkAdaptationEntry entry;
+    entry.cqiIndex = static_cast<std::uint8_t>(cqiResult.first);
+    entry.mcsIndex = static_cast<std::uint8_t>(mcsIndex);
+    entry.modulationOrder = static_cast<std::uint8_t>(mcs.modulationOrder);
+    entry.codeRate = static_cast<float>(mcs.mcsCodeRate);
+    return entry;
+}
+
+LinkAdaptationTable::LinkAdaptationTable(double minSnr_dB, double maxSnr_dB, double step_dB,
+                                         CQITableId cqiTable, MCSTableId mcsTable)
+    : minSnr_dB_(minSnr_dB),
+      step_dB_(step_dB),
+      inverseStep_(1.0 / step_dB),
+      cqiTable_(cqiTable),
+      mcsTable_(mcsTable) {
+    std::size_t numBins = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil((maxSnr_dB - minSnr_dB) / step_dB)));
+    lastBin_ = static_cast<double>(numBins - 1);
+
+    // Decision thresholds, and the decision taken from each threshold on
+    std::vector<LinkAdaptationEntry> decisions(1, determineLinkAdaptation(lowestSnr_dB, cqiTable, mcsTable));
+    int highestCqi = determineLinkAdaptation(highestSnr_dB, cqiTable, mcsTable).cqiIndex;
+    for (int cqi = decisions[0].cqiIndex + 1; cqi <= highestCqi; ++cqi) {
+        double threshold = findThreshold(cqi, cqiTable, mcsTable);
+        if (thresholds_.empty() || threshold != thresholds_.back()) {
+            thresholds_.push_back(threshold);
+            decisions.push_back(determineLinkAdaptation(threshold, cqiTable, mcsTable));
+        }
+    }
+
+    bins_.resize(numBins);
+    std::size_t next = 0; // first threshold not below the current bin
+    for (std::size_t b = 0; b < numBins; ++b) {
+        while (next < thresholds_.size() && binIndex(thresholds_[next]) < b) {
+            ++next;
+        }
+        std::size_t inside = 0;
+        while (next + inside < thresholds_.size() && binIndex(thresholds_[next + inside]) == b) {
+            ++inside;
+        }
+
+        Bin& bin = bins_[b];
+        bin.below = decisions[next];
+        bin.above = inside > 0 ? decisions[next + 1] : bin.below;
+        bin.threshold = inside > 0 ? thresholds_[next] : std::numeric_limits<double>::infinity();
+        bin.multipleThresholds = inside > 1;
+    }
+}
+
+void LinkAdaptationTable::lookup(const double* snr_dB, LinkAdaptationEntry* entries, std::size_t count) const {
+    for (std::size_t i = 0; i < count; ++i) {
+        entries[i] = lookup(snr_dB[i]);
+    }
+}
+
+std::size_t LinkAdaptationTable::validate() const {
+    const double infinity = std::numeric_limits<double>::infinity();
+    std::vector<double> probes;
+    for (std::size_t b = 0; b <= bins_.size(); ++b) {
+        double edge = minSnr_dB_ + b * step_dB_;
+        probes.push_back(std::nextafter(edge, -infinity));
+        probes.push_back(edge);
+        probes.push_back(std::nextafter(edge, infinity));
+    }
+    for (double threshold : thresholds_) {
+        probes.push_back(std::nextafter(threshold, -infinity));
+        probes.push_back(threshold);
+    }
+    probes.push_back(lowestSnr_dB);
+    probes.push_back(highestSnr_dB);
+
+    std::size_t mismatches = 0;
+    for (double snr : probes) {
+        mismatches += (lookup(snr) != determineLinkAdaptation(snr, cqiTable_, mcsTable_));
+    }
+    return mismatches;
+}
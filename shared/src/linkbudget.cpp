@@ -0,0 +1,177 @@
+#include "linkbudget.h"
+#include "metrics.h"
+#include "numerology.h"
+#include "parallel.h"
+#include "tbs.h"
+
+namespace {
+
+// Smallest number of blocks worth handing to another thread
+constexpr std::size_t dlThroughputParallelBlocks = 16;
+
+// Boltzmann's constant in Joules per Kelvin, as used by calculateThermalNoisePower()
+constexpr double boltzmannConstant = 1.38e-23;
+
+// Index a linear scan of a CQI/MCS table would stop at: the number of leading entries
+// whose spectral efficiency does not exceed the given value, entry 0 being the fallback.
+// The running maximum keeps this correct for tables that are not strictly sorted
+// (MCS table 1), without a data dependent branch.
+template <typename Entry, double Entry::*SpectralEfficiency>
+int countLeadingEntriesNotAbove(const ConstexprTable<Entry>& table, double spectralEfficiency) {
+    int index = 0;
+    double threshold = 0.0;
+    for (std::size_t i = 1; i < table.size(); ++i) {
+        threshold = std::max(threshold, table[i].*SpectralEfficiency);
+        index += (threshold <= spectralEfficiency);
+    }
+    return index;
+}
+
+// Steps 12-15: bits per slot across layers and available PRBs, then throughput. Called
+// with a NumerologyConstant, the slot duration is a power of two constant and the
+// division an exact multiplication.
+struct ThroughputStage {
+    const int* numOfLayers;
+    const int* prbCount;
+    const int* tbs;
+    const DLThroughputConfig& config;
+    double* throughput;
+    std::size_t n;
+
+    template <typename Numerology>
+    void operator()(Numerology numerology) const {
+        const double slotDuration = calculateSlotSize(numerology);
+        const double throughputRatio = static_cast<double>(config.applicationPacketSize) / config.macPacketSize;
+        for (std::size_t i = 0; i < n; ++i) {
+            int totalPRBAvailable = prbCount[i] - static_cast<int>(std::ceil(prbCount[i] * config.downlinkOverhead));
+            int bitsPerSlot = numOfLayers[i] * tbs[i] * totalPRBAvailable;
+            throughput[i] = (bitsPerSlot * config.dlFraction) / slotDuration * throughputRatio;
+        }
+    }
+};
+
+void processBlock(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                  const DLThroughputConfig& config, std::size_t begin, std::size_t n) {
+    double rxPowerPerLayer[dlThroughputBatchBlockSize];
+    double thermalNoisePower[dlThroughputBatchBlockSize];
+    double snr[dlThroughputBatchBlockSize];
+    double spectralEfficiency[dlThroughputBatchBlockSize];
+    int cqi[dlThroughputBatchBlockSize];
+    int mcs[dlThroughputBatchBlockSize];
+    int tbs[dlThroughputBatchBlockSize];
+
+    const double* pathLoss = input.pathLoss + begin;
+    const double* txPower = input.txPower + begin;
+    const int* numOfLayers = input.numOfLayers + begin;
+    const int* prbCount = input.prbCount + begin;
+    const double* bandwidth = input.bandwidth + begin;
+    FIVEG_METRICS_TIMELINE(timeline);
+
+    // Steps 1-4: large-scale loss, Rx power per layer, thermal noise and linear SNR
+    for (std::size_t i = 0; i < n; ++i) {
+        double totalLoss = pathLoss[i]
+                         + (input.shadowingLoss ? input.shadowingLoss[begin + i] : config.shadowingLoss)
+                         + (input.o2iLoss ? input.o2iLoss[begin + i] : config.o2iLoss);
+        double txPowerPerLayer = txPower[i] - 10 * std::log10(numOfLayers[i]);
+        rxPowerPerLayer[i] = txPowerPerLayer - totalLoss + config.beamFormingGain;
+        thermalNoisePower[i] = boltzmannConstant * config.temperature * bandwidth[i];
+    }
+    calculateSNRLinearBatch(rxPowerPerLayer, thermalNoisePower, snr, n, config.conversionAccuracy);
+    FIVEG_METRICS_LAP(timeline, MetricStage::DLSnr, n);
+
+    // Steps 5-7: spectral efficiency, CQI index and MCS index
+    const ConstexprTable<CQIEntry> cqiEntries = getCQITable(config.cqiTableId);
+    const ConstexprTable<MCSEntry> mcsEntries = getMCSTable(config.mcsTableId);
+    calculateSpectralEfficiencyPerLayerBatch(snr, spectralEfficiency, n, config.conversionAccuracy);
+    for (std::size_t i = 0; i < n; ++i) {
+        cqi[i] = countLeadingEntriesNotAbove<CQIEntry, &CQIEntry::intermediateSpectralEfficiency>(cqiEntries,
+                                                                                                  spectralEfficiency[i]);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        mcs[i] = countLeadingEntriesNotAbove<MCSEntry, &MCSEntry::maxSpectralEfficiency>(
+            mcsEntries, cqiEntries[cqi[i]].intermediateSpectralEfficiency);
+    }
+    FIVEG_METRICS_LAP(timeline, MetricStage::DLMcs, n);
+
+    // Steps 8-11: REs available to the UE, Ninfo and TBS
+    int availableREs = calculateAvailableREs(numOfSCsPerRB, config.numOfSymbolsPerSlot,
+                                             config.numOfREsForDMRS, config.numOfOverheadREs);
+    int actualAvailableREs = calculateActualAvailableREs(availableREs, config.prbPerUE);
+    const TBSLookupTable* lookupTable = config.tbsLookupTable;
+    // The table holds determineTBS(), which is 0 without REs where the chain below gives 24
+    if (lookupTable && lookupTable->mcsTableId() == config.mcsTableId &&
+        actualAvailableREs >= 1 && actualAvailableREs <= lookupTable->maxREs()) {
+        for (std::size_t i = 0; i < n; ++i) {
+            tbs[i] = lookupTable->lookup(actualAvailableREs, mcs[i], 1);
+        }
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            const MCSEntry& entry = mcsEntries[mcs[i]];
+            tbs[i] = calculateTBSForScaledNinfo(scaledNinfo(actualAvailableREs, entry.mcsCodeRate, entry.modulationOrder, 1),
+                                                static_cast<int>(entry.mcsCodeRate));
+        }
+    }
+    FIVEG_METRICS_LAP(timeline, MetricStage::DLTbs, n);
+
+    // Steps 12-15, specialized for the numerology of the batch
+    const ThroughputStage throughputStage = {numOfLayers, prbCount, tbs, config, output.throughput + begin, n};
+    if (config.numerology >= 0 && config.numerology <= maxNumerology) {
+        dispatchNumerology(config.numerology, throughputStage);
+    } else {
+        throughputStage(config.numerology);
+    }
+    FIVEG_METRICS_LAP(timeline, MetricStage::DLThroughput, n);
+
+    // Optional intermediate columns
+    if (output.snrLinear) std::copy(snr, snr + n, output.snrLinear + begin);
+    if (output.cqiIndex) std::copy(cqi, cqi + n, output.cqiIndex + begin);
+    if (output.mcsIndex) std::copy(mcs, mcs + n, output.mcsIndex + begin);
+    if (output.tbsSize) std::copy(tbs, tbs + n, output.tbsSize + begin);
+    for (std::size_t i = 0; output.modulationOrder && i < n; ++i) {
+        output.modulationOrder[begin + i] = mcsEntries[mcs[i]].modulationOrder;
+    }
+    for (std::size_t i = 0; output.codeRate && i < n; ++i) {
+        output.codeRate[begin + i] = mcsEntries[mcs[i]].mcsCodeRate;
+    }
+    FIVEG_METRICS_LAP(timeline, MetricStage::DLOutputColumns, n);
+}
+
+} // namespace
+
+void calculateDLThroughputBatch(const DLThroughputBatchInput& input, const DLThroughputBatchOutput& output,
+                                const DLThroughputConfig& config) {
+    const std::size_t grain = parallelGrain(input.count, dlThroughputParallelBlocks * dlThroughputBatchBlockSize);
+    parallelFor(input.count, grain, [&](std::size_t chunkBegin, std::size_t chunkEnd) {
+        FIVEG_METRICS_SCOPE(MetricStage::DLThroughputBatch, chunkEnd - chunkBegin);
+        for (std::size_t begin = chunkBegin; begin < chunkEnd; begin += dlThroughputBatchBlockSize) {
+            std::size_t n = std::min(dlThroughputBatchBlockSize, chunkEnd - begin);
+            processBlock(input, output, config, begin, n);
+        }
+    });
+}
+
+double calculateDLThroughput(double pathLoss, double txPower, int numOfLayers, int prbCount, double bandwidth,
+                             const DLThroughputConfig& config) {
+    double lsTotalLoss = calculateLargeScaleTotalLoss(pathLoss, config.shadowingLoss, config.o2iLoss);
+    double txPowerPerLayer = calculateTransmittedPowerPerLayer(txPower, numOfLayers);
+    double rxPowerPerLayer = calculateReceivedPowerPerLayer(txPowerPerLayer, lsTotalLoss, config.beamFormingGain);
+    double thermalNoisePower = calculateThermalNoisePower(config.temperature, bandwidth);
+    double linearSNR = calculateSNRLinear(rxPowerPerLayer, thermalNoisePower);
+    double spectralEfficiency = calculateSpectralEfficiencyPerLayer(linearSNR);
+    auto cqiResult = determineIntermediateSpectralEfficiency(spectralEfficiency, config.cqiTableId);
+    auto mcsResult = determineModulationAndCodeRate(cqiResult.second, config.mcsTableId);
+
+    int availableRE = calculateAvailableREs(numOfSCsPerRB, config.numOfSymbolsPerSlot,
+                                            config.numOfREsForDMRS, config.numOfOverheadREs);
+    int actualAvailableRE = calculateActualAvailableREs(availableRE, config.prbPerUE);
+    double nInfo = calculateNumberOfInformationBits(actualAvailableRE, mcsResult.second, mcsResult.first);
+    int tbsSize = calculateTBSForNinfo(nInfo, static_cast<int>(mcsResult.second));
+
+    int totalBitsPerPrb = calculateTotalBitsPerPrb(numOfLayers, tbsSize);
+    int totalPRBAvailable = calculateTotalPRBsAvailable(prbCount, config.downlinkOverhead);
+    int bitsPerSlot = calculateBitsPerSlot(totalBitsPerPrb, totalPRBAvailable);
+    double slotDuration = calculateSlotSize(config.numerology);
+
+    return calculateDLApplicationThroughput(bitsPerSlot, config.dlFraction, slotDuration,
+                                            config.applicationPacketSize, config.macPacketSize);
+}
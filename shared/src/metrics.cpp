@@ -0,0 +1,270 @@
+#include "metrics.h"
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+const char* const stageNames[numMetricStages] = {
+    "dl_throughput_batch", "dl_snr", "dl_mcs", "dl_tbs", "dl_throughput", "dl_output_columns",
+    "pathloss_rural_batch", "tbs_batch"};
+
+const char* const invalidInputNames[numInvalidInputs] = {
+    "calculateWavelength", "calculateFrequencyFromWavelength", "calculateShannonsCapacity",
+    "calculateOFDMSymbolDuration", "calculateNumberOfSubcarriers", "calculateFFTSize", "calculateCoherenceTime",
+    "calculateCoherenceBandwidth", "calculateNumberOfSlots", "QamModulationSchemeDescriptor",
+    "calculateSpectralEfficiencyPerLayer"};
+
+// Shortest interval the tick rate is measured over
+constexpr std::chrono::milliseconds tickCalibrationTime(10);
+
+// Counters written by their owning thread only, with relaxed load and store pairs, and
+// read by readMetrics() from any thread
+struct ThreadMetrics {
+    std::atomic<std::uint64_t> calls[numMetricStages];
+    std::atomic<std::uint64_t> elements[numMetricStages];
+    std::atomic<std::uint64_t> ticks[numMetricStages];
+    std::atomic<std::uint64_t> invalidInputs[numInvalidInputs];
+    std::atomic<bool> owned{true};
+
+    ThreadMetrics() {
+        for (std::size_t s = 0; s < numMetricStages; ++s) {
+            calls[s].store(0, std::memory_order_relaxed);
+            elements[s].store(0, std::memory_order_relaxed);
+            ticks[s].store(0, std::memory_order_relaxed);
+        }
+        for (std::size_t f = 0; f < numInvalidInputs; ++f) {
+            invalidInputs[f].store(0, std::memory_order_relaxed);
+        }
+    }
+};
+
+void add(std::atomic<std::uint64_t>& counter, std::uint64_t value) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// Raw totals, before the conversion of ticks to seconds
+struct MetricTotals {
+    std::uint64_t calls[numMetricStages] = {};
+    std::uint64_t elements[numMetricStages] = {};
+    std::uint64_t ticks[numMetricStages] = {};
+    std::uint64_t invalidInputs[numInvalidInputs] = {};
+};
+
+struct MetricsRegistry {
+    std::mutex mutex; // guards threads and baseline; taken once per thread, on its first count
+    std::vector<std::unique_ptr<ThreadMetrics>> threads;
+    MetricTotals baseline; // totals at the last resetMetrics()
+    const std::uint64_t startTicks = readMetricTicks();
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+    std::mutex exitMutex; // guards the writeMetricsAtExit() settings
+    std::string exitPath;
+    MetricsFormat exitFormat = MetricsFormat::Json;
+    bool exitRegistered = false;
+};
+
+// Never destroyed: threads of the parallel pool may still count while the process exits,
+// and the atexit() handler reads the counters after the static destructors have started
+MetricsRegistry& registry() {
+    static MetricsRegistry* instance = new MetricsRegistry();
+    return *instance;
+}
+
+// Counters left by finished threads are handed to new threads, which add to them
+ThreadMetrics* acquireThreadMetrics() {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& thread : reg.threads) {
+        bool owned = false;
+        if (thread->owned.compare_exchange_strong(owned, true, std::memory_order_acquire)) {
+            return thread.get();
+        }
+    }
+    reg.threads.emplace_back(new ThreadMetrics());
+    return reg.threads.back().get();
+}
+
+struct ThreadMetricsOwner {
+    ThreadMetrics* metrics = acquireThreadMetrics();
+    ~ThreadMetricsOwner() { metrics->owned.store(false, std::memory_order_release); }
+};
+
+// The plain pointer keeps the common path free of the guard of a thread_local object
+thread_local ThreadMetrics* localMetrics = nullptr;
+
+ThreadMetrics& threadMetrics() {
+    if (!localMetrics) {
+        thread_local ThreadMetricsOwner owner;
+        localMetrics = owner.metrics;
+    }
+    return *localMetrics;
+}
+
+MetricTotals sumThreads(MetricsRegistry& reg) {
+    MetricTotals totals;
+    for (auto& thread : reg.threads) {
+        for (std::size_t s = 0; s < numMetricStages; ++s) {
+            totals.calls[s] += thread->calls[s].load(std::memory_order_relaxed);
+            totals.elements[s] += thread->elements[s].load(std::memory_order_relaxed);
+            totals.ticks[s] += thread->ticks[s].load(std::memory_order_relaxed);
+        }
+        for (std::size_t f = 0; f < numInvalidInputs; ++f) {
+            totals.invalidInputs[f] += thread->invalidInputs[f].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+double ticksPerSecond(const MetricsRegistry& reg) {
+#if FIVEG_HAVE_RDTSC
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    while (now - reg.startTime < tickCalibrationTime) {
+        now = std::chrono::steady_clock::now();
+    }
+    const std::uint64_t ticks = readMetricTicks();
+    return (ticks - reg.startTicks) / std::chrono::duration<double>(now - reg.startTime).count();
+#else
+    (void)reg;
+    return 1e9;
+#endif
+}
+
+void writeAtExit() {
+    MetricsRegistry& reg = registry();
+    std::string path;
+    MetricsFormat format;
+    {
+        std::lock_guard<std::mutex> lock(reg.exitMutex);
+        path = reg.exitPath;
+        format = reg.exitFormat;
+    }
+    std::ofstream out(path.c_str());
+    writeMetrics(out, format);
+}
+
+} // namespace
+
+void recordStage(MetricStage stage, std::size_t elements, std::uint64_t ticks) {
+    ThreadMetrics& metrics = threadMetrics();
+    const std::size_t s = static_cast<std::size_t>(stage);
+    add(metrics.calls[s], 1);
+    add(metrics.elements[s], elements);
+    add(metrics.ticks[s], ticks);
+}
+
+void countInvalidInput(InvalidInput function) {
+    add(threadMetrics().invalidInputs[static_cast<std::size_t>(function)], 1);
+}
+
+MetricsSnapshot readMetrics() {
+    MetricsRegistry& reg = registry();
+    MetricTotals totals;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        totals = sumThreads(reg);
+        for (std::size_t s = 0; s < numMetricStages; ++s) {
+            totals.calls[s] -= reg.baseline.calls[s];
+            totals.elements[s] -= reg.baseline.elements[s];
+            totals.ticks[s] -= reg.baseline.ticks[s];
+        }
+        for (std::size_t f = 0; f < numInvalidInputs; ++f) {
+            totals.invalidInputs[f] -= reg.baseline.invalidInputs[f];
+        }
+    }
+
+    MetricsSnapshot snapshot;
+    const double tickRate = ticksPerSecond(reg);
+    for (std::size_t s = 0; s < numMetricStages; ++s) {
+        snapshot.stages[s].calls = totals.calls[s];
+        snapshot.stages[s].elements = totals.elements[s];
+        snapshot.stages[s].ticks = totals.ticks[s];
+        snapshot.stages[s].seconds = totals.ticks[s] / tickRate;
+    }
+    for (std::size_t f = 0; f < numInvalidInputs; ++f) {
+        snapshot.invalidInputs[f] = totals.invalidInputs[f];
+    }
+    return snapshot;
+}
+
+void resetMetrics() {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    reg.baseline = sumThreads(reg);
+}
+
+const char* metricStageName(MetricStage stage) {
+    const std::size_t s = static_cast<std::size_t>(stage);
+    return s < numMetricStages ? stageNames[s] : "unknown";
+}
+
+const char* invalidInputName(InvalidInput function) {
+    const std::size_t f = static_cast<std::size_t>(function);
+    return f < numInvalidInputs ? invalidInputNames[f] : "unknown";
+}
+
+void writeMetricsJson(std::ostream& out, const MetricsSnapshot& metrics) {
+    const std::streamsize precision = out.precision(9);
+    out << "{\n  \"stages\": {";
+    for (std::size_t s = 0; s < numMetricStages; ++s) {
+        const StageMetrics& stage = metrics.stages[s];
+        out << (s ? ",\n" : "\n") << "    \"" << stageNames[s] << "\": {\"calls\": " << stage.calls
+            << ", \"elements\": " << stage.elements << ", \"ticks\": " << stage.ticks
+            << ", \"seconds\": " << stage.seconds << '}';
+    }
+    out << "\n  },\n  \"invalid_inputs\": {";
+    for (std::size_t f = 0; f < numInvalidInputs; ++f) {
+        out << (f ? ",\n" : "\n") << "    \"" << invalidInputNames[f] << "\": " << metrics.invalidInputs[f];
+    }
+    out << "\n  }\n}\n";
+    out.precision(precision);
+}
+
+void writeMetricsPrometheus(std::ostream& out, const MetricsSnapshot& metrics) {
+    const std::streamsize precision = out.precision(9);
+    out << "# HELP fiveg_stage_calls_total Calls of an instrumented stage.\n"
+        << "# TYPE fiveg_stage_calls_total counter\n";
+    for (std::size_t s = 0; s < numMetricStages; ++s) {
+        out << "fiveg_stage_calls_total{stage=\"" << stageNames[s] << "\"} " << metrics.stages[s].calls << '\n';
+    }
+    out << "# HELP fiveg_stage_elements_total Elements processed by an instrumented stage.\n"
+        << "# TYPE fiveg_stage_elements_total counter\n";
+    for (std::size_t s = 0; s < numMetricStages; ++s) {
+        out << "fiveg_stage_elements_total{stage=\"" << stageNames[s] << "\"} " << metrics.stages[s].elements << '\n';
+    }
+    out << "# HELP fiveg_stage_seconds_total Time spent in an instrumented stage, summed over threads.\n"
+        << "# TYPE fiveg_stage_seconds_total counter\n";
+    for (std::size_t s = 0; s < numMetricStages; ++s) {
+        out << "fiveg_stage_seconds_total{stage=\"" << stageNames[s] << "\"} " << metrics.stages[s].seconds << '\n';
+    }
+    out << "# HELP fiveg_invalid_inputs_total Calls rejected with a sentinel return.\n"
+        << "# TYPE fiveg_invalid_inputs_total counter\n";
+    for (std::size_t f = 0; f < numInvalidInputs; ++f) {
+        out << "fiveg_invalid_inputs_total{function=\"" << invalidInputNames[f] << "\"} "
+            << metrics.invalidInputs[f] << '\n';
+    }
+    out.precision(precision);
+}
+
+void writeMetrics(std::ostream& out, MetricsFormat format) {
+    const MetricsSnapshot metrics = readMetrics();
+    if (format == MetricsFormat::Prometheus) {
+        writeMetricsPrometheus(out, metrics);
+    } else {
+        writeMetricsJson(out, metrics);
+    }
+    out.flush();
+}
+
+void writeMetricsAtExit(const std::string& path, MetricsFormat format) {
+    MetricsRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.exitMutex);
+    reg.exitPath = path;
+    reg.exitFormat = format;
+    if (!reg.exitRegistered) {
+        reg.exitRegistered = std::atexit(writeAtExit) == 0;
+    }
+}
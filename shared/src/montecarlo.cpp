@@ -0,0 +1,220 @@
+#include "montecarlo.h"
+#include "parallel.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Samples per chunk. Chunks are the unit of work and of the ordered mean reduction, so
+// they must not depend on the number of threads.
+constexpr std::uint64_t monteCarloChunkSize = 1 << 14;
+
+constexpr std::uint32_t philoxMultiplier0 = 0xD2511F53;
+constexpr std::uint32_t philoxMultiplier1 = 0xCD9E8D57;
+constexpr std::uint32_t philoxWeyl0 = 0x9E3779B9;
+constexpr std::uint32_t philoxWeyl1 = 0xBB67AE85;
+
+// Uniform double in [0, 1) from 53 bits of two words
+double uniformFromWords(std::uint32_t high, std::uint32_t low) {
+    std::uint64_t bits = (static_cast<std::uint64_t>(high) << 21) ^ (low >> 11);
+    return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+}
+
+struct WorkerResult {
+    std::vector<std::uint64_t> histogram;
+    QuantileSketch sketch;
+    std::uint64_t outageSamples = 0;
+    double minThroughput = std::numeric_limits<double>::infinity();
+    double maxThroughput = -std::numeric_limits<double>::infinity();
+};
+
+// Highest throughput any UE of the scenario can reach: every UE at the highest CQI
+double peakThroughput(const DLThroughputBatchInput& scenario, const DLThroughputConfig& linkBudget) {
+    std::vector<double> pathLoss(scenario.count, -1000.0);
+    std::vector<double> throughput(scenario.count);
+    DLThroughputBatchInput input = scenario;
+    input.pathLoss = pathLoss.data();
+    input.shadowingLoss = nullptr;
+    input.o2iLoss = nullptr;
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    DLThroughputConfig config = linkBudget;
+    config.shadowingLoss = 0.0;
+    config.o2iLoss = 0.0;
+    calculateDLThroughputBatch(input, output, config);
+    return *std::max_element(throughput.begin(), throughput.end());
+}
+
+} // namespace
+
+PhiloxBlock philox4x32(const std::uint32_t counter[4], const std::uint32_t key[2]) {
+    std::uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+    std::uint32_t k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; ++round) {
+        std::uint64_t product0 = static_cast<std::uint64_t>(philoxMultiplier0) * c0;
+        std::uint64_t product1 = static_cast<std::uint64_t>(philoxMultiplier1) * c2;
+        std::uint32_t next0 = static_cast<std::uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        std::uint32_t next2 = static_cast<std::uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<std::uint32_t>(product1);
+        c3 = static_cast<std::uint32_t>(product0);
+        c0 = next0;
+        c2 = next2;
+        k0 += philoxWeyl0;
+        k1 += philoxWeyl1;
+    }
+    PhiloxBlock block = {{c0, c1, c2, c3}};
+    return block;
+}
+
+void drawMonteCarloLosses(const MonteCarloConfig& config, std::uint64_t sample,
+                          double& shadowingLoss, double& o2iLoss) {
+    const std::uint32_t key[2] = {static_cast<std::uint32_t>(config.seed), static_cast<std::uint32_t>(config.seed >> 32)};
+    std::uint32_t counter[4] = {static_cast<std::uint32_t>(sample), static_cast<std::uint32_t>(sample >> 32), 0, 0};
+
+    // Box-Muller: two independent standard normals, for the shadowing and the O2I loss
+    PhiloxBlock block = philox4x32(counter, key);
+    double u1 = 1.0 - uniformFromWords(block.v[0], block.v[1]); // (0, 1], keeps the log finite
+    double u2 = uniformFromWords(block.v[2], block.v[3]);
+    double radius = std::sqrt(-2.0 * std::log(u1));
+    shadowingLoss = config.shadowingStdDev * radius * std::cos(2 * pi * u2);
+
+    o2iLoss = 0.0;
+    if (config.indoorProbability > 0) {
+        counter[2] = 1;
+        block = philox4x32(counter, key);
+        const double toUnit = 1.0 / 4294967296.0;
+        if (block.v[0] * toUnit < config.indoorProbability) {
+            double indoorDistance = std::min(block.v[1], block.v[2]) * toUnit * config.maxIndoorDistance;
+            o2iLoss = config.penetrationLoss + 0.5 * indoorDistance
+                    + config.o2iStdDev * radius * std::sin(2 * pi * u2);
+        }
+    }
+}
+
+MonteCarloResult runMonteCarloDLThroughput(const DLThroughputBatchInput& scenario, const MonteCarloConfig& config) {
+    MonteCarloResult result;
+    if (scenario.count == 0 || config.numTrials == 0) {
+        return result;
+    }
+
+    const std::uint64_t numUEs = scenario.count;
+    const std::uint64_t numSamples = config.numTrials * numUEs;
+    const std::uint64_t numChunks = (numSamples + monteCarloChunkSize - 1) / monteCarloChunkSize;
+    const std::size_t numBins = static_cast<std::size_t>(std::max(1, config.numBins));
+    double maxThroughput = config.maxThroughput > 0 ? config.maxThroughput
+                                                    : peakThroughput(scenario, config.linkBudget);
+    const double binWidth = (maxThroughput > 0 ? maxThroughput : 1.0) / numBins;
+
+    const std::size_t numWorkers = static_cast<std::size_t>(std::min<std::uint64_t>(
+        config.numThreads == 0 ? parallelThreadCount() : config.numThreads, numChunks));
+    std::vector<WorkerResult> workers(numWorkers);
+    std::vector<double> chunkSums(static_cast<std::size_t>(numChunks));
+
+    // Worker w takes chunks w, w + numWorkers, ... and owns its histogram and sketch, so
+    // nothing is shared during the run; both are exact counts and simply add up at the end.
+    parallelFor(numWorkers, 1, [&](std::size_t begin, std::size_t end) {
+        double pathLoss[dlThroughputBatchBlockSize];
+        double txPower[dlThroughputBatchBlockSize];
+        int numOfLayers[dlThroughputBatchBlockSize];
+        int prbCount[dlThroughputBatchBlockSize];
+        double bandwidth[dlThroughputBatchBlockSize];
+        double shadowingLoss[dlThroughputBatchBlockSize];
+        double o2iLoss[dlThroughputBatchBlockSize];
+        double throughput[dlThroughputBatchBlockSize];
+
+        DLThroughputBatchInput input;
+        input.pathLoss = pathLoss;
+        input.txPower = txPower;
+        input.numOfLayers = numOfLayers;
+        input.prbCount = prbCount;
+        input.bandwidth = bandwidth;
+        input.shadowingLoss = shadowingLoss;
+        input.o2iLoss = o2iLoss;
+        DLThroughputBatchOutput output;
+        output.throughput = throughput;
+
+        for (std::size_t w = begin; w < end; ++w) {
+            WorkerResult& worker = workers[w];
+            worker.histogram.assign(numBins, 0);
+            for (std::uint64_t chunk = w; chunk < numChunks; chunk += numWorkers) {
+                const std::uint64_t chunkEnd = std::min(numSamples, (chunk + 1) * monteCarloChunkSize);
+                double chunkSum = 0.0;
+                for (std::uint64_t first = chunk * monteCarloChunkSize; first < chunkEnd;
+                     first += dlThroughputBatchBlockSize) {
+                    const std::size_t n = static_cast<std::size_t>(
+                        std::min<std::uint64_t>(dlThroughputBatchBlockSize, chunkEnd - first));
+                    std::size_t ue = static_cast<std::size_t>(first % numUEs);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        pathLoss[i] = scenario.pathLoss[ue];
+                        txPower[i] = scenario.txPower[ue];
+                        numOfLayers[i] = scenario.numOfLayers[ue];
+                        prbCount[i] = scenario.prbCount[ue];
+                        bandwidth[i] = scenario.bandwidth[ue];
+                        drawMonteCarloLosses(config, first + i, shadowingLoss[i], o2iLoss[i]);
+                        ue = (ue + 1 == numUEs) ? 0 : ue + 1;
+                    }
+                    input.count = n;
+                    calculateDLThroughputBatch(input, output, config.linkBudget);
+
+                    worker.sketch.add(throughput, n);
+                    for (std::size_t i = 0; i < n; ++i) {
+                        const double t = throughput[i];
+                        std::size_t bin = static_cast<std::size_t>(std::max(0.0, t / binWidth));
+                        ++worker.histogram[std::min(bin, numBins - 1)];
+                        worker.outageSamples += (t <= config.outageThroughput);
+                        worker.minThroughput = std::min(worker.minThroughput, t);
+                        worker.maxThroughput = std::max(worker.maxThroughput, t);
+                        chunkSum += t;
+                    }
+                }
+                chunkSums[static_cast<std::size_t>(chunk)] = chunkSum;
+            }
+        }
+    }, static_cast<unsigned int>(numWorkers));
+
+    result.numSamples = numSamples;
+    result.binWidth = binWidth;
+    result.histogram.assign(numBins, 0);
+    result.minThroughput = std::numeric_limits<double>::infinity();
+    result.maxThroughput = -std::numeric_limits<double>::infinity();
+    for (const WorkerResult& worker : workers) {
+        for (std::size_t b = 0; b < numBins; ++b) {
+            result.histogram[b] += worker.histogram[b];
+        }
+        result.throughputSketch.merge(worker.sketch);
+        result.outageSamples += worker.outageSamples;
+        result.minThroughput = std::min(result.minThroughput, worker.minThroughput);
+        result.maxThroughput = std::max(result.maxThroughput, worker.maxThroughput);
+    }
+
+    double sum = 0.0;
+    for (double chunkSum : chunkSums) {
+        sum += chunkSum;
+    }
+    result.meanThroughput = sum / numSamples;
+
+    result.cdf.resize(numBins);
+    std::uint64_t cumulative = 0;
+    for (std::size_t b = 0; b < numBins; ++b) {
+        cumulative += result.histogram[b];
+        result.cdf[b] = static_cast<double>(cumulative) / numSamples;
+    }
+    return result;
+}
+
+double monteCarloQuantile(const MonteCarloResult& result, double probability) {
+    if (result.numSamples == 0) {
+        return 0.0;
+    }
+    const double target = std::min(std::max(probability, 0.0), 1.0) * result.numSamples;
+    std::uint64_t before = 0;
+    for (std::size_t b = 0; b < result.histogram.size(); ++b) {
+        const std::uint64_t count = result.histogram[b];
+        if (count > 0 && before + count >= target) {
+            double quantile = (b + (target - before) / count) * result.binWidth;
+            return std::min(std::max(quantile, result.minThroughput), result.maxThroughput);
+        }
+        before += count;
+    }
+    return result.maxThroughput;
+}
@@ -0,0 +1,82 @@
+#include "numerology.h"
+#include <algorithm>
+
+namespace {
+
+// Fills the frame structure of the elements of one numerology; every value is a constant
+// of the instantiation
+struct FrameStructureGroup {
+    const FrameStructureBatchOutput& output;
+    const std::size_t* indices;
+    std::size_t count;
+
+    template <int Mu>
+    void operator()(NumerologyConstant<Mu>) const {
+        constexpr double ofdmSymbolDuration = calculateOFDMSymbolDuration<Mu>(false);
+        constexpr double slotSize = calculateSlotSize<Mu>();
+        constexpr int slotsPerSubframe = calculateNumberOfSlots<Mu>();
+        constexpr double scs = calculateSCS<Mu>();
+        constexpr double rbBandwidth = numOfSCsPerRB * scs;
+        for (std::size_t i = 0; output.ofdmSymbolDuration && i < count; ++i) {
+            output.ofdmSymbolDuration[indices[i]] = ofdmSymbolDuration;
+        }
+        for (std::size_t i = 0; output.slotSize && i < count; ++i) {
+            output.slotSize[indices[i]] = slotSize;
+        }
+        for (std::size_t i = 0; output.slotsPerSubframe && i < count; ++i) {
+            output.slotsPerSubframe[indices[i]] = slotsPerSubframe;
+        }
+        for (std::size_t i = 0; output.scs && i < count; ++i) {
+            output.scs[indices[i]] = scs;
+        }
+        for (std::size_t i = 0; output.rbBandwidth && i < count; ++i) {
+            output.rbBandwidth[indices[i]] = rbBandwidth;
+        }
+    }
+};
+
+} // namespace
+
+void groupByNumerology(const int* numerology, std::size_t count, NumerologyGroups& groups) {
+    const int invalid = NumerologyGroups::numGroups - 1;
+    std::size_t sizes[NumerologyGroups::numGroups] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        const int mu = numerology[i];
+        ++sizes[mu >= 0 && mu <= maxNumerology ? mu : invalid];
+    }
+    groups.begin[0] = 0;
+    for (int g = 0; g < NumerologyGroups::numGroups; ++g) {
+        groups.begin[g + 1] = groups.begin[g] + sizes[g];
+    }
+
+    // Counting sort, stable so that each group keeps the batch order
+    groups.indices.resize(count);
+    std::size_t next[NumerologyGroups::numGroups];
+    std::copy(groups.begin, groups.begin + NumerologyGroups::numGroups, next);
+    for (std::size_t i = 0; i < count; ++i) {
+        const int mu = numerology[i];
+        groups.indices[next[mu >= 0 && mu <= maxNumerology ? mu : invalid]++] = i;
+    }
+}
+
+std::size_t calculateFrameStructureBatch(const int* numerology, const FrameStructureBatchOutput& output,
+                                         std::size_t count) {
+    NumerologyGroups groups;
+    groupByNumerology(numerology, count, groups);
+    for (int mu = 0; mu <= maxNumerology; ++mu) {
+        if (groups.size(mu) > 0) {
+            dispatchNumerology(mu, FrameStructureGroup{output, groups.group(mu), groups.size(mu)});
+        }
+    }
+
+    const int invalid = NumerologyGroups::numGroups - 1;
+    const std::size_t* indices = groups.group(invalid);
+    for (std::size_t i = 0; i < groups.size(invalid); ++i) {
+        if (output.ofdmSymbolDuration) output.ofdmSymbolDuration[indices[i]] = 0.0;
+        if (output.slotSize) output.slotSize[indices[i]] = 0.0;
+        if (output.slotsPerSubframe) output.slotsPerSubframe[indices[i]] = 0;
+        if (output.scs) output.scs[indices[i]] = 0.0;
+        if (output.rbBandwidth) output.rbBandwidth[indices[i]] = 0.0;
+    }
+    return groups.size(invalid);
+}
@@ -0,0 +1,226 @@
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// Chunks each thread would get if the range were split evenly over 64 threads, times four
+constexpr std::size_t targetChunks = 256;
+
+std::atomic<unsigned int>& threadCountSetting() {
+    static std::atomic<unsigned int> count(0);
+    return count;
+}
+
+// Set while the thread runs the body of a loop; nested loops then run serially
+thread_local bool insideLoop = false;
+
+// Chunks [next, end) still to be run by one thread, padded to keep the runs of the
+// threads on separate cache lines
+struct ChunkRun {
+    std::mutex mutex;
+    std::size_t next = 0;
+    std::size_t end = 0;
+    char padding[64];
+};
+
+struct Loop {
+    std::size_t count;
+    std::size_t grain;
+    const std::function<void(std::size_t, std::size_t)>* body;
+    std::size_t numThreads;
+    std::unique_ptr<ChunkRun[]> runs;
+    std::atomic<bool> failed{false};
+    std::exception_ptr failure;
+    std::mutex failureMutex;
+
+    bool takeOwn(std::size_t thread, std::size_t& chunk) {
+        ChunkRun& run = runs[thread];
+        std::lock_guard<std::mutex> lock(run.mutex);
+        if (run.next == run.end) {
+            return false;
+        }
+        chunk = run.next++;
+        return true;
+    }
+
+    // Move the back half of the run of another thread into the empty run of this one
+    bool steal(std::size_t thread) {
+        for (std::size_t k = 1; k < numThreads; ++k) {
+            ChunkRun& victim = runs[(thread + k) % numThreads];
+            std::size_t begin, end;
+            {
+                std::lock_guard<std::mutex> lock(victim.mutex);
+                const std::size_t remaining = victim.end - victim.next;
+                if (remaining == 0) {
+                    continue;
+                }
+                end = victim.end;
+                begin = end - (remaining + 1) / 2;
+                victim.end = begin;
+            }
+            std::lock_guard<std::mutex> lock(runs[thread].mutex);
+            runs[thread].next = begin;
+            runs[thread].end = end;
+            return true;
+        }
+        return false;
+    }
+
+    void work(std::size_t thread) {
+        insideLoop = true;
+        try {
+            std::size_t chunk;
+            while (!failed.load(std::memory_order_relaxed)) {
+                if (!takeOwn(thread, chunk)) {
+                    if (!steal(thread)) {
+                        break;
+                    }
+                    continue;
+                }
+                const std::size_t begin = chunk * grain;
+                (*body)(begin, std::min(count, begin + grain));
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(failureMutex);
+            if (!failure) {
+                failure = std::current_exception();
+            }
+            failed = true;
+        }
+        insideLoop = false;
+    }
+};
+
+// Threads waiting for loops; the calling thread of a loop is its thread 0
+class ThreadPool {
+public:
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            shutdown_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void run(Loop& loop) {
+        std::lock_guard<std::mutex> loopLock(loopMutex_); // one loop at a time
+        while (threads_.size() + 1 < loop.numThreads) {
+            const std::size_t index = threads_.size() + 1;
+            threads_.emplace_back([this, index] { serve(index); });
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            loop_ = &loop;
+            pending_ = loop.numThreads - 1;
+            ++generation_;
+        }
+        wake_.notify_all();
+        loop.work(0);
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this] { return pending_ == 0; });
+        loop_ = nullptr;
+    }
+
+private:
+    void serve(std::size_t index) {
+        std::uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return shutdown_ || generation_ != seen; });
+            if (shutdown_) {
+                return;
+            }
+            seen = generation_;
+            Loop* loop = loop_;
+            if (!loop || index >= loop->numThreads) {
+                continue;
+            }
+            lock.unlock();
+            loop->work(index);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_one();
+            }
+        }
+    }
+
+    std::mutex loopMutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::vector<std::thread> threads_;
+    Loop* loop_ = nullptr;
+    std::size_t pending_ = 0;
+    std::uint64_t generation_ = 0;
+    bool shutdown_ = false;
+};
+
+ThreadPool& threadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+unsigned int hardwareThreadCount() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count == 0 ? 1 : count;
+}
+
+unsigned int parallelThreadCount() {
+    unsigned int count = threadCountSetting().load();
+    return count == 0 ? hardwareThreadCount() : count;
+}
+
+unsigned int setParallelThreadCount(unsigned int numThreads) {
+    threadCountSetting() = numThreads;
+    return parallelThreadCount();
+}
+
+std::size_t parallelGrain(std::size_t count, std::size_t minGrain) {
+    minGrain = std::max<std::size_t>(minGrain, 1);
+    const std::size_t chunk = (count + targetChunks - 1) / targetChunks;
+    return std::max<std::size_t>(1, (chunk + minGrain - 1) / minGrain) * minGrain;
+}
+
+void parallelFor(std::size_t count, std::size_t grain,
+                 const std::function<void(std::size_t begin, std::size_t end)>& body,
+                 unsigned int numThreads) {
+    if (count == 0) {
+        return;
+    }
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t numChunks = (count + grain - 1) / grain;
+    const std::size_t threads = std::min<std::size_t>(numThreads == 0 ? parallelThreadCount() : numThreads, numChunks);
+    if (threads <= 1 || insideLoop) {
+        for (std::size_t begin = 0; begin < count; begin += grain) {
+            body(begin, std::min(count, begin + grain));
+        }
+        return;
+    }
+
+    Loop loop;
+    loop.count = count;
+    loop.grain = grain;
+    loop.body = &body;
+    loop.numThreads = threads;
+    loop.runs.reset(new ChunkRun[threads]);
+    for (std::size_t t = 0; t < threads; ++t) {
+        loop.runs[t].next = numChunks * t / threads;
+        loop.runs[t].end = numChunks * (t + 1) / threads;
+    }
+    threadPool().run(loop);
+    if (loop.failure) {
+        std::rethrow_exception(loop.failure);
+    }
+}
@@ -0,0 +1,267 @@
+#include "pathloss.h"
+#include "metrics.h"
+#include "parallel.h"
+#include "simd.h"
+
+namespace {
+
+// Smallest number of UEs worth handing to another thread, a multiple of every vector width
+constexpr std::size_t pathLossParallelGrain = 8192;
+
+constexpr double log10Of11_75 = 1.070037866607755; // log10(11.75), NLOS UE height term
+
+// UE height dependent terms, shared by every distance evaluated at that height
+struct UeTerms {
+    double heightDifference;      // gNBAntennaHeight - ueHeight
+    double breakpointDistance;
+    double log10Breakpoint;
+    double pl1AtBreakpoint;       // LOS PL1 evaluated at the breakpoint distance
+    double nlosUeTerm;            // 3.2 * log10(11.75 * ueHeight)^2 - 4.97
+};
+
+UeTerms makeUeTerms(const RuralPathLossSite& site, double ueHeight) {
+    UeTerms terms;
+    double log10UeHeight = std::log10(ueHeight);
+    double log10UeTerm = log10Of11_75 + log10UeHeight;
+    terms.heightDifference = site.gNBAntennaHeight - ueHeight;
+    terms.breakpointDistance = site.breakpointPerUeHeight * ueHeight;
+    terms.log10Breakpoint = site.log10BreakpointPerUeHeight + log10UeHeight;
+    terms.pl1AtBreakpoint = site.losLogCoefficient * terms.log10Breakpoint + site.losOffset +
+                            site.losLinearCoefficient * terms.breakpointDistance;
+    terms.nlosUeTerm = 3.2 * log10UeTerm * log10UeTerm - 4.97;
+    return terms;
+}
+
+double pathLossScalar(const RuralPathLossSite& site, const UeTerms& ue, double distance2D, bool isLOS) {
+    double distance3D = std::sqrt(distance2D * distance2D + ue.heightDifference * ue.heightDifference);
+    double log10Distance3D = std::log10(distance3D);
+
+    double plLos = 0;
+    if (distance2D >= 10 && distance2D <= ue.breakpointDistance) {
+        plLos = site.losLogCoefficient * log10Distance3D + site.losOffset + site.losLinearCoefficient * distance3D;
+    } else if (distance2D >= ue.breakpointDistance && distance2D <= 10000) {
+        plLos = ue.pl1AtBreakpoint + 40 * (log10Distance3D - ue.log10Breakpoint);
+    }
+    if (isLOS) {
+        return plLos;
+    }
+
+    double plNlos = 0;
+    if (distance2D >= 10 && distance2D <= 5000) {
+        plNlos = site.nlosConstant + site.nlosLogCoefficient * (log10Distance3D - 3) - ue.nlosUeTerm;
+    }
+    return std::max(plLos, plNlos);
+}
+
+void pathLossBatchScalar(const RuralPathLossSite& site, const double* distance2D, const double* ueHeight,
+                         bool isLOS, double* pathLoss, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = pathLossScalar(site, makeUeTerms(site, ueHeight[i]), distance2D[i], isLOS);
+    }
+}
+
+void pathLossBatchScalar(const RuralPathLossSite& site, const UeTerms& ue, const double* distance2D,
+                         bool isLOS, double* pathLoss, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = pathLossScalar(site, ue, distance2D[i], isLOS);
+    }
+}
+
+#if FIVEG_HAVE_X86_SIMD
+
+FIVEG_TARGET_AVX2 inline __m256d pathLossAvx2(const RuralPathLossSite& site, __m256d d2D, __m256d heightDifference,
+                                              __m256d breakpoint, __m256d log10Breakpoint, __m256d pl1AtBreakpoint,
+                                              __m256d nlosUeTerm, bool isLOS) {
+    const __m256d d3D = _mm256_sqrt_pd(_mm256_fmadd_pd(d2D, d2D, _mm256_mul_pd(heightDifference, heightDifference)));
+    const __m256d lg = simd::log10Avx2(d3D);
+
+    const __m256d pl1 = _mm256_fmadd_pd(_mm256_set1_pd(site.losLogCoefficient), lg,
+                        _mm256_fmadd_pd(_mm256_set1_pd(site.losLinearCoefficient), d3D, _mm256_set1_pd(site.losOffset)));
+    const __m256d pl2 = _mm256_fmadd_pd(_mm256_set1_pd(40.0), _mm256_sub_pd(lg, log10Breakpoint), pl1AtBreakpoint);
+
+    const __m256d atLeast10 = _mm256_cmp_pd(d2D, _mm256_set1_pd(10.0), _CMP_GE_OQ);
+    const __m256d inPl1 = _mm256_and_pd(atLeast10, _mm256_cmp_pd(d2D, breakpoint, _CMP_LE_OQ));
+    const __m256d inPl2 = _mm256_and_pd(_mm256_cmp_pd(d2D, breakpoint, _CMP_GE_OQ),
+                                        _mm256_cmp_pd(d2D, _mm256_set1_pd(10000.0), _CMP_LE_OQ));
+    const __m256d plLos = _mm256_blendv_pd(_mm256_and_pd(inPl2, pl2), pl1, inPl1);
+    if (isLOS) {
+        return plLos;
+    }
+
+    const __m256d inNlos = _mm256_and_pd(atLeast10, _mm256_cmp_pd(d2D, _mm256_set1_pd(5000.0), _CMP_LE_OQ));
+    const __m256d nlos = _mm256_sub_pd(_mm256_fmadd_pd(_mm256_set1_pd(site.nlosLogCoefficient),
+                                                       _mm256_sub_pd(lg, _mm256_set1_pd(3.0)),
+                                                       _mm256_set1_pd(site.nlosConstant)), nlosUeTerm);
+    return _mm256_max_pd(plLos, _mm256_and_pd(inNlos, nlos));
+}
+
+FIVEG_TARGET_AVX2 void pathLossBatchAvx2(const RuralPathLossSite& site, const double* distance2D, const double* ueHeight,
+                                         bool isLOS, double* pathLoss, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m256d h = _mm256_loadu_pd(ueHeight + i);
+        const __m256d log10UeHeight = simd::log10Avx2(h);
+        const __m256d log10UeTerm = _mm256_add_pd(log10UeHeight, _mm256_set1_pd(log10Of11_75));
+        const __m256d breakpoint = _mm256_mul_pd(_mm256_set1_pd(site.breakpointPerUeHeight), h);
+        const __m256d log10Breakpoint = _mm256_add_pd(_mm256_set1_pd(site.log10BreakpointPerUeHeight), log10UeHeight);
+        const __m256d pl1AtBreakpoint = _mm256_fmadd_pd(_mm256_set1_pd(site.losLogCoefficient), log10Breakpoint,
+                                        _mm256_fmadd_pd(_mm256_set1_pd(site.losLinearCoefficient), breakpoint,
+                                                        _mm256_set1_pd(site.losOffset)));
+        const __m256d nlosUeTerm = _mm256_fmsub_pd(_mm256_mul_pd(_mm256_set1_pd(3.2), log10UeTerm), log10UeTerm,
+                                                   _mm256_set1_pd(4.97));
+        const __m256d heightDifference = _mm256_sub_pd(_mm256_set1_pd(site.gNBAntennaHeight), h);
+        _mm256_storeu_pd(pathLoss + i, pathLossAvx2(site, _mm256_loadu_pd(distance2D + i), heightDifference, breakpoint,
+                                                    log10Breakpoint, pl1AtBreakpoint, nlosUeTerm, isLOS));
+    }
+    pathLossBatchScalar(site, distance2D + i, ueHeight + i, isLOS, pathLoss + i, count - i);
+}
+
+FIVEG_TARGET_AVX2 void pathLossBatchAvx2(const RuralPathLossSite& site, const UeTerms& ue, const double* distance2D,
+                                         bool isLOS, double* pathLoss, std::size_t count) {
+    const __m256d heightDifference = _mm256_set1_pd(ue.heightDifference);
+    const __m256d breakpoint = _mm256_set1_pd(ue.breakpointDistance);
+    const __m256d log10Breakpoint = _mm256_set1_pd(ue.log10Breakpoint);
+    const __m256d pl1AtBreakpoint = _mm256_set1_pd(ue.pl1AtBreakpoint);
+    const __m256d nlosUeTerm = _mm256_set1_pd(ue.nlosUeTerm);
+    std::size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        _mm256_storeu_pd(pathLoss + i, pathLossAvx2(site, _mm256_loadu_pd(distance2D + i), heightDifference, breakpoint,
+                                                    log10Breakpoint, pl1AtBreakpoint, nlosUeTerm, isLOS));
+    }
+    pathLossBatchScalar(site, ue, distance2D + i, isLOS, pathLoss + i, count - i);
+}
+
+FIVEG_TARGET_AVX512 inline __m512d pathLossAvx512(const RuralPathLossSite& site, __m512d d2D, __m512d heightDifference,
+                                                  __m512d breakpoint, __m512d log10Breakpoint, __m512d pl1AtBreakpoint,
+                                                  __m512d nlosUeTerm, bool isLOS) {
+    const __m512d zero = _mm512_setzero_pd();
+    const __m512d d3D = _mm512_sqrt_pd(_mm512_fmadd_pd(d2D, d2D, _mm512_mul_pd(heightDifference, heightDifference)));
+    const __m512d lg = simd::log10Avx512(d3D);
+
+    const __m512d pl1 = _mm512_fmadd_pd(_mm512_set1_pd(site.losLogCoefficient), lg,
+                        _mm512_fmadd_pd(_mm512_set1_pd(site.losLinearCoefficient), d3D, _mm512_set1_pd(site.losOffset)));
+    const __m512d pl2 = _mm512_fmadd_pd(_mm512_set1_pd(40.0), _mm512_sub_pd(lg, log10Breakpoint), pl1AtBreakpoint);
+
+    const __mmask8 atLeast10 = _mm512_cmp_pd_mask(d2D, _mm512_set1_pd(10.0), _CMP_GE_OQ);
+    const __mmask8 inPl1 = atLeast10 & _mm512_cmp_pd_mask(d2D, breakpoint, _CMP_LE_OQ);
+    const __mmask8 inPl2 = _mm512_cmp_pd_mask(d2D, breakpoint, _CMP_GE_OQ) &
+                           _mm512_cmp_pd_mask(d2D, _mm512_set1_pd(10000.0), _CMP_LE_OQ);
+    const __m512d plLos = _mm512_mask_blend_pd(inPl1, _mm512_mask_blend_pd(inPl2, zero, pl2), pl1);
+    if (isLOS) {
+        return plLos;
+    }
+
+    const __mmask8 inNlos = atLeast10 & _mm512_cmp_pd_mask(d2D, _mm512_set1_pd(5000.0), _CMP_LE_OQ);
+    const __m512d nlos = _mm512_sub_pd(_mm512_fmadd_pd(_mm512_set1_pd(site.nlosLogCoefficient),
+                                                       _mm512_sub_pd(lg, _mm512_set1_pd(3.0)),
+                                                       _mm512_set1_pd(site.nlosConstant)), nlosUeTerm);
+    return _mm512_max_pd(plLos, _mm512_mask_blend_pd(inNlos, zero, nlos));
+}
+
+FIVEG_TARGET_AVX512 void pathLossBatchAvx512(const RuralPathLossSite& site, const double* distance2D,
+                                             const double* ueHeight, bool isLOS, double* pathLoss, std::size_t count) {
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m512d h = _mm512_loadu_pd(ueHeight + i);
+        const __m512d log10UeHeight = simd::log10Avx512(h);
+        const __m512d log10UeTerm = _mm512_add_pd(log10UeHeight, _mm512_set1_pd(log10Of11_75));
+        const __m512d breakpoint = _mm512_mul_pd(_mm512_set1_pd(site.breakpointPerUeHeight), h);
+        const __m512d log10Breakpoint = _mm512_add_pd(_mm512_set1_pd(site.log10BreakpointPerUeHeight), log10UeHeight);
+        const __m512d pl1AtBreakpoint = _mm512_fmadd_pd(_mm512_set1_pd(site.losLogCoefficient), log10Breakpoint,
+                                        _mm512_fmadd_pd(_mm512_set1_pd(site.losLinearCoefficient), breakpoint,
+                                                        _mm512_set1_pd(site.losOffset)));
+        const __m512d nlosUeTerm = _mm512_fmsub_pd(_mm512_mul_pd(_mm512_set1_pd(3.2), log10UeTerm), log10UeTerm,
+                                                   _mm512_set1_pd(4.97));
+        const __m512d heightDifference = _mm512_sub_pd(_mm512_set1_pd(site.gNBAntennaHeight), h);
+        _mm512_storeu_pd(pathLoss + i, pathLossAvx512(site, _mm512_loadu_pd(distance2D + i), heightDifference,
+                                                      breakpoint, log10Breakpoint, pl1AtBreakpoint, nlosUeTerm, isLOS));
+    }
+    pathLossBatchScalar(site, distance2D + i, ueHeight + i, isLOS, pathLoss + i, count - i);
+}
+
+FIVEG_TARGET_AVX512 void pathLossBatchAvx512(const RuralPathLossSite& site, const UeTerms& ue, const double* distance2D,
+                                             bool isLOS, double* pathLoss, std::size_t count) {
+    const __m512d heightDifference = _mm512_set1_pd(ue.heightDifference);
+    const __m512d breakpoint = _mm512_set1_pd(ue.breakpointDistance);
+    const __m512d log10Breakpoint = _mm512_set1_pd(ue.log10Breakpoint);
+    const __m512d pl1AtBreakpoint = _mm512_set1_pd(ue.pl1AtBreakpoint);
+    const __m512d nlosUeTerm = _mm512_set1_pd(ue.nlosUeTerm);
+    std::size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        _mm512_storeu_pd(pathLoss + i, pathLossAvx512(site, _mm512_loadu_pd(distance2D + i), heightDifference,
+                                                      breakpoint, log10Breakpoint, pl1AtBreakpoint, nlosUeTerm, isLOS));
+    }
+    pathLossBatchScalar(site, ue, distance2D + i, isLOS, pathLoss + i, count - i);
+}
+
+#endif // FIVEG_HAVE_X86_SIMD
+
+} // namespace
+
+RuralPathLossSite makeRuralPathLossSite(double gNBAntennaHeight, double fLow, double fHigh,
+                                        double buildingHeight, double streetWidth) {
+    double centerFrequency = (fLow + fHigh) / 2 * 1e6; // in Hz
+    double fNorm = centerFrequency / 1e9;              // Normalized by 1 GHz
+    double buildingHeightTerm = pow(buildingHeight, 1.72);
+    double log10AntennaHeight = log10(gNBAntennaHeight);
+
+    RuralPathLossSite site;
+    site.gNBAntennaHeight = gNBAntennaHeight;
+    site.breakpointPerUeHeight = 2 * pi * gNBAntennaHeight * (centerFrequency / speedOfLight);
+    site.log10BreakpointPerUeHeight = log10(site.breakpointPerUeHeight);
+    site.losLogCoefficient = 20 + std::min(0.03 * buildingHeightTerm, 10.0);
+    site.losOffset = 20 * log10(40 * pi * fNorm / 3) - std::min(0.044 * buildingHeightTerm, 14.77);
+    site.losLinearCoefficient = 0.002 * log10(buildingHeight);
+    site.nlosConstant = 161.04 - 7.1 * log10(streetWidth) + 7.5 * log10(buildingHeight) -
+                        (24.37 - 3.7 * pow((buildingHeight / gNBAntennaHeight), 2)) * log10AntennaHeight +
+                        20 * log10(fNorm);
+    site.nlosLogCoefficient = 43.42 - 3.1 * log10AntennaHeight * log10AntennaHeight;
+    return site;
+}
+
+double calculate5GPathLossRural(const RuralPathLossSite& site, double ueHeight, double distance2D, bool isLOS) {
+    return pathLossScalar(site, makeUeTerms(site, ueHeight), distance2D, isLOS);
+}
+
+void calculate5GPathLossRuralBatch(const RuralPathLossSite& site, const double* distance2D, const double* ueHeight,
+                                   bool isLOS, double* pathLoss, std::size_t count) {
+    const SimdLevel level = activeSimdLevel();
+    parallelFor(count, parallelGrain(count, pathLossParallelGrain), [&](std::size_t begin, std::size_t end) {
+        const std::size_t n = end - begin;
+        FIVEG_METRICS_SCOPE(MetricStage::PathLossRuralBatch, n);
+        switch (level) {
+#if FIVEG_HAVE_X86_SIMD
+            case SimdLevel::AVX512:
+                pathLossBatchAvx512(site, distance2D + begin, ueHeight + begin, isLOS, pathLoss + begin, n);
+                return;
+            case SimdLevel::AVX2:
+                pathLossBatchAvx2(site, distance2D + begin, ueHeight + begin, isLOS, pathLoss + begin, n);
+                return;
+#endif
+            default:
+                pathLossBatchScalar(site, distance2D + begin, ueHeight + begin, isLOS, pathLoss + begin, n);
+        }
+    });
+}
+
+void calculate5GPathLossRuralBatch(const RuralPathLossSite& site, const double* distance2D, double ueHeight,
+                                   bool isLOS, double* pathLoss, std::size_t count) {
+    const UeTerms ue = makeUeTerms(site, ueHeight);
+    const SimdLevel level = activeSimdLevel();
+    parallelFor(count, parallelGrain(count, pathLossParallelGrain), [&](std::size_t begin, std::size_t end) {
+        const std::size_t n = end - begin;
+        FIVEG_METRICS_SCOPE(MetricStage::PathLossRuralBatch, n);
+        switch (level) {
+#if FIVEG_HAVE_X86_SIMD
+            case SimdLevel::AVX512:
+                pathLossBatchAvx512(site, ue, distance2D + begin, isLOS, pathLoss + begin, n);
+                return;
+            case SimdLevel::AVX2:
+                pathLossBatchAvx2(site, ue, distance2D + begin, isLOS, pathLoss + begin, n);
+                return;
+#endif
+            default:
+                pathLossBatchScalar(site, ue, distance2D + begin, isLOS, pathLoss + begin, n);
+        }
+    });
+}
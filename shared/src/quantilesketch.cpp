@@ -0,0 +1,152 @@
+#include "quantilesketch.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Rows per chunk of sketchDLThroughputBatch()
+constexpr std::size_t sketchChunkSize = 1 << 14;
+
+std::uint64_t bitsOf(double value) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double valueOf(std::uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+} // namespace
+
+QuantileSketch::QuantileSketch(double lowestValue, double highestValue, int precisionBits)
+    : lowestValue_(lowestValue), highestValue_(highestValue), precisionBits_(precisionBits),
+      min_(std::numeric_limits<double>::infinity()), max_(-std::numeric_limits<double>::infinity()) {
+    if (!(lowestValue > 0) || !(highestValue >= lowestValue) || !std::isfinite(highestValue)) {
+        throw std::invalid_argument("Invalid quantile sketch range");
+    }
+    if (precisionBits < 1 || precisionBits > 16) {
+        throw std::invalid_argument("Invalid quantile sketch precision");
+    }
+    firstKey_ = bitsOf(lowestValue) >> (52 - precisionBits);
+    counts_.assign(bucketOf(highestValue) + 2, 0);
+}
+
+void QuantileSketch::add(const double* values, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        add(values[i]);
+    }
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (other.lowestValue_ != lowestValue_ || other.highestValue_ != highestValue_ ||
+        other.precisionBits_ != precisionBits_) {
+        throw std::invalid_argument("Quantile sketches with different buckets cannot be merged");
+    }
+    for (std::size_t b = 0; b < counts_.size(); ++b) {
+        counts_[b] += other.counts_[b];
+    }
+    count_ += other.count_;
+    min_ = std::min(min_, other.min_);
+    max_ = std::max(max_, other.max_);
+}
+
+void QuantileSketch::clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    count_ = 0;
+    min_ = std::numeric_limits<double>::infinity();
+    max_ = -std::numeric_limits<double>::infinity();
+}
+
+double QuantileSketch::bucketMiddle(std::size_t bucket) const {
+    const std::uint64_t key = firstKey_ + bucket - 1;
+    const int shift = 52 - precisionBits_;
+    return 0.5 * (valueOf(key << shift) + valueOf((key + 1) << shift));
+}
+
+double QuantileSketch::quantile(double probability) const {
+    if (count_ == 0) {
+        return 0.0;
+    }
+    const double p = std::min(std::max(probability, 0.0), 1.0);
+    const std::uint64_t rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(p * count_)));
+    if (rank >= count_) {
+        return max_;
+    }
+    std::uint64_t cumulative = counts_.front();
+    if (rank == 1 || cumulative >= rank) {
+        return min_;
+    }
+    for (std::size_t b = 1; b + 1 < counts_.size(); ++b) {
+        cumulative += counts_[b];
+        if (cumulative >= rank) {
+            return std::min(std::max(bucketMiddle(b), min_), max_);
+        }
+    }
+    return max_;
+}
+
+double QuantileSketch::cdf(double value) const {
+    if (count_ == 0 || std::isnan(value)) {
+        return 0.0;
+    }
+    std::size_t last;
+    if (value < lowestValue_) {
+        last = 0;
+    } else if (value > highestValue_) {
+        last = counts_.size() - 1;
+    } else {
+        last = bucketOf(value);
+    }
+    std::uint64_t cumulative = 0;
+    for (std::size_t b = 0; b <= last; ++b) {
+        cumulative += counts_[b];
+    }
+    return static_cast<double>(cumulative) / count_;
+}
+
+void sketchDLThroughputBatch(const DLThroughputBatchInput& input, QuantileSketch& sketch,
+                             const DLThroughputConfig& config) {
+    if (input.count == 0) {
+        return;
+    }
+    const std::size_t numChunks = (input.count + sketchChunkSize - 1) / sketchChunkSize;
+    const std::size_t numWorkers = std::min<std::size_t>(parallelThreadCount(), numChunks);
+    std::vector<QuantileSketch> workers(numWorkers, QuantileSketch(sketch.lowestValue(), sketch.highestValue(),
+                                                                   sketch.precisionBits()));
+
+    // Worker w takes chunks w, w + numWorkers, ... into its own sketch; the sketches hold
+    // exact counts, so merging them gives the same result for any number of workers
+    parallelFor(numWorkers, 1, [&](std::size_t begin, std::size_t end) {
+        double throughput[dlThroughputBatchBlockSize];
+        DLThroughputBatchOutput output;
+        output.throughput = throughput;
+        for (std::size_t w = begin; w < end; ++w) {
+            for (std::size_t chunk = w; chunk < numChunks; chunk += numWorkers) {
+                const std::size_t chunkEnd = std::min(input.count, (chunk + 1) * sketchChunkSize);
+                for (std::size_t first = chunk * sketchChunkSize; first < chunkEnd; first += dlThroughputBatchBlockSize) {
+                    DLThroughputBatchInput block = input;
+                    block.count = std::min(dlThroughputBatchBlockSize, chunkEnd - first);
+                    block.pathLoss += first;
+                    block.txPower += first;
+                    block.numOfLayers += first;
+                    block.prbCount += first;
+                    block.bandwidth += first;
+                    block.shadowingLoss = input.shadowingLoss ? input.shadowingLoss + first : nullptr;
+                    block.o2iLoss = input.o2iLoss ? input.o2iLoss + first : nullptr;
+                    calculateDLThroughputBatch(block, output, config);
+                    workers[w].add(throughput, block.count);
+                }
+            }
+        }
+    }, static_cast<unsigned int>(numWorkers));
+
+    for (const QuantileSketch& worker : workers) {
+        sketch.merge(worker);
+    }
+}
@@ -0,0 +1,381 @@
+#include "resultcache.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr char cacheMagic[8] = {'5', 'G', 'D', 'L', 'T', 'P', 'C', '1'};
+// Version 2: entries come from the batch engine only; version 1 files may hold scalar results
+constexpr std::uint32_t cacheVersion = 2;
+
+// Slots scanned from the home slot of a key before an entry is replaced
+constexpr std::size_t probeWindow = 16;
+
+std::uint64_t mix(std::uint64_t hash, std::uint64_t value) {
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+std::uint64_t bitsOf(double value) {
+    value += 0.0; // -0.0 and 0.0 are the same key
+    std::uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Final avalanche of splitmix64, spreads the key bits over the slot index
+std::uint64_t finalize(std::uint64_t hash) {
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    return hash ^ (hash >> 31);
+}
+
+std::uint64_t hashKey(const DLThroughputCacheKey& key) {
+    std::uint64_t hash = bitsOf(key.pathLoss);
+    hash = mix(hash, bitsOf(key.txPower));
+    hash = mix(hash, bitsOf(key.bandwidth));
+    hash = mix(hash, static_cast<std::uint32_t>(key.numOfLayers));
+    hash = mix(hash, static_cast<std::uint32_t>(key.prbCount));
+    hash = mix(hash, static_cast<std::uint32_t>(key.numerology));
+    return finalize(hash);
+}
+
+// Every field of the configuration the results depend on. The TBS lookup table returns
+// the same TBS as determineTBS() and the numerology is part of the key.
+std::uint64_t fingerprintConfig(const DLThroughputConfig& config) {
+    std::uint64_t hash = cacheVersion;
+    hash = mix(hash, bitsOf(config.dlFraction));
+    hash = mix(hash, static_cast<std::uint32_t>(config.applicationPacketSize));
+    hash = mix(hash, static_cast<std::uint32_t>(config.macPacketSize));
+    hash = mix(hash, static_cast<std::uint32_t>(config.prbPerUE));
+    hash = mix(hash, static_cast<std::uint32_t>(config.numOfSymbolsPerSlot));
+    hash = mix(hash, static_cast<std::uint32_t>(config.numOfREsForDMRS));
+    hash = mix(hash, static_cast<std::uint32_t>(config.numOfOverheadREs));
+    hash = mix(hash, bitsOf(config.temperature));
+    hash = mix(hash, bitsOf(config.shadowingLoss));
+    hash = mix(hash, bitsOf(config.o2iLoss));
+    hash = mix(hash, bitsOf(config.beamFormingGain));
+    hash = mix(hash, bitsOf(config.downlinkOverhead));
+    hash = mix(hash, static_cast<std::uint32_t>(config.cqiTableId));
+    hash = mix(hash, static_cast<std::uint32_t>(config.mcsTableId));
+    hash = mix(hash, static_cast<std::uint32_t>(config.conversionAccuracy));
+    return finalize(hash);
+}
+
+bool hasNaN(const DLThroughputCacheKey& key) {
+    return std::isnan(key.pathLoss) || std::isnan(key.txPower) || std::isnan(key.bandwidth);
+}
+
+// Both entry points evaluate with the batch engine, so that an entry does not depend on
+// which one stored it (the scalar chain differs with Fast conversions, for example)
+double evaluate(const DLThroughputCacheKey& key, const DLThroughputConfig& config) {
+    DLThroughputBatchInput input;
+    input.count = 1;
+    input.pathLoss = &key.pathLoss;
+    input.txPower = &key.txPower;
+    input.numOfLayers = &key.numOfLayers;
+    input.prbCount = &key.prbCount;
+    input.bandwidth = &key.bandwidth;
+    double throughput;
+    DLThroughputBatchOutput output;
+    output.throughput = &throughput;
+    calculateDLThroughputBatch(input, output, config);
+    return throughput;
+}
+
+std::size_t roundUpToPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+} // namespace
+
+struct DLThroughputCache::Header {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entrySize;
+    std::uint64_t capacity;
+    std::uint64_t fingerprint;
+    std::uint64_t size; // occupied entries
+    std::uint8_t padding[24];
+};
+
+struct DLThroughputCache::Entry {
+    double pathLoss;
+    double txPower;
+    double bandwidth;
+    double throughput;
+    std::int32_t numOfLayers;
+    std::int32_t prbCount;
+    std::int32_t numerology;
+    std::uint32_t occupied;
+
+    bool matches(const DLThroughputCacheKey& key) const {
+        return occupied && bitsOf(pathLoss) == bitsOf(key.pathLoss) && bitsOf(txPower) == bitsOf(key.txPower) &&
+               bitsOf(bandwidth) == bitsOf(key.bandwidth) && numOfLayers == key.numOfLayers &&
+               prbCount == key.prbCount && numerology == key.numerology;
+    }
+};
+
+DLThroughputCache::DLThroughputCache(std::size_t capacity, const DLThroughputConfig& config) {
+    initialize(capacity, config);
+    mapping_ = std::calloc(1, mappingSize_);
+    if (!mapping_) {
+        throw std::bad_alloc();
+    }
+    header_ = static_cast<Header*>(mapping_);
+    entries_ = reinterpret_cast<Entry*>(header_ + 1);
+    reset();
+}
+
+DLThroughputCache::DLThroughputCache(const std::string& path, std::size_t capacity, const DLThroughputConfig& config) {
+    initialize(capacity, config);
+    int file = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    struct stat status;
+    if (file >= 0 && ::fstat(file, &status) == 0) {
+        bool keep = static_cast<std::size_t>(status.st_size) == mappingSize_;
+        if (keep || (::ftruncate(file, 0) == 0 && ::ftruncate(file, static_cast<off_t>(mappingSize_)) == 0)) {
+            void* mapping = ::mmap(nullptr, mappingSize_, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+            if (mapping != MAP_FAILED) {
+                mapping_ = mapping;
+                file_ = file;
+                header_ = static_cast<Header*>(mapping_);
+                entries_ = reinterpret_cast<Entry*>(header_ + 1);
+                if (!keep || std::memcmp(header_->magic, cacheMagic, sizeof(cacheMagic)) != 0 ||
+                    header_->version != cacheVersion || header_->entrySize != sizeof(Entry) ||
+                    header_->capacity != capacity_ || header_->fingerprint != fingerprint_) {
+                    reset();
+                }
+                return;
+            }
+        }
+    }
+    if (file >= 0) {
+        ::close(file);
+    }
+    mapping_ = std::calloc(1, mappingSize_);
+    if (!mapping_) {
+        throw std::bad_alloc();
+    }
+    header_ = static_cast<Header*>(mapping_);
+    entries_ = reinterpret_cast<Entry*>(header_ + 1);
+    reset();
+}
+
+DLThroughputCache::~DLThroughputCache() {
+    if (file_ >= 0) {
+        ::munmap(mapping_, mappingSize_);
+        ::close(file_);
+    } else {
+        std::free(mapping_);
+    }
+}
+
+void DLThroughputCache::initialize(std::size_t capacity, const DLThroughputConfig& config) {
+    static_assert(sizeof(Header) == 64, "the header must keep the entries aligned");
+    config_ = config;
+    fingerprint_ = fingerprintConfig(config);
+    capacity_ = roundUpToPowerOfTwo(std::max(capacity, probeWindow));
+    mappingSize_ = sizeof(Header) + capacity_ * sizeof(Entry);
+}
+
+void DLThroughputCache::reset() {
+    std::memset(entries_, 0, capacity_ * sizeof(Entry));
+    std::memset(header_, 0, sizeof(Header));
+    std::memcpy(header_->magic, cacheMagic, sizeof(cacheMagic));
+    header_->version = cacheVersion;
+    header_->entrySize = sizeof(Entry);
+    header_->capacity = capacity_;
+    header_->fingerprint = fingerprint_;
+}
+
+const DLThroughputCache::Entry* DLThroughputCache::lookup(const DLThroughputCacheKey& key, std::uint64_t hash) const {
+    const std::size_t mask = capacity_ - 1;
+    for (std::size_t probe = 0; probe < probeWindow; ++probe) {
+        const Entry& entry = entries_[(hash + probe) & mask];
+        if (!entry.occupied) {
+            return nullptr;
+        }
+        if (entry.matches(key)) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+void DLThroughputCache::insert(const DLThroughputCacheKey& key, std::uint64_t hash, double throughput) {
+    const std::size_t mask = capacity_ - 1;
+    Entry* slot = &entries_[hash & mask];
+    for (std::size_t probe = 0; probe < probeWindow; ++probe) {
+        Entry& entry = entries_[(hash + probe) & mask];
+        if (!entry.occupied) {
+            slot = &entry;
+            ++header_->size;
+            break;
+        }
+        if (entry.matches(key)) {
+            slot = &entry;
+            break;
+        }
+        if (probe + 1 == probeWindow) {
+            ++stats_.evictions;
+        }
+    }
+    slot->pathLoss = key.pathLoss + 0.0;
+    slot->txPower = key.txPower + 0.0;
+    slot->bandwidth = key.bandwidth + 0.0;
+    slot->throughput = throughput;
+    slot->numOfLayers = key.numOfLayers;
+    slot->prbCount = key.prbCount;
+    slot->numerology = key.numerology;
+    slot->occupied = 1;
+}
+
+double DLThroughputCache::throughput(const DLThroughputCacheKey& key) {
+    DLThroughputConfig config = config_;
+    config.numerology = key.numerology;
+    if (hasNaN(key)) {
+        ++stats_.misses;
+        return evaluate(key, config);
+    }
+    const std::uint64_t hash = hashKey(key);
+    if (const Entry* entry = lookup(key, hash)) {
+        ++stats_.hits;
+        return entry->throughput;
+    }
+    ++stats_.misses;
+    double result = evaluate(key, config);
+    insert(key, hash, result);
+    return result;
+}
+
+void DLThroughputCache::throughputBatch(const DLThroughputBatchInput& input, int numerology, double* throughput) {
+    DLThroughputConfig config = config_;
+    config.numerology = numerology;
+    if (input.shadowingLoss || input.o2iLoss) {
+        // Per-UE losses are not part of the key: evaluate every row and store nothing
+        DLThroughputBatchOutput output;
+        output.throughput = throughput;
+        calculateDLThroughputBatch(input, output, config);
+        stats_.misses += input.count;
+        return;
+    }
+
+    // Misses are evaluated once per distinct tuple: repeats of a missed tuple within the
+    // batch are found in a local table of the misses and copied after the evaluation
+    const std::size_t noMiss = static_cast<std::size_t>(-1);
+    const std::size_t pendingMask = roundUpToPowerOfTwo(2 * input.count) - 1;
+    std::vector<std::size_t> pending;
+    std::vector<std::size_t> missIndex;
+    std::vector<std::uint64_t> missHash;
+    std::vector<std::size_t> repeatIndex, repeatMiss;
+    for (std::size_t i = 0; i < input.count; ++i) {
+        DLThroughputCacheKey key = {input.pathLoss[i], input.txPower[i], input.numOfLayers[i], input.prbCount[i],
+                                    input.bandwidth[i], numerology};
+        const std::uint64_t hash = hashKey(key);
+        if (hasNaN(key)) {
+            missIndex.push_back(i);
+            missHash.push_back(hash);
+            continue;
+        }
+        if (const Entry* entry = lookup(key, hash)) {
+            throughput[i] = entry->throughput;
+            continue;
+        }
+        if (pending.empty()) {
+            pending.assign(pendingMask + 1, noMiss);
+        }
+        std::size_t slot = hash & pendingMask;
+        while (pending[slot] != noMiss) {
+            std::size_t j = missIndex[pending[slot]];
+            if (missHash[pending[slot]] == hash && bitsOf(input.pathLoss[j]) == bitsOf(key.pathLoss) &&
+                bitsOf(input.txPower[j]) == bitsOf(key.txPower) && bitsOf(input.bandwidth[j]) == bitsOf(key.bandwidth) &&
+                input.numOfLayers[j] == key.numOfLayers && input.prbCount[j] == key.prbCount) {
+                break;
+            }
+            slot = (slot + 1) & pendingMask;
+        }
+        if (pending[slot] != noMiss) {
+            repeatIndex.push_back(i);
+            repeatMiss.push_back(pending[slot]);
+        } else {
+            pending[slot] = missIndex.size();
+            missIndex.push_back(i);
+            missHash.push_back(hash);
+        }
+    }
+    stats_.hits += input.count - missIndex.size();
+    stats_.misses += missIndex.size();
+    if (missIndex.empty()) {
+        return;
+    }
+
+    const std::size_t numMisses = missIndex.size();
+    std::vector<double> pathLoss(numMisses), txPower(numMisses), bandwidth(numMisses), result(numMisses);
+    std::vector<int> numOfLayers(numMisses), prbCount(numMisses);
+    for (std::size_t m = 0; m < numMisses; ++m) {
+        std::size_t i = missIndex[m];
+        pathLoss[m] = input.pathLoss[i];
+        txPower[m] = input.txPower[i];
+        numOfLayers[m] = input.numOfLayers[i];
+        prbCount[m] = input.prbCount[i];
+        bandwidth[m] = input.bandwidth[i];
+    }
+    DLThroughputBatchInput misses;
+    misses.count = numMisses;
+    misses.pathLoss = pathLoss.data();
+    misses.txPower = txPower.data();
+    misses.numOfLayers = numOfLayers.data();
+    misses.prbCount = prbCount.data();
+    misses.bandwidth = bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = result.data();
+    calculateDLThroughputBatch(misses, output, config);
+
+    for (std::size_t m = 0; m < numMisses; ++m) {
+        throughput[missIndex[m]] = result[m];
+        DLThroughputCacheKey key = {pathLoss[m], txPower[m], numOfLayers[m], prbCount[m], bandwidth[m], numerology};
+        if (!hasNaN(key)) {
+            insert(key, missHash[m], result[m]);
+        }
+    }
+    for (std::size_t r = 0; r < repeatIndex.size(); ++r) {
+        throughput[repeatIndex[r]] = result[repeatMiss[r]];
+    }
+}
+
+bool DLThroughputCache::find(const DLThroughputCacheKey& key, double& throughput) const {
+    if (hasNaN(key)) {
+        return false;
+    }
+    const Entry* entry = lookup(key, hashKey(key));
+    if (entry) {
+        throughput = entry->throughput;
+    }
+    return entry != nullptr;
+}
+
+void DLThroughputCache::clear() {
+    reset();
+}
+
+bool DLThroughputCache::sync() {
+    return file_ >= 0 && ::msync(mapping_, mappingSize_, MS_SYNC) == 0;
+}
+
+std::size_t DLThroughputCache::size() const {
+    return static_cast<std::size_t>(header_->size);
+}
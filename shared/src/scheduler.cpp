@@ -0,0 +1,217 @@
+#include "scheduler.h"
+#include "tbs.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// averageScale_ is brought back to 1 before it can overflow
+constexpr double maxAverageScale = 1e150;
+
+int mcsIndexForSnr(double snrLinear, const DLThroughputConfig& link) {
+    double spectralEfficiency = calculateSpectralEfficiencyPerLayer(snrLinear);
+    auto cqiResult = determineIntermediateSpectralEfficiency(spectralEfficiency, link.cqiTableId);
+    return determineMcsIndex(cqiResult.second, link.mcsTableId);
+}
+
+} // namespace
+
+SchedulerSimulator::SchedulerSimulator(const std::vector<double>& snrLinear, const SchedulerConfig& config)
+    : config_(config),
+      availableREs_(calculateAvailableREs(numOfSCsPerRB, config.link.numOfSymbolsPerSlot,
+                                          config.link.numOfREsForDMRS, config.link.numOfOverheadREs)),
+      forgettingFactor_(1.0 - 1.0 / config.fairnessTimeConstant),
+      averageScale_(1.0),
+      ues_(snrLinear.size()),
+      keys_(snrLinear.size()),
+      heap_(snrLinear.size()),
+      position_(snrLinear.size()) {
+    // A forgetting factor of 0 or less would make averageScale_ infinite and the averages NaN
+    if (!(config.fairnessTimeConstant > 1.0)) {
+        throw std::invalid_argument("The fairness time constant must be above 1 slot");
+    }
+    config_.rbgSize = std::max(1, config.rbgSize);
+    int totalPRBs = std::max(0, calculateTotalPRBsAvailable(config.prbCount, config.link.downlinkOverhead));
+    rbgsPerSlot_ = (totalPRBs + config_.rbgSize - 1) / config_.rbgSize;
+    lastRbgSize_ = totalPRBs - (rbgsPerSlot_ - 1) * config_.rbgSize;
+    scheduled_.reserve(rbgsPerSlot_);
+
+    // The heap must hold every UE before the first setChannel() sifts through it
+    for (std::size_t ue = 0; ue < ues_.size(); ++ue) {
+        heap_[ue] = ue;
+        position_[ue] = ue;
+    }
+    for (std::size_t ue = 0; ue < ues_.size(); ++ue) {
+        setChannel(ue, snrLinear[ue]);
+    }
+}
+
+int SchedulerSimulator::slotTBS(std::size_t ue, int prbs) const {
+    int nRE = calculateActualAvailableREs(availableREs_, prbs);
+    const TBSLookupTable* table = config_.link.tbsLookupTable;
+    if (table && table->mcsTableId() == config_.link.mcsTableId && nRE >= 0 && nRE <= table->maxREs() &&
+        config_.numOfLayers >= 1 && config_.numOfLayers <= table->maxLayers()) {
+        return table->lookup(nRE, ues_[ue].mcs, config_.numOfLayers);
+    }
+    return determineTBS(nRE, ues_[ue].mcs, config_.numOfLayers, config_.link.mcsTableId);
+}
+
+void SchedulerSimulator::setChannel(std::size_t ue, double snrLinear) {
+    ues_[ue].mcs = mcsIndexForSnr(snrLinear, config_.link);
+    ues_[ue].tbs = slotTBS(ue, config_.rbgSize);
+    update(ue);
+}
+
+double SchedulerSimulator::metric(std::size_t ue) const {
+    const UE& state = ues_[ue];
+    switch (config_.policy) {
+        case SchedulerPolicy::RoundRobin:
+            return -static_cast<double>(state.lastServed);
+        case SchedulerPolicy::MaxCI:
+            return state.tbs;
+        default:
+            // TBS over average throughput; averageScale_ is common to all UEs and left out
+            return state.scaledAverage > 0 ? state.tbs / state.scaledAverage : std::numeric_limits<double>::infinity();
+    }
+}
+
+bool SchedulerSimulator::before(std::size_t a, std::size_t b) const {
+    return keys_[a] > keys_[b] || (keys_[a] == keys_[b] && a < b);
+}
+
+void SchedulerSimulator::siftUp(std::size_t position) {
+    std::size_t ue = heap_[position];
+    while (position > 0) {
+        std::size_t parent = (position - 1) / 2;
+        if (!before(ue, heap_[parent])) {
+            break;
+        }
+        heap_[position] = heap_[parent];
+        position_[heap_[position]] = position;
+        position = parent;
+    }
+    heap_[position] = ue;
+    position_[ue] = position;
+}
+
+void SchedulerSimulator::siftDown(std::size_t position) {
+    std::size_t ue = heap_[position];
+    const std::size_t size = heap_.size();
+    while (true) {
+        std::size_t child = 2 * position + 1;
+        if (child >= size) {
+            break;
+        }
+        if (child + 1 < size && before(heap_[child + 1], heap_[child])) {
+            ++child;
+        }
+        if (!before(heap_[child], ue)) {
+            break;
+        }
+        heap_[position] = heap_[child];
+        position_[heap_[position]] = position;
+        position = child;
+    }
+    heap_[position] = ue;
+    position_[ue] = position;
+}
+
+void SchedulerSimulator::update(std::size_t ue) {
+    keys_[ue] = metric(ue);
+    siftUp(position_[ue]);
+    siftDown(position_[ue]);
+}
+
+void SchedulerSimulator::renormalize() {
+    for (UE& state : ues_) {
+        state.scaledAverage /= averageScale_;
+    }
+    averageScale_ = 1.0;
+    for (std::size_t ue = 0; ue < ues_.size(); ++ue) {
+        keys_[ue] = metric(ue);
+    }
+    for (std::size_t position = heap_.size() / 2; position-- > 0;) {
+        siftDown(position);
+    }
+}
+
+void SchedulerSimulator::run(std::uint64_t numSlots) {
+    if (ues_.empty() || rbgsPerSlot_ == 0) {
+        slot_ += numSlots;
+        return;
+    }
+    const double smoothing = 1.0 - forgettingFactor_;
+    std::vector<int> prbs(ues_.size(), 0);
+    for (std::uint64_t n = 0; n < numSlots; ++n, ++slot_) {
+        // One RBG per UE in metric order; when there are more RBGs than UEs, the extra RBGs
+        // go to the same UEs again, in the same order. The metrics only change at the end of
+        // the slot, so every UE is taken out of the heap at most once.
+        scheduled_.clear();
+        for (int rbg = 0; rbg < rbgsPerSlot_; ++rbg) {
+            int size = rbg + 1 == rbgsPerSlot_ ? lastRbgSize_ : config_.rbgSize;
+            if (scheduled_.size() < ues_.size() && static_cast<int>(scheduled_.size()) == rbg) {
+                std::size_t ue = heap_.front();
+                scheduled_.push_back(ue);
+                heap_.front() = heap_.back();
+                position_[heap_.front()] = 0;
+                heap_.pop_back();
+                if (!heap_.empty()) {
+                    siftDown(0);
+                }
+                prbs[ue] = size;
+            } else {
+                prbs[scheduled_[rbg % scheduled_.size()]] += size;
+            }
+        }
+
+        // Proportional fair averages: every UE decays by forgettingFactor_, folded into
+        // averageScale_, and the scheduled UEs add their share of the slot
+        averageScale_ /= forgettingFactor_;
+        for (std::size_t k = 0; k < scheduled_.size(); ++k) {
+            std::size_t ue = scheduled_[k];
+            UE& state = ues_[ue];
+            int tbs = slotTBS(ue, prbs[ue]);
+            state.bits += tbs;
+            state.allocations += (prbs[ue] + config_.rbgSize - 1) / config_.rbgSize;
+            state.lastServed = slot_ * rbgsPerSlot_ + k + 1;
+            state.scaledAverage += smoothing * tbs * averageScale_;
+            prbs[ue] = 0;
+            heap_.push_back(ue);
+            position_[ue] = heap_.size() - 1;
+            keys_[ue] = metric(ue);
+            siftUp(heap_.size() - 1);
+        }
+        if (averageScale_ > maxAverageScale) {
+            renormalize();
+        }
+    }
+}
+
+SchedulerResult SchedulerSimulator::result() const {
+    SchedulerResult result;
+    result.slots = slot_;
+    const double slotDuration = calculateSlotSize(config_.link.numerology);
+    const double throughputRatio = static_cast<double>(config_.link.applicationPacketSize) / config_.link.macPacketSize;
+    double sum = 0.0, sumOfSquares = 0.0;
+    for (const UE& state : ues_) {
+        double bitsPerSlot = slot_ > 0 ? static_cast<double>(state.bits) / slot_ : 0.0;
+        double throughput = (bitsPerSlot * config_.link.dlFraction) / slotDuration * throughputRatio;
+        result.bits.push_back(state.bits);
+        result.allocations.push_back(state.allocations);
+        result.throughput.push_back(throughput);
+        sum += throughput;
+        sumOfSquares += throughput * throughput;
+    }
+    result.cellThroughput = sum;
+    result.fairnessIndex = sumOfSquares > 0 ? sum * sum / (ues_.size() * sumOfSquares) : 0.0;
+    return result;
+}
+
+SchedulerResult runSchedulerSimulation(const std::vector<double>& snrLinear, std::uint64_t numSlots,
+                                       const SchedulerConfig& config) {
+    SchedulerSimulator simulator(snrLinear, config);
+    simulator.run(numSlots);
+    return simulator.result();
+}
@@ -0,0 +1,398 @@
+#include "server.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr std::size_t readBlockSize = 1 << 16;
+
+// Bytes read from one connection per pass, so that a fast client cannot starve the others
+constexpr std::size_t maxReadPerPass = 1 << 20;
+
+constexpr std::size_t binaryHeaderSize = 4;
+
+enum BinaryStatus : std::uint8_t {
+    binaryValid = 0,
+    binaryInvalid = 1,
+    binaryUnknownCommand = 2,
+    binaryMalformed = 3 // nonzero reserved byte
+};
+
+bool setNonBlocking(int fd) {
+    int flags = ::fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && ::fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+bool isNameSeparator(char c) {
+    return c == ' ' || c == '\t' || c == ',' || c == ';';
+}
+
+} // namespace
+
+CommandServer::CommandServer(const CommandServerOptions& options) : options_(options), stopping_(false) {
+    int wake[2];
+    if (::pipe(wake) == 0) {
+        wakeRead_ = wake[0];
+        wakeWrite_ = wake[1];
+        setNonBlocking(wakeRead_);
+        setNonBlocking(wakeWrite_);
+    }
+}
+
+CommandServer::~CommandServer() {
+    for (const Connection& connection : connections_) {
+        ::close(connection.fd);
+    }
+    if (listener_ >= 0) {
+        ::close(listener_);
+        ::unlink(path_.c_str());
+    }
+    if (wakeRead_ >= 0) {
+        ::close(wakeRead_);
+        ::close(wakeWrite_);
+    }
+}
+
+bool CommandServer::listen(const std::string& path) {
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    ::unlink(path.c_str());
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, options_.backlog) != 0 || !setNonBlocking(fd)) {
+        int error = errno;
+        ::close(fd);
+        errno = error;
+        return false;
+    }
+    if (listener_ >= 0) {
+        ::close(listener_);
+        ::unlink(path_.c_str());
+    }
+    listener_ = fd;
+    path_ = path;
+    return true;
+}
+
+bool CommandServer::run() {
+    while (!stopping_.load()) {
+        if (!poll(-1)) {
+            return false;
+        }
+    }
+    stopping_.store(false);
+    return true;
+}
+
+void CommandServer::stop() {
+    stopping_.store(true);
+    if (wakeWrite_ >= 0) {
+        char wake = 1;
+        ssize_t ignored = ::write(wakeWrite_, &wake, 1);
+        (void)ignored;
+    }
+}
+
+bool CommandServer::poll(int timeout) {
+    std::vector<pollfd> fds;
+    fds.reserve(connections_.size() + 2);
+    fds.push_back({wakeRead_, POLLIN, 0});
+    fds.push_back({listener_, POLLIN, 0});
+    for (const Connection& connection : connections_) {
+        short events = 0;
+        if (!connection.closing && connection.output.size() - connection.written < options_.maxPendingOutput) {
+            events |= POLLIN;
+        }
+        if (connection.written < connection.output.size()) {
+            events |= POLLOUT;
+        }
+        fds.push_back({connection.fd, events, 0});
+    }
+    if (::poll(fds.data(), fds.size(), timeout) < 0) {
+        return errno == EINTR;
+    }
+
+    if (fds[0].revents & POLLIN) {
+        char drain[64];
+        while (::read(wakeRead_, drain, sizeof(drain)) > 0) {
+        }
+    }
+    // Connections accepted now are polled on the next pass
+    const std::size_t numPolled = connections_.size();
+    if (fds[1].revents & POLLIN) {
+        accept();
+    }
+    for (std::size_t i = 0; i < numPolled; ++i) {
+        if (fds[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) {
+            read(i);
+            parse(i);
+        }
+    }
+    evaluate();
+    for (std::size_t i = 0; i < connections_.size(); ++i) {
+        if (connections_[i].written < connections_[i].output.size()) {
+            write(i);
+        }
+    }
+
+    auto finished = [](const Connection& connection) {
+        if (connection.closing && connection.written == connection.output.size()) {
+            ::close(connection.fd);
+            return true;
+        }
+        return false;
+    };
+    connections_.erase(std::remove_if(connections_.begin(), connections_.end(), finished), connections_.end());
+    return true;
+}
+
+void CommandServer::accept() {
+    while (true) {
+        int fd = ::accept(listener_, nullptr, nullptr);
+        if (fd < 0) {
+            return; // EAGAIN once every pending connection is accepted
+        }
+        if (!setNonBlocking(fd)) {
+            ::close(fd);
+            continue;
+        }
+        Connection connection;
+        connection.fd = fd;
+        connections_.push_back(std::move(connection));
+        ++stats_.connections;
+    }
+}
+
+void CommandServer::read(std::size_t index) {
+    Connection& connection = connections_[index];
+    std::size_t total = 0;
+    while (!connection.closing && total < maxReadPerPass) {
+        const std::size_t size = connection.input.size();
+        connection.input.resize(size + readBlockSize);
+        ssize_t length = ::read(connection.fd, connection.input.data() + size, readBlockSize);
+        connection.input.resize(size + (length > 0 ? static_cast<std::size_t>(length) : 0));
+        if (length > 0) {
+            total += static_cast<std::size_t>(length);
+        } else if (length == 0) {
+            connection.closing = true; // the client is done, answer what it sent
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return;
+        } else if (errno != EINTR) {
+            connection.closing = true;
+            connection.output.clear();
+            connection.written = 0;
+        }
+    }
+}
+
+void CommandServer::parse(std::size_t index) {
+    Connection& connection = connections_[index];
+    std::size_t numCommands;
+    const Command* commands = commandList(numCommands);
+    const char* data = connection.input.data();
+    const std::size_t size = connection.input.size();
+    std::size_t position = 0;
+    bool malformed = false;
+
+    while (position < size) {
+        Request request;
+        request.connection = index;
+        std::fill(request.inputs, request.inputs + maxCommandFields, 0.0);
+        int numInputs;
+
+        if (data[position] == '\0') {
+            if (size - position < binaryHeaderSize) {
+                break;
+            }
+            const unsigned char commandIndex = static_cast<unsigned char>(data[position + 1]);
+            numInputs = static_cast<unsigned char>(data[position + 2]);
+            // The length of the request does not depend on the reserved byte, so a request
+            // using it is answered with an error and the stream stays in sync
+            request.malformed = data[position + 3] != 0;
+            if (numInputs > maxCommandFields) {
+                malformed = true;
+                break;
+            }
+            const std::size_t length = binaryHeaderSize + numInputs * sizeof(double);
+            if (size - position < length) {
+                break;
+            }
+            std::memcpy(request.inputs, data + position + binaryHeaderSize, numInputs * sizeof(double));
+            request.command = commandIndex < numCommands && !request.malformed ? &commands[commandIndex] : nullptr;
+            request.binary = true;
+            position += length;
+        } else {
+            const char* begin = data + position;
+            const char* newline = static_cast<const char*>(std::memchr(begin, '\n', size - position));
+            // Once the client has closed its side, the last line needs no newline
+            const char* end = newline ? newline : connection.closing ? data + size : nullptr;
+            if (!end) {
+                malformed = size - position > options_.maxLineLength;
+                break;
+            }
+            if (static_cast<std::size_t>(end - begin) > options_.maxLineLength) {
+                malformed = true;
+                break;
+            }
+            position = static_cast<std::size_t>(end - data) + (newline ? 1 : 0);
+
+            while (begin < end && (isNameSeparator(*begin) || *begin == '\r')) {
+                ++begin;
+            }
+            if (begin == end) {
+                continue; // empty lines are not requests
+            }
+            const char* name = begin;
+            while (begin < end && !isNameSeparator(*begin) && *begin != '\r') {
+                ++begin;
+            }
+            request.command = findCommand(std::string(name, begin));
+            // A '\0' after the record keeps strtod from reading past it, as in runCommandStream()
+            std::string record(begin, end);
+            numInputs = parseCommandFields(record.data(), record.data() + record.size(), request.inputs);
+            request.binary = false;
+            request.malformed = false;
+        }
+
+        request.valid = request.command && numInputs >= request.command->minInputs &&
+                        numInputs <= request.command->maxInputs;
+        requests_.push_back(request);
+    }
+
+    if (malformed) {
+        ++stats_.protocolErrors;
+        connection.closing = true;
+        connection.input.clear();
+    } else {
+        connection.input.erase(connection.input.begin(), connection.input.begin() + position);
+    }
+}
+
+void CommandServer::evaluate() {
+    if (requests_.empty()) {
+        return;
+    }
+    std::size_t numCommands;
+    const Command* commands = commandList(numCommands);
+    for (Request& request : requests_) {
+        if (request.valid && !request.command->evaluateBatch) {
+            request.valid = request.command->evaluate(request.inputs, request.outputs);
+        }
+    }
+
+    // One batch call per command, over the requests of every connection
+    std::vector<std::size_t> batch;
+    std::vector<double> inputs, outputs;
+    for (std::size_t c = 0; c < numCommands; ++c) {
+        const Command& command = commands[c];
+        if (!command.evaluateBatch) {
+            continue;
+        }
+        batch.clear();
+        for (std::size_t r = 0; r < requests_.size(); ++r) {
+            if (requests_[r].command == &command && requests_[r].valid) {
+                batch.push_back(r);
+            }
+        }
+        if (batch.empty()) {
+            continue;
+        }
+        inputs.resize(batch.size() * maxCommandFields);
+        outputs.resize(batch.size() * maxCommandFields);
+        std::unique_ptr<bool[]> valid(new bool[batch.size()]);
+        for (std::size_t k = 0; k < batch.size(); ++k) {
+            std::copy(requests_[batch[k]].inputs, requests_[batch[k]].inputs + maxCommandFields,
+                      inputs.begin() + k * maxCommandFields);
+        }
+        command.evaluateBatch(inputs.data(), outputs.data(), valid.get(), batch.size());
+        for (std::size_t k = 0; k < batch.size(); ++k) {
+            Request& request = requests_[batch[k]];
+            request.valid = valid[k];
+            std::copy(outputs.begin() + k * maxCommandFields, outputs.begin() + (k + 1) * maxCommandFields,
+                      request.outputs);
+        }
+        ++stats_.batches;
+        stats_.batchedRequests += batch.size();
+    }
+
+    for (const Request& request : requests_) {
+        respond(request);
+    }
+    requests_.clear();
+}
+
+void CommandServer::respond(const Request& request) {
+    ++stats_.requests;
+    if (!request.valid) {
+        ++stats_.invalid;
+    }
+    std::string& out = connections_[request.connection].output;
+    if (!request.binary) {
+        if (request.command) {
+            formatCommandOutputs(*request.command, request.outputs, request.valid, out, options_.precision);
+        } else {
+            out += "error\n";
+        }
+        return;
+    }
+
+    const int numOutputs = request.command ? request.command->numOutputs : 0;
+    char header[binaryHeaderSize] = {};
+    header[0] = static_cast<char>(request.malformed ? binaryMalformed
+                                  : !request.command ? binaryUnknownCommand
+                                  : request.valid ? binaryValid : binaryInvalid);
+    header[1] = static_cast<char>(numOutputs);
+    out.append(header, binaryHeaderSize);
+    for (int i = 0; i < numOutputs; ++i) {
+        const double value = request.valid ? request.outputs[i] : std::nan("");
+        out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+}
+
+void CommandServer::write(std::size_t index) {
+    Connection& connection = connections_[index];
+    while (connection.written < connection.output.size()) {
+        ssize_t length = ::send(connection.fd, connection.output.data() + connection.written,
+                                connection.output.size() - connection.written, MSG_NOSIGNAL);
+        if (length > 0) {
+            connection.written += static_cast<std::size_t>(length);
+        } else if (length < 0 && errno == EINTR) {
+            continue;
+        } else if (length < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            // The client is gone, drop its pending responses
+            connection.closing = true;
+            connection.input.clear();
+            connection.output.clear();
+            connection.written = 0;
+            return;
+        }
+    }
+    if (connection.written == connection.output.size()) {
+        connection.output.clear();
+        connection.written = 0;
+    } else if (connection.written >= readBlockSize) {
+        connection.output.erase(0, connection.written);
+        connection.written = 0;
+    }
+}
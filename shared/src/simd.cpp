@@ -0,0 +1,35 @@
+#include "simd.h"
+#include <atomic>
+
+namespace {
+
+std::atomic<int>& simdLevelSetting() {
+    static std::atomic<int> level(static_cast<int>(detectSimdLevel()));
+    return level;
+}
+
+} // namespace
+
+SimdLevel detectSimdLevel() {
+#if FIVEG_HAVE_X86_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return SimdLevel::AVX2;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+SimdLevel activeSimdLevel() {
+    return static_cast<SimdLevel>(simdLevelSetting().load(std::memory_order_relaxed));
+}
+
+SimdLevel setSimdLevel(SimdLevel level) {
+    int detected = static_cast<int>(detectSimdLevel());
+    int requested = static_cast<int>(level);
+    simdLevelSetting().store(requested < detected ? requested : detected, std::memory_order_relaxed);
+    return activeSimdLevel();
+}
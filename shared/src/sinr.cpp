@@ -0,0 +1,344 @@
+#include "sinr.h"
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Ratio between consecutive distances probed for the pruning radius
+constexpr double radiusGridRatio = 1.01;
+
+// Lower end of the validity range of the rural path loss model
+constexpr double minModelDistance = 10.0;
+
+// Largest distance at which the NLOS formula applies; the path loss drops back to the LOS
+// value beyond it
+constexpr double maxNlosDistance = 5000.0;
+
+// Distance from a coordinate to the interval [low, high], 0 when inside
+double distanceToInterval(double value, double low, double high) {
+    return value < low ? low - value : (value > high ? value - high : 0.0);
+}
+
+// Smallest path loss of a site model at or beyond each of a set of probe distances. The path
+// loss increases with the distance except where the model switches formula, at the LOS
+// breakpoint and at the end of the NLOS range; probing both sides of those points keeps
+// the bound conservative between probes. Probes outside the validity range of the model
+// hold +infinity.
+struct PathLossEnvelope {
+    std::vector<double> distance;
+    std::vector<double> minPathLoss;
+
+    // Lower bound of the path loss at any distance of at least d
+    double lowerBound(double d) const {
+        std::size_t k = std::upper_bound(distance.begin(), distance.end(), d) - distance.begin();
+        return k == 0 ? minPathLoss.front() : minPathLoss[k - 1];
+    }
+};
+
+PathLossEnvelope makeEnvelope(const RuralPathLossSite& model, const SinrConfig& config) {
+    PathLossEnvelope envelope;
+    std::vector<double>& distances = envelope.distance;
+    for (double d = minModelDistance; d < config.maxDistance; d *= radiusGridRatio) {
+        distances.push_back(d);
+    }
+    const double breakpoint = model.breakpointPerUeHeight * config.ueHeight;
+    for (double d : {breakpoint, maxNlosDistance}) {
+        if (d >= minModelDistance && d < config.maxDistance) {
+            distances.push_back(d);
+            distances.push_back(std::nextafter(d, config.maxDistance));
+        }
+    }
+    distances.push_back(config.maxDistance);
+    std::sort(distances.begin(), distances.end());
+
+    const double infinity = std::numeric_limits<double>::infinity();
+    envelope.minPathLoss.resize(distances.size());
+    double minimum = infinity;
+    for (std::size_t k = distances.size(); k-- > 0;) {
+        double pathLoss = calculate5GPathLossRural(model, config.ueHeight, distances[k], config.isLOS);
+        minimum = std::min(minimum, pathLoss > 0 ? pathLoss : infinity);
+        envelope.minPathLoss[k] = minimum;
+    }
+    return envelope;
+}
+
+// Threshold below which a contribution is dropped, in Watts, for a reference power
+double pruningThreshold(double referencePower, const SinrConfig& config) {
+    return referencePower * std::pow(10.0, config.interferenceThreshold / 10);
+}
+
+struct SinrCell {
+    RuralPathLossSite model;
+    const PathLossEnvelope* envelope;
+    double txPowerPerLayer; // in dBm
+    double radius;          // pruning radius in meters
+
+    // Upper bound of the Rx power per layer at any distance of at least d, in Watts
+    double maxRxPower(double d, const SinrConfig& config) const {
+        return dBmToWatts(calculateReceivedPowerPerLayer(txPowerPerLayer, envelope->lowerBound(d),
+                                                         config.beamFormingGain));
+    }
+};
+
+// Smallest probe distance beyond which the cell stays below the threshold relative to the noise
+double pruningRadius(const SinrCell& cell, const SinrConfig& config) {
+    const double threshold = pruningThreshold(calculateThermalNoisePower(config.temperature, config.bandwidth), config);
+    const PathLossEnvelope& envelope = *cell.envelope;
+    for (std::size_t k = 0; k < envelope.distance.size(); ++k) {
+        if (cell.maxRxPower(envelope.distance[k], config) < threshold) {
+            return k == 0 ? 0.0 : envelope.distance[k];
+        }
+    }
+    return config.maxDistance;
+}
+
+// Site models and envelopes of a set of cells; cells with the same antenna height share an envelope
+struct SinrCells {
+    std::vector<SinrCell> cells;
+    std::vector<PathLossEnvelope> envelopes;
+
+    SinrCells(const std::vector<CoverageSite>& sites, const SinrConfig& config) : cells(sites.size()) {
+        std::vector<double> heights;
+        for (const auto& site : sites) {
+            heights.push_back(site.gNBAntennaHeight);
+        }
+        std::sort(heights.begin(), heights.end());
+        heights.erase(std::unique(heights.begin(), heights.end()), heights.end());
+        envelopes.resize(heights.size());
+        parallelFor(heights.size(), 1, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t h = begin; h < end; ++h) {
+                envelopes[h] = makeEnvelope(makeRuralPathLossSite(heights[h], config.fLow, config.fHigh,
+                                                                  config.buildingHeight, config.streetWidth), config);
+            }
+        }, config.numThreads);
+
+        for (std::size_t c = 0; c < sites.size(); ++c) {
+            SinrCell& cell = cells[c];
+            cell.model = makeRuralPathLossSite(sites[c].gNBAntennaHeight, config.fLow, config.fHigh,
+                                               config.buildingHeight, config.streetWidth);
+            std::size_t h = std::lower_bound(heights.begin(), heights.end(), sites[c].gNBAntennaHeight) - heights.begin();
+            cell.envelope = &envelopes[h];
+            cell.txPowerPerLayer = calculateTransmittedPowerPerLayer(sites[c].txPower, config.numOfLayers);
+            cell.radius = pruningRadius(cell, config);
+        }
+    }
+};
+
+// Uniform grid of square bins holding item indices, stored as one array sorted by bin
+struct BinIndex {
+    double originX = 0.0;
+    double originY = 0.0;
+    double binSize = 1.0;
+    std::size_t width = 1;
+    std::size_t height = 1;
+    std::vector<std::size_t> start; // items of bin b are order[start[b], start[b + 1])
+    std::vector<std::size_t> order;
+
+    std::size_t column(double x) const { return clamp((x - originX) / binSize, width); }
+    std::size_t row(double y) const { return clamp((y - originY) / binSize, height); }
+
+    static std::size_t clamp(double position, std::size_t size) {
+        return position <= 0 ? 0 : std::min(static_cast<std::size_t>(position), size - 1);
+    }
+
+    template <typename X, typename Y>
+    void fill(std::size_t count, X x, Y y) {
+        std::vector<std::size_t> bin(count);
+        start.assign(width * height + 1, 0);
+        for (std::size_t i = 0; i < count; ++i) {
+            bin[i] = row(y(i)) * width + column(x(i));
+            ++start[bin[i] + 1];
+        }
+        for (std::size_t b = 0; b < width * height; ++b) {
+            start[b + 1] += start[b];
+        }
+        std::vector<std::size_t> next(start.begin(), start.end() - 1);
+        order.resize(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            order[next[bin[i]]++] = i;
+        }
+    }
+};
+
+} // namespace
+
+double calculateSinrPruningRadius(const CoverageSite& cell, const SinrConfig& config) {
+    return SinrCells(std::vector<CoverageSite>(1, cell), config).cells.front().radius;
+}
+
+SinrStats calculateMultiCellSINRBatch(const std::vector<CoverageSite>& cells, const SinrBatchInput& input,
+                                      const SinrBatchOutput& output, const SinrConfig& config) {
+    SinrStats stats;
+    const std::size_t count = input.count;
+    if (count == 0) {
+        return stats;
+    }
+    const double noisePower = calculateThermalNoisePower(config.temperature, config.bandwidth);
+    const SinrCells models(cells, config);
+    double maxRadius = 0.0;
+    for (const SinrCell& model : models.cells) {
+        maxRadius = std::max(maxRadius, model.radius);
+    }
+
+    // Bins cover the bounding box of the UEs. Cells outside of it are clamped to the border
+    // bins, which keeps them within the bin range scanned around any UE they can reach.
+    BinIndex ues;
+    double minX = *std::min_element(input.x, input.x + count);
+    double maxX = *std::max_element(input.x, input.x + count);
+    double minY = *std::min_element(input.y, input.y + count);
+    double maxY = *std::max_element(input.y, input.y + count);
+    ues.originX = minX;
+    ues.originY = minY;
+    ues.binSize = std::max(config.binSize, 1.0);
+    ues.width = static_cast<std::size_t>((maxX - minX) / ues.binSize) + 1;
+    ues.height = static_cast<std::size_t>((maxY - minY) / ues.binSize) + 1;
+    ues.fill(count, [&](std::size_t i) { return input.x[i]; }, [&](std::size_t i) { return input.y[i]; });
+
+    BinIndex cellBins = ues;
+    cellBins.fill(cells.size(), [&](std::size_t c) { return cells[c].x; }, [&](std::size_t c) { return cells[c].y; });
+    const std::size_t span = static_cast<std::size_t>(std::ceil(maxRadius / ues.binSize));
+
+    std::atomic<std::size_t> pairsEvaluated(0), pairsContributing(0), unservedUEs(0);
+    parallelFor(ues.width * ues.height, 1, [&](std::size_t begin, std::size_t end) {
+        std::vector<double> x, y, distance, pathLoss, rxPower, rxPowerWatts, total, best;
+        std::vector<std::int32_t> server;
+        std::vector<std::pair<double, std::size_t>> candidates; // (upper bound of the Rx power, cell)
+        std::size_t evaluated = 0, contributing = 0, unserved = 0;
+
+        for (std::size_t bin = begin; bin < end; ++bin) {
+            const std::size_t first = ues.start[bin];
+            const std::size_t n = ues.start[bin + 1] - first;
+            if (n == 0) {
+                continue;
+            }
+            x.resize(n);
+            y.resize(n);
+            distance.resize(n);
+            pathLoss.resize(n);
+            rxPower.resize(n);
+            rxPowerWatts.resize(n);
+            total.assign(n, 0.0);
+            best.assign(n, 0.0);
+            server.assign(n, -1);
+            for (std::size_t k = 0; k < n; ++k) {
+                x[k] = input.x[ues.order[first + k]];
+                y[k] = input.y[ues.order[first + k]];
+            }
+            const double x0 = *std::min_element(x.begin(), x.end());
+            const double x1 = *std::max_element(x.begin(), x.end());
+            const double y0 = *std::min_element(y.begin(), y.end());
+            const double y1 = *std::max_element(y.begin(), y.end());
+
+            // Cells whose pruning radius reaches the UEs of the bin, strongest bound first
+            const std::size_t col = bin % ues.width;
+            const std::size_t row = bin / ues.width;
+            candidates.clear();
+            for (std::size_t r = row - std::min(row, span); r <= std::min(row + span, ues.height - 1); ++r) {
+                for (std::size_t c = col - std::min(col, span); c <= std::min(col + span, ues.width - 1); ++c) {
+                    const std::size_t cellBin = r * ues.width + c;
+                    for (std::size_t i = cellBins.start[cellBin]; i < cellBins.start[cellBin + 1]; ++i) {
+                        const std::size_t cell = cellBins.order[i];
+                        const double dx = distanceToInterval(cells[cell].x, x0, x1);
+                        const double dy = distanceToInterval(cells[cell].y, y0, y1);
+                        const double minDistance = std::sqrt(dx * dx + dy * dy);
+                        if (minDistance <= models.cells[cell].radius) {
+                            candidates.emplace_back(models.cells[cell].maxRxPower(minDistance, config), cell);
+                        }
+                    }
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(),
+                      [](const std::pair<double, std::size_t>& a, const std::pair<double, std::size_t>& b) {
+                          return a.first > b.first || (a.first == b.first && a.second < b.second);
+                      });
+
+            // Once the serving cell of every UE is known, the remaining cells are dropped as soon
+            // as their bound falls below the threshold relative to the weakest serving cell
+            double threshold = pruningThreshold(noisePower, config);
+            for (const auto& candidate : candidates) {
+                if (candidate.first < threshold) {
+                    break;
+                }
+                const std::size_t cell = candidate.second;
+                const SinrCell& model = models.cells[cell];
+                for (std::size_t k = 0; k < n; ++k) {
+                    const double dx = x[k] - cells[cell].x;
+                    const double dy = y[k] - cells[cell].y;
+                    distance[k] = std::sqrt(dx * dx + dy * dy);
+                }
+                calculate5GPathLossRuralBatch(model.model, distance.data(), config.ueHeight, config.isLOS,
+                                              pathLoss.data(), n);
+                for (std::size_t k = 0; k < n; ++k) {
+                    rxPower[k] = calculateReceivedPowerPerLayer(model.txPowerPerLayer, pathLoss[k], config.beamFormingGain);
+                }
+                dBmToWattsBatch(rxPower.data(), rxPowerWatts.data(), n, config.conversionAccuracy);
+                double weakestServer = std::numeric_limits<double>::infinity();
+                for (std::size_t k = 0; k < n; ++k) {
+                    // The model returns 0 outside of its validity range
+                    const bool contributes = pathLoss[k] > 0 && distance[k] <= config.maxDistance;
+                    const double power = contributes ? rxPowerWatts[k] : 0.0;
+                    total[k] += power;
+                    server[k] = power > best[k] ? static_cast<std::int32_t>(cell) : server[k];
+                    best[k] = std::max(best[k], power);
+                    weakestServer = std::min(weakestServer, best[k]);
+                    contributing += contributes;
+                }
+                evaluated += n;
+                threshold = pruningThreshold(std::max(noisePower, weakestServer), config);
+            }
+
+            for (std::size_t k = 0; k < n; ++k) {
+                const std::size_t ue = ues.order[first + k];
+                const double interference = total[k] - best[k];
+                output.sinrLinear[ue] = server[k] >= 0 ? best[k] / (interference + noisePower) : 0.0;
+                if (output.servingCell) output.servingCell[ue] = server[k];
+                if (output.signalPower) output.signalPower[ue] = best[k];
+                if (output.interferencePower) output.interferencePower[ue] = interference;
+                unserved += server[k] < 0;
+            }
+        }
+        pairsEvaluated += evaluated;
+        pairsContributing += contributing;
+        unservedUEs += unserved;
+    }, config.numThreads);
+
+    stats.pairsEvaluated = pairsEvaluated;
+    stats.pairsContributing = pairsContributing;
+    stats.unservedUEs = unservedUEs;
+    return stats;
+}
+
+double calculateMultiCellSINR(const std::vector<CoverageSite>& cells, double x, double y,
+                              const SinrConfig& config, std::int32_t* servingCell) {
+    double total = 0.0;
+    double best = 0.0;
+    std::int32_t server = -1;
+    for (std::size_t c = 0; c < cells.size(); ++c) {
+        const double dx = x - cells[c].x;
+        const double dy = y - cells[c].y;
+        const double distance = std::sqrt(dx * dx + dy * dy);
+        RuralPathLossSite model = makeRuralPathLossSite(cells[c].gNBAntennaHeight, config.fLow, config.fHigh,
+                                                        config.buildingHeight, config.streetWidth);
+        double pathLoss = calculate5GPathLossRural(model, config.ueHeight, distance, config.isLOS);
+        if (pathLoss <= 0 || distance > config.maxDistance) {
+            continue;
+        }
+        double txPowerPerLayer = calculateTransmittedPowerPerLayer(cells[c].txPower, config.numOfLayers);
+        double rxPower = dBmToWatts(calculateReceivedPowerPerLayer(txPowerPerLayer, pathLoss, config.beamFormingGain));
+        total += rxPower;
+        if (rxPower > best) {
+            best = rxPower;
+            server = static_cast<std::int32_t>(c);
+        }
+    }
+    if (servingCell) {
+        *servingCell = server;
+    }
+    if (server < 0) {
+        return 0.0;
+    }
+    return best / (total - best + calculateThermalNoisePower(config.temperature, config.bandwidth));
+}
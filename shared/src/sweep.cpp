@@ -0,0 +1,157 @@
+#include "sweep.h"
+#include "numerology.h"
+#include "parallel.h"
+
+namespace {
+
+// Rows handed to a thread at once. A link row holds one SNR per path loss and a throughput
+// row one value per (Tx power, path loss) pair.
+constexpr std::size_t sweepRowGrain = 16;
+
+// Final stage of a row of (Tx power, path loss) pairs. Called with a NumerologyConstant,
+// the slot duration is a constant of the instantiation.
+struct SweepRowStage {
+    const int* tbsBlock;
+    int layerPrbs;
+    double dlFraction;
+    double throughputRatio;
+    double* throughput;
+    std::size_t rowLength;
+
+    template <typename Numerology>
+    void operator()(Numerology numerology) const {
+        const double slotDuration = calculateSlotSize(numerology);
+        for (std::size_t k = 0; k < rowLength; ++k) {
+            int bitsPerSlot = tbsBlock[k] * layerPrbs;
+            throughput[k] = (bitsPerSlot * dlFraction) / slotDuration * throughputRatio;
+        }
+    }
+};
+
+} // namespace
+
+std::size_t dlThroughputSweepSize(const DLThroughputSweepAxes& axes) {
+    return axes.bandwidth.size() * axes.numOfLayers.size() * axes.prbCount.size() * axes.numerology.size() *
+           axes.txPower.size() * axes.pathLoss.size();
+}
+
+std::size_t dlThroughputSweepIndex(const DLThroughputSweepAxes& axes, std::size_t bandwidth, std::size_t numOfLayers,
+                                   std::size_t prbCount, std::size_t numerology, std::size_t txPower,
+                                   std::size_t pathLoss) {
+    std::size_t index = bandwidth;
+    index = index * axes.numOfLayers.size() + numOfLayers;
+    index = index * axes.prbCount.size() + prbCount;
+    index = index * axes.numerology.size() + numerology;
+    index = index * axes.txPower.size() + txPower;
+    return index * axes.pathLoss.size() + pathLoss;
+}
+
+DLThroughputSweepResult runDLThroughputSweep(const DLThroughputSweepAxes& axes, const DLThroughputConfig& config,
+                                             unsigned int numThreads) {
+    DLThroughputSweepResult result;
+    const std::size_t points = dlThroughputSweepSize(axes);
+    if (points == 0) {
+        return result;
+    }
+    const std::size_t numBandwidths = axes.bandwidth.size();
+    const std::size_t numLayerCounts = axes.numOfLayers.size();
+    const std::size_t numPrbCounts = axes.prbCount.size();
+    const std::size_t numNumerologies = axes.numerology.size();
+    const std::size_t numTxPowers = axes.txPower.size();
+    const std::size_t numPathLosses = axes.pathLoss.size();
+    DLThroughputSweepStats& stats = result.stats;
+
+    // Stages depending on a single swept input
+    std::vector<double> thermalNoisePower(numBandwidths);
+    for (std::size_t b = 0; b < numBandwidths; ++b) {
+        thermalNoisePower[b] = calculateThermalNoisePower(config.temperature, axes.bandwidth[b]);
+    }
+    std::vector<double> totalLoss(numPathLosses);
+    for (std::size_t pl = 0; pl < numPathLosses; ++pl) {
+        totalLoss[pl] = calculateLargeScaleTotalLoss(axes.pathLoss[pl], config.shadowingLoss, config.o2iLoss);
+    }
+    std::vector<int> totalPRBAvailable(numPrbCounts);
+    for (std::size_t p = 0; p < numPrbCounts; ++p) {
+        totalPRBAvailable[p] = calculateTotalPRBsAvailable(axes.prbCount[p], config.downlinkOverhead);
+    }
+    std::vector<double> txPowerPerLayer(numLayerCounts * numTxPowers);
+    for (std::size_t l = 0; l < numLayerCounts; ++l) {
+        for (std::size_t t = 0; t < numTxPowers; ++t) {
+            txPowerPerLayer[l * numTxPowers + t] = calculateTransmittedPowerPerLayer(axes.txPower[t], axes.numOfLayers[l]);
+        }
+    }
+
+    // MCS and TBS per CQI index: the MCS only depends on the CQI through its intermediate
+    // spectral efficiency, and the REs per UE are the same for the whole sweep
+    const ConstexprTable<CQIEntry> cqiEntries = getCQITable(config.cqiTableId);
+    int availableREs = calculateAvailableREs(numOfSCsPerRB, config.numOfSymbolsPerSlot,
+                                             config.numOfREsForDMRS, config.numOfOverheadREs);
+    int actualAvailableREs = calculateActualAvailableREs(availableREs, config.prbPerUE);
+    std::vector<int> tbsPerCqi(cqiEntries.size());
+    for (std::size_t c = 0; c < cqiEntries.size(); ++c) {
+        auto mcsResult = determineModulationAndCodeRate(cqiEntries[c].intermediateSpectralEfficiency, config.mcsTableId);
+        double nInfo = calculateNumberOfInformationBits(actualAvailableREs, mcsResult.second, mcsResult.first);
+        tbsPerCqi[c] = calculateTBSForNinfo(nInfo, static_cast<int>(mcsResult.second));
+    }
+
+    // TBS per (bandwidth, layers, Tx power, path loss). One row per (bandwidth, layers, Tx power),
+    // over the path losses, so that the SNR and spectral efficiency run as array conversions.
+    const std::size_t numLinkRows = numBandwidths * numLayerCounts * numTxPowers;
+    std::vector<int> tbs(numLinkRows * numPathLosses);
+    parallelFor(numLinkRows, sweepRowGrain, [&](std::size_t begin, std::size_t end) {
+        std::vector<double> rxPowerPerLayer(numPathLosses), noise(numPathLosses);
+        std::vector<double> snr(numPathLosses), spectralEfficiency(numPathLosses);
+        for (std::size_t row = begin; row < end; ++row) {
+            std::size_t b = row / (numLayerCounts * numTxPowers);
+            std::size_t lt = row % (numLayerCounts * numTxPowers);
+            for (std::size_t pl = 0; pl < numPathLosses; ++pl) {
+                rxPowerPerLayer[pl] = calculateReceivedPowerPerLayer(txPowerPerLayer[lt], totalLoss[pl],
+                                                                     config.beamFormingGain);
+            }
+            std::fill(noise.begin(), noise.end(), thermalNoisePower[b]);
+            calculateSNRLinearBatch(rxPowerPerLayer.data(), noise.data(), snr.data(), numPathLosses,
+                                    config.conversionAccuracy);
+            calculateSpectralEfficiencyPerLayerBatch(snr.data(), spectralEfficiency.data(), numPathLosses,
+                                                     config.conversionAccuracy);
+            int* tbsRow = tbs.data() + row * numPathLosses;
+            for (std::size_t pl = 0; pl < numPathLosses; ++pl) {
+                tbsRow[pl] = tbsPerCqi[determineIntermediateSpectralEfficiency(spectralEfficiency[pl],
+                                                                               config.cqiTableId).first];
+            }
+        }
+    }, numThreads);
+
+    // Final stage, once per point. A row of (Tx power, path loss) pairs reads a contiguous
+    // block of the TBS table.
+    const std::size_t rowLength = numTxPowers * numPathLosses;
+    const std::size_t numRows = points / rowLength;
+    const double throughputRatio = static_cast<double>(config.applicationPacketSize) / config.macPacketSize;
+    result.throughput.resize(points);
+    parallelFor(numRows, sweepRowGrain, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t row = begin; row < end; ++row) {
+            std::size_t n = row % numNumerologies;
+            std::size_t p = row / numNumerologies % numPrbCounts;
+            std::size_t l = row / (numNumerologies * numPrbCounts) % numLayerCounts;
+            std::size_t b = row / (numNumerologies * numPrbCounts * numLayerCounts);
+            const SweepRowStage stage = {tbs.data() + (b * numLayerCounts + l) * rowLength,
+                                         axes.numOfLayers[l] * totalPRBAvailable[p], config.dlFraction, throughputRatio,
+                                         result.throughput.data() + row * rowLength, rowLength};
+            const int numerology = axes.numerology[n];
+            if (numerology >= 0 && numerology <= maxNumerology) {
+                dispatchNumerology(numerology, stage);
+            } else {
+                stage(numerology);
+            }
+        }
+    }, numThreads);
+
+    stats.points = points;
+    stats.thermalNoiseEvaluations = numBandwidths;
+    stats.txPowerPerLayerEvaluations = numLayerCounts * numTxPowers;
+    stats.totalLossEvaluations = numPathLosses;
+    stats.linkEvaluations = numLinkRows * numPathLosses;
+    stats.tbsEvaluations = cqiEntries.size();
+    stats.prbEvaluations = numPrbCounts;
+    stats.slotEvaluations = numNumerologies;
+    return result;
+}
@@ -0,0 +1,123 @@
+#include "tbs.h"
+#include "metrics.h"
+#include "parallel.h"
+#include <algorithm>
+
+namespace {
+
+// Smallest number of allocations worth handing to another thread
+constexpr std::size_t tbsParallelGrain = 4096;
+
+constexpr int ninfoFractionBits = 11;            // Ninfo is given in units of 2^-11 bit
+constexpr std::int64_t smallNinfoLimit = 3824LL << ninfoFractionBits;
+
+// floor(log2(x)) for x > 0
+inline int floorLog2(std::uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int n = 0;
+    while (x >>= 1) {
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Largest entry of the TBS table not above NinfoPrime, as findTBSForNinfoPrime(); the
+// halving search compiles to conditional moves
+inline int floorTBSTableEntry(int ninfoPrime) {
+    const int* base = tbsTable.begin();
+    std::size_t length = tbsTable.size();
+    while (length > 1) {
+        const std::size_t half = length / 2;
+        base = base[half] <= ninfoPrime ? base + half : base;
+        length -= half;
+    }
+    return *base;
+}
+
+inline int tbsForScaledNinfo(std::int64_t ninfo, int codeRate) {
+    const std::uint64_t scaled = ninfo > 0 ? static_cast<std::uint64_t>(ninfo) : 0;
+
+    // Ninfo <= 3824: n = max(3, floor(log2(Ninfo)) - 6), NinfoPrime = max(24, 2^n * floor(Ninfo / 2^n))
+    const int smallN = std::max(3, floorLog2(scaled | 1) - ninfoFractionBits - 6);
+    const int smallPrime = std::max<int>(24, static_cast<int>((scaled >> (ninfoFractionBits + smallN)) << smallN));
+    const int smallTBS = floorTBSTableEntry(smallPrime);
+
+    // Ninfo > 3824: n = floor(log2(Ninfo - 24)) - 5, NinfoPrime = 2^n * round((Ninfo - 24) / 2^n)
+    const std::uint64_t excess = scaled > (24u << ninfoFractionBits) ? scaled - (24u << ninfoFractionBits) : 1;
+    const int largeShift = std::max(1, floorLog2(excess) - 5); // log2 of 2^n in units of 2^-11 bit
+    const std::int64_t largePrime = static_cast<std::int64_t>(
+        ((excess + (std::uint64_t(1) << (largeShift - 1))) >> largeShift) << std::max(0, largeShift - ninfoFractionBits));
+
+    // calculateTBS(): C code blocks, TBS = 8 * C * ceil((NinfoPrime + 24) / (8 * C)) - 24
+    const std::int64_t x = largePrime + 24;
+    const std::int64_t blockSize = codeRate <= 256 ? 3816 : (largePrime >= 8424 ? 8424 : x);
+    const std::int64_t step = 8 * ((x + blockSize - 1) / blockSize);
+    const int largeTBS = static_cast<int>(step * ((x + step - 1) / step) - 24);
+
+    return static_cast<std::int64_t>(scaled) <= smallNinfoLimit ? smallTBS : largeTBS;
+}
+
+} // namespace
+
+int calculateTBSForScaledNinfo(std::int64_t ninfo, int codeRate) {
+    return tbsForScaledNinfo(ninfo, codeRate);
+}
+
+void calculateTBSForScaledNinfoBatch(const std::int64_t* ninfo, const int* codeRate, int* tbs, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        tbs[i] = tbsForScaledNinfo(ninfo[i], codeRate[i]);
+    }
+}
+
+int determineTBS(int nRE, int mcsIdx, int numLayers, MCSTableId table) {
+    const ConstexprTable<MCSEntry> mcs = getMCSTable(table);
+    if (nRE <= 0 || numLayers <= 0 || mcsIdx < 0 || mcsIdx >= static_cast<int>(mcs.size())) {
+        return 0;
+    }
+    const MCSEntry& entry = mcs[mcsIdx];
+    return tbsForScaledNinfo(scaledNinfo(nRE, entry.mcsCodeRate, entry.modulationOrder, numLayers),
+                             static_cast<int>(entry.mcsCodeRate));
+}
+
+void determineTBSBatch(const int* nRE, const int* mcsIdx, const int* numLayers, int* tbs, std::size_t count,
+                       MCSTableId table, const TBSLookupTable* lookupTable) {
+    const int numMcs = static_cast<int>(getMCSTable(table).size());
+    parallelFor(count, parallelGrain(count, tbsParallelGrain), [&](std::size_t begin, std::size_t end) {
+        FIVEG_METRICS_SCOPE(MetricStage::TBSBatch, end - begin);
+        for (std::size_t i = begin; i < end; ++i) {
+            const bool covered = lookupTable && lookupTable->mcsTableId() == table && nRE[i] >= 0 &&
+                                 nRE[i] <= lookupTable->maxREs() && mcsIdx[i] >= 0 && mcsIdx[i] < numMcs &&
+                                 numLayers[i] >= 1 && numLayers[i] <= lookupTable->maxLayers();
+            tbs[i] = covered ? lookupTable->lookup(nRE[i], mcsIdx[i], numLayers[i])
+                             : determineTBS(nRE[i], mcsIdx[i], numLayers[i], table);
+        }
+    });
+}
+
+TBSLookupTable::TBSLookupTable(int maxREs, int maxLayers, MCSTableId table)
+    : maxREs_(maxREs),
+      maxLayers_(maxLayers),
+      mcsTableId_(table),
+      numMcs_(static_cast<int>(getMCSTable(table).size())),
+      rowLength_(static_cast<std::size_t>(maxREs) + 1),
+      table_(rowLength_ * numMcs_ * maxLayers) {
+    // One row per (layers, MCS) pair, contiguous in N_RE
+    parallelFor(static_cast<std::size_t>(maxLayers_) * numMcs_, 1, [this](std::size_t begin, std::size_t end) {
+        for (std::size_t row = begin; row < end; ++row) {
+            int numLayers = static_cast<int>(row / numMcs_) + 1;
+            int mcsIdx = static_cast<int>(row % numMcs_);
+            std::uint32_t* entries = table_.data() + row * rowLength_;
+            for (int nRE = 0; nRE <= maxREs_; ++nRE) {
+                entries[nRE] = static_cast<std::uint32_t>(determineTBS(nRE, mcsIdx, numLayers, mcsTableId_));
+            }
+        }
+    });
+}
+
+const TBSLookupTable& defaultTBSLookupTable() {
+    static const TBSLookupTable table;
+    return table;
+}
@@ -0,0 +1,186 @@
+#include "trace.h"
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+static_assert((traceRingCapacity & (traceRingCapacity - 1)) == 0, "traceRingCapacity must be a power of two");
+
+// Single producer (the owning thread), single consumer (drainTrace() under drainMutex).
+// head and tail count records since the ring was created and are never wrapped.
+struct TraceRing {
+    TraceRecord records[traceRingCapacity];
+    std::atomic<std::uint64_t> head{0};
+    std::atomic<std::uint64_t> tail{0};
+    std::atomic<bool> owned{true};
+    std::uint32_t index = 0;
+};
+
+struct TraceRegistry {
+    std::mutex mutex; // guards rings; taken once per thread, when it traces for the first time
+    std::vector<std::unique_ptr<TraceRing>> rings;
+    std::mutex drainMutex;
+    std::atomic<std::uint64_t> dropped{0};
+};
+
+TraceRegistry& registry() {
+    static TraceRegistry instance;
+    return instance;
+}
+
+// Rings left by finished threads are handed to new threads once drained, so programs that
+// start short-lived workers do not accumulate rings.
+TraceRing* acquireRing() {
+    TraceRegistry& reg = registry();
+    std::lock_guard<std::mutex> lock(reg.mutex);
+    for (auto& ring : reg.rings) {
+        if (!ring->owned.load(std::memory_order_acquire) &&
+            ring->head.load(std::memory_order_relaxed) == ring->tail.load(std::memory_order_acquire)) {
+            ring->owned.store(true, std::memory_order_relaxed);
+            return ring.get();
+        }
+    }
+    reg.rings.emplace_back(new TraceRing());
+    reg.rings.back()->index = static_cast<std::uint32_t>(reg.rings.size() - 1);
+    return reg.rings.back().get();
+}
+
+struct ThreadRing {
+    TraceRing* ring = acquireRing();
+    ~ThreadRing() { ring->owned.store(false, std::memory_order_release); }
+};
+
+void record(const char* name, const char* unit, double value) {
+    thread_local ThreadRing local;
+    TraceRing& ring = *local.ring;
+    std::uint64_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= traceRingCapacity) {
+        registry().dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TraceRecord& slot = ring.records[head & (traceRingCapacity - 1)];
+    slot.timestamp = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+    slot.thread = ring.index;
+    slot.name = name;
+    slot.unit = unit;
+    slot.value = value;
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+// Stops a flusher still running at exit, whose joinable thread would otherwise make its
+// destruction call std::terminate()
+struct TraceFlusher {
+    std::mutex mutex;
+    std::condition_variable wakeUp;
+    std::thread thread;
+    bool stopping = false;
+
+    // The registry is constructed first so that it outlives the last flush
+    TraceFlusher() { registry(); }
+    ~TraceFlusher() { stop(); }
+
+    void stop() {
+        std::thread running;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+            running.swap(thread);
+        }
+        wakeUp.notify_all();
+        if (running.joinable()) {
+            running.join();
+        }
+    }
+};
+
+TraceFlusher& flusher() {
+    static TraceFlusher instance;
+    return instance;
+}
+
+} // namespace
+
+void StreamTrace::value(const char* name, double value, const char* unit) {
+    std::cout << name << ": " << value << (unit[0] ? " " : "") << unit << std::endl;
+}
+
+void StreamTrace::message(const char* text) {
+    std::cerr << text << std::endl;
+}
+
+void RingBufferTrace::value(const char* name, double value, const char* unit) {
+    record(name, unit, value);
+}
+
+void RingBufferTrace::message(const char* text) {
+    record(text, nullptr, 0.0);
+}
+
+std::size_t drainTrace(std::vector<TraceRecord>& records) {
+    TraceRegistry& reg = registry();
+    std::lock_guard<std::mutex> drainLock(reg.drainMutex);
+    std::vector<TraceRing*> rings;
+    {
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        for (auto& ring : reg.rings) {
+            rings.push_back(ring.get());
+        }
+    }
+    std::size_t count = 0;
+    for (TraceRing* ring : rings) {
+        std::uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        std::uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail, ++count) {
+            records.push_back(ring->records[tail & (traceRingCapacity - 1)]);
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+    return count;
+}
+
+std::size_t flushTrace(std::ostream& out) {
+    std::vector<TraceRecord> records;
+    drainTrace(records);
+    for (const TraceRecord& r : records) {
+        out << '[' << r.thread << "] " << r.name;
+        if (r.unit) {
+            out << ": " << r.value << (r.unit[0] ? " " : "") << r.unit;
+        }
+        out << '\n';
+    }
+    out.flush();
+    return records.size();
+}
+
+void startTraceFlusher(std::ostream& out, std::chrono::milliseconds interval) {
+    TraceFlusher& f = flusher();
+    std::lock_guard<std::mutex> lock(f.mutex);
+    if (f.thread.joinable()) {
+        return;
+    }
+    f.stopping = false;
+    std::ostream* stream = &out;
+    f.thread = std::thread([&f, stream, interval]() {
+        std::unique_lock<std::mutex> lock(f.mutex);
+        bool stopping = false;
+        while (!stopping) {
+            stopping = f.wakeUp.wait_for(lock, interval, [&f]() { return f.stopping; });
+            lock.unlock();
+            flushTrace(*stream);
+            lock.lock();
+        }
+    });
+}
+
+void stopTraceFlusher() {
+    flusher().stop();
+}
+
+std::uint64_t droppedTraceRecords() {
+    return registry().dropped.load(std::memory_order_relaxed);
+}
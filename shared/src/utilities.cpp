@@ -1,20 +1,23 @@
 #include "utilities.h"
+#include "metrics.h"
 
-double calculateWavelength(double frequency, bool logging) {
+template <typename Trace>
+double calculateWavelength(double frequency) {
     // Check if the frequency is not zero to avoid division by zero
     if (frequency <= 0) {
-        if (logging)
-            std::cerr << "Frequency must be greater than 0 Hz." << std::endl;
+        Trace::message("Frequency must be greater than 0 Hz.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::Wavelength);
         return 0.0;  // Return zero as an error indicator
     }
     return speedOfLight / frequency;
 }
 
-double calculateFrequencyFromWavelength(double wavelength, bool logging) {
+template <typename Trace>
+double calculateFrequencyFromWavelength(double wavelength) {
     // Check if the wavelength is positive and non-zero
     if (wavelength <= 0) {
-        if (logging)
-            std::cerr << "Wavelength must be greater than 0 meters." << std::endl;
+        Trace::message("Wavelength must be greater than 0 meters.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::FrequencyFromWavelength);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
 
@@ -24,20 +27,22 @@ double calculateFrequencyFromWavelength(double wavelength, bool logging) {
     return frequency;
 }
 
-double calculateShannonsCapacity(double bandwidth, double snr, bool logging) {
+double calculateShannonsCapacity(double bandwidth, double snr) {
     // Ensure that the inputs are valid
     if (bandwidth <= 0 || snr < 0) {
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::ShannonsCapacity);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
     // Calculate Shannon's Capacity using the formula: C = B * log2(1 + SNR)
     return bandwidth * log2(1 + snr);
 }
 
-double calculateOFDMSymbolDuration(double scs, bool useExtendedCP, bool logging) {
+template <typename Trace>
+double calculateOFDMSymbolDuration(double scs, bool useExtendedCP) {
 
     if (scs <= 0) {
-        if (logging)
-            std::cerr << "SCS must be greater than 0 KHz" << std::endl;
+        Trace::message("SCS must be greater than 0 KHz");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::OFDMSymbolDuration);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
 
@@ -49,16 +54,17 @@ double calculateOFDMSymbolDuration(double scs, bool useExtendedCP, bool logging)
     return ofdmSymbolDuration;
 }
 
-int calculateNumberOfSubcarriers(double bandwidth, double scs, bool logging) {
+template <typename Trace>
+int calculateNumberOfSubcarriers(double bandwidth, double scs) {
     // Check for valid input values
     if (bandwidth <= 0) {
-        if (logging)
-            std::cerr << "Bandwidth must be greater than 0 Hz." << std::endl;
+        Trace::message("Bandwidth must be greater than 0 Hz.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::NumberOfSubcarriers);
         return 0;  // Return zero as an error indicator for invalid inputs
     }
     if (scs <= 0) {
-        if (logging)
-            std::cerr << "SCS must be greater than 0 kHz." << std::endl;
+        Trace::message("SCS must be greater than 0 kHz.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::NumberOfSubcarriers);
         return 0;  // Return zero as an error indicator for invalid inputs
     }
 
@@ -71,16 +77,17 @@ int calculateNumberOfSubcarriers(double bandwidth, double scs, bool logging) {
     return nsc;
 }
 
-int calculateFFTSize(double symbolDuration, double samplingFreq, bool logging) {
+template <typename Trace>
+int calculateFFTSize(double symbolDuration, double samplingFreq) {
     // Check for valid input values
     if (symbolDuration <= 0) {
-        if (logging)
-            std::cerr << "OFDM symbol duration must be greater than 0 seconds." << std::endl;
+        Trace::message("OFDM symbol duration must be greater than 0 seconds.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::FFTSize);
         return 0;  // Return zero as an error indicator for invalid inputs
     }
     if (samplingFreq <= 0) {
-        if (logging)
-            std::cerr << "Sampling frequency must be greater than 0 Hz." << std::endl;
+        Trace::message("Sampling frequency must be greater than 0 Hz.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::FFTSize);
         return 0;  // Return zero as an error indicator for invalid inputs
     }
 
@@ -90,23 +97,24 @@ int calculateFFTSize(double symbolDuration, double samplingFreq, bool logging) {
     return fftSize;
 }
 
-double calculateTrafficDensity(double spectralEfficiency, double cellularDensity, double bandwidth, bool logging) {
+double calculateTrafficDensity(double spectralEfficiency, double cellularDensity, double bandwidth) {
     // Calculate the traffic density GkM
     double trafficDensity = spectralEfficiency * cellularDensity * bandwidth;
 
     return trafficDensity;
 }
 
-double calculateCoherenceTime(double wavelength, double speed, bool logging) {
+template <typename Trace>
+double calculateCoherenceTime(double wavelength, double speed) {
     // Check for valid input values
     if (wavelength <= 0) {
-        if (logging)
-            std::cerr << "Wavelength must be greater than 0 meters." << std::endl;
+        Trace::message("Wavelength must be greater than 0 meters.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::CoherenceTime);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
     if (speed <= 0) {
-        if (logging)
-            std::cerr << "Speed must be greater than 0 meters/second." << std::endl;
+        Trace::message("Speed must be greater than 0 meters/second.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::CoherenceTime);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
 
@@ -116,11 +124,12 @@ double calculateCoherenceTime(double wavelength, double speed, bool logging) {
     return coherenceTime;
 }
 
-double calculateCoherenceBandwidth(double delaySpread, bool logging) {
+template <typename Trace>
+double calculateCoherenceBandwidth(double delaySpread) {
     // Check if the delay spread is positive and non-zero
     if (delaySpread <= 0) {
-        if (logging)
-            std::cerr << "Delay spread must be greater than 0 seconds." << std::endl;
+        Trace::message("Delay spread must be greater than 0 seconds.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::CoherenceBandwidth);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
 
@@ -130,7 +139,7 @@ double calculateCoherenceBandwidth(double delaySpread, bool logging) {
     return coherenceBandwidth;
 }
 
-double calculateSlotSize(int n, bool logging) {
+double calculateSlotSize(int n) {
 
     if (n < 0 && n > 4) {
         return 0.0;  // Return zero as an error indicator for invalid inputs
@@ -139,16 +148,17 @@ double calculateSlotSize(int n, bool logging) {
     return 1.0 / std::pow(2, n);
 }
 
-int calculateNumberOfSlots(double slotSize, bool logging) {
+int calculateNumberOfSlots(double slotSize) {
 
     if (slotSize <= 0) {
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::NumberOfSlots);
         return 0.0;  // Return zero as an error indicator for invalid inputs
     }
 
     return static_cast<int>(1.0 / slotSize);
 }
 
-double calculateSCS(int n, bool logging) {
+double calculateSCS(int n) {
 
     if (n < 0 && n > 4) {
         return 0.0;  // Return zero as an error indicator for invalid inputs
@@ -157,10 +167,11 @@ double calculateSCS(int n, bool logging) {
     return 15 * std::pow(2, n);
 }
 
-void QamModulationSchemeDescriptor(int M, double& b, double& sf, bool logging) {
+template <typename Trace>
+void QamModulationSchemeDescriptor(int M, double& b, double& sf) {
     if (M <= 1 || (M & (M - 1)) != 0) { // Check if M is a power of 2 and greater than 1
-        if (logging)
-            std::cerr << "Invalid Modulation order. M must be a power of 2 and greater than 1." << std::endl;
+        Trace::message("Invalid Modulation order. M must be a power of 2 and greater than 1.");
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::QamModulationScheme);
         b = 0; // Resetting values to 0 as error indication
         sf = 0;
         return;
@@ -187,25 +198,25 @@ int getNumerology(int scs) {
     }
 }
 
-double calculateLargeScaleTotalLoss(double pathLoss, double shadowingLoss, double o2iLoss, bool logging) {
+double calculateLargeScaleTotalLoss(double pathLoss, double shadowingLoss, double o2iLoss) {
     // Calculate total large-scale loss
     double totalLoss = pathLoss + shadowingLoss + o2iLoss;
     return totalLoss;
 }
 
-double calculateTransmittedPowerPerLayer(double txPower, int numOfLayers, bool logging) {
+double calculateTransmittedPowerPerLayer(double txPower, int numOfLayers) {
     // Calculate the transmitted power per layer using the formula provided
     double txPowerPerLayer = txPower - (10 * std::log10(numOfLayers));
     return txPowerPerLayer;
 }
 
-double calculateReceivedPowerPerLayer(double txPowerPerLayer, double totalLoss, double bfGain, bool logging) {
+double calculateReceivedPowerPerLayer(double txPowerPerLayer, double totalLoss, double bfGain) {
     // Calculate the received power using the formula provided
     double rxPowerPerLayer = txPowerPerLayer - totalLoss + bfGain;
     return rxPowerPerLayer;
 }
 
-double calculateThermalNoisePower(double temperature, double bandwidth, bool logging) {
+double calculateThermalNoisePower(double temperature, double bandwidth) {
     // Boltzmann's constant in Joules per Kelvin
     constexpr double boltzmannConstant = 1.38e-23;
 
@@ -215,15 +226,15 @@ double calculateThermalNoisePower(double temperature, double bandwidth, bool log
     return thermalNoisePower;
 }
 
-double dBmToWatts(double dBm, bool logging) {
+double dBmToWatts(double dBm) {
     return 1e-3 * std::pow(10, dBm / 10); // 1mW * 10^(P(dBm)/10)
 }
 
-double wattsToDbm(double watts, bool logging) {
+double wattsToDbm(double watts) {
     return 10.0 * log10(watts / 0.001); // 10 * log10(watts / 0.001)
 }
 
-double calculateSNRLinear(double rxPower_dBm, double thermalNoisePower_Watts, bool logging) {
+double calculateSNRLinear(double rxPower_dBm, double thermalNoisePower_Watts) {
     // Convert received power from dBm to watts
     double rxPower_Watts = dBmToWatts(rxPower_dBm);
 
@@ -233,8 +244,9 @@ double calculateSNRLinear(double rxPower_dBm, double thermalNoisePower_Watts, bo
     return snrLinear;
 }
 
-double calculateSpectralEfficiencyPerLayer(double snrLinear, bool logging) {
+double calculateSpectralEfficiencyPerLayer(double snrLinear) {
     if (snrLinear < 0) {
+        FIVEG_METRICS_INVALID_INPUT(InvalidInput::SpectralEfficiency);
         return 0.0;  // Return zero as an error indicator 
                      // since snrLinear is assumed to be non-negative
     }
@@ -245,12 +257,18 @@ double calculateSpectralEfficiencyPerLayer(double snrLinear, bool logging) {
     return spectralEfficiency;
 }
 
-std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEfficiency, bool logging) {
+std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEfficiency) {
+    return determineIntermediateSpectralEfficiency(spectralEfficiency, CQITableId::Table2);
+}
+
+std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEfficiency, CQITableId table) {
+    const ConstexprTable<CQIEntry> cqi = getCQITable(table);
+
     // Initialize to the lowest CQI if all else fails
     int closestCQI = 0;
 
     // Find the closest CQI entry
-    for (const auto& entry : cqiTable) {
+    for (const auto& entry : cqi) {
         if (entry.intermediateSpectralEfficiency <= spectralEfficiency) {
             closestCQI = entry.index;
         } else { 
@@ -259,50 +277,67 @@ std::pair<int, double> determineIntermediateSpectralEfficiency(double spectralEf
     }
 
     // Fetch the values from the specified index
-    int cqiIndex = cqiTable[closestCQI].index;
-    double specEfficiency = cqiTable[closestCQI].intermediateSpectralEfficiency;
+    int cqiIndex = cqi[closestCQI].index;
+    double specEfficiency = cqi[closestCQI].intermediateSpectralEfficiency;
 
     // Return them as a pair
     return std::make_pair(cqiIndex, specEfficiency);
 }
 
-std::pair<int, double> determineModulationAndCodeRate(double spectralEfficiency, bool logging) {
+std::pair<int, double> determineModulationAndCodeRate(double spectralEfficiency) {
+    return determineModulationAndCodeRate(spectralEfficiency, MCSTableId::Table2);
+}
+
+std::pair<int, double> determineModulationAndCodeRate(double spectralEfficiency, MCSTableId table) {
+    const ConstexprTable<MCSEntry> mcs = getMCSTable(table);
+    int closestMcsIndex = determineMcsIndex(spectralEfficiency, table);
+
+    // Fetch the values from the specified index
+    int modulationOrder = mcs[closestMcsIndex].modulationOrder;
+    double mcsCodeRate = mcs[closestMcsIndex].mcsCodeRate;
+
+    // Return them as a pair
+    return std::make_pair(modulationOrder, mcsCodeRate);
+
+}
+
+int determineMcsIndex(double spectralEfficiency, MCSTableId table) {
     // Initialize to the lowest MCS if all else fails
     int closestMcsIndex = 0;
 
     // Find the closest MCS entry
-    for (const auto& entry : mcsTable) {
+    for (const auto& entry : getMCSTable(table)) {
         if (entry.maxSpectralEfficiency <= spectralEfficiency) {
             closestMcsIndex = entry.index;
         } else {
-            break; // Since MCS table is sorted, we can break the loop once we pass spectralEfficiency
+            break; // Stop at the first entry that exceeds spectralEfficiency
         }
     }
 
-    // Fetch the values from the specified index
-    int modulationOrder = mcsTable[closestMcsIndex].modulationOrder;
-    double mcsCodeRate = mcsTable[closestMcsIndex].mcsCodeRate;
-
-    // Return them as a pair
-    return std::make_pair(modulationOrder, mcsCodeRate);
+    return closestMcsIndex;
+}
 
+std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx) {
+    return determineModulationAndCodeRateUsingMcsIndex(mcsIdx, MCSTableId::Table2);
 }
 
-std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx, bool logging) {
+std::pair<int, double> determineModulationAndCodeRateUsingMcsIndex(int mcsIdx, MCSTableId table) {
+    const ConstexprTable<MCSEntry> mcs = getMCSTable(table);
+
     // Validate mcsIdx argument
-    if (mcsIdx < 0 || mcsIdx > 27) {
+    if (mcsIdx < 0 || mcsIdx >= static_cast<int>(mcs.size())) {
         throw std::runtime_error("Invalid MCS index");
     }
 
     // Fetch the values from the specified index
-    int modulationOrder = mcsTable[mcsIdx].modulationOrder;
-    double mcsCodeRate = mcsTable[mcsIdx].mcsCodeRate;
+    int modulationOrder = mcs[mcsIdx].modulationOrder;
+    double mcsCodeRate = mcs[mcsIdx].mcsCodeRate;
 
     // Return them as a pair
     return std::make_pair(modulationOrder, mcsCodeRate);
 }
 
-int calculateAvailableREs(int numberOfSubcarriers, int numberOfSymbols, int numberOfREsForDMRS, int overheadFromHigherLayer, bool logging) {
+int calculateAvailableREs(int numberOfSubcarriers, int numberOfSymbols, int numberOfREsForDMRS, int overheadFromHigherLayer) {
     // Calculate the total number of REs for data transfer
     int totalREs = numberOfSubcarriers * numberOfSymbols;
 
@@ -312,7 +347,7 @@ int calculateAvailableREs(int numberOfSubcarriers, int numberOfSymbols, int numb
     return availableREs;
 }
 
-int calculateActualAvailableREs(int availableREsPerRB, int numberOfAllocatedPRBs, bool logging) {
+int calculateActualAvailableREs(int availableREsPerRB, int numberOfAllocatedPRBs) {
     // The UE never assumes more than 156 REs per RB
     int cappedREsPerRB = std::min(156, availableREsPerRB);
 
@@ -322,7 +357,7 @@ int calculateActualAvailableREs(int availableREsPerRB, int numberOfAllocatedPRBs
     return totalActualREs;
 }
 
-double calculateNumberOfInformationBits(int N, double codeRate, int modulationOrder, bool logging) {
+double calculateNumberOfInformationBits(int N, double codeRate, int modulationOrder) {
     // Calculate the scaled code rate
     double R = codeRate / 1024.0;
 
@@ -332,7 +367,7 @@ double calculateNumberOfInformationBits(int N, double codeRate, int modulationOr
     return Ninfo;
 }
 
-int calculateNinfoPrime(double Ninfo, bool logging) {
+int calculateNinfoPrime(double Ninfo) {
     if (Ninfo <= 3824) {
         int n = std::max(3, static_cast<int>(std::floor(std::log2(Ninfo))) - 6);
         int powerOfTwo = static_cast<int>(std::pow(2, n));
@@ -347,7 +382,7 @@ int calculateNinfoPrime(double Ninfo, bool logging) {
 }
 
 // When NinfoPrime <= 3824
-int findTBSForNinfoPrime(int NinfoPrime, bool logging) {
+int findTBSForNinfoPrime(int NinfoPrime) {
     // Find the largest TBS that is less than NinfoPrime
     int maxTBS = 0; // To keep track of the maximum TBS value that is less than NinfoPrime
     for (int TBS : tbsTable) {
@@ -368,7 +403,7 @@ int findTBSForNinfoPrime(int NinfoPrime, bool logging) {
 }
 
 // When NinfoPrime > 3824
-int calculateTBS(int NinfoPrime, int codeRate, bool logging) {
+int calculateTBS(int NinfoPrime, int codeRate) {
     double R = static_cast<double>(codeRate) / 1024.0; // Convert codeRate to actual fraction
     int TBS = 0;
     if (R <= 0.25) { // If R <= 1/4
@@ -386,7 +421,15 @@ int calculateTBS(int NinfoPrime, int codeRate, bool logging) {
     return TBS;
 }
 
-int calculateTotalBitsPerPrb(int numLayers, int tbsSize, bool logging) {
+int calculateTBSForNinfo(double Ninfo, int codeRate) {
+    int NinfoPrime = calculateNinfoPrime(Ninfo);
+    if (Ninfo <= 3824) {
+        return findTBSForNinfoPrime(NinfoPrime);
+    }
+    return calculateTBS(NinfoPrime, codeRate);
+}
+
+int calculateTotalBitsPerPrb(int numLayers, int tbsSize) {
     int totalBitsPerPrb = 0;
     for (int layer = 0; layer < numLayers; ++layer) {
         totalBitsPerPrb += tbsSize; // Add TBS size for each layer
@@ -394,22 +437,22 @@ int calculateTotalBitsPerPrb(int numLayers, int tbsSize, bool logging) {
     return totalBitsPerPrb;
 }
 
-int calculateTotalPRBsAvailable(int prbCount, double downlinkOH, bool logging) {
+int calculateTotalPRBsAvailable(int prbCount, double downlinkOH) {
     int overhead = std::ceil(prbCount * downlinkOH);
     int totalPRBAvailable = prbCount - overhead;
     return totalPRBAvailable;
 }
 
-int calculateBitsPerSlot(int bitsPerPRB, int totalPRBAvailable, bool logging) {
+int calculateBitsPerSlot(int bitsPerPRB, int totalPRBAvailable) {
     int bitsPerSlot = bitsPerPRB * totalPRBAvailable;
     return bitsPerSlot;
 }
 
-double calculateDLApplicationThroughput(int bitsPerSlot, double dlFraction, double slotTime, int appPacketSize, int macPacketSize, bool logging) {
+template <typename Trace>
+double calculateDLApplicationThroughput(int bitsPerSlot, double dlFraction, double slotTime, int appPacketSize, int macPacketSize) {
     // Calculate DL MAC Throughput
     double dlMacThroughput = (bitsPerSlot * dlFraction) / slotTime;
-    if (logging)
-        std::cout << "DL MAC Throughput: " << dlMacThroughput/1000 << " Mbps" << std::endl;
+    Trace::value("DL MAC Throughput", dlMacThroughput / 1000, "Mbps");
 
     // Calculate DL Application Throughput
     double throughputRatio = static_cast<double>(appPacketSize) / static_cast<double>(macPacketSize);
@@ -418,7 +461,7 @@ double calculateDLApplicationThroughput(int bitsPerSlot, double dlFraction, doub
     return dlApplicationThroughput;
 }
 
-double calculateDLFraction(const std::string& ratioStr, bool logging) {
+double calculateDLFraction(const std::string& ratioStr) {
     std::istringstream iss(ratioStr);
     int dl, ul;
     char colon;
@@ -431,29 +474,26 @@ double calculateDLFraction(const std::string& ratioStr, bool logging) {
     return dl / totalParts;
 }
 
+template <typename Trace>
 double calculate5GPathLossRural(double gNBAntennaHeight, double ueHeight, double fLow, double fHigh, double distance2D, 
-                           double buildingHeight, double streetWidth, bool isLOS, bool logging) {
+                           double buildingHeight, double streetWidth, bool isLOS) {
     // Calculate center frequency and normalized frequency
     double centerFrequency = (fLow + fHigh) / 2;
-    if (logging)
-        std::cout << "centerFrequency: " << centerFrequency << " MHz" << std::endl;
+    Trace::value("centerFrequency", centerFrequency, "MHz");
 
     // convert centerFrequency to Hz for further calculations
     centerFrequency = centerFrequency * 1e6;
     
     double fNorm = centerFrequency / 1e9; // Normalized by 1 GHz
-    if (logging)
-        std::cout << "fNorm: " << fNorm << " GHz" << std::endl;
+    Trace::value("fNorm", fNorm, "GHz");
 
     // Calculate breakpoint distance
     double breakpointDistance = 2 * pi * gNBAntennaHeight * ueHeight * (centerFrequency / speedOfLight);
-    if (logging)
-        std::cout << "breakPointDistance: " << breakpointDistance << std::endl;
+    Trace::value("breakPointDistance", breakpointDistance);
 
     // Calculate 3D distance
     double distance3D = std::sqrt(distance2D * distance2D + (gNBAntennaHeight - ueHeight) * (gNBAntennaHeight - ueHeight));
-    if (logging)
-        std::cout << "distance3D: " << distance3D << std::endl;
+    Trace::value("distance3D", distance3D);
 
     // Calculate LOS path loss for all distances to use as baseline
     double plLos = 0;
@@ -484,3 +524,21 @@ double calculate5GPathLossRural(double gNBAntennaHeight, double ueHeight, double
 
     return pathLoss;
 }
+
+// Instantiations for the trace policies of trace.h
+#define FIVEG_INSTANTIATE_TRACED(Trace)                                                                            \
+    template double calculateWavelength<Trace>(double);                                                            \
+    template double calculateFrequencyFromWavelength<Trace>(double);                                               \
+    template double calculateOFDMSymbolDuration<Trace>(double, bool);                                              \
+    template int calculateNumberOfSubcarriers<Trace>(double, double);                                              \
+    template int calculateFFTSize<Trace>(double, double);                                                          \
+    template double calculateCoherenceTime<Trace>(double, double);                                                 \
+    template double calculateCoherenceBandwidth<Trace>(double);                                                    \
+    template void QamModulationSchemeDescriptor<Trace>(int, double&, double&);                                     \
+    template double calculateDLApplicationThroughput<Trace>(int, double, double, int, int);                        \
+    template double calculate5GPathLossRural<Trace>(double, double, double, double, double, double, double, bool);
+
+FIVEG_INSTANTIATE_TRACED(NoTrace)
+FIVEG_INSTANTIATE_TRACED(StreamTrace)
+FIVEG_INSTANTIATE_TRACED(RingBufferTrace)
+#undef FIVEG_INSTANTIATE_TRACED
@@ -0,0 +1,186 @@
+#include "batchstatus.h"
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+TEST(BatchStatusTests, NumerologyBatchMatchesScalarWithoutThrowing) {
+    const std::vector<int> scs = {15, 30, 60, 120, 240, 0, -15, 45, 90, 480, 7, 120};
+    std::vector<int> numerology(scs.size(), -1);
+    std::vector<std::uint64_t> mask(batchMaskWords(scs.size()));
+    std::vector<BatchError> errors(scs.size());
+    BatchStatus status;
+    status.validMask = mask.data();
+    status.errors = errors.data();
+
+    EXPECT_EQ(getNumerologyBatch(scs.data(), numerology.data(), scs.size(), status), 6u);
+    for (std::size_t i = 0; i < scs.size(); ++i) {
+        bool valid = true;
+        int expected = 0;
+        try {
+            expected = getNumerology(scs[i]);
+        } catch (const std::invalid_argument&) {
+            valid = false;
+        }
+        EXPECT_EQ(isBatchElementValid(mask.data(), i), valid) << "SCS " << scs[i];
+        EXPECT_EQ(numerology[i], expected) << "SCS " << scs[i];
+        EXPECT_EQ(errors[i], valid ? BatchError::None : BatchError::UnsupportedSCS) << "SCS " << scs[i];
+    }
+    EXPECT_EQ(countValidBatchElements(mask.data(), scs.size()), 6u);
+}
+
+TEST(BatchStatusTests, McsIndexBatchMatchesScalarWithoutThrowing) {
+    std::vector<int> mcsIdx;
+    for (int i = -3; i < 35; ++i) {
+        mcsIdx.push_back(i);
+    }
+    std::vector<int> modulationOrder(mcsIdx.size());
+    std::vector<double> codeRate(mcsIdx.size());
+    std::vector<std::uint64_t> mask(batchMaskWords(mcsIdx.size()));
+    BatchStatus status;
+    status.validMask = mask.data();
+
+    for (MCSTableId table : {MCSTableId::Table1, MCSTableId::Table2, MCSTableId::Table3}) {
+        std::size_t invalid = determineModulationAndCodeRateUsingMcsIndexBatch(
+            mcsIdx.data(), modulationOrder.data(), codeRate.data(), mcsIdx.size(), status, table);
+        EXPECT_EQ(invalid, mcsIdx.size() - getMCSTable(table).size());
+        for (std::size_t i = 0; i < mcsIdx.size(); ++i) {
+            try {
+                auto expected = determineModulationAndCodeRateUsingMcsIndex(mcsIdx[i], table);
+                EXPECT_TRUE(isBatchElementValid(mask.data(), i));
+                EXPECT_EQ(modulationOrder[i], expected.first);
+                EXPECT_EQ(codeRate[i], expected.second);
+            } catch (const std::runtime_error&) {
+                EXPECT_FALSE(isBatchElementValid(mask.data(), i));
+                EXPECT_EQ(modulationOrder[i], 0);
+                EXPECT_EQ(codeRate[i], 0.0);
+            }
+        }
+    }
+}
+
+TEST(BatchStatusTests, MaskClearsBitsPastTheLastElement) {
+    const std::vector<int> scs(70, 30);
+    std::vector<int> numerology(scs.size());
+    std::vector<std::uint64_t> mask(batchMaskWords(scs.size()), ~std::uint64_t(0));
+    BatchStatus status;
+    status.validMask = mask.data();
+
+    EXPECT_EQ(getNumerologyBatch(scs.data(), numerology.data(), scs.size(), status), 0u);
+    EXPECT_EQ(mask[0], ~std::uint64_t(0));
+    EXPECT_EQ(mask[1], (std::uint64_t(1) << 6) - 1);
+    EXPECT_EQ(countValidBatchElements(mask.data(), scs.size()), scs.size());
+}
+
+TEST(BatchStatusTests, DLThroughputRejectsInvalidRowsOnly) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double inf = std::numeric_limits<double>::infinity();
+    const std::size_t count = 600; // spans three blocks
+    std::vector<double> pathLoss(count), txPower(count), bandwidth(count), shadowing(count);
+    std::vector<int> layers(count), prbCount(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 70.0 + 0.1 * i;
+        txPower[i] = 30 + i % 20;
+        layers[i] = 1 << (i % 4);
+        prbCount[i] = 25 + i % 250;
+        bandwidth[i] = (10 + 10 * (i % 10)) * 1e6;
+        shadowing[i] = i % 7;
+    }
+    pathLoss[3] = nan;
+    txPower[70] = inf;
+    layers[130] = 0;
+    layers[131] = 16;
+    prbCount[260] = -1;
+    prbCount[261] = 1000;
+    bandwidth[400] = 0.0;
+    bandwidth[401] = -20e6;
+    shadowing[599] = nan;
+    layers[598] = 0;
+    bandwidth[598] = nan; // non-finite input takes precedence
+
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+    input.shadowingLoss = shadowing.data();
+
+    std::vector<double> throughput(count, -1.0), snr(count, -1.0);
+    std::vector<int> cqi(count, -1);
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    output.snrLinear = snr.data();
+    output.cqiIndex = cqi.data();
+    std::vector<std::uint64_t> mask(batchMaskWords(count));
+    std::vector<BatchError> errors(count);
+    BatchStatus status;
+    status.validMask = mask.data();
+    status.errors = errors.data();
+
+    EXPECT_EQ(calculateDLThroughputBatchChecked(input, output, status), 10u);
+    EXPECT_EQ(countValidBatchElements(mask.data(), count), count - 10);
+    EXPECT_EQ(errors[3], BatchError::NonFiniteInput);
+    EXPECT_EQ(errors[70], BatchError::NonFiniteInput);
+    EXPECT_EQ(errors[130], BatchError::InvalidLayerCount);
+    EXPECT_EQ(errors[131], BatchError::InvalidLayerCount);
+    EXPECT_EQ(errors[260], BatchError::InvalidPrbCount);
+    EXPECT_EQ(errors[261], BatchError::InvalidPrbCount);
+    EXPECT_EQ(errors[400], BatchError::InvalidBandwidth);
+    EXPECT_EQ(errors[401], BatchError::InvalidBandwidth);
+    EXPECT_EQ(errors[598], BatchError::NonFiniteInput);
+    EXPECT_EQ(errors[599], BatchError::NonFiniteInput);
+
+    DLThroughputConfig config;
+    for (std::size_t i = 0; i < count; ++i) {
+        if (isBatchElementValid(mask.data(), i)) {
+            EXPECT_EQ(errors[i], BatchError::None);
+            config.shadowingLoss = shadowing[i];
+            EXPECT_DOUBLE_EQ(throughput[i],
+                             calculateDLThroughput(pathLoss[i], txPower[i], layers[i], prbCount[i], bandwidth[i], config))
+                << "row " << i;
+        } else {
+            EXPECT_EQ(throughput[i], 0.0) << "row " << i;
+            EXPECT_EQ(snr[i], 0.0) << "row " << i;
+            EXPECT_EQ(cqi[i], 0) << "row " << i;
+        }
+    }
+}
+
+TEST(BatchStatusTests, DLThroughputRejectsEveryRowOfAnInvalidConfiguration) {
+    const std::size_t count = 100;
+    std::vector<double> pathLoss(count, 80.0), txPower(count, 40.0), bandwidth(count, 100e6);
+    std::vector<int> layers(count, 2), prbCount(count, 100);
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+    std::vector<double> throughput(count, -1.0);
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    std::vector<BatchError> errors(count);
+    BatchStatus status;
+    status.errors = errors.data();
+
+    DLThroughputConfig config;
+    config.numerology = 5;
+    EXPECT_EQ(calculateDLThroughputBatchChecked(input, output, status, config), count);
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(errors[i], BatchError::InvalidConfiguration);
+        EXPECT_EQ(throughput[i], 0.0);
+    }
+
+    input.bandwidth = nullptr;
+    EXPECT_EQ(calculateDLThroughputBatchChecked(input, output, status), count);
+    EXPECT_EQ(errors[0], BatchError::InvalidConfiguration);
+}
+
+TEST(BatchStatusTests, ErrorMessages) {
+    EXPECT_STREQ(batchErrorMessage(BatchError::None), "No error");
+    EXPECT_STREQ(batchErrorMessage(BatchError::UnsupportedSCS), "Unsupported SCS value");
+    EXPECT_STREQ(batchErrorMessage(BatchError::InvalidMcsIndex), "Invalid MCS index");
+}
@@ -0,0 +1,194 @@
+#include "5gutils.h"
+#include "batchstatus.h"
+#include "conversions.h"
+#include "pathloss.h"
+#include "tbs.h"
+#include <cmath>
+#include <limits>
+#include <gtest/gtest.h>
+
+TEST(CApiTests, VersionAndMessages) {
+    EXPECT_EQ(FIVEG_API_VERSION, fiveg_api_version());
+    EXPECT_STREQ("Success", fiveg_status_message(FIVEG_OK));
+    EXPECT_STREQ("Null pointer", fiveg_status_message(FIVEG_ERROR_NULL_POINTER));
+    EXPECT_STREQ("Unknown status", fiveg_status_message(-1));
+}
+
+TEST(CApiTests, ConversionsMatchCpp) {
+    const std::size_t count = 1000;
+    std::vector<double> dBm(count), noise(count), bandwidth(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        dBm[i] = -120.0 + 0.17 * i;
+        noise[i] = 1e-13 * (1 + i % 9);
+        bandwidth[i] = 5e6 * (1 + i % 20);
+    }
+    for (int accuracy : {FIVEG_ACCURACY_FAST, FIVEG_ACCURACY_STRICT}) {
+        const ConversionAccuracy acc = accuracy == FIVEG_ACCURACY_FAST ? ConversionAccuracy::Fast
+                                                                       : ConversionAccuracy::Strict;
+        std::vector<double> result(count), expected(count), snr(count), expectedSnr(count);
+        ASSERT_EQ(FIVEG_OK, fiveg_dbm_to_watts(dBm.data(), result.data(), count, accuracy));
+        dBmToWattsBatch(dBm.data(), expected.data(), count, acc);
+        EXPECT_EQ(expected, result);
+
+        ASSERT_EQ(FIVEG_OK, fiveg_watts_to_dbm(noise.data(), result.data(), count, accuracy));
+        wattsToDbmBatch(noise.data(), expected.data(), count, acc);
+        EXPECT_EQ(expected, result);
+
+        ASSERT_EQ(FIVEG_OK, fiveg_snr_linear(dBm.data(), noise.data(), snr.data(), count, accuracy));
+        calculateSNRLinearBatch(dBm.data(), noise.data(), expectedSnr.data(), count, acc);
+        EXPECT_EQ(expectedSnr, snr);
+
+        ASSERT_EQ(FIVEG_OK, fiveg_spectral_efficiency(snr.data(), result.data(), count, accuracy));
+        calculateSpectralEfficiencyPerLayerBatch(snr.data(), expected.data(), count, acc);
+        EXPECT_EQ(expected, result);
+
+        ASSERT_EQ(FIVEG_OK, fiveg_shannon_capacity(bandwidth.data(), snr.data(), result.data(), count, accuracy));
+        calculateShannonsCapacityBatch(bandwidth.data(), snr.data(), expected.data(), count, acc);
+        EXPECT_EQ(expected, result);
+    }
+
+    double value = 0.0;
+    EXPECT_EQ(FIVEG_ERROR_INVALID_ARGUMENT, fiveg_dbm_to_watts(dBm.data(), &value, 1, 2));
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_dbm_to_watts(nullptr, &value, 1, FIVEG_ACCURACY_STRICT));
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_snr_linear(dBm.data(), nullptr, &value, 1, FIVEG_ACCURACY_STRICT));
+    EXPECT_EQ(FIVEG_OK, fiveg_shannon_capacity(nullptr, nullptr, nullptr, 0, FIVEG_ACCURACY_FAST));
+}
+
+TEST(CApiTests, PathLossMatchesCpp) {
+    const fiveg_rural_site site = {35.0, 3300.0, 3800.0, 5.0, 20.0};
+    const std::size_t count = 777;
+    std::vector<double> distance(count), height(count), pathLoss(count), expected(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        distance[i] = 5.0 + 13.0 * i;
+        height[i] = 1.5 + i % 5;
+    }
+    const RuralPathLossSite model = makeRuralPathLossSite(35.0, 3300.0, 3800.0, 5.0, 20.0);
+    for (int isLOS : {0, 1}) {
+        ASSERT_EQ(FIVEG_OK, fiveg_pathloss_rural(&site, distance.data(), height.data(), isLOS, pathLoss.data(), count));
+        calculate5GPathLossRuralBatch(model, distance.data(), height.data(), isLOS != 0, expected.data(), count);
+        EXPECT_EQ(expected, pathLoss);
+    }
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_pathloss_rural(nullptr, distance.data(), height.data(), 1,
+                                                             pathLoss.data(), count));
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_pathloss_rural(&site, distance.data(), nullptr, 1, pathLoss.data(), count));
+}
+
+TEST(CApiTests, TbsMatchesCpp) {
+    const std::size_t count = 2000;
+    std::vector<int32_t> nRE(count), mcs(count), layers(count), tbs(count);
+    std::vector<int> expected(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        nRE[i] = static_cast<int32_t>(12 * (i % 300));
+        mcs[i] = static_cast<int32_t>(i % 30) - 1; // includes invalid indices
+        layers[i] = static_cast<int32_t>(1 + i % 4);
+    }
+    const MCSTableId tables[] = {MCSTableId::Table1, MCSTableId::Table2, MCSTableId::Table3};
+    for (int table = FIVEG_TABLE_1; table <= FIVEG_TABLE_3; ++table) {
+        ASSERT_EQ(FIVEG_OK, fiveg_determine_tbs(nRE.data(), mcs.data(), layers.data(), tbs.data(), count, table));
+        determineTBSBatch(nRE.data(), mcs.data(), layers.data(), expected.data(), count, tables[table - FIVEG_TABLE_1]);
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(expected[i], tbs[i]) << "table " << table << ", row " << i;
+        }
+    }
+    EXPECT_EQ(FIVEG_ERROR_INVALID_ARGUMENT,
+              fiveg_determine_tbs(nRE.data(), mcs.data(), layers.data(), tbs.data(), count, 0));
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_determine_tbs(nRE.data(), nullptr, layers.data(), tbs.data(), count,
+                                                            FIVEG_TABLE_2));
+}
+
+TEST(CApiTests, ConfigInitHasCppDefaults) {
+    fiveg_dl_throughput_config config;
+    fiveg_dl_throughput_config_init(&config);
+    const DLThroughputConfig defaults;
+    EXPECT_EQ(sizeof(config), config.size);
+    EXPECT_EQ(defaults.dlFraction, config.dlFraction);
+    EXPECT_EQ(defaults.numerology, config.numerology);
+    EXPECT_EQ(defaults.macPacketSize, config.macPacketSize);
+    EXPECT_EQ(FIVEG_TABLE_2, config.cqiTable);
+    EXPECT_EQ(FIVEG_TABLE_2, config.mcsTable);
+    EXPECT_EQ(FIVEG_ACCURACY_STRICT, config.accuracy);
+    EXPECT_EQ(defaults.downlinkOverhead, config.downlinkOverhead);
+}
+
+TEST(CApiTests, DLThroughputMatchesCpp) {
+    const std::size_t count = 1500;
+    std::vector<double> pathLoss(count), txPower(count), bandwidth(count);
+    std::vector<int32_t> layers(count), prbs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 70.0 + 0.05 * i;
+        txPower[i] = 40.0;
+        layers[i] = static_cast<int32_t>(1 + i % 4);
+        prbs[i] = i % 100 == 42 ? -1 : 273;
+        bandwidth[i] = 100e6;
+    }
+    pathLoss[7] = std::numeric_limits<double>::quiet_NaN();
+
+    fiveg_dl_throughput_config config;
+    fiveg_dl_throughput_config_init(&config);
+    config.numerology = 1;
+    config.mcsTable = FIVEG_TABLE_1;
+    config.cqiTable = FIVEG_TABLE_1;
+    const fiveg_dl_throughput_input input = {pathLoss.data(), txPower.data(), layers.data(), prbs.data(),
+                                             bandwidth.data(), nullptr, nullptr};
+    std::vector<double> throughput(count);
+    std::vector<int32_t> mcs(count);
+    std::vector<uint64_t> mask(batchMaskWords(count));
+    std::vector<uint8_t> errors(count);
+    fiveg_dl_throughput_output output = {};
+    output.throughput = throughput.data();
+    output.mcsIndex = mcs.data();
+    output.validMask = mask.data();
+    output.errors = errors.data();
+    std::size_t numInvalid = 0;
+    ASSERT_EQ(FIVEG_OK, fiveg_dl_throughput(&config, &input, &output, count, &numInvalid));
+
+    DLThroughputConfig cppConfig;
+    cppConfig.numerology = 1;
+    cppConfig.mcsTableId = MCSTableId::Table1;
+    cppConfig.cqiTableId = CQITableId::Table1;
+    DLThroughputBatchInput cppInput;
+    cppInput.count = count;
+    cppInput.pathLoss = pathLoss.data();
+    cppInput.txPower = txPower.data();
+    cppInput.numOfLayers = layers.data();
+    cppInput.prbCount = prbs.data();
+    cppInput.bandwidth = bandwidth.data();
+    std::vector<double> expected(count);
+    std::vector<int> expectedMcs(count);
+    std::vector<BatchError> expectedErrors(count);
+    DLThroughputBatchOutput cppOutput;
+    cppOutput.throughput = expected.data();
+    cppOutput.mcsIndex = expectedMcs.data();
+    BatchStatus status;
+    status.errors = expectedErrors.data();
+    EXPECT_EQ(calculateDLThroughputBatchChecked(cppInput, cppOutput, status, cppConfig), numInvalid);
+    EXPECT_GE(numInvalid, 16u);
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(expected[i], throughput[i]) << "row " << i;
+        ASSERT_EQ(expectedMcs[i], mcs[i]) << "row " << i;
+        ASSERT_EQ(static_cast<uint8_t>(expectedErrors[i]), errors[i]) << "row " << i;
+        ASSERT_EQ(expectedErrors[i] == BatchError::None, isBatchElementValid(mask.data(), i)) << "row " << i;
+    }
+
+    // Null configuration: the defaults
+    ASSERT_EQ(FIVEG_OK, fiveg_dl_throughput(nullptr, &input, &output, count, nullptr));
+    calculateDLThroughputBatchChecked(cppInput, cppOutput, status);
+    EXPECT_EQ(expected, throughput);
+
+    // An out of range numerology rejects every row
+    config.numerology = 5;
+    ASSERT_EQ(FIVEG_OK, fiveg_dl_throughput(&config, &input, &output, count, &numInvalid));
+    EXPECT_EQ(count, numInvalid);
+    EXPECT_EQ(static_cast<uint8_t>(BatchError::InvalidConfiguration), errors[0]);
+
+    config.numerology = 1;
+    config.accuracy = 7;
+    EXPECT_EQ(FIVEG_ERROR_INVALID_ARGUMENT, fiveg_dl_throughput(&config, &input, &output, count, nullptr));
+    config.accuracy = FIVEG_ACCURACY_FAST;
+    config.size = sizeof(size_t);
+    EXPECT_EQ(FIVEG_ERROR_INVALID_ARGUMENT, fiveg_dl_throughput(&config, &input, &output, count, nullptr));
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_dl_throughput(nullptr, &input, nullptr, count, nullptr));
+    fiveg_dl_throughput_input missing = input;
+    missing.bandwidth = nullptr;
+    EXPECT_EQ(FIVEG_ERROR_NULL_POINTER, fiveg_dl_throughput(nullptr, &missing, &output, count, nullptr));
+}
@@ -0,0 +1,238 @@
+#include "columnfile.h"
+#include "commands.h"
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::string tempFile(const std::string& name) {
+    std::string path = ::testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+// A DL throughput input file sweeping the path loss over every CQI
+std::string writeDLThroughputInput(const std::string& name, std::size_t count, bool withShadowing) {
+    std::string path = tempFile(name);
+    std::vector<ColumnSpec> columns = {{"pathLoss", ColumnType::Float64}, {"txPower", ColumnType::Float64},
+                                       {"numOfLayers", ColumnType::Int32}, {"prbCount", ColumnType::Int32},
+                                       {"bandwidth", ColumnType::Float64}};
+    if (withShadowing) {
+        columns.push_back({"shadowingLoss", ColumnType::Float64});
+    }
+    ColumnFileWriter writer;
+    EXPECT_TRUE(writer.create(path, count, columns));
+    for (std::size_t i = 0; i < count; ++i) {
+        writer.float64("pathLoss")[i] = 60.0 + 0.05 * i;
+        writer.float64("txPower")[i] = 40.0 + i % 7;
+        writer.int32("numOfLayers")[i] = 1 + i % 4;
+        writer.int32("prbCount")[i] = 52 + i % 222;
+        writer.float64("bandwidth")[i] = 20e6 * (1 + i % 5);
+        if (withShadowing) {
+            writer.float64("shadowingLoss")[i] = (i % 3) * 4.0;
+        }
+    }
+    EXPECT_TRUE(writer.close());
+    return path;
+}
+
+} // namespace
+
+TEST(ColumnFileTests, RoundTrip) {
+    const std::string path = tempFile("columns_round_trip.col");
+    const std::size_t count = 1001;
+    {
+        ColumnFileWriter writer;
+        ASSERT_TRUE(writer.create(path, count, {{"x", ColumnType::Float64}, {"n", ColumnType::Int32}}));
+        EXPECT_EQ(count, writer.numRows());
+        EXPECT_EQ(nullptr, writer.float64("n")); // wrong type
+        for (std::size_t i = 0; i < count; ++i) {
+            writer.float64("x")[i] = 0.5 * i;
+            writer.int32("n")[i] = -static_cast<std::int32_t>(i);
+        }
+        EXPECT_TRUE(writer.flush(0, count));
+    } // the destructor writes and closes the file
+
+    ColumnFile file;
+    ASSERT_TRUE(file.open(path));
+    EXPECT_EQ(count, file.numRows());
+    ASSERT_EQ(2u, file.numColumns());
+    EXPECT_EQ("x", file.columnName(0));
+    EXPECT_EQ(ColumnType::Int32, file.columnType(1));
+    const double* x = file.float64("x");
+    const std::int32_t* n = file.int32("n");
+    ASSERT_TRUE(x && n);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(x) % 64);
+    EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(n) % 64);
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(0.5 * i, x[i]);
+        ASSERT_EQ(-static_cast<std::int32_t>(i), n[i]);
+    }
+    EXPECT_EQ(nullptr, file.float64("y"));
+    EXPECT_EQ(nullptr, file.int32("x"));
+    file.close();
+    EXPECT_EQ(0u, file.numColumns());
+}
+
+TEST(ColumnFileTests, RejectsInvalidFiles) {
+    ColumnFile file;
+    errno = 0;
+    EXPECT_FALSE(file.open(tempFile("columns_missing.col")));
+    EXPECT_EQ(ENOENT, errno);
+
+    const std::string text = tempFile("columns_text.col");
+    std::ofstream(text) << "pathLoss,txPower\n100,40\n100,40\n100,40\n100,40\n100,40\n100,40\n100,40\n";
+    EXPECT_FALSE(file.open(text));
+    EXPECT_EQ(EINVAL, errno);
+
+    // A truncated file no longer holds its columns
+    const std::string path = tempFile("columns_truncated.col");
+    ColumnFileWriter writer;
+    ASSERT_TRUE(writer.create(path, 100, {{"x", ColumnType::Float64}}));
+    ASSERT_TRUE(writer.close());
+    std::string content;
+    {
+        std::ifstream in(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    std::ofstream(path, std::ios::binary).write(content.data(), content.size() - 8);
+    EXPECT_FALSE(file.open(path));
+    EXPECT_EQ(EINVAL, errno);
+
+    EXPECT_FALSE(writer.create(path, 10, {{"x", ColumnType::Float64}, {"x", ColumnType::Int32}}));
+    EXPECT_EQ(EINVAL, errno);
+    EXPECT_FALSE(writer.create(path, 10, {{std::string(48, 'x'), ColumnType::Float64}}));
+    EXPECT_TRUE(writer.create(path, 0, {}));
+    EXPECT_TRUE(writer.close());
+    EXPECT_TRUE(file.open(path));
+    EXPECT_EQ(0u, file.numRows());
+}
+
+TEST(ColumnFileTests, DLThroughputRunsOnMappedColumns) {
+    const std::size_t count = 2000;
+    const std::string input = writeDLThroughputInput("columns_dl_input.col", count, true);
+    const std::string output = tempFile("columns_dl_output.col");
+    DLThroughputConfig config;
+    config.numerology = 1;
+    ASSERT_TRUE(calculateDLThroughputColumns(input, output, config, true));
+
+    ColumnFile in, out;
+    ASSERT_TRUE(in.open(input));
+    ASSERT_TRUE(out.open(output));
+    ASSERT_EQ(count, out.numRows());
+    DLThroughputBatchInput columns;
+    ASSERT_TRUE(mapDLThroughputInput(in, columns));
+    ASSERT_TRUE(columns.shadowingLoss && !columns.o2iLoss);
+
+    std::vector<double> throughput(count), codeRate(count);
+    std::vector<int> cqi(count), tbs(count);
+    DLThroughputBatchOutput expected;
+    expected.throughput = throughput.data();
+    expected.codeRate = codeRate.data();
+    expected.cqiIndex = cqi.data();
+    expected.tbsSize = tbs.data();
+    calculateDLThroughputBatch(columns, expected, config);
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(throughput[i], out.float64("throughput")[i]) << "row " << i;
+        ASSERT_EQ(codeRate[i], out.float64("codeRate")[i]) << "row " << i;
+        ASSERT_EQ(cqi[i], out.int32("cqiIndex")[i]) << "row " << i;
+        ASSERT_EQ(tbs[i], out.int32("tbsSize")[i]) << "row " << i;
+    }
+
+    // Without intermediates only the throughput is stored
+    ASSERT_TRUE(calculateDLThroughputColumns(input, output, config));
+    ASSERT_TRUE(out.open(output));
+    EXPECT_EQ(1u, out.numColumns());
+    EXPECT_EQ(throughput[count - 1], out.float64("throughput")[count - 1]);
+
+    // A file without the mandatory columns is rejected
+    const std::string pathLossOnly = tempFile("columns_pathloss_only.col");
+    ColumnFileWriter writer;
+    ASSERT_TRUE(writer.create(pathLossOnly, 10, {{"pathLoss", ColumnType::Float64}}));
+    ASSERT_TRUE(writer.close());
+    EXPECT_FALSE(calculateDLThroughputColumns(pathLossOnly, output));
+    EXPECT_EQ(EINVAL, errno);
+}
+
+TEST(ColumnFileTests, PathLossStreamsAcrossBlocks) {
+    // More rows than one block of the file driver
+    const std::size_t count = (1 << 20) + 333;
+    const std::string input = tempFile("columns_pathloss_input.col");
+    {
+        ColumnFileWriter writer;
+        ASSERT_TRUE(writer.create(input, count, {{"distance2D", ColumnType::Float64}, {"ueHeight", ColumnType::Float64}}));
+        double* distance = writer.float64("distance2D");
+        double* height = writer.float64("ueHeight");
+        for (std::size_t i = 0; i < count; ++i) {
+            distance[i] = 10.0 + (i % 20000) * 0.5;
+            height[i] = 1.5 + (i % 7);
+        }
+    }
+    const std::string output = tempFile("columns_pathloss_output.col");
+    const RuralPathLossSite site = makeRuralPathLossSite(35.0, 3300.0, 3800.0, 5.0, 20.0);
+    ASSERT_TRUE(calculate5GPathLossRuralColumns(site, false, input, output));
+
+    ColumnFile in, out;
+    ASSERT_TRUE(in.open(input));
+    ASSERT_TRUE(out.open(output));
+    std::vector<double> expected(count);
+    calculate5GPathLossRuralBatch(site, in.float64("distance2D"), in.float64("ueHeight"), false, expected.data(), count);
+    const double* pathLoss = out.float64("pathLoss");
+    for (std::size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(expected[i], pathLoss[i]) << "row " << i;
+    }
+}
+
+TEST(ColumnFileTests, CommandsRunOnColumns) {
+    const Command* command = findCommand("dl-throughput");
+    ASSERT_NE(nullptr, command);
+    const std::size_t count = 5000;
+    const std::string input = tempFile("columns_command_input.col");
+    {
+        ColumnFileWriter writer;
+        ASSERT_TRUE(writer.create(input, count, {{"layers", ColumnType::Float64}, {"bandwidth_MHz", ColumnType::Float64},
+                                                 {"txPower_dBm", ColumnType::Float64}, {"pathLoss_dB", ColumnType::Float64},
+                                                 {"prbCount", ColumnType::Float64}}));
+        for (std::size_t i = 0; i < count; ++i) {
+            writer.float64("layers")[i] = 1 + i % 4;
+            writer.float64("bandwidth_MHz")[i] = 100;
+            writer.float64("txPower_dBm")[i] = 40;
+            writer.float64("pathLoss_dB")[i] = 60 + 0.02 * i;
+            writer.float64("prbCount")[i] = i % 10 == 9 ? -1 : 273; // every tenth record is invalid
+        }
+    }
+    const std::string output = tempFile("columns_command_output.col");
+    CommandStreamStats stats;
+    ASSERT_TRUE(runCommandColumns(*command, input, output, stats));
+    EXPECT_EQ(count, stats.records);
+
+    ColumnFile in, out;
+    ASSERT_TRUE(in.open(input));
+    ASSERT_TRUE(out.open(output));
+    const double* throughput = out.float64("throughput_Mbps");
+    ASSERT_NE(nullptr, throughput);
+    std::size_t invalid = 0;
+    for (std::size_t i = 0; i < count; ++i) {
+        double record[maxCommandFields] = {in.float64("layers")[i], in.float64("bandwidth_MHz")[i],
+                                           in.float64("txPower_dBm")[i], in.float64("pathLoss_dB")[i],
+                                           in.float64("prbCount")[i]};
+        double expected[maxCommandFields];
+        if (command->evaluate(record, expected)) {
+            ASSERT_EQ(expected[0], throughput[i]) << "row " << i;
+        } else {
+            ASSERT_TRUE(std::isnan(throughput[i])) << "row " << i;
+            ++invalid;
+        }
+    }
+    EXPECT_EQ(invalid, stats.invalid);
+    EXPECT_GE(invalid, count / 10);
+
+    // The input column of the wavelength command is missing
+    CommandStreamStats missing;
+    EXPECT_FALSE(runCommandColumns(*findCommand("wavelength"), input, output, missing));
+    EXPECT_EQ(EINVAL, errno);
+}
@@ -0,0 +1,162 @@
+#include "commands.h"
+#include "linkbudget.h"
+#include <gtest/gtest.h>
+#include <cstring>
+
+namespace {
+
+std::string evaluate(const std::string& name, const std::string& record) {
+    const Command* command = findCommand(name);
+    std::string out;
+    if (command) {
+        evaluateRecord(*command, record.data(), record.data() + record.size(), out, 17);
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(CommandTests, EveryUtilityIsRegistered) {
+    std::size_t count;
+    const Command* commands = commandList(count);
+    EXPECT_EQ(42u, count);
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_EQ(&commands[i], findCommand(commands[i].name));
+        EXPECT_EQ(&commands[i], findCommand(commands[i].utility));
+        EXPECT_LE(commands[i].minInputs, commands[i].maxInputs);
+        EXPECT_LE(commands[i].maxInputs, maxCommandFields);
+        EXPECT_LE(commands[i].numOutputs, maxCommandFields);
+    }
+    EXPECT_EQ(nullptr, findCommand("unknown"));
+}
+
+TEST(CommandTests, RecordsMatchTheUtilityFunctions) {
+    char expected[64];
+    std::snprintf(expected, sizeof(expected), "%.17g\n", calculateWavelength(3.5e9));
+    EXPECT_EQ(expected, evaluate("wavelength", "3.5e9"));
+    EXPECT_EQ("30\n", evaluate("watts-to-dbm", " 1 "));
+    EXPECT_EQ("30\n", evaluate("ConvertWattsToDbm", "1"));
+    EXPECT_EQ("6,666\n", evaluate("modulation-code-rate", "4"));
+
+    double nInfo = calculateNumberOfInformationBits(calculateActualAvailableREs(calculateAvailableREs(12, 14, 0, 0), 2),
+                                                    567, 6);
+    std::snprintf(expected, sizeof(expected), "%.17g,%d\n", nInfo, calculateTBSForNinfo(nInfo, 567));
+    EXPECT_EQ(expected, evaluate("information-bits", "2;13;14"));
+
+    std::snprintf(expected, sizeof(expected), "%.17g\n", calculateDLThroughput(100, 40, 4, 273, 100e6) / 1000);
+    EXPECT_EQ(expected, evaluate("dl-throughput", "4,100,40,100,273"));
+}
+
+TEST(CommandTests, UtilityFunctionsAreCommandsUnderTheirNames) {
+    auto number = [](double value) {
+        char text[64];
+        std::snprintf(text, sizeof(text), "%.17g", value);
+        return std::string(text);
+    };
+    EXPECT_EQ("0.25\n", evaluate("calculateSlotSize", "2"));
+    EXPECT_EQ("4\n", evaluate("calculateNumberOfSlots", "0.25"));
+    EXPECT_EQ("120\n", evaluate("calculateSCS", "3"));
+    EXPECT_EQ("3\n", evaluate("getNumerology", "120"));
+    EXPECT_EQ("113\n", evaluate("calculateLargeScaleTotalLoss", "100,8,5"));
+    EXPECT_EQ("100\n", evaluate("large-scale-loss", "100"));
+    EXPECT_EQ(number(calculateTransmittedPowerPerLayer(40, 4)) + "\n",
+              evaluate("calculateTransmittedPowerPerLayer", "40,4"));
+    EXPECT_EQ("-57\n", evaluate("calculateReceivedPowerPerLayer", "40,100,3"));
+    EXPECT_EQ(number(calculateThermalNoisePower(290, 100e6)) + "\n",
+              evaluate("calculateThermalNoisePower", "290,100e6"));
+    EXPECT_EQ(number(calculateSNRLinear(-80, 4e-13)) + "\n", evaluate("calculateSNRLinear", "-80,4e-13"));
+
+    auto cqi = determineIntermediateSpectralEfficiency(3.0, CQITableId::Table1);
+    EXPECT_EQ(std::to_string(cqi.first) + "," + number(cqi.second) + "\n",
+              evaluate("determineIntermediateSpectralEfficiency", "3,1"));
+    cqi = determineIntermediateSpectralEfficiency(3.0);
+    EXPECT_EQ(std::to_string(cqi.first) + "," + number(cqi.second) + "\n", evaluate("cqi", "3"));
+    EXPECT_EQ(std::to_string(determineMcsIndex(3.0, MCSTableId::Table3)) + "\n", evaluate("determineMcsIndex", "3,3"));
+    auto mcs = determineModulationAndCodeRateUsingMcsIndex(20, MCSTableId::Table1);
+    EXPECT_EQ(std::to_string(mcs.first) + "," + number(mcs.second) + "\n",
+              evaluate("determineModulationAndCodeRateUsingMcsIndex", "20,1"));
+    mcs = determineModulationAndCodeRate(determineIntermediateSpectralEfficiency(4.0, CQITableId::Table1).second,
+                                         MCSTableId::Table1);
+    EXPECT_EQ(std::to_string(mcs.first) + "," + number(mcs.second) + "\n", evaluate("modulation-code-rate", "4,1"));
+
+    EXPECT_EQ("156\n", evaluate("calculateAvailableREs", "12,14,12,0"));
+    EXPECT_EQ("168\n", evaluate("available-res", "12,14"));
+    EXPECT_EQ("1560\n", evaluate("calculateActualAvailableREs", "168,10"));
+    EXPECT_EQ(number(calculateNumberOfInformationBits(1560, 658, 6)) + "\n",
+              evaluate("calculateNumberOfInformationBits", "1560,658,6"));
+    EXPECT_EQ(std::to_string(calculateNinfoPrime(6015.9)) + "\n", evaluate("calculateNinfoPrime", "6015.9"));
+    EXPECT_EQ(std::to_string(findTBSForNinfoPrime(1000)) + "\n", evaluate("findTBSForNinfoPrime", "1000"));
+    EXPECT_EQ(std::to_string(calculateTBS(6016, 658)) + "\n", evaluate("calculateTBS", "6016,658"));
+    EXPECT_EQ(std::to_string(calculateTBSForNinfo(6015.9, 658)) + "\n", evaluate("calculateTBSForNinfo", "6015.9,658"));
+    EXPECT_EQ("16000\n", evaluate("calculateTotalBitsPerPrb", "4,4000"));
+    EXPECT_EQ(std::to_string(calculateTotalPRBsAvailable(273)) + "\n",
+              evaluate("calculateTotalPRBsAvailable", "273,0.18"));
+    EXPECT_EQ("3584000\n", evaluate("calculateBitsPerSlot", "16000,224"));
+    EXPECT_EQ(number(calculateDLApplicationThroughput(3584000, 0.8, 0.5e-3, 1460 * 8, 1500 * 8)) + "\n",
+              evaluate("calculateDLApplicationThroughput", "3584000,0.8,0.5e-3,11680,12000"));
+    EXPECT_EQ(number(calculateDLFraction("4:1")) + "\n", evaluate("calculateDLFraction", "4,1"));
+
+    // Inputs outside of what the functions handle give "nan" instead of an exception or overflow
+    EXPECT_EQ("nan\n", evaluate("getNumerology", "45"));
+    EXPECT_EQ("nan,nan\n", evaluate("determineModulationAndCodeRateUsingMcsIndex", "28"));
+    EXPECT_EQ("nan,nan\n", evaluate("cqi", "3,4"));
+    EXPECT_EQ("nan\n", evaluate("calculateNinfoPrime", "0"));
+    EXPECT_EQ("nan\n", evaluate("calculateTotalBitsPerPrb", "100000000,8"));
+    EXPECT_EQ("nan\n", evaluate("calculateBitsPerSlot", "100000,100000"));
+    EXPECT_EQ("nan\n", evaluate("calculateDLFraction", "4,0"));
+}
+
+TEST(CommandTests, InvalidRecordsKeepTheOutputAligned) {
+    EXPECT_EQ("nan\n", evaluate("wavelength", "-1"));
+    EXPECT_EQ("nan\n", evaluate("wavelength", "abc"));
+    EXPECT_EQ("nan\n", evaluate("wavelength", "1,2"));
+    EXPECT_EQ("nan,nan\n", evaluate("information-bits", "2,40,14"));
+    EXPECT_EQ("nan\n", evaluate("ofdm-symbol-duration", "45"));
+    EXPECT_NE("nan\n", evaluate("ofdm-symbol-duration", "60"));
+}
+
+TEST(CommandTests, StreamSkipsHeaderAndComments) {
+    const char input[] = "power_dBm\n# comment\n30\n\n0\r\nx\n-30";
+    std::FILE* in = std::tmpfile();
+    std::FILE* out = std::tmpfile();
+    ASSERT_TRUE(in && out);
+    std::fwrite(input, 1, std::strlen(input), in);
+    std::rewind(in);
+
+    CommandStreamOptions options;
+    options.header = true;
+    options.precision = 6;
+    CommandStreamStats stats = runCommandStream(*findCommand("dbm-to-watts"), in, out, options);
+    EXPECT_EQ(4u, stats.records);
+    EXPECT_EQ(1u, stats.invalid);
+
+    std::rewind(out);
+    char result[128] = {};
+    std::size_t length = std::fread(result, 1, sizeof(result) - 1, out);
+    EXPECT_EQ("power_W\n1\n0.001\nnan\n1e-06\n", std::string(result, length));
+    std::fclose(in);
+    std::fclose(out);
+}
+
+TEST(CommandTests, BatchEvaluationMatchesRecords) {
+    std::size_t count;
+    const Command* commands = commandList(count);
+    const double records[][maxCommandFields] = {{4, 100, 40, 100, 273}, {1, 20, 23, 130, 51}, {3, 100, 40, 100, 273},
+                                                {2, 50, 43, 90, 133.5}, {8, 400, 46, 120, 264}};
+    const std::size_t numRecords = sizeof(records) / sizeof(records[0]);
+    for (std::size_t c = 0; c < count; ++c) {
+        if (!commands[c].evaluateBatch) {
+            continue;
+        }
+        double outputs[numRecords][maxCommandFields];
+        bool valid[numRecords];
+        commands[c].evaluateBatch(&records[0][0], &outputs[0][0], valid, numRecords);
+        for (std::size_t r = 0; r < numRecords; ++r) {
+            double expected[maxCommandFields];
+            ASSERT_EQ(commands[c].evaluate(records[r], expected), valid[r]) << commands[c].name << " record " << r;
+            for (int i = 0; valid[r] && i < commands[c].numOutputs; ++i) {
+                EXPECT_EQ(expected[i], outputs[r][i]) << commands[c].name << " record " << r;
+            }
+        }
+    }
+}
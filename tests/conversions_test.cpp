@@ -0,0 +1,134 @@
+#include "conversions.h"
+#include "simd.h"
+#include <cfloat>
+#include <limits>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Distance between two doubles of the same sign in units in the last place
+double ulpDistance(double expected, double actual) {
+    double ulp = std::nextafter(std::fabs(expected), std::numeric_limits<double>::infinity()) - std::fabs(expected);
+    return std::fabs(expected - actual) / ulp;
+}
+
+std::vector<double> sweep(double low, double high, std::size_t count) {
+    std::vector<double> values(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        values[i] = low + (high - low) * i / (count - 1);
+    }
+    return values;
+}
+
+bool sameValue(double expected, double actual) {
+    return expected == actual || (std::isnan(expected) && std::isnan(actual));
+}
+
+void expectDbmToWattsWithinFourUlp() {
+    std::vector<double> dBm = sweep(-3000.0, 3000.0, 1000003);
+    std::vector<double> watts(dBm.size());
+    dBmToWattsBatch(dBm.data(), watts.data(), dBm.size());
+    for (std::size_t i = 0; i < dBm.size(); ++i) {
+        ASSERT_LE(ulpDistance(dBmToWatts(dBm[i]), watts[i]), 4.0) << "dBm " << dBm[i];
+    }
+}
+
+void expectWattsToDbmWithinBound() {
+    std::vector<double> watts;
+    for (double w = 1e-300; w < 1e300; w *= 1.0173) {
+        watts.push_back(w);
+    }
+    std::vector<double> dBm(watts.size());
+    wattsToDbmBatch(watts.data(), dBm.data(), watts.size());
+    for (std::size_t i = 0; i < watts.size(); ++i) {
+        ASSERT_NEAR(wattsToDbm(watts[i]), dBm[i], 2e-12) << "watts " << watts[i];
+    }
+}
+
+void expectSNRLinearWithinFourUlp() {
+    std::vector<double> rxPower = sweep(-150.0, 30.0, 50001);
+    std::vector<double> noise(rxPower.size()), snr(rxPower.size());
+    for (std::size_t i = 0; i < noise.size(); ++i) {
+        noise[i] = calculateThermalNoisePower(300.0, (5 + i % 96) * 1e6);
+    }
+    calculateSNRLinearBatch(rxPower.data(), noise.data(), snr.data(), rxPower.size());
+    for (std::size_t i = 0; i < rxPower.size(); ++i) {
+        ASSERT_LE(ulpDistance(calculateSNRLinear(rxPower[i], noise[i]), snr[i]), 4.0) << "rx power " << rxPower[i];
+    }
+}
+
+void expectSpectralEfficiencyWithinFourUlp() {
+    std::vector<double> snr;
+    for (double s = 1e-12; s < 1e12; s *= 1.0071) {
+        snr.push_back(s);
+    }
+    snr.push_back(0.0);
+    snr.push_back(-1.0);
+    std::vector<double> spectralEfficiency(snr.size());
+    calculateSpectralEfficiencyPerLayerBatch(snr.data(), spectralEfficiency.data(), snr.size());
+    for (std::size_t i = 0; i < snr.size(); ++i) {
+        ASSERT_LE(ulpDistance(calculateSpectralEfficiencyPerLayer(snr[i]), spectralEfficiency[i]), 4.0)
+            << "snr " << snr[i];
+    }
+}
+
+// Values outside the range of the polynomial kernels, mixed into full vectors
+void expectOutOfRangeValuesMatchLibm() {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values = {-inf, -5000.0, -1.0, 0.0, DBL_MIN / 4, 5000.0, inf, nan};
+    std::vector<double> result(values.size());
+
+    dBmToWattsBatch(values.data(), result.data(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_TRUE(sameValue(dBmToWatts(values[i]), result[i])) << values[i];
+    }
+    wattsToDbmBatch(values.data(), result.data(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_TRUE(sameValue(wattsToDbm(values[i]), result[i])) << values[i];
+    }
+    calculateSpectralEfficiencyPerLayerBatch(values.data(), result.data(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_TRUE(sameValue(calculateSpectralEfficiencyPerLayer(values[i]), result[i])) << values[i];
+    }
+}
+
+void expectFastConversionsWithinBounds(SimdLevel level) {
+    SimdLevel previous = activeSimdLevel();
+    setSimdLevel(level);
+    expectDbmToWattsWithinFourUlp();
+    expectWattsToDbmWithinBound();
+    expectSNRLinearWithinFourUlp();
+    expectSpectralEfficiencyWithinFourUlp();
+    expectOutOfRangeValuesMatchLibm();
+    setSimdLevel(previous);
+}
+
+} // namespace
+
+TEST(ConversionsTests, ScalarBatchWithinBounds) {
+    expectFastConversionsWithinBounds(SimdLevel::Scalar);
+}
+
+TEST(ConversionsTests, AVX2BatchWithinBounds) {
+    expectFastConversionsWithinBounds(SimdLevel::AVX2);
+}
+
+TEST(ConversionsTests, AVX512BatchWithinBounds) {
+    expectFastConversionsWithinBounds(SimdLevel::AVX512);
+}
+
+TEST(ConversionsTests, StrictModeIsBitIdentical) {
+    std::vector<double> dBm = sweep(-120.0, 60.0, 1001);
+    std::vector<double> noise(dBm.size(), 4.14e-13);
+    std::vector<double> result(dBm.size());
+
+    dBmToWattsBatch(dBm.data(), result.data(), dBm.size(), ConversionAccuracy::Strict);
+    for (std::size_t i = 0; i < dBm.size(); ++i) {
+        ASSERT_EQ(dBmToWatts(dBm[i]), result[i]);
+    }
+    calculateSNRLinearBatch(dBm.data(), noise.data(), result.data(), dBm.size(), ConversionAccuracy::Strict);
+    for (std::size_t i = 0; i < dBm.size(); ++i) {
+        ASSERT_EQ(calculateSNRLinear(dBm[i], noise[i]), result[i]);
+    }
+}
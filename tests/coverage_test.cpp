@@ -0,0 +1,99 @@
+#include "coverage.h"
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <gtest/gtest.h>
+
+namespace {
+
+std::vector<CoverageSite> testSites() {
+    std::vector<CoverageSite> sites;
+    sites.push_back({1000.0, 1000.0, 35.0, 46.0});
+    sites.push_back({4000.0, 2500.0, 25.0, 43.0});
+    sites.push_back({2500.0, 4500.0, 35.0, 46.0});
+    return sites;
+}
+
+CoverageGrid testGrid() {
+    CoverageGrid grid;
+    grid.resolution = 50.0;
+    grid.width = 100;  // 5 km
+    grid.height = 90;  // 4.5 km, not a multiple of the tile size
+    return grid;
+}
+
+} // namespace
+
+TEST(CoverageTests, BestServerMatchesPerPixelReference) {
+    std::vector<CoverageSite> sites = testSites();
+    CoverageGrid grid = testGrid();
+    CoverageConfig config;
+    config.tileSize = 16;
+    CoverageMap map = generateCoverageMap(sites, grid, config);
+
+    for (int row = 0; row < grid.height; row += 7) {
+        for (int col = 0; col < grid.width; col += 3) {
+            double x = (col + 0.5) * grid.resolution;
+            double y = (row + 0.5) * grid.resolution;
+            int expectedServer = -1;
+            double expectedRsrp = 0;
+            for (std::size_t s = 0; s < sites.size(); ++s) {
+                double d = std::hypot(x - sites[s].x, y - sites[s].y);
+                double pl = calculate5GPathLossRural(sites[s].gNBAntennaHeight, config.ueHeight, config.fLow, config.fHigh,
+                                                     d, config.buildingHeight, config.streetWidth, config.isLOS);
+                double rsrp = sites[s].txPower - 10 * std::log10(12 * config.prbCount) - pl;
+                if (pl > 0 && (expectedServer < 0 || rsrp > expectedRsrp)) {
+                    expectedServer = static_cast<int>(s);
+                    expectedRsrp = rsrp;
+                }
+            }
+            std::size_t pixel = static_cast<std::size_t>(row) * grid.width + col;
+            ASSERT_EQ(expectedServer, map.bestServer[pixel]) << "pixel " << col << "," << row;
+            if (expectedServer >= 0) {
+                EXPECT_NEAR(expectedRsrp, map.rsrp[pixel], 1e-3);
+            }
+        }
+    }
+}
+
+TEST(CoverageTests, ResultIndependentOfThreadCountAndTiling) {
+    CoverageConfig serial;
+    serial.numThreads = 1;
+    serial.tileSize = 64;
+    CoverageConfig parallel;
+    parallel.numThreads = 4;
+    parallel.tileSize = 7;
+
+    CoverageMap a = generateCoverageMap(testSites(), testGrid(), serial);
+    CoverageMap b = generateCoverageMap(testSites(), testGrid(), parallel);
+    EXPECT_EQ(a.bestServer, b.bestServer);
+    for (std::size_t i = 0; i < a.pathLoss.size(); ++i) {
+        ASSERT_EQ(a.pathLoss[i], b.pathLoss[i]);
+    }
+}
+
+TEST(CoverageTests, RastersAreWrittenLittleEndian) {
+    const CoverageMap map = generateCoverageMap(testSites(), testGrid(), CoverageConfig());
+    const std::string prefix = ::testing::TempDir() + "coverage_test";
+    ASSERT_TRUE(writeCoverageMap(map, prefix));
+
+    std::ifstream rsrp(prefix + "_rsrp.f32", std::ios::binary);
+    const std::vector<unsigned char> rsrpBytes((std::istreambuf_iterator<char>(rsrp)), std::istreambuf_iterator<char>());
+    std::ifstream server(prefix + "_server.i32", std::ios::binary);
+    const std::vector<unsigned char> serverBytes((std::istreambuf_iterator<char>(server)),
+                                                 std::istreambuf_iterator<char>());
+    ASSERT_EQ(4 * map.rsrp.size(), rsrpBytes.size());
+    ASSERT_EQ(4 * map.bestServer.size(), serverBytes.size());
+    auto littleEndian = [](const std::vector<unsigned char>& bytes, std::size_t i) {
+        return static_cast<std::uint32_t>(bytes[4 * i]) | static_cast<std::uint32_t>(bytes[4 * i + 1]) << 8 |
+               static_cast<std::uint32_t>(bytes[4 * i + 2]) << 16 | static_cast<std::uint32_t>(bytes[4 * i + 3]) << 24;
+    };
+    for (std::size_t i = 0; i < map.rsrp.size(); ++i) {
+        std::uint32_t rsrpBits, serverBits;
+        std::memcpy(&rsrpBits, &map.rsrp[i], 4);
+        std::memcpy(&serverBits, &map.bestServer[i], 4);
+        ASSERT_EQ(rsrpBits, littleEndian(rsrpBytes, i)) << "pixel " << i;
+        ASSERT_EQ(serverBits, littleEndian(serverBytes, i)) << "pixel " << i;
+    }
+}
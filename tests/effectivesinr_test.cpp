@@ -0,0 +1,180 @@
+#include "effectivesinr.h"
+#include "simd.h"
+#include <cmath>
+#include <random>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Per-PRB SINRs of a frequency selective channel: Rayleigh fading around a mean SINR
+std::vector<double> fadingChannel(double meanSinr_dB, std::size_t numPrbs, unsigned int seed) {
+    std::mt19937 generator(seed);
+    std::exponential_distribution<double> fading(1.0);
+    std::vector<double> sinr(numPrbs);
+    for (double& value : sinr) {
+        value = std::pow(10, meanSinr_dB / 10) * fading(generator);
+    }
+    return sinr;
+}
+
+double referenceEesm(const std::vector<double>& sinr, double beta) {
+    double sum = 0.0;
+    for (double value : sinr) {
+        sum += std::exp(-value / beta);
+    }
+    return -beta * std::log(sum / sinr.size());
+}
+
+double referenceMiesm(const std::vector<double>& sinr, int modulationOrder) {
+    double sum = 0.0;
+    for (double value : sinr) {
+        sum += std::min<double>(modulationOrder, std::log2(1.0 + value));
+    }
+    return std::pow(2.0, sum / sinr.size()) - 1.0;
+}
+
+void expectKernelsMatchReference(SimdLevel level) {
+    SimdLevel previous = activeSimdLevel();
+    setSimdLevel(level);
+    for (std::size_t numPrbs = 1; numPrbs <= 273; numPrbs += 17) {
+        std::vector<double> sinr = fadingChannel(5.0, numPrbs, static_cast<unsigned int>(numPrbs));
+        for (double beta : {1.5, 6.0, 40.0}) {
+            const double expected = referenceEesm(sinr, beta);
+            EXPECT_NEAR(expected, calculateEesmEffectiveSinr(sinr.data(), numPrbs, beta), 1e-12 * expected)
+                << numPrbs << " PRBs, beta " << beta;
+        }
+        for (int qm : {2, 4, 6, 8}) {
+            const double expected = referenceMiesm(sinr, qm);
+            EXPECT_NEAR(expected, calculateMiesmEffectiveSinr(sinr.data(), numPrbs, qm), 1e-12 * expected)
+                << numPrbs << " PRBs, Qm " << qm;
+        }
+    }
+    setSimdLevel(previous);
+}
+
+} // namespace
+
+TEST(EffectiveSinrTests, ScalarKernelsMatchReference) {
+    expectKernelsMatchReference(SimdLevel::Scalar);
+}
+
+TEST(EffectiveSinrTests, AVX2KernelsMatchReference) {
+    if (detectSimdLevel() < SimdLevel::AVX2) {
+        GTEST_SKIP() << "AVX2 not supported";
+    }
+    expectKernelsMatchReference(SimdLevel::AVX2);
+}
+
+TEST(EffectiveSinrTests, AVX512KernelsMatchReference) {
+    if (detectSimdLevel() < SimdLevel::AVX512) {
+        GTEST_SKIP() << "AVX-512 not supported";
+    }
+    expectKernelsMatchReference(SimdLevel::AVX512);
+}
+
+TEST(EffectiveSinrTests, FlatChannelKeepsItsSinr) {
+    const std::vector<double> flat(273, 12.5);
+    EXPECT_NEAR(12.5, calculateEesmEffectiveSinr(flat.data(), flat.size(), 3.0), 1e-12);
+    EXPECT_NEAR(12.5, calculateMiesmEffectiveSinr(flat.data(), flat.size(), 6), 1e-12);
+    // The mutual information saturates at Qm bits per symbol
+    EXPECT_NEAR(3.0, calculateMiesmEffectiveSinr(flat.data(), flat.size(), 2), 1e-12);
+    EXPECT_EQ(0.0, calculateEesmEffectiveSinr(flat.data(), 0, 3.0));
+}
+
+TEST(EffectiveSinrTests, EesmLiesBetweenMinimumAndMean) {
+    std::vector<double> sinr = fadingChannel(10.0, 273, 7);
+    double minimum = sinr[0], mean = 0.0;
+    for (double value : sinr) {
+        minimum = std::min(minimum, value);
+        mean += value / sinr.size();
+    }
+    double previous = minimum;
+    for (double beta : {0.01, 0.1, 1.0, 10.0, 100.0}) {
+        const double effective = calculateEesmEffectiveSinr(sinr.data(), sinr.size(), beta);
+        EXPECT_GE(effective, previous);
+        EXPECT_LE(effective, mean);
+        previous = effective;
+    }
+    EXPECT_NEAR(mean, calculateEesmEffectiveSinr(sinr.data(), sinr.size(), 1e9), 1e-6 * mean);
+}
+
+TEST(EffectiveSinrTests, CalibratedBetaMatchesMiesmOnReferenceChannel) {
+    for (MCSTableId table : {MCSTableId::Table1, MCSTableId::Table2, MCSTableId::Table3}) {
+        const ConstexprTable<MCSEntry> mcs = getMCSTable(table);
+        for (std::size_t m = 0; m < mcs.size(); ++m) {
+            const double beta = eesmBeta(static_cast<int>(m), table);
+            const double operatingPoint = std::pow(2.0, mcs[m].maxSpectralEfficiency) - 1.0;
+            const double channel[2] = {operatingPoint / std::pow(10, 0.6), operatingPoint * std::pow(10, 0.6)};
+            const double miesm = calculateMiesmEffectiveSinr(channel, 2, mcs[m].modulationOrder);
+            EXPECT_NEAR(miesm, calculateEesmEffectiveSinr(channel, 2, beta), 1e-9 * miesm) << "MCS " << m;
+        }
+    }
+    EXPECT_LT(eesmBeta(0), 3.0);
+    EXPECT_GT(eesmBeta(27), 20.0);
+    EXPECT_LT(eesmBeta(4), eesmBeta(10));
+    EXPECT_THROW(eesmBeta(28), std::runtime_error);
+    EXPECT_THROW(eesmBeta(-1, MCSTableId::Table1), std::runtime_error);
+}
+
+TEST(EffectiveSinrTests, FlatChannelTakesTheDecisionOfTheChain) {
+    for (EffectiveSinrModel model : {EffectiveSinrModel::EESM, EffectiveSinrModel::MIESM}) {
+        EffectiveSinrConfig config;
+        config.model = model;
+        for (double snr_dB = -10.0; snr_dB <= 40.0; snr_dB += 0.37) {
+            const std::vector<double> flat(52, std::pow(10, snr_dB / 10));
+            EffectiveLinkAdaptation result = determineEffectiveLinkAdaptation(flat.data(), flat.size(), config);
+            EXPECT_TRUE(result.entry == determineLinkAdaptationLinear(flat[0])) << snr_dB << " dB";
+        }
+    }
+}
+
+TEST(EffectiveSinrTests, FadingLowersTheMcs) {
+    for (EffectiveSinrModel model : {EffectiveSinrModel::EESM, EffectiveSinrModel::MIESM}) {
+        EffectiveSinrConfig config;
+        config.model = model;
+        for (double meanSinr_dB = 0.0; meanSinr_dB <= 30.0; meanSinr_dB += 5.0) {
+            std::vector<double> sinr = fadingChannel(meanSinr_dB, 273, 11);
+            double minimum = sinr[0], mean = 0.0;
+            for (double value : sinr) {
+                minimum = std::min(minimum, value);
+                mean += value / sinr.size();
+            }
+            EffectiveLinkAdaptation result = determineEffectiveLinkAdaptation(sinr.data(), sinr.size(), config);
+            EXPECT_GE(result.effectiveSinr, minimum);
+            EXPECT_LE(result.effectiveSinr, mean);
+            EXPECT_LE(result.entry.mcsIndex, determineLinkAdaptationLinear(mean).mcsIndex);
+            EXPECT_GE(result.entry.mcsIndex, determineLinkAdaptationLinear(minimum).mcsIndex);
+            EXPECT_TRUE(result.entry == determineLinkAdaptationLinear(result.effectiveSinr));
+        }
+    }
+}
+
+TEST(EffectiveSinrTests, BetaOverride) {
+    std::vector<double> sinr = fadingChannel(15.0, 100, 3);
+    std::vector<double> beta(mcsTable1.size(), 4.0);
+    EffectiveSinrConfig config;
+    config.mcsTable = MCSTableId::Table1;
+    config.cqiTable = CQITableId::Table1;
+    config.beta = beta.data();
+    EffectiveLinkAdaptation result = determineEffectiveLinkAdaptation(sinr.data(), sinr.size(), config);
+    EXPECT_DOUBLE_EQ(calculateEesmEffectiveSinr(sinr.data(), sinr.size(), 4.0), result.effectiveSinr);
+    EXPECT_TRUE(result.entry == determineLinkAdaptationLinear(result.effectiveSinr, CQITableId::Table1,
+                                                              MCSTableId::Table1));
+}
+
+TEST(EffectiveSinrTests, BatchMatchesPerUe) {
+    const std::size_t numPrbs = 273;
+    const std::size_t numUes = 500;
+    std::vector<double> sinr;
+    for (std::size_t ue = 0; ue < numUes; ++ue) {
+        std::vector<double> channel = fadingChannel(-5.0 + 0.07 * ue, numPrbs, static_cast<unsigned int>(ue));
+        sinr.insert(sinr.end(), channel.begin(), channel.end());
+    }
+    std::vector<EffectiveLinkAdaptation> results(numUes);
+    determineEffectiveLinkAdaptationBatch(sinr.data(), numPrbs, numUes, results.data());
+    for (std::size_t ue = 0; ue < numUes; ++ue) {
+        EffectiveLinkAdaptation expected = determineEffectiveLinkAdaptation(sinr.data() + ue * numPrbs, numPrbs);
+        ASSERT_EQ(expected.effectiveSinr, results[ue].effectiveSinr) << "UE " << ue;
+        ASSERT_TRUE(expected.entry == results[ue].entry) << "UE " << ue;
+    }
+}
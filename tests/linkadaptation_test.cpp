@@ -0,0 +1,57 @@
+#include "linkadaptation.h"
+#include <limits>
+#include <gtest/gtest.h>
+
+TEST(LinkAdaptationTests, ValidationFindsNoDisagreement) {
+    LinkAdaptationTable table;
+    EXPECT_EQ(5000u, table.numBins());
+    EXPECT_EQ(15u, table.thresholds().size());
+    EXPECT_EQ(0u, table.validate());
+
+    LinkAdaptationTable lowSe(-10.0, 40.0, 0.01, CQITableId::Table3, MCSTableId::Table3);
+    EXPECT_EQ(0u, lowSe.validate());
+}
+
+TEST(LinkAdaptationTests, CoarseBinsStayExact) {
+    // 2 dB bins hold several thresholds each and must fall back to the exact chain
+    LinkAdaptationTable table(-10.0, 40.0, 2.0, CQITableId::Table1, MCSTableId::Table1);
+    EXPECT_EQ(0u, table.validate());
+}
+
+TEST(LinkAdaptationTests, NaNSnrTakesLowestDecision) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    // Fine bins, and coarse bins falling back to the exact chain in bin 0
+    for (double step : {0.01, 20.0}) {
+        LinkAdaptationTable table(-10.0, 40.0, step, CQITableId::Table1, MCSTableId::Table1);
+        const LinkAdaptationEntry lowest = table.lookup(-100.0);
+        EXPECT_EQ(0, lowest.cqiIndex);
+        EXPECT_TRUE(lowest == table.lookup(nan)) << "step " << step;
+        LinkAdaptationEntry entry;
+        table.lookup(&nan, &entry, 1);
+        EXPECT_TRUE(lowest == entry) << "step " << step;
+    }
+}
+
+TEST(LinkAdaptationTests, LookupMatchesChainAcrossRange) {
+    LinkAdaptationTable table;
+    std::vector<double> snr;
+    for (double s = -20.0; s <= 50.0; s += 0.0037) {
+        snr.push_back(s);
+    }
+    std::vector<LinkAdaptationEntry> entries(snr.size());
+    table.lookup(snr.data(), entries.data(), snr.size());
+    for (std::size_t i = 0; i < snr.size(); ++i) {
+        LinkAdaptationEntry expected = determineLinkAdaptation(snr[i]);
+        ASSERT_TRUE(expected == entries[i]) << "SNR " << snr[i] << " dB";
+    }
+    EXPECT_EQ(0, entries.front().cqiIndex);
+    EXPECT_EQ(15, entries.back().cqiIndex);
+    EXPECT_EQ(27, entries.back().mcsIndex);
+    EXPECT_EQ(8, entries.back().modulationOrder);
+}
+
+TEST(LinkAdaptationTests, LinearChainMatchesDbChain) {
+    for (double snr_dB = -10.0; snr_dB <= 40.0; snr_dB += 0.11) {
+        EXPECT_TRUE(determineLinkAdaptation(snr_dB) == determineLinkAdaptationLinear(std::pow(10, snr_dB / 10)));
+    }
+}
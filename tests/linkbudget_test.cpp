@@ -0,0 +1,131 @@
+#include "linkbudget.h"
+#include <gtest/gtest.h>
+
+TEST(LinkBudgetTests, BatchMatchesScalarChain) {
+    const std::size_t count = 1000;
+    std::vector<double> pathLoss(count), txPower(count), bandwidth(count), throughput(count);
+    std::vector<int> layers(count), prbCount(count), cqi(count), tbs(count);
+    const int layerChoices[] = {1, 2, 4, 8};
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 60.0 + 0.1 * i;
+        txPower[i] = 20 + i % 30;
+        layers[i] = layerChoices[i % 4];
+        prbCount[i] = 25 + i % 250;
+        bandwidth[i] = (10 + 10 * (i % 10)) * 1e6;
+    }
+
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    output.cqiIndex = cqi.data();
+    output.tbsSize = tbs.data();
+
+    calculateDLThroughputBatch(input, output);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_DOUBLE_EQ(throughput[i], calculateDLThroughput(pathLoss[i], txPower[i], layers[i], prbCount[i], bandwidth[i]));
+    }
+    // The sweep covers the whole CQI range, from out of range to the highest entry
+    EXPECT_EQ(0, *std::min_element(cqi.begin(), cqi.end()));
+    EXPECT_EQ(15, *std::max_element(cqi.begin(), cqi.end()));
+}
+
+TEST(LinkBudgetTests, PerUEShadowingColumnOverridesConfig) {
+    double pathLoss[] = {100.0, 100.0};
+    double txPower[] = {40.0, 40.0};
+    int layers[] = {2, 2};
+    int prbCount[] = {100, 100};
+    double bandwidth[] = {20e6, 20e6};
+    double shadowing[] = {0.0, 30.0};
+    double throughput[2];
+
+    DLThroughputBatchInput input;
+    input.count = 2;
+    input.pathLoss = pathLoss;
+    input.txPower = txPower;
+    input.numOfLayers = layers;
+    input.prbCount = prbCount;
+    input.bandwidth = bandwidth;
+    input.shadowingLoss = shadowing;
+
+    DLThroughputBatchOutput output;
+    output.throughput = throughput;
+    calculateDLThroughputBatch(input, output);
+
+    DLThroughputConfig shadowed;
+    shadowed.shadowingLoss = 30.0;
+    EXPECT_DOUBLE_EQ(throughput[0], calculateDLThroughput(100.0, 40.0, 2, 100, 20e6));
+    EXPECT_DOUBLE_EQ(throughput[1], calculateDLThroughput(100.0, 40.0, 2, 100, 20e6, shadowed));
+    EXPECT_LT(throughput[1], throughput[0]);
+}
+
+TEST(LinkBudgetTests, BatchHonoursSelectedTables) {
+    const std::size_t count = 600;
+    std::vector<double> pathLoss(count), txPower(count, 43.0), bandwidth(count, 40e6), throughput(count);
+    std::vector<int> layers(count, 4), prbCount(count, 106);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 70.0 + 0.15 * i;
+    }
+
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+
+    const CQITableId cqiTables[] = {CQITableId::Table1, CQITableId::Table2, CQITableId::Table3};
+    const MCSTableId mcsTables[] = {MCSTableId::Table1, MCSTableId::Table2, MCSTableId::Table3};
+    for (int t = 0; t < 3; ++t) {
+        DLThroughputConfig config;
+        config.cqiTableId = cqiTables[t];
+        config.mcsTableId = mcsTables[t];
+        calculateDLThroughputBatch(input, output, config);
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_DOUBLE_EQ(calculateDLThroughput(pathLoss[i], txPower[i], layers[i], prbCount[i], bandwidth[i], config),
+                             throughput[i]) << "table " << t << " UE " << i;
+        }
+    }
+}
+
+TEST(LinkBudgetTests, FastConversionsTrackStrictSNR) {
+    const std::size_t count = 1000;
+    std::vector<double> pathLoss(count), txPower(count, 40.0), bandwidth(count, 20e6), throughput(count);
+    std::vector<double> strictSnr(count), fastSnr(count);
+    std::vector<int> layers(count, 2), prbCount(count, 100);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 60.0 + 0.13 * i;
+    }
+
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    output.snrLinear = strictSnr.data();
+    calculateDLThroughputBatch(input, output);
+
+    DLThroughputConfig fast;
+    fast.conversionAccuracy = ConversionAccuracy::Fast;
+    output.snrLinear = fastSnr.data();
+    calculateDLThroughputBatch(input, output, fast);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        EXPECT_NEAR(strictSnr[i], fastSnr[i], 1e-14 * strictSnr[i]);
+    }
+}
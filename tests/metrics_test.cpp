@@ -0,0 +1,136 @@
+#include "metrics.h"
+#include "linkbudget.h"
+#include "pathloss.h"
+#include "tbs.h"
+#include "utilities.h"
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <gtest/gtest.h>
+
+TEST(MetricsTests, DLThroughputBatchTimesEveryStage) {
+    if (!metricsCompiledIn) {
+        GTEST_SKIP() << "built without FIVEG_METRICS";
+    }
+    const std::size_t count = 5 * dlThroughputBatchBlockSize + 17;
+    std::vector<double> pathLoss(count, 100.0), txPower(count, 40.0), bandwidth(count, 100e6), throughput(count);
+    std::vector<int> layers(count, 2), prbs(count, 273);
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+
+    resetMetrics();
+    calculateDLThroughputBatch(input, output);
+    const MetricsSnapshot metrics = readMetrics();
+
+    EXPECT_GE(metrics.stage(MetricStage::DLThroughputBatch).calls, 1u);
+    EXPECT_EQ(count, metrics.stage(MetricStage::DLThroughputBatch).elements);
+    for (MetricStage stage : {MetricStage::DLSnr, MetricStage::DLMcs, MetricStage::DLTbs, MetricStage::DLThroughput,
+                              MetricStage::DLOutputColumns}) {
+        EXPECT_EQ(6u, metrics.stage(stage).calls) << metricStageName(stage);
+        EXPECT_EQ(count, metrics.stage(stage).elements) << metricStageName(stage);
+    }
+    EXPECT_GT(metrics.stage(MetricStage::DLSnr).ticks, 0u);
+    EXPECT_GT(metrics.stage(MetricStage::DLThroughputBatch).seconds, 0.0);
+    EXPECT_EQ(0u, metrics.stage(MetricStage::PathLossRuralBatch).calls);
+}
+
+TEST(MetricsTests, PathLossAndTBSBatchesCountElements) {
+    if (!metricsCompiledIn) {
+        GTEST_SKIP() << "built without FIVEG_METRICS";
+    }
+    const std::size_t count = 20000;
+    std::vector<double> distance(count, 1000.0), height(count, 1.5), pathLoss(count);
+    std::vector<int> nRE(count, 1000), mcs(count, 10), layers(count, 1), tbs(count);
+
+    resetMetrics();
+    const RuralPathLossSite site = makeRuralPathLossSite(35.0, 3300.0, 3800.0, 5.0, 20.0);
+    calculate5GPathLossRuralBatch(site, distance.data(), height.data(), true, pathLoss.data(), count);
+    calculate5GPathLossRuralBatch(site, distance.data(), 1.5, false, pathLoss.data(), count);
+    determineTBSBatch(nRE.data(), mcs.data(), layers.data(), tbs.data(), count, MCSTableId::Table1);
+    const MetricsSnapshot metrics = readMetrics();
+
+    EXPECT_EQ(2 * count, metrics.stage(MetricStage::PathLossRuralBatch).elements);
+    EXPECT_EQ(count, metrics.stage(MetricStage::TBSBatch).elements);
+    EXPECT_GE(metrics.stage(MetricStage::TBSBatch).calls, 1u);
+}
+
+TEST(MetricsTests, SentinelReturnsAreCountedOnEveryThread) {
+    if (!metricsCompiledIn) {
+        GTEST_SKIP() << "built without FIVEG_METRICS";
+    }
+    resetMetrics();
+    EXPECT_EQ(0.0, calculateWavelength(0.0));
+    EXPECT_GT(calculateWavelength(3.5e9), 0.0);
+    EXPECT_EQ(0.0, calculateShannonsCapacity(-1.0, 10.0));
+    double b, sf;
+    QamModulationSchemeDescriptor(6, b, sf);
+
+    // Counters of finished threads are kept, including those handed over to later threads
+    for (int round = 0; round < 2; ++round) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([]() {
+                for (int i = 0; i < 100; ++i) {
+                    calculateWavelength(-1.0);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    const MetricsSnapshot metrics = readMetrics();
+    EXPECT_EQ(801u, metrics.invalidInput(InvalidInput::Wavelength));
+    EXPECT_EQ(1u, metrics.invalidInput(InvalidInput::ShannonsCapacity));
+    EXPECT_EQ(1u, metrics.invalidInput(InvalidInput::QamModulationScheme));
+    EXPECT_EQ(0u, metrics.invalidInput(InvalidInput::CoherenceTime));
+
+    resetMetrics();
+    EXPECT_EQ(0u, readMetrics().invalidInput(InvalidInput::Wavelength));
+}
+
+TEST(MetricsTests, ExportFormats) {
+    MetricsSnapshot metrics;
+    metrics.stages[static_cast<std::size_t>(MetricStage::DLSnr)].calls = 3;
+    metrics.stages[static_cast<std::size_t>(MetricStage::DLSnr)].elements = 768;
+    metrics.stages[static_cast<std::size_t>(MetricStage::DLSnr)].ticks = 5000;
+    metrics.stages[static_cast<std::size_t>(MetricStage::DLSnr)].seconds = 2.5e-6;
+    metrics.invalidInputs[static_cast<std::size_t>(InvalidInput::Wavelength)] = 7;
+
+    std::ostringstream json;
+    writeMetricsJson(json, metrics);
+    EXPECT_EQ(0u, json.str().find("{\n  \"stages\": {\n"));
+    EXPECT_NE(std::string::npos,
+              json.str().find("\"dl_snr\": {\"calls\": 3, \"elements\": 768, \"ticks\": 5000, \"seconds\": 2.5e-06}"));
+    EXPECT_NE(std::string::npos, json.str().find("\"tbs_batch\": {\"calls\": 0,"));
+    EXPECT_NE(std::string::npos, json.str().find("\"calculateWavelength\": 7,\n"));
+    EXPECT_NE(std::string::npos, json.str().find("\"calculateSpectralEfficiencyPerLayer\": 0\n  }\n}\n"));
+
+    std::ostringstream prometheus;
+    writeMetricsPrometheus(prometheus, metrics);
+    const std::string text = prometheus.str();
+    EXPECT_EQ(0u, text.find("# HELP fiveg_stage_calls_total "));
+    EXPECT_NE(std::string::npos, text.find("\n# TYPE fiveg_stage_calls_total counter\n"));
+    EXPECT_NE(std::string::npos, text.find("\nfiveg_stage_calls_total{stage=\"dl_snr\"} 3\n"));
+    EXPECT_NE(std::string::npos, text.find("\nfiveg_stage_elements_total{stage=\"dl_snr\"} 768\n"));
+    EXPECT_NE(std::string::npos, text.find("\nfiveg_stage_seconds_total{stage=\"dl_snr\"} 2.5e-06\n"));
+    EXPECT_NE(std::string::npos, text.find("\nfiveg_invalid_inputs_total{function=\"calculateWavelength\"} 7\n"));
+    EXPECT_EQ(numMetricStages * 3 + numInvalidInputs + 8,
+              static_cast<std::size_t>(std::count(text.begin(), text.end(), '\n')));
+
+    // The stream keeps its own precision
+    std::ostringstream stream;
+    stream.precision(3);
+    writeMetrics(stream, MetricsFormat::Prometheus);
+    EXPECT_EQ(3, stream.precision());
+}
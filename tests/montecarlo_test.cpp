@@ -0,0 +1,140 @@
+#include "montecarlo.h"
+#include "tbs.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+struct Scenario {
+    std::vector<double> pathLoss = {95.0, 120.0, 142.0};
+    std::vector<double> txPower = {46.0, 43.0, 46.0};
+    std::vector<int> numOfLayers = {4, 2, 1};
+    std::vector<int> prbCount = {273, 106, 273};
+    std::vector<double> bandwidth = {100e6, 40e6, 100e6};
+
+    DLThroughputBatchInput input() const {
+        DLThroughputBatchInput in;
+        in.count = pathLoss.size();
+        in.pathLoss = pathLoss.data();
+        in.txPower = txPower.data();
+        in.numOfLayers = numOfLayers.data();
+        in.prbCount = prbCount.data();
+        in.bandwidth = bandwidth.data();
+        return in;
+    }
+};
+
+} // namespace
+
+TEST(MonteCarloTests, PhiloxKnownAnswers) {
+    // Known answer tests of the Random123 distribution
+    const std::uint32_t zeroCounter[4] = {0, 0, 0, 0};
+    const std::uint32_t zeroKey[2] = {0, 0};
+    PhiloxBlock block = philox4x32(zeroCounter, zeroKey);
+    EXPECT_EQ(0x6627e8d5u, block.v[0]);
+    EXPECT_EQ(0xe169c58du, block.v[1]);
+    EXPECT_EQ(0xbc57ac4cu, block.v[2]);
+    EXPECT_EQ(0x9b00dbd8u, block.v[3]);
+
+    const std::uint32_t piCounter[4] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+    const std::uint32_t piKey[2] = {0xa4093822, 0x299f31d0};
+    block = philox4x32(piCounter, piKey);
+    EXPECT_EQ(0xd16cfe09u, block.v[0]);
+    EXPECT_EQ(0x94fdccebu, block.v[1]);
+    EXPECT_EQ(0x5001e420u, block.v[2]);
+    EXPECT_EQ(0x24126ea1u, block.v[3]);
+}
+
+TEST(MonteCarloTests, LossDistributions) {
+    MonteCarloConfig config;
+    config.indoorProbability = 0.3;
+    const int n = 200000;
+    double sum = 0, sumSquares = 0;
+    int indoor = 0;
+    for (int s = 0; s < n; ++s) {
+        double shadowing, o2i;
+        drawMonteCarloLosses(config, s, shadowing, o2i);
+        sum += shadowing;
+        sumSquares += shadowing * shadowing;
+        indoor += (o2i != 0.0);
+    }
+    double mean = sum / n;
+    EXPECT_NEAR(0.0, mean, 0.06);
+    EXPECT_NEAR(config.shadowingStdDev, std::sqrt(sumSquares / n - mean * mean), 0.06);
+    EXPECT_NEAR(config.indoorProbability, static_cast<double>(indoor) / n, 0.005);
+}
+
+TEST(MonteCarloTests, MatchesPerSampleReference) {
+    Scenario scenario;
+    MonteCarloConfig config;
+    config.numTrials = 500;
+    config.indoorProbability = 0.5;
+    config.numBins = 50;
+    // Outage below the throughput the cell edge UE gets without fading
+    config.outageThroughput = calculateDLThroughput(scenario.pathLoss[2], scenario.txPower[2], scenario.numOfLayers[2],
+                                                    scenario.prbCount[2], scenario.bandwidth[2]);
+    MonteCarloResult result = runMonteCarloDLThroughput(scenario.input(), config);
+
+    std::vector<std::uint64_t> histogram(config.numBins, 0);
+    std::uint64_t outage = 0;
+    for (std::uint64_t s = 0; s < config.numTrials * 3; ++s) {
+        std::size_t ue = s % 3;
+        DLThroughputConfig linkBudget;
+        drawMonteCarloLosses(config, s, linkBudget.shadowingLoss, linkBudget.o2iLoss);
+        double throughput = calculateDLThroughput(scenario.pathLoss[ue], scenario.txPower[ue], scenario.numOfLayers[ue],
+                                                  scenario.prbCount[ue], scenario.bandwidth[ue], linkBudget);
+        std::size_t bin = std::min<std::size_t>(static_cast<std::size_t>(throughput / result.binWidth), config.numBins - 1);
+        ++histogram[bin];
+        outage += (throughput <= config.outageThroughput);
+    }
+
+    EXPECT_EQ(1500u, result.numSamples);
+    EXPECT_EQ(histogram, result.histogram);
+    EXPECT_EQ(outage, result.outageSamples);
+    EXPECT_GT(outage, 0u);
+    EXPECT_DOUBLE_EQ(1.0, result.cdf.back());
+    EXPECT_LE(monteCarloQuantile(result, 0.05), monteCarloQuantile(result, 0.5));
+    EXPECT_LE(monteCarloQuantile(result, 0.5), monteCarloQuantile(result, 0.95));
+}
+
+TEST(MonteCarloTests, ReproducibleForAnyThreadCount) {
+    Scenario scenario;
+    MonteCarloConfig config;
+    config.numTrials = 20000; // several chunks
+    config.indoorProbability = 0.2;
+    config.linkBudget.tbsLookupTable = &defaultTBSLookupTable();
+    config.numThreads = 1;
+    MonteCarloResult single = runMonteCarloDLThroughput(scenario.input(), config);
+    config.numThreads = 3;
+    MonteCarloResult multi = runMonteCarloDLThroughput(scenario.input(), config);
+
+    EXPECT_EQ(single.histogram, multi.histogram);
+    EXPECT_EQ(single.outageSamples, multi.outageSamples);
+    EXPECT_EQ(single.meanThroughput, multi.meanThroughput);
+    EXPECT_EQ(single.minThroughput, multi.minThroughput);
+    EXPECT_EQ(single.maxThroughput, multi.maxThroughput);
+    EXPECT_EQ(single.numSamples, multi.throughputSketch.count());
+    for (double p : {0.0, 0.05, 0.5, 0.95, 1.0}) {
+        EXPECT_EQ(single.throughputSketch.quantile(p), multi.throughputSketch.quantile(p)) << p;
+    }
+    EXPECT_EQ(single.minThroughput, single.throughputSketch.quantile(0.0));
+    EXPECT_EQ(single.maxThroughput, single.throughputSketch.quantile(1.0));
+
+    config.seed = 2;
+    MonteCarloResult otherSeed = runMonteCarloDLThroughput(scenario.input(), config);
+    EXPECT_NE(single.histogram, otherSeed.histogram);
+}
+
+TEST(MonteCarloTests, NoFadingGivesPointEstimate) {
+    Scenario scenario;
+    MonteCarloConfig config;
+    config.numTrials = 10;
+    config.shadowingStdDev = 0.0;
+    DLThroughputBatchInput input = scenario.input();
+    input.count = 1;
+    MonteCarloResult result = runMonteCarloDLThroughput(input, config);
+    double expected = calculateDLThroughput(scenario.pathLoss[0], scenario.txPower[0], scenario.numOfLayers[0],
+                                            scenario.prbCount[0], scenario.bandwidth[0]);
+    EXPECT_DOUBLE_EQ(expected, result.minThroughput);
+    EXPECT_DOUBLE_EQ(expected, result.maxThroughput);
+    EXPECT_NEAR(expected, result.meanThroughput, 1e-9 * expected);
+}
@@ -0,0 +1,114 @@
+#include "numerology.h"
+#include "commands.h"
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Checks the templates of one numerology against the runtime functions
+struct ExpectMatchesRuntime {
+    template <int Mu>
+    int operator()(NumerologyConstant<Mu> numerology) const {
+        EXPECT_EQ(calculateSlotSize(Mu), calculateSlotSize<Mu>()) << "numerology " << Mu;
+        EXPECT_EQ(calculateSlotSize(Mu), calculateSlotSize(numerology)) << "numerology " << Mu;
+        EXPECT_EQ(calculateSCS(Mu), calculateSCS<Mu>()) << "numerology " << Mu;
+        EXPECT_EQ(calculateNumberOfSlots(calculateSlotSize(Mu)), calculateNumberOfSlots<Mu>()) << "numerology " << Mu;
+        for (bool extendedCP : {false, true}) {
+            EXPECT_EQ(calculateOFDMSymbolDuration(calculateSCS(Mu), extendedCP),
+                      calculateOFDMSymbolDuration<Mu>(extendedCP)) << "numerology " << Mu;
+        }
+        return Mu;
+    }
+};
+
+} // namespace
+
+TEST(NumerologyTests, TemplatesMatchRuntimeFunctions) {
+    for (int mu = 0; mu <= maxNumerology; ++mu) {
+        EXPECT_EQ(mu, dispatchNumerology(mu, ExpectMatchesRuntime()));
+    }
+    EXPECT_THROW(dispatchNumerology(5, ExpectMatchesRuntime()), std::invalid_argument);
+    EXPECT_THROW(dispatchNumerology(-1, ExpectMatchesRuntime()), std::invalid_argument);
+
+    // Usable as compile-time constants
+    static_assert(calculateNumberOfSlots<3>() == 8, "8 slots per subframe at 120 kHz");
+    static_assert(calculateSCS<4>() == 240.0, "240 kHz at numerology 4");
+    static_assert(calculateNumberOfSymbolsPerSlot<2>(true) == 12, "extended CP at 60 kHz");
+    static_assert(calculateNumberOfSymbolsPerSlot<1>(true) == 14, "no extended CP at 30 kHz");
+}
+
+TEST(NumerologyTests, GroupsKeepBatchOrder) {
+    const std::vector<int> numerology = {3, 0, 7, 3, 1, -2, 4, 0, 3, 2};
+    NumerologyGroups groups;
+    groupByNumerology(numerology.data(), numerology.size(), groups);
+    EXPECT_EQ(numerology.size(), groups.indices.size());
+    EXPECT_EQ(2u, groups.size(0));
+    EXPECT_EQ(1u, groups.size(1));
+    EXPECT_EQ(1u, groups.size(2));
+    ASSERT_EQ(3u, groups.size(3));
+    EXPECT_EQ(0u, groups.group(3)[0]);
+    EXPECT_EQ(3u, groups.group(3)[1]);
+    EXPECT_EQ(8u, groups.group(3)[2]);
+    EXPECT_EQ(1u, groups.size(4));
+    ASSERT_EQ(2u, groups.size(NumerologyGroups::numGroups - 1));
+    EXPECT_EQ(2u, groups.group(NumerologyGroups::numGroups - 1)[0]);
+    EXPECT_EQ(5u, groups.group(NumerologyGroups::numGroups - 1)[1]);
+
+    groupByNumerology(numerology.data(), 0, groups);
+    EXPECT_EQ(0u, groups.size(3));
+}
+
+TEST(NumerologyTests, FrameStructureBatchMatchesRuntimeFunctions) {
+    std::vector<int> numerology;
+    for (int i = 0; i < 1000; ++i) {
+        numerology.push_back((i * 3) % 7 - 1); // -1 to 5, mixed
+    }
+    const std::size_t count = numerology.size();
+    std::vector<double> symbolDuration(count, -1), slotSize(count, -1), scs(count, -1), rbBandwidth(count, -1);
+    std::vector<int> slots(count, -1);
+    FrameStructureBatchOutput output;
+    output.ofdmSymbolDuration = symbolDuration.data();
+    output.slotSize = slotSize.data();
+    output.slotsPerSubframe = slots.data();
+    output.scs = scs.data();
+    output.rbBandwidth = rbBandwidth.data();
+    std::size_t invalid = 0;
+    for (int mu : numerology) {
+        invalid += mu < 0 || mu > maxNumerology;
+    }
+    EXPECT_EQ(invalid, calculateFrameStructureBatch(numerology.data(), output, count));
+    for (std::size_t i = 0; i < count; ++i) {
+        const int mu = numerology[i];
+        if (mu < 0 || mu > maxNumerology) {
+            EXPECT_EQ(0.0, symbolDuration[i]);
+            EXPECT_EQ(0, slots[i]);
+            continue;
+        }
+        ASSERT_EQ(calculateOFDMSymbolDuration(calculateSCS(mu), false), symbolDuration[i]) << i;
+        ASSERT_EQ(calculateSlotSize(mu), slotSize[i]) << i;
+        ASSERT_EQ(calculateNumberOfSlots(calculateSlotSize(mu)), slots[i]) << i;
+        ASSERT_EQ(calculateSCS(mu), scs[i]) << i;
+        ASSERT_EQ(numOfSCsPerRB * calculateSCS(mu), rbBandwidth[i]) << i;
+    }
+}
+
+TEST(NumerologyTests, MixedNumerologyCommandsMatchPerRecord) {
+    const double records[][maxCommandFields] = {{15, 0}, {60, 1}, {240, 0}, {45, 0}, {30, 1}, {60, 0}, {120, 1},
+                                                {2, 0}, {4.5, 0}, {-1, 0}, {0, 0}, {15, 1}};
+    const std::size_t numRecords = sizeof(records) / sizeof(records[0]);
+    for (const char* name : {"ofdm-symbol-duration", "frame-structure"}) {
+        const Command* command = findCommand(name);
+        ASSERT_NE(nullptr, command);
+        ASSERT_NE(nullptr, command->evaluateBatch) << name;
+        double outputs[numRecords][maxCommandFields];
+        bool valid[numRecords];
+        command->evaluateBatch(&records[0][0], &outputs[0][0], valid, numRecords);
+        for (std::size_t r = 0; r < numRecords; ++r) {
+            double expected[maxCommandFields];
+            ASSERT_EQ(command->evaluate(records[r], expected), valid[r]) << name << " record " << r;
+            for (int i = 0; valid[r] && i < command->numOutputs; ++i) {
+                EXPECT_EQ(expected[i], outputs[r][i]) << name << " record " << r;
+            }
+        }
+    }
+}
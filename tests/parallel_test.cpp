@@ -0,0 +1,251 @@
+#include "parallel.h"
+#include "batchstatus.h"
+#include "conversions.h"
+#include "linkbudget.h"
+#include "pathloss.h"
+#include "tbs.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Restores the default thread count when a test ends
+struct ThreadCountGuard {
+    ~ThreadCountGuard() { setParallelThreadCount(0); }
+};
+
+std::vector<double> uniform(std::size_t count, double low, double high, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> distribution(low, high);
+    std::vector<double> values(count);
+    for (double& value : values) {
+        value = distribution(rng);
+    }
+    return values;
+}
+
+} // namespace
+
+TEST(ParallelTests, EveryIterationRunsOnce) {
+    for (unsigned int threads : {1u, 2u, 5u, 16u}) {
+        for (std::size_t grain : {1u, 7u, 1000u}) {
+            const std::size_t count = 10007;
+            std::vector<std::atomic<int>> visits(count);
+            std::atomic<bool> aligned(true);
+            parallelFor(count, grain, [&](std::size_t begin, std::size_t end) {
+                aligned = aligned && begin % grain == 0 && end == std::min(count, begin + grain);
+                for (std::size_t i = begin; i < end; ++i) {
+                    ++visits[i];
+                }
+            }, threads);
+            EXPECT_TRUE(aligned) << threads << " threads, grain " << grain;
+            for (std::size_t i = 0; i < count; ++i) {
+                ASSERT_EQ(1, visits[i].load()) << "iteration " << i << ", " << threads << " threads, grain " << grain;
+            }
+        }
+    }
+}
+
+TEST(ParallelTests, UnevenChunksAreStolen) {
+    // The first chunks are far more expensive; the threads holding the cheap ones steal them
+    std::vector<std::thread::id> owner(64);
+    parallelFor(64, 1, [&](std::size_t begin, std::size_t) {
+        owner[begin] = std::this_thread::get_id();
+        if (begin < 8) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }, 4);
+    std::vector<std::thread::id> distinct;
+    for (std::size_t i = 0; i < 8; ++i) {
+        if (std::find(distinct.begin(), distinct.end(), owner[i]) == distinct.end()) {
+            distinct.push_back(owner[i]);
+        }
+    }
+    EXPECT_GT(distinct.size(), 1u);
+}
+
+TEST(ParallelTests, NestedLoopsAndExceptions) {
+    std::atomic<int> total(0);
+    parallelFor(8, 1, [&](std::size_t, std::size_t) {
+        parallelFor(100, 10, [&](std::size_t begin, std::size_t end) {
+            total += static_cast<int>(end - begin);
+        });
+    }, 4);
+    EXPECT_EQ(800, total.load());
+
+    EXPECT_THROW(parallelFor(1000, 1, [](std::size_t begin, std::size_t) {
+        if (begin == 500) {
+            throw std::runtime_error("chunk 500");
+        }
+    }, 4), std::runtime_error);
+    // The pool is usable after a failure
+    total = 0;
+    parallelFor(1000, 1, [&](std::size_t, std::size_t) { ++total; }, 4);
+    EXPECT_EQ(1000, total.load());
+}
+
+TEST(ParallelTests, ReductionIsIdenticalForAnyThreadCount) {
+    const std::vector<double> values = uniform(100000, -1e6, 1e6, 3);
+    auto sum = [&](unsigned int threads) {
+        return parallelReduce(values.size(), parallelGrain(values.size(), 64), 0.0,
+                              [&](std::size_t begin, std::size_t end) {
+                                  double partial = 0.0;
+                                  for (std::size_t i = begin; i < end; ++i) {
+                                      partial += values[i];
+                                  }
+                                  return partial;
+                              },
+                              [](double a, double b) { return a + b; }, threads);
+    };
+    const double serial = sum(1);
+    for (unsigned int threads : {2u, 3u, 8u, 32u}) {
+        EXPECT_EQ(serial, sum(threads)) << threads << " threads";
+    }
+    EXPECT_EQ(0.0, parallelReduce(0, 16, 0.0, [](std::size_t, std::size_t) { return 1.0; },
+                                  [](double a, double b) { return a + b; }));
+}
+
+TEST(ParallelTests, GrainDependsOnTheCountOnly) {
+    EXPECT_EQ(8192u, parallelGrain(100, 8192));
+    EXPECT_EQ(8192u, parallelGrain(256 * 8192, 8192));
+    EXPECT_EQ(2 * 8192u, parallelGrain(256 * 8192 + 1, 8192));
+    EXPECT_EQ(1u, parallelGrain(0, 0));
+}
+
+TEST(ParallelTests, BatchFunctionsAreIdenticalForAnyThreadCount) {
+    ThreadCountGuard guard;
+    const std::size_t count = 300001;
+    const std::vector<double> distance = uniform(count, 10, 10000, 1);
+    const std::vector<double> ueHeight = uniform(count, 1, 10, 2);
+    const std::vector<double> snr = uniform(count, -1, 1000, 3);
+    const std::vector<double> bandwidth = uniform(count, 1e6, 400e6, 4);
+    const RuralPathLossSite site = makeRuralPathLossSite(35, 3300, 3400, 5, 20);
+
+    std::vector<double> txPower(count, 43.0), rxBandwidth(count, 100e6);
+    std::vector<int> layers(count), prbs(count, 273), nRE(count), mcs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        layers[i] = 1 << (i % 4);
+        nRE[i] = static_cast<int>(i % 5000);
+        mcs[i] = static_cast<int>(i % 28);
+    }
+
+    struct Results {
+        std::vector<double> pathLoss, commonHeight, throughput, capacity;
+        std::vector<int> tbs;
+    };
+    auto run = [&](unsigned int threads) {
+        setParallelThreadCount(threads);
+        Results results;
+        results.pathLoss.resize(count);
+        results.commonHeight.resize(count);
+        results.throughput.resize(count);
+        results.capacity.resize(count);
+        results.tbs.resize(count);
+        calculate5GPathLossRuralBatch(site, distance.data(), ueHeight.data(), false, results.pathLoss.data(), count);
+        calculate5GPathLossRuralBatch(site, distance.data(), 1.5, true, results.commonHeight.data(), count);
+
+        DLThroughputBatchInput input;
+        input.count = count;
+        input.pathLoss = results.pathLoss.data();
+        input.txPower = txPower.data();
+        input.numOfLayers = layers.data();
+        input.prbCount = prbs.data();
+        input.bandwidth = rxBandwidth.data();
+        DLThroughputBatchOutput output;
+        output.throughput = results.throughput.data();
+        DLThroughputConfig config;
+        config.conversionAccuracy = ConversionAccuracy::Fast;
+        calculateDLThroughputBatch(input, output, config);
+
+        calculateShannonsCapacityBatch(bandwidth.data(), snr.data(), results.capacity.data(), count);
+        determineTBSBatch(nRE.data(), mcs.data(), layers.data(), results.tbs.data(), count);
+        return results;
+    };
+
+    const Results serial = run(1);
+    const Results parallel = run(7);
+    EXPECT_EQ(serial.pathLoss, parallel.pathLoss);
+    EXPECT_EQ(serial.commonHeight, parallel.commonHeight);
+    EXPECT_EQ(serial.throughput, parallel.throughput);
+    EXPECT_EQ(serial.capacity, parallel.capacity);
+    EXPECT_EQ(serial.tbs, parallel.tbs);
+}
+
+TEST(ParallelTests, CheckedDLThroughputIsIdenticalForAnyThreadCount) {
+    ThreadCountGuard guard;
+    const std::size_t count = 100003;
+    const std::vector<double> pathLoss = uniform(count, 60, 160, 5);
+    std::vector<double> txPower(count, 43.0), bandwidth(count, 100e6);
+    std::vector<int> layers(count), prbs(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        layers[i] = 1 << (i % 4);
+        prbs[i] = i % 997 == 0 ? -1 : 273; // invalid rows in every mask word range
+    }
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+
+    struct Results {
+        std::vector<double> throughput;
+        std::vector<std::uint64_t> mask;
+        std::vector<BatchError> errors;
+        std::size_t invalid;
+    };
+    auto run = [&](unsigned int threads) {
+        setParallelThreadCount(threads);
+        Results results;
+        results.throughput.resize(count);
+        results.mask.resize(batchMaskWords(count));
+        results.errors.resize(count);
+        DLThroughputBatchOutput output;
+        output.throughput = results.throughput.data();
+        BatchStatus status;
+        status.validMask = results.mask.data();
+        status.errors = results.errors.data();
+        results.invalid = calculateDLThroughputBatchChecked(input, output, status);
+        return results;
+    };
+
+    const Results serial = run(1);
+    const Results parallel = run(7);
+    EXPECT_EQ((count + 996) / 997, serial.invalid);
+    EXPECT_EQ(serial.invalid, parallel.invalid);
+    EXPECT_EQ(serial.throughput, parallel.throughput);
+    EXPECT_EQ(serial.mask, parallel.mask);
+    EXPECT_EQ(serial.errors, parallel.errors);
+}
+
+TEST(ParallelTests, ShannonAndTBSBatchesMatchTheScalarFunctions) {
+    const double bandwidth[] = {20e6, 100e6, 0, -1, 5e6, 40e6, 1e6, 80e6, 60e6};
+    const double snr[] = {10, 0.5, 10, 10, -0.1, 0, 1e6, 3.3, 123.4};
+    double capacity[9];
+    calculateShannonsCapacityBatch(bandwidth, snr, capacity, 9, ConversionAccuracy::Strict);
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_EQ(calculateShannonsCapacity(bandwidth[i], snr[i]), capacity[i]) << "value " << i;
+    }
+    calculateShannonsCapacityBatch(bandwidth, snr, capacity, 9, ConversionAccuracy::Fast);
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_NEAR(calculateShannonsCapacity(bandwidth[i], snr[i]), capacity[i], 1e-12 * capacity[i]) << "value " << i;
+    }
+
+    const TBSLookupTable table(2000, 2);
+    const int nRE[] = {0, 1, 100, 1999, 2000, 2001, 40000, -5, 500};
+    const int mcsIdx[] = {5, 0, 27, 10, 3, 3, 20, 1, 28};
+    const int numLayers[] = {1, 2, 2, 1, 2, 2, 4, 1, 1};
+    int tbs[9], fromTable[9];
+    determineTBSBatch(nRE, mcsIdx, numLayers, tbs, 9);
+    determineTBSBatch(nRE, mcsIdx, numLayers, fromTable, 9, MCSTableId::Table2, &table);
+    for (int i = 0; i < 9; ++i) {
+        EXPECT_EQ(determineTBS(nRE[i], mcsIdx[i], numLayers[i]), tbs[i]) << "allocation " << i;
+        EXPECT_EQ(tbs[i], fromTable[i]) << "allocation " << i;
+    }
+}
@@ -0,0 +1,76 @@
+#include "pathloss.h"
+#include "simd.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+const double gNBAntennaHeight = 35.0;
+const double fLow = 3300.0;
+const double fHigh = 3400.0;
+const double buildingHeight = 5.0;
+const double streetWidth = 20.0;
+
+// Distances covering the too-close, PL1, PL2, NLOS cut-off and out of range regions
+std::vector<double> testDistances() {
+    std::vector<double> distances;
+    for (double d = 1.0; d < 12000.0; d *= 1.013) {
+        distances.push_back(d);
+    }
+    distances.push_back(10.0);
+    distances.push_back(5000.0);
+    distances.push_back(10000.0);
+    return distances;
+}
+
+void expectBatchMatchesReference(SimdLevel level) {
+    SimdLevel previous = activeSimdLevel();
+    setSimdLevel(level);
+
+    RuralPathLossSite site = makeRuralPathLossSite(gNBAntennaHeight, fLow, fHigh, buildingHeight, streetWidth);
+    std::vector<double> distances = testDistances();
+    std::vector<double> heights(distances.size());
+    for (std::size_t i = 0; i < heights.size(); ++i) {
+        heights[i] = 1.0 + (i % 20) * 0.5;
+    }
+    std::vector<double> pathLoss(distances.size());
+
+    for (int los = 0; los < 2; ++los) {
+        calculate5GPathLossRuralBatch(site, distances.data(), heights.data(), los == 1, pathLoss.data(), distances.size());
+        for (std::size_t i = 0; i < distances.size(); ++i) {
+            double expected = calculate5GPathLossRural(gNBAntennaHeight, heights[i], fLow, fHigh, distances[i],
+                                                       buildingHeight, streetWidth, los == 1);
+            ASSERT_NEAR(expected, pathLoss[i], 1e-9) << "distance " << distances[i] << " height " << heights[i];
+        }
+
+        calculate5GPathLossRuralBatch(site, distances.data(), 1.5, los == 1, pathLoss.data(), distances.size());
+        for (std::size_t i = 0; i < distances.size(); ++i) {
+            double expected = calculate5GPathLossRural(gNBAntennaHeight, 1.5, fLow, fHigh, distances[i],
+                                                       buildingHeight, streetWidth, los == 1);
+            ASSERT_NEAR(expected, pathLoss[i], 1e-9) << "distance " << distances[i];
+        }
+    }
+
+    setSimdLevel(previous);
+}
+
+} // namespace
+
+TEST(PathLossTests, PrecomputedSiteMatchesReference) {
+    RuralPathLossSite site = makeRuralPathLossSite(gNBAntennaHeight, fLow, fHigh, buildingHeight, streetWidth);
+    for (double d : testDistances()) {
+        EXPECT_NEAR(calculate5GPathLossRural(gNBAntennaHeight, 1.5, fLow, fHigh, d, buildingHeight, streetWidth, false),
+                    calculate5GPathLossRural(site, 1.5, d, false), 1e-9);
+    }
+}
+
+TEST(PathLossTests, ScalarBatchMatchesReference) {
+    expectBatchMatchesReference(SimdLevel::Scalar);
+}
+
+TEST(PathLossTests, AVX2BatchMatchesReference) {
+    expectBatchMatchesReference(SimdLevel::AVX2);
+}
+
+TEST(PathLossTests, AVX512BatchMatchesReference) {
+    expectBatchMatchesReference(SimdLevel::AVX512);
+}
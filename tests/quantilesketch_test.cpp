@@ -0,0 +1,143 @@
+#include "quantilesketch.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Nearest rank quantile of sorted samples, as defined by QuantileSketch::quantile()
+double nearestRank(const std::vector<double>& sorted, double probability) {
+    std::size_t rank = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(probability * sorted.size())));
+    return sorted[std::min(rank, sorted.size()) - 1];
+}
+
+// Log-normal throughputs in kbps with a share of zero (outage) samples
+std::vector<double> throughputSamples(std::size_t count, unsigned int seed) {
+    std::mt19937_64 generator(seed);
+    std::lognormal_distribution<double> throughput(std::log(50000.0), 1.5);
+    std::uniform_real_distribution<double> outage(0.0, 1.0);
+    std::vector<double> samples(count);
+    for (double& sample : samples) {
+        sample = outage(generator) < 0.03 ? 0.0 : throughput(generator);
+    }
+    return samples;
+}
+
+} // namespace
+
+TEST(QuantileSketchTests, QuantilesWithinRelativeError) {
+    std::vector<double> samples = throughputSamples(200000, 1);
+    for (int precisionBits : {4, 7, 10}) {
+        QuantileSketch sketch(1e-3, 1e9, precisionBits);
+        sketch.add(samples.data(), samples.size());
+        std::vector<double> sorted = samples;
+        std::sort(sorted.begin(), sorted.end());
+        ASSERT_EQ(samples.size(), sketch.count());
+        EXPECT_EQ(sorted.front(), sketch.quantile(0.0));
+        EXPECT_EQ(sorted.back(), sketch.quantile(1.0));
+        for (double p = 0.001; p < 1.0; p += 0.0137) {
+            const double exact = nearestRank(sorted, p);
+            EXPECT_NEAR(exact, sketch.quantile(p), sketch.relativeError() * exact)
+                << "p " << p << ", precision " << precisionBits;
+        }
+    }
+}
+
+TEST(QuantileSketchTests, MemoryIndependentOfSampleCount) {
+    QuantileSketch sketch;
+    const std::size_t buckets = sketch.numBuckets();
+    EXPECT_LT(buckets * sizeof(std::uint64_t), 48u * 1024);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<double> samples = throughputSamples(100000, round);
+        sketch.add(samples.data(), samples.size());
+    }
+    EXPECT_EQ(2000000u, sketch.count());
+    EXPECT_EQ(buckets, sketch.numBuckets());
+}
+
+TEST(QuantileSketchTests, MergeEqualsSingleSketch) {
+    std::vector<double> samples = throughputSamples(100000, 2);
+    QuantileSketch whole, first, second;
+    whole.add(samples.data(), samples.size());
+    first.add(samples.data(), 30000);
+    second.add(samples.data() + 30000, samples.size() - 30000);
+    second.merge(first);
+    EXPECT_EQ(whole.count(), second.count());
+    EXPECT_EQ(whole.min(), second.min());
+    EXPECT_EQ(whole.max(), second.max());
+    for (double p = 0.0; p <= 1.0; p += 0.01) {
+        ASSERT_EQ(whole.quantile(p), second.quantile(p)) << p;
+    }
+    EXPECT_EQ(whole.cdf(50000.0), second.cdf(50000.0));
+
+    QuantileSketch coarse(1e-3, 1e9, 5);
+    EXPECT_THROW(whole.merge(coarse), std::invalid_argument);
+    EXPECT_THROW(QuantileSketch(0.0, 1.0), std::invalid_argument);
+    EXPECT_THROW(QuantileSketch(1.0, 0.5), std::invalid_argument);
+    EXPECT_THROW(QuantileSketch(1.0, 2.0, 17), std::invalid_argument);
+}
+
+TEST(QuantileSketchTests, OutOfRangeAndSpecialValues) {
+    QuantileSketch sketch(1.0, 1000.0);
+    EXPECT_EQ(0.0, sketch.quantile(0.5));
+    EXPECT_EQ(0.0, sketch.cdf(10.0));
+    sketch.add(std::numeric_limits<double>::quiet_NaN());
+    EXPECT_EQ(0u, sketch.count());
+
+    // Underflow and overflow buckets report the exact extremes
+    for (int i = 0; i < 10; ++i) {
+        sketch.add(0.0);
+    }
+    sketch.add(100.0);
+    sketch.add(5000.0);
+    EXPECT_EQ(12u, sketch.count());
+    EXPECT_EQ(0.0, sketch.quantile(0.5));
+    EXPECT_NEAR(100.0, sketch.quantile(11.0 / 12), 100.0 * sketch.relativeError());
+    EXPECT_EQ(5000.0, sketch.quantile(1.0));
+    EXPECT_DOUBLE_EQ(10.0 / 12, sketch.cdf(0.5));
+    EXPECT_DOUBLE_EQ(11.0 / 12, sketch.cdf(100.0));
+    EXPECT_DOUBLE_EQ(1.0, sketch.cdf(1e6));
+
+    sketch.clear();
+    EXPECT_EQ(0u, sketch.count());
+    EXPECT_EQ(0.0, sketch.max());
+}
+
+TEST(QuantileSketchTests, DLThroughputBatchMatchesStoredResults) {
+    const std::size_t count = 50000;
+    std::vector<double> pathLoss(count), txPower(count, 40.0), bandwidth(count, 100e6);
+    std::vector<int> layers(count), prbs(count, 273);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 60.0 + 0.001 * i;
+        layers[i] = 1 + i % 4;
+    }
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+    std::vector<double> throughput(count);
+    DLThroughputBatchOutput output;
+    output.throughput = throughput.data();
+    calculateDLThroughputBatch(input, output);
+
+    QuantileSketch expected;
+    expected.add(throughput.data(), count);
+    const unsigned int previous = parallelThreadCount();
+    for (unsigned int numThreads : {1u, 3u}) {
+        setParallelThreadCount(numThreads);
+        QuantileSketch sketch;
+        sketchDLThroughputBatch(input, sketch);
+        ASSERT_EQ(count, sketch.count());
+        for (double p : {0.0, 0.05, 0.5, 0.95, 1.0}) {
+            EXPECT_EQ(expected.quantile(p), sketch.quantile(p)) << p << ", " << numThreads << " threads";
+        }
+    }
+    setParallelThreadCount(previous);
+}
@@ -0,0 +1,226 @@
+#include "resultcache.h"
+#include "tbs.h"
+#include <cstdio>
+#include <limits>
+#include <gtest/gtest.h>
+
+namespace {
+
+DLThroughputCacheKey makeKey(double pathLoss, int numerology = 3) {
+    return {pathLoss, 40.0, 2, 273, 100e6, numerology};
+}
+
+double reference(const DLThroughputCacheKey& key, DLThroughputConfig config = DLThroughputConfig()) {
+    config.numerology = key.numerology;
+    return calculateDLThroughput(key.pathLoss, key.txPower, key.numOfLayers, key.prbCount, key.bandwidth, config);
+}
+
+std::string cachePath(const char* name) {
+    std::string path = ::testing::TempDir() + name;
+    std::remove(path.c_str());
+    return path;
+}
+
+} // namespace
+
+TEST(ResultCacheTests, HitsReturnTheCalculatedThroughput) {
+    DLThroughputCache cache(1024);
+    EXPECT_EQ(cache.capacity(), 1024u);
+    EXPECT_FALSE(cache.isPersistent());
+    for (int pass = 0; pass < 3; ++pass) {
+        for (int pl = 80; pl < 140; ++pl) {
+            DLThroughputCacheKey key = makeKey(pl, pl % 4);
+            EXPECT_EQ(cache.throughput(key), reference(key)) << "path loss " << pl;
+        }
+    }
+    EXPECT_EQ(cache.stats().misses, 60u);
+    EXPECT_EQ(cache.stats().hits, 120u);
+    EXPECT_EQ(cache.size(), 60u);
+
+    // Every field is part of the key; -0.0 and 0.0 are the same key
+    double value;
+    EXPECT_FALSE(cache.find(makeKey(100.0, 1), value));
+    DLThroughputCacheKey key = makeKey(100.0, 0);
+    key.txPower = 41.0;
+    EXPECT_FALSE(cache.find(key, value));
+    key = {0.0, 40.0, 1, 100, 20e6, 3};
+    cache.throughput(key);
+    key.pathLoss = -0.0;
+    EXPECT_TRUE(cache.find(key, value));
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_FALSE(cache.find(makeKey(100.0, 0), value));
+}
+
+TEST(ResultCacheTests, FullWindowsEvictInsteadOfGrowing) {
+    DLThroughputCache cache(64);
+    for (int i = 0; i < 1000; ++i) {
+        DLThroughputCacheKey key = makeKey(60.0 + 0.1 * i);
+        EXPECT_EQ(cache.throughput(key), reference(key));
+    }
+    EXPECT_LE(cache.size(), 64u);
+    EXPECT_GT(cache.stats().evictions, 0u);
+    EXPECT_EQ(cache.stats().misses, 1000u);
+    // The last key inserted is always kept
+    double value;
+    EXPECT_TRUE(cache.find(makeKey(60.0 + 0.1 * 999), value));
+}
+
+TEST(ResultCacheTests, NaNInputsAreNeverCached) {
+    DLThroughputCache cache(64);
+    DLThroughputCacheKey key = makeKey(std::numeric_limits<double>::quiet_NaN());
+    cache.throughput(key);
+    cache.throughput(key);
+    EXPECT_EQ(cache.stats().misses, 2u);
+    EXPECT_EQ(cache.size(), 0u);
+}
+
+TEST(ResultCacheTests, BatchMatchesScalar) {
+    DLThroughputConfig config;
+    config.prbPerUE = 4;
+    DLThroughputCache cache(4096, config);
+    const std::size_t count = 1000;
+    std::vector<double> pathLoss(count), txPower(count, 43.0), bandwidth(count, 50e6), throughput(count);
+    std::vector<int> layers(count), prbs(count, 133);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 70.0 + (i % 250) * 0.25; // each tuple four times
+        layers[i] = 1 + static_cast<int>(i % 2);
+    }
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+
+    for (int pass = 0; pass < 2; ++pass) {
+        cache.throughputBatch(input, 1, throughput.data());
+        for (std::size_t i = 0; i < count; ++i) {
+            DLThroughputCacheKey key = {pathLoss[i], txPower[i], layers[i], prbs[i], bandwidth[i], 1};
+            ASSERT_EQ(throughput[i], reference(key, config)) << "UE " << i << " pass " << pass;
+        }
+    }
+    // Repeats within a batch are evaluated once
+    EXPECT_EQ(cache.size(), 250u);
+    EXPECT_EQ(cache.stats().misses, 250u);
+    EXPECT_EQ(cache.stats().hits, 2 * count - 250u);
+}
+
+TEST(ResultCacheTests, BatchWithPerUELossesIsNotCached) {
+    DLThroughputCache cache(4096);
+    const std::size_t count = 100;
+    std::vector<double> pathLoss(count, 90.0), txPower(count, 40.0), bandwidth(count, 100e6), throughput(count);
+    std::vector<double> shadowing(count), expected(count);
+    std::vector<int> layers(count, 2), prbs(count, 273);
+    for (std::size_t i = 0; i < count; ++i) {
+        shadowing[i] = 0.2 * i;
+    }
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbs.data();
+    input.bandwidth = bandwidth.data();
+    input.shadowingLoss = shadowing.data();
+
+    DLThroughputConfig config;
+    config.numerology = 1;
+    DLThroughputBatchOutput output;
+    output.throughput = expected.data();
+    calculateDLThroughputBatch(input, output, config);
+
+    for (int pass = 0; pass < 2; ++pass) {
+        cache.throughputBatch(input, 1, throughput.data());
+        EXPECT_EQ(expected, throughput);
+    }
+    EXPECT_NE(expected.front(), expected.back());
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT_EQ(cache.stats().misses, 2 * count);
+    EXPECT_EQ(cache.stats().hits, 0u);
+}
+
+TEST(ResultCacheTests, ScalarAndBatchLookupsShareOneEngine) {
+    // Fast conversions, the TBS table and allocations without REs are where the scalar
+    // chain could part from the batch engine
+    for (int prbPerUE : {4, 0}) {
+        DLThroughputConfig config;
+        config.conversionAccuracy = ConversionAccuracy::Fast;
+        config.tbsLookupTable = &defaultTBSLookupTable();
+        config.prbPerUE = prbPerUE;
+        const std::size_t count = 200;
+        std::vector<double> pathLoss(count), txPower(count, 43.0), bandwidth(count, 50e6), expected(count);
+        std::vector<double> fromBatch(count);
+        std::vector<int> layers(count, 2), prbs(count, 133);
+        for (std::size_t i = 0; i < count; ++i) {
+            pathLoss[i] = 70.0 + 0.37 * i;
+        }
+        DLThroughputBatchInput input;
+        input.count = count;
+        input.pathLoss = pathLoss.data();
+        input.txPower = txPower.data();
+        input.numOfLayers = layers.data();
+        input.prbCount = prbs.data();
+        input.bandwidth = bandwidth.data();
+        config.numerology = 1;
+        DLThroughputBatchOutput output;
+        output.throughput = expected.data();
+        calculateDLThroughputBatch(input, output, config);
+
+        // Whichever method stores a tuple, the other one gets the same value back
+        DLThroughputCache cache(4096, config);
+        for (std::size_t i = 0; i < count; i += 2) {
+            EXPECT_EQ(expected[i], cache.throughput({pathLoss[i], 43.0, 2, 133, 50e6, 1})) << "UE " << i;
+        }
+        cache.throughputBatch(input, 1, fromBatch.data());
+        EXPECT_EQ(expected, fromBatch) << "prbPerUE " << prbPerUE;
+        for (std::size_t i = 1; i < count; i += 2) {
+            EXPECT_EQ(expected[i], cache.throughput({pathLoss[i], 43.0, 2, 133, 50e6, 1})) << "UE " << i;
+        }
+        EXPECT_EQ(cache.stats().misses, count);
+    }
+}
+
+TEST(ResultCacheTests, FileBackedCacheSurvivesReopening) {
+    const std::string path = cachePath("resultcache_test.bin");
+    {
+        DLThroughputCache cache(path, 256);
+        ASSERT_TRUE(cache.isPersistent());
+        for (int pl = 90; pl < 100; ++pl) {
+            cache.throughput(makeKey(pl));
+        }
+        EXPECT_TRUE(cache.sync());
+    }
+    {
+        DLThroughputCache cache(path, 256);
+        EXPECT_EQ(cache.size(), 10u);
+        for (int pl = 90; pl < 100; ++pl) {
+            EXPECT_EQ(cache.throughput(makeKey(pl)), reference(makeKey(pl)));
+        }
+        EXPECT_EQ(cache.stats().hits, 10u);
+        EXPECT_EQ(cache.stats().misses, 0u);
+    }
+    {
+        // Results depend on the configuration: another one starts from an empty cache
+        DLThroughputConfig config;
+        config.beamFormingGain = 3.0;
+        DLThroughputCache cache(path, 256, config);
+        EXPECT_EQ(cache.size(), 0u);
+        EXPECT_EQ(cache.throughput(makeKey(95)), reference(makeKey(95), config));
+    }
+    {
+        DLThroughputCache cache(path, 512);
+        EXPECT_EQ(cache.size(), 0u);
+    }
+    std::remove(path.c_str());
+}
+
+TEST(ResultCacheTests, UnusableFileFallsBackToMemory) {
+    DLThroughputCache cache("/nonexistent-directory/cache.bin", 64);
+    EXPECT_FALSE(cache.isPersistent());
+    EXPECT_FALSE(cache.sync());
+    EXPECT_EQ(cache.throughput(makeKey(100.0)), reference(makeKey(100.0)));
+    EXPECT_EQ(cache.size(), 1u);
+}
@@ -0,0 +1,145 @@
+#include "scheduler.h"
+#include "tbs.h"
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <gtest/gtest.h>
+
+namespace {
+
+// SNRs from -5 dB to 25 dB
+std::vector<double> spreadSnr(std::size_t count, unsigned seed = 1) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> snr_dB(-5.0, 25.0);
+    std::vector<double> snr(count);
+    for (double& value : snr) {
+        value = std::pow(10.0, snr_dB(rng) / 10);
+    }
+    return snr;
+}
+
+SchedulerConfig configWithPolicy(SchedulerPolicy policy) {
+    SchedulerConfig config;
+    config.policy = policy;
+    return config;
+}
+
+} // namespace
+
+TEST(SchedulerTests, SingleUEGetsEveryPRB) {
+    SchedulerConfig config;
+    const double snr = 100.0;
+    SchedulerResult result = runSchedulerSimulation(std::vector<double>(1, snr), 10, config);
+
+    int totalPRBs = calculateTotalPRBsAvailable(config.prbCount, config.link.downlinkOverhead);
+    int availableREs = calculateAvailableREs(numOfSCsPerRB, config.link.numOfSymbolsPerSlot,
+                                             config.link.numOfREsForDMRS, config.link.numOfOverheadREs);
+    int mcs = determineMcsIndex(determineIntermediateSpectralEfficiency(calculateSpectralEfficiencyPerLayer(snr)).second);
+    int tbs = determineTBS(calculateActualAvailableREs(availableREs, totalPRBs), mcs, 1);
+    ASSERT_EQ(result.bits.size(), 1u);
+    EXPECT_EQ(result.bits[0], 10u * tbs);
+    EXPECT_EQ(result.slots, 10u);
+    EXPECT_DOUBLE_EQ(result.throughput[0], calculateDLApplicationThroughput(tbs, config.link.dlFraction,
+                                                                            calculateSlotSize(config.link.numerology),
+                                                                            config.link.applicationPacketSize,
+                                                                            config.link.macPacketSize));
+    EXPECT_DOUBLE_EQ(result.fairnessIndex, 1.0);
+}
+
+TEST(SchedulerTests, RoundRobinSharesRBGsEqually) {
+    // 273 PRBs leave 223 after overhead: 13 full RBGs and one of 15 PRBs per slot
+    const std::size_t numUEs = 140;
+    SchedulerResult result = runSchedulerSimulation(spreadSnr(numUEs), 1000, configWithPolicy(SchedulerPolicy::RoundRobin));
+    for (std::size_t ue = 0; ue < numUEs; ++ue) {
+        EXPECT_EQ(result.allocations[ue], 100u) << "UE " << ue;
+    }
+}
+
+TEST(SchedulerTests, MaxCIServesOnlyTheBestUEs) {
+    const std::size_t numUEs = 200;
+    std::vector<double> snr = spreadSnr(numUEs);
+    SchedulerConfig config = configWithPolicy(SchedulerPolicy::MaxCI);
+    SchedulerSimulator simulator(snr, config);
+    simulator.run(500);
+    SchedulerResult result = simulator.result();
+
+    std::vector<int> tbs(numUEs);
+    for (std::size_t ue = 0; ue < numUEs; ++ue) {
+        tbs[ue] = simulator.rbgTBS(ue);
+    }
+    std::vector<int> sorted = tbs;
+    std::sort(sorted.rbegin(), sorted.rend());
+    const int cutoff = sorted[13]; // 14 RBGs per slot
+    for (std::size_t ue = 0; ue < numUEs; ++ue) {
+        if (tbs[ue] < cutoff) {
+            EXPECT_EQ(result.bits[ue], 0u) << "UE " << ue;
+        }
+        if (tbs[ue] > cutoff) {
+            EXPECT_EQ(result.allocations[ue], 500u) << "UE " << ue;
+        }
+    }
+}
+
+TEST(SchedulerTests, ProportionalFairTradesThroughputForFairness) {
+    const std::size_t numUEs = 100;
+    std::vector<double> snr = spreadSnr(numUEs);
+    SchedulerResult rr = runSchedulerSimulation(snr, 5000, configWithPolicy(SchedulerPolicy::RoundRobin));
+    SchedulerResult pf = runSchedulerSimulation(snr, 5000, configWithPolicy(SchedulerPolicy::ProportionalFair));
+    SchedulerResult maxCI = runSchedulerSimulation(snr, 5000, configWithPolicy(SchedulerPolicy::MaxCI));
+
+    EXPECT_GT(maxCI.cellThroughput, pf.cellThroughput);
+    EXPECT_GT(pf.fairnessIndex, maxCI.fairnessIndex);
+    // With constant channels proportional fair converges to equal shares of the RBGs
+    for (std::size_t ue = 0; ue < numUEs; ++ue) {
+        EXPECT_NEAR(pf.allocations[ue], rr.allocations[ue], 0.05 * rr.allocations[ue]) << "UE " << ue;
+    }
+}
+
+TEST(SchedulerTests, ProportionalFairFollowsChannelChanges) {
+    SchedulerConfig config = configWithPolicy(SchedulerPolicy::ProportionalFair);
+    config.fairnessTimeConstant = 10.0; // renormalizes the averages every few thousand slots
+    std::vector<double> snr(50, 10.0);
+    SchedulerSimulator simulator(snr, config);
+    simulator.run(20000);
+    SchedulerResult before = simulator.result();
+    EXPECT_NEAR(before.fairnessIndex, 1.0, 1e-3);
+
+    // A UE whose channel improves gets more bits but the same share of RBGs
+    simulator.setChannel(7, 1000.0);
+    simulator.run(20000);
+    SchedulerResult after = simulator.result();
+    std::uint64_t bitsOfUE7 = after.bits[7] - before.bits[7];
+    std::uint64_t bitsOfUE8 = after.bits[8] - before.bits[8];
+    EXPECT_GT(bitsOfUE7, 2 * bitsOfUE8);
+    EXPECT_NEAR(after.allocations[7] - before.allocations[7], after.allocations[8] - before.allocations[8], 100.0);
+    for (double throughput : after.throughput) {
+        EXPECT_TRUE(std::isfinite(throughput));
+    }
+}
+
+TEST(SchedulerTests, MoreRBGsThanUEs) {
+    SchedulerResult result = runSchedulerSimulation(std::vector<double>(3, 50.0), 100);
+    // 14 RBGs per slot go to the 3 UEs in turn
+    for (std::uint64_t allocations : result.allocations) {
+        EXPECT_GE(allocations, 100u * 4);
+        EXPECT_LE(allocations, 100u * 5);
+    }
+    EXPECT_EQ(result.allocations[0] + result.allocations[1] + result.allocations[2], 100u * 14);
+}
+
+TEST(SchedulerTests, FairnessTimeConstantMustExceedOneSlot) {
+    const std::vector<double> snr = spreadSnr(10);
+    SchedulerConfig config;
+    for (double timeConstant : {1.0, 0.5, 0.0, -3.0, std::numeric_limits<double>::quiet_NaN()}) {
+        config.fairnessTimeConstant = timeConstant;
+        EXPECT_THROW(SchedulerSimulator(snr, config), std::invalid_argument) << "T " << timeConstant;
+    }
+    // The shortest window still keeps finite averages
+    config.fairnessTimeConstant = 1.5;
+    SchedulerSimulator simulator(snr, config);
+    simulator.run(1000);
+    SchedulerResult result = simulator.result();
+    EXPECT_TRUE(std::isfinite(result.fairnessIndex));
+    EXPECT_GT(result.cellThroughput, 0.0);
+}
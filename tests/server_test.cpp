@@ -0,0 +1,254 @@
+#include "server.h"
+#include "linkbudget.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Runs a server on a socket of the test's temporary directory for the lifetime of the object
+class ServerFixture {
+public:
+    explicit ServerFixture(const char* name, const CommandServerOptions& options = CommandServerOptions())
+        : path_(::testing::TempDir() + name), server_(options) {
+        listening_ = server_.listen(path_);
+        if (listening_) {
+            thread_ = std::thread([this] { server_.run(); });
+        }
+    }
+
+    ~ServerFixture() { stop(); }
+
+    // Stops the server thread, after which its counters can be read
+    void stop() {
+        if (thread_.joinable()) {
+            server_.stop();
+            thread_.join();
+        }
+    }
+
+    bool listening() const { return listening_; }
+    const CommandServerStats& stats() const { return server_.stats(); }
+
+    int connect() const {
+        int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        std::snprintf(address.sun_path, sizeof(address.sun_path), "%s", path_.c_str());
+        if (fd >= 0 && ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+private:
+    std::string path_;
+    CommandServer server_;
+    bool listening_ = false;
+    std::thread thread_;
+};
+
+void sendAll(int fd, const std::string& data) {
+    std::size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t length = ::write(fd, data.data() + sent, data.size() - sent);
+        ASSERT_GT(length, 0);
+        sent += static_cast<std::size_t>(length);
+    }
+}
+
+// Reads until the server closes the connection
+std::string receiveAll(int fd) {
+    std::string data;
+    char buffer[4096];
+    ssize_t length;
+    while ((length = ::read(fd, buffer, sizeof(buffer))) > 0) {
+        data.append(buffer, static_cast<std::size_t>(length));
+    }
+    return data;
+}
+
+std::string expectedLine(const char* command, const char* record) {
+    std::string out;
+    evaluateRecord(*findCommand(command), record, record + std::strlen(record), out, 17);
+    return out;
+}
+
+} // namespace
+
+TEST(ServerTests, PipelinedLineRequestsAreAnsweredInOrder) {
+    ServerFixture server("server_test_lines.sock");
+    ASSERT_TRUE(server.listening());
+    int fd = server.connect();
+    ASSERT_GE(fd, 0);
+
+    std::string requests, expected;
+    for (int pathLoss = 80; pathLoss < 180; ++pathLoss) {
+        std::string record = "4,100,40," + std::to_string(pathLoss) + ",273";
+        requests += "dl-throughput " + record + "\n";
+        expected += expectedLine("dl-throughput", record.c_str());
+    }
+    requests += "\r\nwatts-to-dbm 1\r\nwavelength -1\nno-such-command 1\n";
+    expected += "30\nnan\nerror\n";
+    sendAll(fd, requests);
+    ::shutdown(fd, SHUT_WR);
+    EXPECT_EQ(expected, receiveAll(fd));
+    ::close(fd);
+}
+
+TEST(ServerTests, LastLineNeedsNoNewline) {
+    ServerFixture server("server_test_last_line.sock");
+    ASSERT_TRUE(server.listening());
+    int fd = server.connect();
+    ASSERT_GE(fd, 0);
+
+    sendAll(fd, "watts-to-dbm 1\nwatts-to-dbm 1000");
+    ::shutdown(fd, SHUT_WR);
+    EXPECT_EQ("30\n60\n", receiveAll(fd));
+    ::close(fd);
+}
+
+TEST(ServerTests, BinaryRequestsMatchTheCommands) {
+    ServerFixture server("server_test_binary.sock");
+    ASSERT_TRUE(server.listening());
+    int fd = server.connect();
+    ASSERT_GE(fd, 0);
+
+    std::size_t numCommands;
+    const Command* commands = commandList(numCommands);
+    std::size_t dlThroughput = findCommand("dl-throughput") - commands;
+    std::size_t watts = findCommand("dbm-to-watts") - commands;
+    const double dlInputs[] = {2, 50, 43, 110, 133};
+    const double wattsInput = 30;
+
+    std::string requests;
+    auto append = [&](std::size_t command, const double* inputs, int count) {
+        const char header[4] = {0, static_cast<char>(command), static_cast<char>(count), 0};
+        requests.append(header, sizeof(header));
+        requests.append(reinterpret_cast<const char*>(inputs), count * sizeof(double));
+    };
+    append(dlThroughput, dlInputs, 5);
+    append(watts, &wattsInput, 1);
+    append(dlThroughput, dlInputs, 4); // too few inputs
+    append(numCommands, dlInputs, 0);  // unknown command
+    sendAll(fd, requests + "watts-to-dbm 1000\n");
+    ::shutdown(fd, SHUT_WR);
+    std::string response = receiveAll(fd);
+    ::close(fd);
+
+    ASSERT_EQ(4u * 4 + 3 * sizeof(double) + 3, response.size());
+    const char* p = response.data();
+    double value;
+    EXPECT_EQ(0, p[0]);
+    EXPECT_EQ(1, p[1]);
+    std::memcpy(&value, p + 4, sizeof(value));
+    EXPECT_EQ(calculateDLThroughput(110, 43, 2, 133, 50e6) / 1000, value);
+    p += 4 + sizeof(double);
+    EXPECT_EQ(0, p[0]);
+    std::memcpy(&value, p + 4, sizeof(value));
+    EXPECT_EQ(dBmToWatts(30), value);
+    p += 4 + sizeof(double);
+    EXPECT_EQ(1, p[0]);
+    std::memcpy(&value, p + 4, sizeof(value));
+    EXPECT_TRUE(std::isnan(value));
+    p += 4 + sizeof(double);
+    EXPECT_EQ(2, p[0]);
+    EXPECT_EQ(0, p[1]);
+    EXPECT_EQ("60\n", std::string(p + 4));
+}
+
+TEST(ServerTests, NonzeroReservedByteIsAnError) {
+    ServerFixture server("server_test_reserved.sock");
+    ASSERT_TRUE(server.listening());
+    int fd = server.connect();
+    ASSERT_GE(fd, 0);
+
+    std::size_t numCommands;
+    const char watts = static_cast<char>(findCommand("dbm-to-watts") - commandList(numCommands));
+    const double input = 30;
+    std::string requests;
+    for (char reserved : {char(1), char(0)}) {
+        const char header[4] = {0, watts, 1, reserved};
+        requests.append(header, sizeof(header));
+        requests.append(reinterpret_cast<const char*>(&input), sizeof(input));
+    }
+    sendAll(fd, requests);
+    ::shutdown(fd, SHUT_WR);
+    std::string response = receiveAll(fd);
+    ::close(fd);
+
+    // The request is skipped by its length, so the next one is still answered
+    ASSERT_EQ(4u + 4 + sizeof(double), response.size());
+    EXPECT_EQ(3, response[0]);
+    EXPECT_EQ(0, response[1]);
+    EXPECT_EQ(0, response[4]);
+    EXPECT_EQ(1, response[5]);
+    double value;
+    std::memcpy(&value, response.data() + 8, sizeof(value));
+    EXPECT_EQ(dBmToWatts(30), value);
+    server.stop();
+    EXPECT_EQ(1u, server.stats().invalid);
+    EXPECT_EQ(0u, server.stats().protocolErrors);
+}
+
+TEST(ServerTests, ConcurrentClientsShareBatches) {
+    const int numClients = 8;
+    const int numRequests = 200;
+    ServerFixture server("server_test_clients.sock");
+    ASSERT_TRUE(server.listening());
+
+    std::vector<std::thread> clients;
+    std::vector<std::string> responses(numClients), expected(numClients);
+    for (int c = 0; c < numClients; ++c) {
+        std::string requests;
+        for (int r = 0; r < numRequests; ++r) {
+            std::string record = "1,20,30," + std::to_string(60 + c + 0.5 * r) + ",106";
+            requests += "DLThroughputCalculator " + record + "\n";
+            expected[c] += expectedLine("dl-throughput", record.c_str());
+        }
+        clients.emplace_back([&server, &responses, c, requests] {
+            int fd = server.connect();
+            if (fd >= 0) {
+                sendAll(fd, requests);
+                ::shutdown(fd, SHUT_WR);
+                responses[c] = receiveAll(fd);
+                ::close(fd);
+            }
+        });
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    for (int c = 0; c < numClients; ++c) {
+        EXPECT_EQ(expected[c], responses[c]) << "client " << c;
+    }
+    server.stop();
+    EXPECT_EQ(static_cast<std::size_t>(numClients), server.stats().connections);
+    EXPECT_EQ(static_cast<std::size_t>(numClients * numRequests), server.stats().batchedRequests);
+    EXPECT_LE(server.stats().batches, server.stats().batchedRequests);
+}
+
+TEST(ServerTests, OverlongLinesCloseTheConnection) {
+    CommandServerOptions options;
+    options.maxLineLength = 64;
+    ServerFixture server("server_test_overlong.sock", options);
+    ASSERT_TRUE(server.listening());
+    int fd = server.connect();
+    ASSERT_GE(fd, 0);
+
+    // Requests before the overlong line are answered, none after it
+    sendAll(fd, "watts-to-dbm 1\nwatts-to-dbm " + std::string(100, '1') + "\nwatts-to-dbm 1\n");
+    EXPECT_EQ("30\n", receiveAll(fd));
+    ::close(fd);
+
+    server.stop();
+    EXPECT_EQ(1u, server.stats().protocolErrors);
+    EXPECT_EQ(1u, server.stats().requests);
+}
@@ -0,0 +1,168 @@
+#include "sinr.h"
+#include <random>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Hexagonal-ish layout: a jittered square lattice of cells with varying heights and powers
+std::vector<CoverageSite> testCells(int side, double spacing) {
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> jitter(-0.2 * spacing, 0.2 * spacing);
+    std::vector<CoverageSite> cells;
+    for (int r = 0; r < side; ++r) {
+        for (int c = 0; c < side; ++c) {
+            cells.push_back({c * spacing + jitter(rng), r * spacing + jitter(rng), 25.0 + 5 * ((r + c) % 3),
+                             40.0 + 3 * ((r * c) % 3)});
+        }
+    }
+    return cells;
+}
+
+struct TestUEs {
+    std::vector<double> x, y;
+    TestUEs(std::size_t count, double extent, unsigned seed = 3) : x(count), y(count) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<double> position(-0.1 * extent, 1.1 * extent);
+        for (std::size_t i = 0; i < count; ++i) {
+            x[i] = position(rng);
+            y[i] = position(rng);
+        }
+    }
+    SinrBatchInput input() const {
+        SinrBatchInput in;
+        in.count = x.size();
+        in.x = x.data();
+        in.y = y.data();
+        return in;
+    }
+};
+
+} // namespace
+
+TEST(SinrTests, BatchWithoutPruningMatchesScalarReference) {
+    std::vector<CoverageSite> cells = testCells(6, 1500.0);
+    TestUEs ues(2000, 5 * 1500.0);
+    SinrConfig config;
+    config.interferenceThreshold = -std::numeric_limits<double>::infinity();
+    config.binSize = 700.0;
+
+    std::vector<double> sinr(ues.x.size()), signal(ues.x.size()), interference(ues.x.size());
+    std::vector<std::int32_t> server(ues.x.size());
+    SinrBatchOutput output;
+    output.sinrLinear = sinr.data();
+    output.servingCell = server.data();
+    output.signalPower = signal.data();
+    output.interferencePower = interference.data();
+    SinrStats stats = calculateMultiCellSINRBatch(cells, ues.input(), output, config);
+
+    EXPECT_EQ(stats.unservedUEs, 0u);
+    for (std::size_t i = 0; i < ues.x.size(); ++i) {
+        std::int32_t expectedServer = -2;
+        double expected = calculateMultiCellSINR(cells, ues.x[i], ues.y[i], config, &expectedServer);
+        EXPECT_EQ(server[i], expectedServer) << "UE " << i;
+        EXPECT_NEAR(sinr[i], expected, 1e-9 * expected) << "UE " << i;
+        EXPECT_NEAR(sinr[i], signal[i] / (interference[i] + calculateThermalNoisePower(300, 100e6)), 1e-12 * sinr[i]);
+    }
+}
+
+TEST(SinrTests, InterferenceLowersSinrBelowSnr) {
+    std::vector<CoverageSite> cells = testCells(3, 1000.0);
+    SinrConfig config;
+    std::int32_t server = -1;
+    double sinr = calculateMultiCellSINR(cells, 1000.0, 1000.0, config, &server);
+    ASSERT_GE(server, 0);
+
+    std::vector<CoverageSite> servingOnly(1, cells[server]);
+    double snr = calculateMultiCellSINR(servingOnly, 1000.0, 1000.0, config);
+    EXPECT_LT(sinr, snr);
+    EXPECT_GT(sinr, 0.0);
+}
+
+TEST(SinrTests, PruningDropsOnlyCellsBelowThreshold) {
+    std::vector<CoverageSite> cells = testCells(12, 800.0);
+    TestUEs ues(5000, 11 * 800.0, 5);
+    SinrConfig config;
+    config.isLOS = true;
+    config.interferenceThreshold = -20.0;
+    const double noise = calculateThermalNoisePower(config.temperature, config.bandwidth);
+    const double thresholdRatio = std::pow(10.0, config.interferenceThreshold / 10);
+
+    std::vector<double> sinr(ues.x.size()), signal(ues.x.size()), interference(ues.x.size());
+    std::vector<std::int32_t> server(ues.x.size());
+    SinrBatchOutput output;
+    output.sinrLinear = sinr.data();
+    output.servingCell = server.data();
+    output.signalPower = signal.data();
+    output.interferencePower = interference.data();
+    SinrStats pruned = calculateMultiCellSINRBatch(cells, ues.input(), output, config);
+    EXPECT_LT(pruned.pairsEvaluated, ues.x.size() * cells.size() / 2);
+
+    SinrConfig unprunedConfig = config;
+    unprunedConfig.interferenceThreshold = -std::numeric_limits<double>::infinity();
+    std::vector<double> exactInterference(ues.x.size()), exactSinr(ues.x.size());
+    std::vector<std::int32_t> exactServer(ues.x.size());
+    SinrBatchOutput exact;
+    exact.sinrLinear = exactSinr.data();
+    exact.servingCell = exactServer.data();
+    exact.interferencePower = exactInterference.data();
+    SinrStats unpruned = calculateMultiCellSINRBatch(cells, ues.input(), exact, unprunedConfig);
+    EXPECT_GT(unpruned.pairsContributing, pruned.pairsContributing);
+
+    for (std::size_t i = 0; i < ues.x.size(); ++i) {
+        // The serving cell is never dropped, and every dropped interferer is below the threshold
+        EXPECT_EQ(server[i], exactServer[i]);
+        EXPECT_LE(interference[i], exactInterference[i] * (1 + 1e-12));
+        EXPECT_LE(exactInterference[i] - interference[i], thresholdRatio * std::max(noise, signal[i]) * cells.size());
+        EXPECT_GE(sinr[i], exactSinr[i] * (1 - 1e-12));
+    }
+}
+
+TEST(SinrTests, PruningRadiusBoundsReceivedPower) {
+    CoverageSite cell = {0.0, 0.0, 35.0, 46.0};
+    for (bool isLOS : {false, true}) {
+        SinrConfig config;
+        config.isLOS = isLOS;
+        config.interferenceThreshold = 10.0; // a 46 dBm cell reaches the noise floor beyond the model range
+        ASSERT_EQ(calculateSinrPruningRadius(cell, SinrConfig()), SinrConfig().maxDistance);
+        const double radius = calculateSinrPruningRadius(cell, config);
+        ASSERT_GT(radius, 10.0);
+        ASSERT_LE(radius, config.maxDistance);
+
+        const double noise_dBm = wattsToDbm(calculateThermalNoisePower(config.temperature, config.bandwidth));
+        RuralPathLossSite model = makeRuralPathLossSite(cell.gNBAntennaHeight, config.fLow, config.fHigh,
+                                                        config.buildingHeight, config.streetWidth);
+        for (double d = radius; d <= config.maxDistance; d += 1.0) {
+            double pathLoss = calculate5GPathLossRural(model, config.ueHeight, d, isLOS);
+            if (pathLoss > 0) {
+                EXPECT_LT(cell.txPower - pathLoss, noise_dBm + config.interferenceThreshold) << "d " << d;
+            }
+        }
+    }
+
+    SinrConfig silent;
+    silent.interferenceThreshold = 200.0;
+    EXPECT_EQ(calculateSinrPruningRadius(cell, silent), 0.0);
+}
+
+TEST(SinrTests, UEsOutOfReachAreUnserved) {
+    std::vector<CoverageSite> cells(1, CoverageSite{0.0, 0.0, 35.0, 46.0});
+    std::vector<double> x = {500.0, 20000.0, 5.0};
+    std::vector<double> y = {0.0, 0.0, 0.0};
+    SinrBatchInput input;
+    input.count = x.size();
+    input.x = x.data();
+    input.y = y.data();
+    std::vector<double> sinr(x.size(), -1.0);
+    std::vector<std::int32_t> server(x.size());
+    SinrBatchOutput output;
+    output.sinrLinear = sinr.data();
+    output.servingCell = server.data();
+
+    SinrStats stats = calculateMultiCellSINRBatch(cells, input, output);
+    EXPECT_EQ(server[0], 0);
+    EXPECT_GT(sinr[0], 0.0);
+    EXPECT_EQ(server[1], -1); // beyond the model range
+    EXPECT_EQ(sinr[1], 0.0);
+    EXPECT_EQ(server[2], -1); // closer than the 10 m model minimum
+    EXPECT_EQ(stats.unservedUEs, 2u);
+}
@@ -0,0 +1,68 @@
+#include "sweep.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+DLThroughputSweepAxes testAxes() {
+    DLThroughputSweepAxes axes;
+    axes.bandwidth = {10e6, 20e6, 50e6, 100e6};
+    axes.numOfLayers = {1, 2, 4, 8};
+    axes.prbCount = {25, 106, 273};
+    axes.numerology = {0, 1, 3};
+    axes.txPower = {23.0, 33.0, 43.0, 49.0};
+    for (double pathLoss = 60.0; pathLoss <= 200.0; pathLoss += 2.5) {
+        axes.pathLoss.push_back(pathLoss);
+    }
+    return axes;
+}
+
+} // namespace
+
+TEST(SweepTests, EveryPointMatchesScalarChain) {
+    DLThroughputSweepAxes axes = testAxes();
+    DLThroughputConfig config;
+    config.beamFormingGain = 3.0;
+    DLThroughputSweepResult result = runDLThroughputSweep(axes, config);
+    ASSERT_EQ(dlThroughputSweepSize(axes), result.throughput.size());
+
+    for (std::size_t b = 0; b < axes.bandwidth.size(); ++b)
+    for (std::size_t l = 0; l < axes.numOfLayers.size(); ++l)
+    for (std::size_t p = 0; p < axes.prbCount.size(); ++p)
+    for (std::size_t n = 0; n < axes.numerology.size(); ++n)
+    for (std::size_t t = 0; t < axes.txPower.size(); ++t)
+    for (std::size_t pl = 0; pl < axes.pathLoss.size(); ++pl) {
+        config.numerology = axes.numerology[n];
+        double expected = calculateDLThroughput(axes.pathLoss[pl], axes.txPower[t], axes.numOfLayers[l],
+                                                axes.prbCount[p], axes.bandwidth[b], config);
+        ASSERT_EQ(expected, result.throughput[dlThroughputSweepIndex(axes, b, l, p, n, t, pl)]);
+    }
+}
+
+TEST(SweepTests, StagesRunOncePerDistinctInput) {
+    DLThroughputSweepAxes axes = testAxes();
+    DLThroughputSweepStats stats = runDLThroughputSweep(axes).stats;
+    EXPECT_EQ(dlThroughputSweepSize(axes), stats.points);
+    EXPECT_EQ(axes.bandwidth.size(), stats.thermalNoiseEvaluations);
+    EXPECT_EQ(axes.numOfLayers.size() * axes.txPower.size(), stats.txPowerPerLayerEvaluations);
+    EXPECT_EQ(axes.bandwidth.size() * axes.numOfLayers.size() * axes.txPower.size() * axes.pathLoss.size(),
+              stats.linkEvaluations);
+    EXPECT_EQ(16u, stats.tbsEvaluations);
+    EXPECT_EQ(axes.prbCount.size(), stats.prbEvaluations);
+    EXPECT_EQ(axes.numerology.size(), stats.slotEvaluations);
+    // The PRB and numerology axes multiply the points but not the link evaluations
+    EXPECT_EQ(stats.points, stats.linkEvaluations * axes.prbCount.size() * axes.numerology.size());
+}
+
+TEST(SweepTests, ResultIndependentOfThreadCount) {
+    DLThroughputSweepAxes axes = testAxes();
+    EXPECT_EQ(runDLThroughputSweep(axes, DLThroughputConfig(), 1).throughput,
+              runDLThroughputSweep(axes, DLThroughputConfig(), 7).throughput);
+}
+
+TEST(SweepTests, EmptyAxisGivesEmptyResult) {
+    DLThroughputSweepAxes axes = testAxes();
+    axes.numerology.clear();
+    DLThroughputSweepResult result = runDLThroughputSweep(axes);
+    EXPECT_TRUE(result.throughput.empty());
+    EXPECT_EQ(0u, result.stats.points);
+}
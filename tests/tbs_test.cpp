@@ -0,0 +1,117 @@
+#include "tbs.h"
+#include "linkbudget.h"
+#include <gtest/gtest.h>
+
+TEST(TBSTests, DetermineTBSFollowsBothBranches) {
+    // 1 PRB of 156 REs at MCS 0: Ninfo = 156 * 120/1024 * 2 = 36.56 -> NinfoPrime 32 -> TBS 32
+    EXPECT_EQ(32, determineTBS(156, 0, 1));
+    // 100 PRBs at MCS 27 over 4 layers is far above 3824 bits
+    int nRE = 156 * 100;
+    double nInfo = calculateNumberOfInformationBits(nRE, 948, 8) * 4;
+    EXPECT_EQ(calculateTBS(calculateNinfoPrime(nInfo), 948), determineTBS(nRE, 27, 4));
+    EXPECT_EQ(0, determineTBS(0, 5, 1));
+    EXPECT_EQ(0, determineTBS(156, 28, 1));
+}
+
+TEST(TBSTests, LookupTableMatchesReferenceOverFullDomain) {
+    const TBSLookupTable& table = defaultTBSLookupTable();
+    ASSERT_EQ(maxTBSLookupREs, table.maxREs());
+    ASSERT_EQ(maxTBSLookupLayers, table.maxLayers());
+    for (int layers = 1; layers <= table.maxLayers(); ++layers) {
+        for (int mcs = 0; mcs < static_cast<int>(mcsTable.size()); ++mcs) {
+            for (int nRE = 0; nRE <= table.maxREs(); ++nRE) {
+                ASSERT_EQ(determineTBS(nRE, mcs, layers), table.lookup(nRE, mcs, layers))
+                    << "nRE " << nRE << " mcs " << mcs << " layers " << layers;
+            }
+        }
+    }
+}
+
+TEST(TBSTests, BatchThroughputWithLookupTableIsUnchanged) {
+    const std::size_t count = 512;
+    std::vector<double> pathLoss(count), txPower(count, 40.0), bandwidth(count, 50e6);
+    std::vector<double> reference(count), withTable(count);
+    std::vector<int> layers(count, 2), prbCount(count, 133);
+    for (std::size_t i = 0; i < count; ++i) {
+        pathLoss[i] = 80.0 + 0.2 * i;
+    }
+
+    DLThroughputBatchInput input;
+    input.count = count;
+    input.pathLoss = pathLoss.data();
+    input.txPower = txPower.data();
+    input.numOfLayers = layers.data();
+    input.prbCount = prbCount.data();
+    input.bandwidth = bandwidth.data();
+
+    // An allocation of 0 PRBs has no RE, which the table must not map to another TBS
+    // than the scalar chain
+    TBSLookupTable table(156 * 32, 1);
+    for (int prbPerUE : {20, 0}) {
+        DLThroughputConfig config;
+        config.prbPerUE = prbPerUE;
+        DLThroughputBatchOutput output;
+        output.throughput = reference.data();
+        calculateDLThroughputBatch(input, output, config);
+
+        config.tbsLookupTable = &table;
+        output.throughput = withTable.data();
+        calculateDLThroughputBatch(input, output, config);
+
+        EXPECT_EQ(reference, withTable) << "prbPerUE " << prbPerUE;
+        for (std::size_t i = 0; i < count; ++i) {
+            ASSERT_DOUBLE_EQ(calculateDLThroughput(pathLoss[i], txPower[i], layers[i], prbCount[i], bandwidth[i], config),
+                             withTable[i]) << "prbPerUE " << prbPerUE << " UE " << i;
+        }
+    }
+}
+
+TEST(TBSTests, IntegerTBSIsBitExactOverEveryAllocation) {
+    // Every Ninfo a UE can be allocated, in every MCS table, against the double precision chain
+    for (MCSTableId id : {MCSTableId::Table1, MCSTableId::Table2, MCSTableId::Table3}) {
+        const ConstexprTable<MCSEntry> mcs = getMCSTable(id);
+        for (std::size_t m = 0; m < mcs.size(); ++m) {
+            const MCSEntry& entry = mcs[m];
+            for (int layers = 1; layers <= maxTBSLookupLayers; ++layers) {
+                for (int nRE = 1; nRE <= maxTBSLookupREs; ++nRE) {
+                    double nInfo = calculateNumberOfInformationBits(nRE, entry.mcsCodeRate, entry.modulationOrder) * layers;
+                    ASSERT_EQ(calculateTBSForNinfo(nInfo, static_cast<int>(entry.mcsCodeRate)),
+                              determineTBS(nRE, static_cast<int>(m), layers, id))
+                        << "nRE " << nRE << " MCS " << m << " layers " << layers;
+                }
+            }
+        }
+    }
+}
+
+TEST(TBSTests, IntegerTBSIsBitExactAroundEveryBoundary) {
+    // Every Ninfo in 1/2048 bit steps up to 4096 bits, across the switch of branches at 3824,
+    // then a window around every power of two and rounding step of the large Ninfo branch
+    std::vector<std::int64_t> small, large;
+    for (std::int64_t ninfo = 1; ninfo <= (std::int64_t(1) << 23); ++ninfo) {
+        small.push_back(ninfo);
+    }
+    for (int exponent = 23; exponent < 34; ++exponent) {
+        for (std::int64_t centre : {std::int64_t(1) << exponent, (std::int64_t(1) << exponent) + (24 << 11)}) {
+            for (std::int64_t delta = -4096; delta <= 4096; ++delta) {
+                large.push_back(centre + delta);
+            }
+        }
+    }
+    // The code rate only matters above 3824 bits, on both sides of R = 1/4
+    auto check = [](const std::vector<std::int64_t>& values, int codeRate) {
+        std::vector<int> tbs(values.size());
+        std::vector<int> codeRates(values.size(), codeRate);
+        calculateTBSForScaledNinfoBatch(values.data(), codeRates.data(), tbs.data(), values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            ASSERT_EQ(calculateTBSForNinfo(values[i] / 2048.0, codeRate), tbs[i])
+                << "Ninfo " << values[i] << "/2048, code rate " << codeRate;
+        }
+    };
+    check(small, 948);
+    for (int codeRate : {120, 256, 257, 948}) {
+        check(large, codeRate);
+    }
+    EXPECT_EQ(24, calculateTBSForScaledNinfo(0, 120));
+    EXPECT_EQ(24, calculateTBSForScaledNinfo(-5, 120));
+}
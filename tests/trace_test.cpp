@@ -0,0 +1,162 @@
+#include "trace.h"
+#include "utilities.h"
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <gtest/gtest.h>
+
+namespace {
+
+// Swaps the buffer of a standard stream for a string buffer for the lifetime of the object
+class CaptureStream {
+public:
+    explicit CaptureStream(std::ostream& stream) : stream_(stream), previous_(stream.rdbuf(buffer_.rdbuf())) {}
+    ~CaptureStream() { stream_.rdbuf(previous_); }
+    std::string str() const { return buffer_.str(); }
+
+private:
+    std::ostream& stream_;
+    std::ostringstream buffer_;
+    std::streambuf* previous_;
+};
+
+void discardPendingRecords() {
+    std::vector<TraceRecord> records;
+    drainTrace(records);
+}
+
+} // namespace
+
+TEST(TraceTest, NoTraceIsDisabled) {
+    EXPECT_FALSE(NoTrace::enabled);
+    EXPECT_TRUE(StreamTrace::enabled);
+    EXPECT_TRUE(RingBufferTrace::enabled);
+}
+
+TEST(TraceTest, NoTraceRecordsNothing) {
+    discardPendingRecords();
+    CaptureStream out(std::cout);
+    CaptureStream err(std::cerr);
+    EXPECT_EQ(calculateWavelength(-1.0), 0.0);
+    calculate5GPathLossRural(35, 1.5, 3500, 3600, 1000, 5, 20, true);
+
+    std::vector<TraceRecord> records;
+    EXPECT_EQ(drainTrace(records), 0u);
+    EXPECT_TRUE(out.str().empty());
+    EXPECT_TRUE(err.str().empty());
+}
+
+TEST(TraceTest, StreamTracePrintsMessagesToStandardError) {
+    CaptureStream err(std::cerr);
+    EXPECT_EQ(calculateWavelength<StreamTrace>(-1.0), 0.0);
+    EXPECT_EQ(err.str(), "Frequency must be greater than 0 Hz.\n");
+}
+
+TEST(TraceTest, StreamTracePrintsValuesToStandardOutput) {
+    CaptureStream out(std::cout);
+    double traced = calculate5GPathLossRural<StreamTrace>(35, 1.5, 3500, 3600, 1000, 5, 20, true);
+    EXPECT_EQ(traced, calculate5GPathLossRural(35, 1.5, 3500, 3600, 1000, 5, 20, true));
+    EXPECT_NE(out.str().find("centerFrequency: 3550 MHz\n"), std::string::npos);
+    EXPECT_NE(out.str().find("fNorm: 3.55 GHz\n"), std::string::npos);
+    EXPECT_NE(out.str().find("breakPointDistance: "), std::string::npos);
+}
+
+TEST(TraceTest, RingBufferTraceKeepsValuesAndMessages) {
+    discardPendingRecords();
+    calculateWavelength<RingBufferTrace>(-1.0);
+    calculate5GPathLossRural<RingBufferTrace>(35, 1.5, 3500, 3600, 1000, 5, 20, true);
+
+    std::vector<TraceRecord> records;
+    ASSERT_GE(drainTrace(records), 3u);
+    EXPECT_STREQ(records[0].name, "Frequency must be greater than 0 Hz.");
+    EXPECT_EQ(records[0].unit, nullptr);
+    EXPECT_STREQ(records[1].name, "centerFrequency");
+    EXPECT_STREQ(records[1].unit, "MHz");
+    EXPECT_EQ(records[1].value, 3550);
+    EXPECT_STREQ(records[2].name, "fNorm");
+    EXPECT_DOUBLE_EQ(records[2].value, 3.55);
+    EXPECT_LE(records[0].timestamp, records[1].timestamp);
+
+    records.clear();
+    EXPECT_EQ(drainTrace(records), 0u);
+}
+
+TEST(TraceTest, RingBufferTraceKeepsOrderOfEachThread) {
+    discardPendingRecords();
+    const int numThreads = 4;
+    const int perThread = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([t]() {
+            for (int i = 0; i < perThread; ++i) {
+                RingBufferTrace::value("sample", t * perThread + i);
+            }
+        });
+    }
+    // Drain while the threads are still tracing
+    std::vector<TraceRecord> records;
+    drainTrace(records);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    drainTrace(records);
+
+    ASSERT_EQ(records.size(), static_cast<std::size_t>(numThreads * perThread));
+    std::map<std::uint32_t, double> last;
+    std::map<int, int> perProducer;
+    for (const TraceRecord& r : records) {
+        auto previous = last.find(r.thread);
+        if (previous != last.end() && static_cast<int>(previous->second) / perThread == static_cast<int>(r.value) / perThread) {
+            EXPECT_LT(previous->second, r.value);
+        }
+        last[r.thread] = r.value;
+        ++perProducer[static_cast<int>(r.value) / perThread];
+    }
+    for (int t = 0; t < numThreads; ++t) {
+        EXPECT_EQ(perProducer[t], perThread);
+    }
+}
+
+TEST(TraceTest, RingBufferTraceDropsRecordsWhenFull) {
+    discardPendingRecords();
+    std::uint64_t droppedBefore = droppedTraceRecords();
+    std::thread producer([]() {
+        for (std::size_t i = 0; i < traceRingCapacity + 10; ++i) {
+            RingBufferTrace::value("sample", static_cast<double>(i));
+        }
+    });
+    producer.join();
+    EXPECT_EQ(droppedTraceRecords() - droppedBefore, 10u);
+
+    std::vector<TraceRecord> records;
+    ASSERT_EQ(drainTrace(records), traceRingCapacity);
+    EXPECT_EQ(records.front().value, 0);
+    EXPECT_EQ(records.back().value, traceRingCapacity - 1);
+}
+
+TEST(TraceTest, FlusherWritesPendingRecords) {
+    discardPendingRecords();
+    std::ostringstream out;
+    startTraceFlusher(out, std::chrono::milliseconds(1));
+    RingBufferTrace::value("rxPower", -80.5, "dBm");
+    RingBufferTrace::message("done");
+    stopTraceFlusher();
+
+    std::string text = out.str();
+    EXPECT_NE(text.find("] rxPower: -80.5 dBm\n"), std::string::npos);
+    EXPECT_NE(text.find("] done\n"), std::string::npos);
+    EXPECT_LT(text.find("rxPower"), text.find("done"));
+}
+
+TEST(TraceTest, FlusherRunningAtExitIsStopped) {
+    // Without a stop, the destructor of the running thread would abort the program. The
+    // child process is started afresh, as the threads of the parallel pool do not survive a fork.
+    ::testing::GTEST_FLAG(death_test_style) = "threadsafe";
+    EXPECT_EXIT({
+        startTraceFlusher(std::cerr, std::chrono::milliseconds(1));
+        RingBufferTrace::message("flushed at exit");
+        std::exit(0);
+    }, ::testing::ExitedWithCode(0), "flushed at exit");
+}
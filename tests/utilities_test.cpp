@@ -62,6 +62,27 @@ TEST(UtilityTests, CalculateSpectralEfficiencyPerLayer) {
     EXPECT_NEAR(calculateSpectralEfficiencyPerLayer(snrLinear), log2(1 + snrLinear), 0.001);
 }
 
+TEST(UtilityTests, SelectableCQIAndMCSTables) {
+    // Lookups on the constexpr tables are available at compile time
+    static_assert(getCQITable(CQITableId::Table1)[15].modulationOrder == 6, "CQI table 1 tops out at 64QAM");
+    static_assert(getMCSTable(MCSTableId::Table2)[27].modulationOrder == 8, "MCS table 2 tops out at 256QAM");
+
+    // The default tables are the 256QAM ones
+    EXPECT_EQ(determineIntermediateSpectralEfficiency(6.0), determineIntermediateSpectralEfficiency(6.0, CQITableId::Table2));
+    EXPECT_EQ(12, determineIntermediateSpectralEfficiency(6.0).first);
+    EXPECT_EQ(15, determineIntermediateSpectralEfficiency(6.0, CQITableId::Table1).first);
+    EXPECT_EQ(1, determineIntermediateSpectralEfficiency(0.06, CQITableId::Table3).first);
+    EXPECT_EQ(0, determineIntermediateSpectralEfficiency(0.06, CQITableId::Table2).first);
+
+    EXPECT_EQ(std::make_pair(8, 948.0), determineModulationAndCodeRateUsingMcsIndex(27));
+    EXPECT_EQ(std::make_pair(6, 948.0), determineModulationAndCodeRateUsingMcsIndex(28, MCSTableId::Table1));
+    EXPECT_THROW(determineModulationAndCodeRateUsingMcsIndex(28), std::runtime_error);
+
+    // MCS table 1 is not sorted at index 16/17; the scan stops at the first entry above the target
+    EXPECT_EQ(std::make_pair(4, 616.0), determineModulationAndCodeRate(2.568, MCSTableId::Table1));
+    EXPECT_STREQ("Modulation_256_QAM", modulationSchemeName(8));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include "coverage.h"
+
+// Reads one gNB per line as "x,y,antennaHeight,txPower" (meters, meters, meters, dBm).
+// Empty lines and lines starting with '#' are ignored.
+bool readSites(const std::string& path, std::vector<CoverageSite>& sites) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream iss(line);
+        CoverageSite site;
+        char c1, c2, c3;
+        if (!(iss >> site.x >> c1 >> site.y >> c2 >> site.gNBAntennaHeight >> c3 >> site.txPower) ||
+            c1 != ',' || c2 != ',' || c3 != ',') {
+            std::cerr << "Error: Invalid site record: " << line << std::endl;
+            return false;
+        }
+        sites.push_back(site);
+    }
+    return true;
+}
+
+int main() {
+    std::cout << "\nRunning Rural Coverage Map Generator" << std::endl;
+    std::cout << "====================================" << std::endl;
+
+    std::string sitesFile;
+    std::string outputPrefix;
+    double areaWidth;  // in km
+    double areaHeight; // in km
+    CoverageGrid grid;
+    CoverageConfig config;
+    char ip;
+
+    std::cout << "Enter the path of the gNB file (one x,y,antennaHeight,txPower record per line): " << std::endl;
+    std::cin >> sitesFile;
+    std::vector<CoverageSite> sites;
+    if (!readSites(sitesFile, sites) || sites.empty()) {
+        std::cerr << "Error: Could not read any gNB from " << sitesFile << std::endl;
+        return 1;
+    }
+    std::cout << "Loaded " << sites.size() << " gNBs" << std::endl;
+
+    std::cout << "Enter the width and height of the area in km (origin at 0,0): " << std::endl;
+    std::cin >> areaWidth >> areaHeight;
+    if (!std::cin || areaWidth <= 0 || areaHeight <= 0) {
+        std::cerr << "Error: Please enter positive numbers for the area size." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Enter the raster resolution in meters: " << std::endl;
+    std::cin >> grid.resolution;
+    if (!std::cin || grid.resolution <= 0) {
+        std::cerr << "Error: Please enter a positive number for the resolution." << std::endl;
+        return 1;
+    }
+    grid.width = static_cast<int>(std::ceil(areaWidth * 1000 / grid.resolution));
+    grid.height = static_cast<int>(std::ceil(areaHeight * 1000 / grid.resolution));
+
+    std::cout << "Enter the lower and higher frequency of the bandwidth in MHz: " << std::endl;
+    std::cin >> config.fLow >> config.fHigh;
+    if (!std::cin || config.fLow <= 0 || config.fHigh <= 0) {
+        std::cerr << "Error: Please enter positive numbers for the frequencies." << std::endl;
+        return 1;
+    }
+    if (config.fHigh <= config.fLow) {
+        std::cerr << "Error: The higher frequency must be above the lower frequency." << std::endl;
+        return 1;
+    }
+    config.bandwidth = (config.fHigh - config.fLow) * 1e6;
+
+    std::cout << "Enter the height of the building and the street width in meters: " << std::endl;
+    std::cin >> config.buildingHeight >> config.streetWidth;
+    if (!std::cin || config.buildingHeight <= 0 || config.streetWidth <= 0) {
+        std::cerr << "Error: Please enter positive numbers for building height and street width." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Enter the UE height in meters: " << std::endl;
+    std::cin >> config.ueHeight;
+    if (!std::cin || config.ueHeight <= 0) {
+        std::cerr << "Error: Please enter a positive number for UE height." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Choose the Path Loss Scenario: " << std::endl;
+    std::cout << "Press a for LOS\nPress b for NLOS" << std::endl;
+    std::cin >> ip;
+    if (ip != 'a' && ip != 'b') {
+        std::cerr << "Invalid input. Exiting" << std::endl;
+        return 1;
+    }
+    config.isLOS = (ip == 'a');
+
+    std::cout << "Enter the output file prefix: " << std::endl;
+    std::cin >> outputPrefix;
+
+    std::cout << "\nGenerating " << grid.width << " x " << grid.height << " raster..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    CoverageMap map = generateCoverageMap(sites, grid, config);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Coverage map generated in " << elapsed.count() << " seconds" << std::endl;
+
+    std::size_t covered = 0;
+    for (std::int32_t server : map.bestServer) {
+        covered += (server >= 0);
+    }
+    std::cout << "Covered pixels: " << covered << " of " << map.bestServer.size() << std::endl;
+
+    if (!writeCoverageMap(map, outputPrefix)) {
+        std::cerr << "Error: Could not write the rasters with prefix " << outputPrefix << std::endl;
+        return 1;
+    }
+    std::cout << "Rasters written with prefix " << outputPrefix << std::endl;
+
+    return 0;
+}
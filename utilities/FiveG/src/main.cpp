@@ -0,0 +1,209 @@
+#include <cerrno>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "commands.h"
+#include "metrics.h"
+#include "server.h"
+
+// Multi-call front end of the utilities: "5g <utility> [options] [values...]", or the utility
+// name itself when invoked through a symlink (e.g. WavelengthCalculator -> 5g).
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " <utility> [-i input] [-o output] [--header] [--precision N] [values...]\n"
+              << "       " << program << " <utility> --columns -i input -o output\n"
+              << "       " << program << " list\n"
+              << "       " << program << " serve <socket> [--precision N]\n\n"
+              << "Without values, records are read from the input (stdin by default), one per line, as\n"
+              << "comma, semicolon, tab or space separated numbers. One comma separated output line is\n"
+              << "written per record; invalid records produce \"nan\" fields.\n\n"
+              << "--columns reads and writes memory mapped column files instead, with one float64\n"
+              << "column per input and output named as listed by \"list\", see columnfile.h.\n\n"
+              << "serve answers \"<utility> <values...>\" lines and binary requests on a Unix domain\n"
+              << "socket until interrupted, see server.h." << std::endl;
+}
+
+void printCommands() {
+    std::size_t count;
+    const Command* commands = commandList(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::cout << commands[i].name << " (" << commands[i].utility << ")\n"
+                  << "    " << commands[i].description << "\n"
+                  << "    in:  " << commands[i].inputs << "\n"
+                  << "    out: " << commands[i].outputs << "\n";
+    }
+}
+
+CommandServer* runningServer = nullptr;
+
+void stopServer(int) {
+    runningServer->stop();
+}
+
+int serve(int argc, char* argv[]) {
+    CommandServerOptions options;
+    const char* path = nullptr;
+    for (int arg = 2; arg < argc; ++arg) {
+        std::string option = argv[arg];
+        if (option == "--precision" && arg + 1 < argc) {
+            options.precision = std::atoi(argv[++arg]);
+            if (options.precision < 1 || options.precision > 17) {
+                std::cerr << "Error: Precision must be between 1 and 17 digits." << std::endl;
+                return 1;
+            }
+        } else if (!path) {
+            path = argv[arg];
+        } else {
+            std::cerr << "Error: Unexpected argument " << option << std::endl;
+            return 1;
+        }
+    }
+    if (!path) {
+        std::cerr << "Error: Missing socket path" << std::endl;
+        return 1;
+    }
+
+    CommandServer server(options);
+    if (!server.listen(path)) {
+        std::cerr << "Error: Could not listen on " << path << ": " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    runningServer = &server;
+    std::signal(SIGINT, stopServer);
+    std::signal(SIGTERM, stopServer);
+    bool ok = server.run();
+    runningServer = nullptr;
+
+    const CommandServerStats& stats = server.stats();
+    std::cerr << stats.requests << " requests from " << stats.connections << " connections, "
+              << stats.batchedRequests << " in " << stats.batches << " batches" << std::endl;
+    if (!ok) {
+        std::cerr << "Error: " << std::strerror(errno) << std::endl;
+    }
+    return ok ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    // Per-stage timers and invalid input counters of the run, as Prometheus text for a
+    // ".prom" file and JSON otherwise
+    if (const char* metricsPath = std::getenv("FIVEG_METRICS_FILE")) {
+        const std::string path = metricsPath;
+        const bool prometheus = path.size() >= 5 && path.compare(path.size() - 5, 5, ".prom") == 0;
+        writeMetricsAtExit(path, prometheus ? MetricsFormat::Prometheus : MetricsFormat::Json);
+    }
+
+    const char* program = std::strrchr(argv[0], '/') ? std::strrchr(argv[0], '/') + 1 : argv[0];
+    int arg = 1;
+    const Command* command = findCommand(program);
+    if (!command) {
+        if (argc < 2) {
+            printUsage(program);
+            return 1;
+        }
+        if (std::string(argv[1]) == "list") {
+            printCommands();
+            return 0;
+        }
+        if (std::string(argv[1]) == "serve") {
+            return serve(argc, argv);
+        }
+        command = findCommand(argv[1]);
+        if (!command) {
+            std::cerr << "Error: Unknown utility " << argv[1] << std::endl;
+            printUsage(program);
+            return 1;
+        }
+        arg = 2;
+    }
+
+    CommandStreamOptions options;
+    const char* inputPath = nullptr;
+    const char* outputPath = nullptr;
+    std::string values;
+    bool columns = false;
+    for (; arg < argc; ++arg) {
+        std::string option = argv[arg];
+        if ((option == "-i" || option == "-o" || option == "--precision") && arg + 1 < argc) {
+            const char* value = argv[++arg];
+            if (option == "-i") {
+                inputPath = value;
+            } else if (option == "-o") {
+                outputPath = value;
+            } else {
+                options.precision = std::atoi(value);
+                if (options.precision < 1 || options.precision > 17) {
+                    std::cerr << "Error: Precision must be between 1 and 17 digits." << std::endl;
+                    return 1;
+                }
+            }
+        } else if (option == "--header") {
+            options.header = true;
+        } else if (option == "--columns") {
+            columns = true;
+        } else if (option == "-h" || option == "--help") {
+            printUsage(program);
+            return 0;
+        } else {
+            values += option;
+            values += ' ';
+        }
+    }
+
+    if (columns) {
+        if (!inputPath || !outputPath || !values.empty()) {
+            std::cerr << "Error: --columns needs an input and an output file, and no values" << std::endl;
+            return 1;
+        }
+        CommandStreamStats stats;
+        if (!runCommandColumns(*command, inputPath, outputPath, stats)) {
+            std::cerr << "Error: Could not convert " << inputPath << " to " << outputPath << ": "
+                      << std::strerror(errno) << std::endl;
+            return 1;
+        }
+        if (stats.invalid > 0) {
+            std::cerr << stats.invalid << " of " << stats.records << " records were invalid" << std::endl;
+        }
+        return 0;
+    }
+
+    std::FILE* out = outputPath ? std::fopen(outputPath, "wb") : stdout;
+    if (!out) {
+        std::cerr << "Error: Could not open " << outputPath << " for writing" << std::endl;
+        return 1;
+    }
+
+    bool ok = true;
+    if (!values.empty()) {
+        // A single record given on the command line
+        std::string result;
+        if (options.header) {
+            result = std::string(command->outputs) + "\n";
+        }
+        ok = evaluateRecord(*command, values.data(), values.data() + values.size(), result, options.precision);
+        std::fwrite(result.data(), 1, result.size(), out);
+    } else {
+        std::FILE* in = inputPath ? std::fopen(inputPath, "rb") : stdin;
+        if (!in) {
+            std::cerr << "Error: Could not open " << inputPath << std::endl;
+            return 1;
+        }
+        CommandStreamStats stats = runCommandStream(*command, in, out, options);
+        if (stats.invalid > 0) {
+            std::cerr << stats.invalid << " of " << stats.records << " records were invalid" << std::endl;
+        }
+        if (in != stdin) {
+            std::fclose(in);
+        }
+    }
+
+    if (std::fflush(out) != 0 || std::ferror(out)) {
+        std::cerr << "Error: Could not write the results" << std::endl;
+        return 1;
+    }
+    if (out != stdout) {
+        std::fclose(out);
+    }
+    return ok ? 0 : 1;
+}
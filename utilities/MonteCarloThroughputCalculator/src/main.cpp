@@ -0,0 +1,122 @@
+#include <chrono>
+#include <iostream>
+#include "montecarlo.h"
+#include "tbs.h"
+
+int main() {
+    std::cout << "\nRunning Monte Carlo DL Throughput Calculator" << std::endl;
+    std::cout << "============================================" << std::endl;
+
+    char ip;
+    int numOfLayers;
+    double bandwidth; // in MHz
+    double bandwidthInHz;
+    double totalTransmitPower; // in dBm
+    double pathLoss; // in dB
+    int prbCount;
+    double outageThroughput; // in Mbps
+    MonteCarloConfig config;
+
+    std::cout << "Choose the MIMO Configuration: " << std::endl;
+    std::cout << "Press a for 1*1\nPress b for 2*2\nPress c for 4*4\nPress d for 8*8" << std::endl;
+    std::cin >> ip;
+    switch (ip) {
+        case 'a': numOfLayers = 1; break;
+        case 'b': numOfLayers = 2; break;
+        case 'c': numOfLayers = 4; break;
+        case 'd': numOfLayers = 8; break;
+        default:
+            std::cerr << "Invalid input. Exiting" << std::endl;
+            return 1;
+    }
+
+    std::cout << "\nEnter bandwidth of operation in MHz: " << std::endl;
+    std::cin >> bandwidth;
+    if (!std::cin || bandwidth <= 0) {
+        std::cerr << "Error: Please enter a positive number for bandwidth." << std::endl;
+        return 1;
+    }
+    bandwidthInHz = bandwidth * 1e6;
+
+    std::cout << "\nEnter transmit power in dBm: " << std::endl;
+    std::cin >> totalTransmitPower;
+    if (!std::cin || totalTransmitPower <= 0) {
+        std::cerr << "Error: Please enter a positive number for transmit power." << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nEnter the median path loss in dB: " << std::endl;
+    std::cin >> pathLoss;
+    if (!std::cin || pathLoss <= 0) {
+        std::cerr << "Error: Please enter a positive number for pathLoss." << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nEnter PRB Count set in gNB: " << std::endl;
+    std::cin >> prbCount;
+    if (!std::cin || prbCount <= 0) {
+        std::cerr << "Error: Please enter a positive number for PRB Count." << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nEnter the shadow fading standard deviation in dB: " << std::endl;
+    std::cin >> config.shadowingStdDev;
+    if (!std::cin || config.shadowingStdDev < 0) {
+        std::cerr << "Error: Please enter a non-negative number for the shadow fading." << std::endl;
+        return 1;
+    }
+
+    std::cout << "\nEnter the probability of the UE being indoor (0 to 1): " << std::endl;
+    std::cin >> config.indoorProbability;
+    if (!std::cin || config.indoorProbability < 0 || config.indoorProbability > 1) {
+        std::cerr << "Error: Please enter a probability between 0 and 1." << std::endl;
+        return 1;
+    }
+    if (config.indoorProbability > 0) {
+        std::cout << "\nEnter the mean building penetration loss in dB: " << std::endl;
+        std::cin >> config.penetrationLoss;
+        if (!std::cin || config.penetrationLoss < 0) {
+            std::cerr << "Error: Please enter a non-negative number for the penetration loss." << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "\nEnter the outage throughput in Mbps: " << std::endl;
+    std::cin >> outageThroughput;
+    if (!std::cin || outageThroughput < 0) {
+        std::cerr << "Error: Please enter a non-negative number for the outage throughput." << std::endl;
+        return 1;
+    }
+    config.outageThroughput = outageThroughput * 1000;
+
+    std::cout << "\nEnter the number of trials: " << std::endl;
+    std::cin >> config.numTrials;
+    if (!std::cin || config.numTrials == 0) {
+        std::cerr << "Error: Please enter a positive number of trials." << std::endl;
+        return 1;
+    }
+
+    DLThroughputBatchInput scenario;
+    scenario.count = 1;
+    scenario.pathLoss = &pathLoss;
+    scenario.txPower = &totalTransmitPower;
+    scenario.numOfLayers = &numOfLayers;
+    scenario.prbCount = &prbCount;
+    scenario.bandwidth = &bandwidthInHz;
+    config.linkBudget.tbsLookupTable = &defaultTBSLookupTable();
+
+    std::cout << "\nRunning " << config.numTrials << " trials..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    MonteCarloResult result = runMonteCarloDLThroughput(scenario, config);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "Completed in " << elapsed.count() << " seconds ("
+              << result.numSamples / elapsed.count() << " trials per second)\n" << std::endl;
+
+    std::cout << "Mean DL Application Throughput: " << result.meanThroughput / 1000 << " Mbps" << std::endl;
+    std::cout << "5th percentile: " << result.throughputSketch.quantile(0.05) / 1000 << " Mbps" << std::endl;
+    std::cout << "Median: " << result.throughputSketch.quantile(0.5) / 1000 << " Mbps" << std::endl;
+    std::cout << "95th percentile: " << result.throughputSketch.quantile(0.95) / 1000 << " Mbps" << std::endl;
+    std::cout << "Outage probability: " << static_cast<double>(result.outageSamples) / result.numSamples << std::endl;
+
+    return 0;
+}
@@ -87,8 +87,8 @@ int main() {
             return 1;
     }
 
-    double pathLoss = calculate5GPathLossRural(gNBAntennaHeight, ueHeight, fLow, fHigh, distance2D,
-                                          buildingHeight, streetWidth, isLOS, true);
+    double pathLoss = calculate5GPathLossRural<StreamTrace>(gNBAntennaHeight, ueHeight, fLow, fHigh, distance2D,
+                                          buildingHeight, streetWidth, isLOS);
                                           
     std::string message = std::string("Calculated Path Loss for Rural ");
     if (isLOS) 